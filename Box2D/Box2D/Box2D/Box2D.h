@@ -48,6 +48,7 @@ For discussion please visit http://box2d.org/forum
 #include "Box2D/Dynamics/b2Body.h"
 #include "Box2D/Dynamics/b2Fixture.h"
 #include "Box2D/Dynamics/b2WorldCallbacks.h"
+#include "Box2D/Dynamics/b2ShapeQuery.h"
 #include "Box2D/Dynamics/b2TimeStep.h"
 #include "Box2D/Dynamics/b2World.h"
 
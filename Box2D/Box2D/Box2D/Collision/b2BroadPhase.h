@@ -72,6 +72,8 @@ public:
 	int32 GetProxyCount() const;
 
 	/// Update the pairs. This results in pair callbacks. This can only add pairs.
+	/// The callback must provide ShouldPair, a cheap test that can reject a pair
+	/// up front, and AddPair, which is called for each pair that passes.
 	template <typename T>
 	void UpdatePairs(T* callback);
 
@@ -218,7 +220,11 @@ void b2BroadPhase::UpdatePairs(T* callback)
 		void* userDataA = m_tree.GetUserData(primaryPair->proxyIdA);
 		void* userDataB = m_tree.GetUserData(primaryPair->proxyIdB);
 
-		callback->AddPair(userDataA, userDataB);
+		// Let the client cheaply reject the pair before the full callback.
+		if (callback->ShouldPair(userDataA, userDataB))
+		{
+			callback->AddPair(userDataA, userDataB);
+		}
 		++i;
 
 		// Skip any duplicate pairs.
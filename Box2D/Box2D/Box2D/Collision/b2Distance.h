@@ -90,6 +90,32 @@ void b2Distance(b2DistanceOutput* output,
 				b2SimplexCache* cache, 
 				const b2DistanceInput* input);
 
+/// Input for b2ShapeCast. Shape B is swept from transformB.p to
+/// transformB.p + translationB while shape A stays fixed.
+struct b2ShapeCastInput
+{
+	b2DistanceProxy proxyA;
+	b2DistanceProxy proxyB;
+	b2Transform transformA;
+	b2Transform transformB;
+	b2Vec2 translationB;
+};
+
+/// Output for b2ShapeCast.
+struct b2ShapeCastOutput
+{
+	b2Vec2 point;		///< hit point on the surface of shape A
+	b2Vec2 normal;		///< surface normal of shape A at the hit point
+	float32 lambda;		///< fraction of the translation at the time of impact
+	int32 iterations;	///< number of GJK iterations used
+};
+
+/// Perform a linear shape cast of shape B against shape A using GJK ray-casting
+/// (Gino van den Bergen). Supports any combination of b2CircleShape,
+/// b2PolygonShape and b2EdgeShape.
+/// @return true if the shapes hit, false if they miss or initially overlap.
+bool b2ShapeCast(b2ShapeCastOutput* output, const b2ShapeCastInput* input);
+
 
 //////////////////////////////////////////////////////////////////////////
 
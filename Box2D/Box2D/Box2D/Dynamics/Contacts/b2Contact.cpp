@@ -148,6 +148,10 @@ b2Contact::b2Contact(b2Fixture* fA, int32 indexA, b2Fixture* fB, int32 indexB)
 	m_nodeB.next = nullptr;
 	m_nodeB.other = nullptr;
 
+	m_island = nullptr;
+	m_islandPrev = nullptr;
+	m_islandNext = nullptr;
+
 	m_toiCount = 0;
 
 	m_friction = b2MixFriction(m_fixtureA->m_friction, m_fixtureB->m_friction);
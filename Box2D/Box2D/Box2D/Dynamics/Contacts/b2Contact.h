@@ -31,6 +31,7 @@ class b2World;
 class b2BlockAllocator;
 class b2StackAllocator;
 class b2ContactListener;
+struct b2PersistentIsland;
 
 /// Friction mixing law. The idea is to allow either fixture to drive the friction to zero.
 /// For example, anything slides on ice.
@@ -150,6 +151,7 @@ protected:
 	friend class b2ContactSolver;
 	friend class b2Body;
 	friend class b2Fixture;
+	friend class b2IslandManager;
 
 	// Flags stored in m_flags
 	enum
@@ -202,6 +204,11 @@ protected:
 	b2ContactEdge m_nodeA;
 	b2ContactEdge m_nodeB;
 
+	// Persistent island membership. Null unless touching and solid.
+	b2PersistentIsland* m_island;
+	b2Contact* m_islandPrev;
+	b2Contact* m_islandNext;
+
 	b2Fixture* m_fixtureA;
 	b2Fixture* m_fixtureB;
 
@@ -191,7 +191,9 @@ b2Joint::b2Joint(const b2JointDef* def)
 	m_bodyB = def->bodyB;
 	m_index = 0;
 	m_collideConnected = def->collideConnected;
-	m_islandFlag = false;
+	m_island = nullptr;
+	m_islandPrev = nullptr;
+	m_islandNext = nullptr;
 	m_userData = def->userData;
 
 	m_edgeA.joint = nullptr;
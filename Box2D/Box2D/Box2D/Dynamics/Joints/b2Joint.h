@@ -25,6 +25,7 @@ class b2Body;
 class b2Joint;
 struct b2SolverData;
 class b2BlockAllocator;
+struct b2PersistentIsland;
 
 enum b2JointType
 {
@@ -153,6 +154,7 @@ protected:
 	friend class b2World;
 	friend class b2Body;
 	friend class b2Island;
+	friend class b2IslandManager;
 	friend class b2GearJoint;
 
 	static b2Joint* Create(const b2JointDef* def, b2BlockAllocator* allocator);
@@ -177,7 +179,11 @@ protected:
 
 	int32 m_index;
 
-	bool m_islandFlag;
+	// Persistent island membership. Null if either body is inactive.
+	b2PersistentIsland* m_island;
+	b2Joint* m_islandPrev;
+	b2Joint* m_islandNext;
+
 	bool m_collideConnected;
 
 	void* m_userData;
@@ -71,6 +71,10 @@ b2Body::b2Body(const b2BodyDef* bd, b2World* world)
 	m_prev = nullptr;
 	m_next = nullptr;
 
+	m_island = nullptr;
+	m_islandPrev = nullptr;
+	m_islandNext = nullptr;
+
 	m_linearVelocity = bd->linearVelocity;
 	m_angularVelocity = bd->angularVelocity;
 
@@ -123,9 +127,12 @@ void b2Body::SetType(b2BodyType type)
 		return;
 	}
 
+	m_world->m_islandManager.RemoveBody(this);
+
 	m_type = type;
 
 	ResetMassData();
+	SynchronizeProxyFilters();
 
 	if (m_type == b2_staticBody)
 	{
@@ -151,6 +158,9 @@ void b2Body::SetType(b2BodyType type)
 	}
 	m_contactList = nullptr;
 
+	// Rejoin the island graph with the new type.
+	m_world->m_islandManager.AddBody(this);
+
 	// Touch the proxies so that new contacts will be created (when appropriate)
 	b2BroadPhase* broadPhase = &m_world->m_contactManager.m_broadPhase;
 	for (b2Fixture* f = m_fixtureList; f; f = f->m_next)
@@ -396,6 +406,14 @@ void b2Body::SetMassData(const b2MassData* massData)
 	m_linearVelocity += b2Cross(m_angularVelocity, m_sweep.c - oldCenter);
 }
 
+void b2Body::SynchronizeProxyFilters()
+{
+	for (b2Fixture* f = m_fixtureList; f; f = f->m_next)
+	{
+		f->SynchronizeProxyFilter();
+	}
+}
+
 bool b2Body::ShouldCollide(const b2Body* other) const
 {
 	// At least one body should be dynamic.
@@ -476,12 +494,18 @@ void b2Body::SetActive(bool flag)
 			f->CreateProxies(broadPhase, m_xf);
 		}
 
+		// Join an island and reconnect the joints.
+		m_world->m_islandManager.AddBody(this);
+
 		// Contacts are created the next time step.
 	}
 	else
 	{
 		m_flags &= ~e_activeFlag;
 
+		// Leave the island and disconnect the joints.
+		m_world->m_islandManager.RemoveBody(this);
+
 		// Destroy all proxies.
 		b2BroadPhase* broadPhase = &m_world->m_contactManager.m_broadPhase;
 		for (b2Fixture* f = m_fixtureList; f; f = f->m_next)
@@ -21,6 +21,7 @@
 
 #include "Box2D/Common/b2Math.h"
 #include "Box2D/Collision/Shapes/b2Shape.h"
+#include "Box2D/Dynamics/b2IslandManager.h"
 #include <memory>
 
 class b2Fixture;
@@ -396,6 +397,7 @@ private:
 	friend class b2ContactManager;
 	friend class b2ContactSolver;
 	friend class b2Contact;
+	friend class b2IslandManager;
 	
 	friend class b2DistanceJoint;
 	friend class b2FrictionJoint;
@@ -427,6 +429,9 @@ private:
 	void SynchronizeFixtures();
 	void SynchronizeTransform();
 
+	// Refresh the filter data cached in the broad-phase proxies of all fixtures.
+	void SynchronizeProxyFilters();
+
 	// This is used to prevent connected bodies from colliding.
 	// It may lie, depending on the collideConnected flag.
 	bool ShouldCollide(const b2Body* other) const;
@@ -439,6 +444,11 @@ private:
 
 	int32 m_islandIndex;
 
+	// Persistent island membership. Null for static and inactive bodies.
+	b2PersistentIsland* m_island;
+	b2Body* m_islandPrev;
+	b2Body* m_islandNext;
+
 	b2Transform m_xf;		// the body origin transform
 	b2Sweep m_sweep;		// the swept motion for CCD
 
@@ -642,6 +652,11 @@ inline void b2Body::SetAwake(bool flag)
 	{
 		m_flags |= e_awakeFlag;
 		m_sleepTime = 0.0f;
+
+		if (m_island)
+		{
+			m_island->m_awake = true;
+		}
 	}
 	else
 	{
@@ -19,6 +19,7 @@
 #include "Box2D/Dynamics/b2ContactManager.h"
 #include "Box2D/Dynamics/b2Body.h"
 #include "Box2D/Dynamics/b2Fixture.h"
+#include "Box2D/Dynamics/b2IslandManager.h"
 #include "Box2D/Dynamics/b2WorldCallbacks.h"
 #include "Box2D/Dynamics/Contacts/b2Contact.h"
 
@@ -32,6 +33,7 @@ b2ContactManager::b2ContactManager()
 	m_contactFilter = &b2_defaultFilter;
 	m_contactListener = &b2_defaultListener;
 	m_allocator = nullptr;
+	m_islandManager = nullptr;
 }
 
 void b2ContactManager::Destroy(b2Contact* c)
@@ -46,6 +48,9 @@ void b2ContactManager::Destroy(b2Contact* c)
 		m_contactListener->EndContact(c);
 	}
 
+	// Remove from the island graph.
+	m_islandManager->UnlinkContact(c);
+
 	// Remove from the world.
 	if (c->m_prev)
 	{
@@ -165,10 +170,48 @@ void b2ContactManager::Collide()
 
 		// The contact persists.
 		c->Update(m_contactListener);
+
+		// Link or unlink the contact as it begins or stops touching.
+		m_islandManager->SynchronizeContact(c);
+
 		c = c->GetNext();
 	}
 }
 
+// This is the broad-phase fast path. It only reads the filter data cached in the
+// proxies, so rejected pairs never touch the fixtures, the bodies or the filter vtable.
+inline bool b2ContactManager::ShouldPair(void* proxyUserDataA, void* proxyUserDataB) const
+{
+	const b2FixtureProxy* proxyA = (b2FixtureProxy*)proxyUserDataA;
+	const b2FixtureProxy* proxyB = (b2FixtureProxy*)proxyUserDataB;
+
+	// Are the fixtures on the same body?
+	if (proxyA->body == proxyB->body)
+	{
+		return false;
+	}
+
+	// At least one body should be dynamic.
+	if (((proxyA->flags | proxyB->flags) & b2FixtureProxy::e_dynamicFlag) == 0)
+	{
+		return false;
+	}
+
+	// The cached bits mirror b2ContactFilter::ShouldCollide, so they can only
+	// stand in for the default filter.
+	if (m_contactFilter == &b2_defaultFilter)
+	{
+		if (proxyA->groupIndex == proxyB->groupIndex && proxyA->groupIndex != 0)
+		{
+			return proxyA->groupIndex > 0;
+		}
+
+		return (proxyA->maskBits & proxyB->categoryBits) != 0 && (proxyA->categoryBits & proxyB->maskBits) != 0;
+	}
+
+	return true;
+}
+
 void b2ContactManager::FindNewContacts()
 {
 	m_broadPhase.UpdatePairs(this);
@@ -185,14 +228,11 @@ void b2ContactManager::AddPair(void* proxyUserDataA, void* proxyUserDataB)
 	int32 indexA = proxyA->childIndex;
 	int32 indexB = proxyB->childIndex;
 
-	b2Body* bodyA = fixtureA->GetBody();
-	b2Body* bodyB = fixtureB->GetBody();
+	b2Body* bodyA = proxyA->body;
+	b2Body* bodyB = proxyB->body;
 
-	// Are the fixtures on the same body?
-	if (bodyA == bodyB)
-	{
-		return;
-	}
+	// ShouldPair has already rejected fixtures on the same body.
+	b2Assert(bodyA != bodyB);
 
 	// TODO_ERIN use a hash table to remove a potential bottleneck when both
 	// bodies have a lot of contacts.
@@ -223,14 +263,16 @@ void b2ContactManager::AddPair(void* proxyUserDataA, void* proxyUserDataB)
 		edge = edge->next;
 	}
 
-	// Does a joint override collision? Is at least one body dynamic?
-	if (bodyB->ShouldCollide(bodyA) == false)
+	// Does a joint override collision? A joint connects both bodies, so there
+	// is nothing to check unless both have joints. ShouldPair has already made
+	// sure at least one body is dynamic.
+	if ((proxyA->flags & proxyB->flags & b2FixtureProxy::e_jointFlag) && bodyB->ShouldCollide(bodyA) == false)
 	{
 		return;
 	}
 
-	// Check user filtering.
-	if (m_contactFilter && m_contactFilter->ShouldCollide(fixtureA, fixtureB) == false)
+	// Check user filtering. ShouldPair has already applied the default filter.
+	if (m_contactFilter && m_contactFilter != &b2_defaultFilter && m_contactFilter->ShouldCollide(fixtureA, fixtureB) == false)
 	{
 		return;
 	}
@@ -25,6 +25,7 @@ class b2Contact;
 class b2ContactFilter;
 class b2ContactListener;
 class b2BlockAllocator;
+class b2IslandManager;
 
 // Delegate of b2World.
 class b2ContactManager
@@ -32,7 +33,8 @@ class b2ContactManager
 public:
 	b2ContactManager();
 
-	// Broad-phase callback.
+	// Broad-phase callbacks.
+	bool ShouldPair(void* proxyUserDataA, void* proxyUserDataB) const;
 	void AddPair(void* proxyUserDataA, void* proxyUserDataB);
 
 	void FindNewContacts();
@@ -47,6 +49,7 @@ public:
 	b2ContactFilter* m_contactFilter;
 	b2ContactListener* m_contactListener;
 	b2BlockAllocator* m_allocator;
+	b2IslandManager* m_islandManager;
 };
 
 #endif
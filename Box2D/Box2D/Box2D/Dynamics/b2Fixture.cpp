@@ -134,6 +134,8 @@ void b2Fixture::CreateProxies(b2BroadPhase* broadPhase, const b2Transform& xf)
 		proxy->fixture = this;
 		proxy->childIndex = i;
 	}
+
+	SynchronizeProxyFilter();
 }
 
 void b2Fixture::DestroyProxies(b2BroadPhase* broadPhase)
@@ -173,10 +175,36 @@ void b2Fixture::Synchronize(b2BroadPhase* broadPhase, const b2Transform& transfo
 	}
 }
 
+void b2Fixture::SynchronizeProxyFilter()
+{
+	uint16 flags = 0;
+	if (m_body->GetType() == b2_dynamicBody)
+	{
+		flags |= b2FixtureProxy::e_dynamicFlag;
+	}
+
+	if (m_body->GetJointList() != nullptr)
+	{
+		flags |= b2FixtureProxy::e_jointFlag;
+	}
+
+	for (int32 i = 0; i < m_proxyCount; ++i)
+	{
+		b2FixtureProxy* proxy = m_proxies + i;
+		proxy->body = m_body;
+		proxy->categoryBits = m_filter.categoryBits;
+		proxy->maskBits = m_filter.maskBits;
+		proxy->groupIndex = m_filter.groupIndex;
+		proxy->flags = flags;
+	}
+}
+
 void b2Fixture::SetFilterData(const b2Filter& filter)
 {
 	m_filter = filter;
 
+	SynchronizeProxyFilter();
+
 	Refilter();
 }
 
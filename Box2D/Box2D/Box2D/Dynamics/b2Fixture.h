@@ -91,12 +91,25 @@ struct b2FixtureDef
 };
 
 /// This proxy is used internally to connect fixtures to the broad-phase.
+/// The body pointer, filter bits and flags are cached copies so that the
+/// contact manager can reject pairs without touching fixture or body memory.
 struct b2FixtureProxy
 {
+	enum
+	{
+		e_dynamicFlag	= 0x0001,
+		e_jointFlag		= 0x0002
+	};
+
 	b2AABB aabb;
 	b2Fixture* fixture;
+	b2Body* body;
 	int32 childIndex;
 	int32 proxyId;
+	uint16 categoryBits;
+	uint16 maskBits;
+	int16 groupIndex;
+	uint16 flags;
 };
 
 /// A fixture is used to attach a shape to a body for collision detection. A fixture
@@ -215,6 +228,10 @@ protected:
 
 	void Synchronize(b2BroadPhase* broadPhase, const b2Transform& xf1, const b2Transform& xf2);
 
+	// Refresh the filter data cached in the proxies. Call this when the filter,
+	// the body type or the body's joint list changes.
+	void SynchronizeProxyFilter();
+
 	float32 m_density;
 
 	b2Fixture* m_next;
@@ -0,0 +1,483 @@
+/*
+* Copyright (c) 2026 the GravTank contributors
+*
+* Written for this project on top of Box2D and released under the same
+* zlib license.
+*
+* This software is provided 'as-is', without any express or implied
+* warranty.  In no event will the authors be held liable for any damages
+* arising from the use of this software.
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+* 1. The origin of this software must not be misrepresented; you must not
+* claim that you wrote the original software. If you use this software
+* in a product, an acknowledgment in the product documentation would be
+* appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+* misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "Box2D/Dynamics/b2IslandManager.h"
+#include "Box2D/Dynamics/b2Body.h"
+#include "Box2D/Dynamics/b2Fixture.h"
+#include "Box2D/Dynamics/Contacts/b2Contact.h"
+#include "Box2D/Dynamics/Joints/b2Joint.h"
+#include "Box2D/Common/b2BlockAllocator.h"
+#include "Box2D/Common/b2StackAllocator.h"
+
+b2IslandManager::b2IslandManager()
+{
+	m_islandList = nullptr;
+	m_islandCount = 0;
+	m_allocator = nullptr;
+	m_stackAllocator = nullptr;
+}
+
+void b2IslandManager::AddBody(b2Body* body)
+{
+	b2Assert(body->m_island == nullptr);
+
+	// Static and inactive bodies do not own an island. To keep islands as
+	// small as possible, they never connect islands either.
+	if (body->IsActive() && body->m_type != b2_staticBody)
+	{
+		b2PersistentIsland* island = CreateIsland(nullptr);
+		island->m_awake = body->IsAwake();
+		AddToIsland(island, body);
+	}
+
+	for (b2JointEdge* je = body->m_jointList; je; je = je->next)
+	{
+		LinkJoint(je->joint);
+	}
+
+	// Contacts are linked as they begin touching.
+}
+
+void b2IslandManager::RemoveBody(b2Body* body)
+{
+	for (b2JointEdge* je = body->m_jointList; je; je = je->next)
+	{
+		UnlinkJoint(je->joint);
+	}
+
+	for (b2ContactEdge* ce = body->m_contactList; ce; ce = ce->next)
+	{
+		UnlinkContact(ce->contact);
+	}
+
+	b2PersistentIsland* island = body->m_island;
+	if (island == nullptr)
+	{
+		return;
+	}
+
+	RemoveFromIsland(body);
+
+	if (island->m_bodyCount == 0)
+	{
+		b2Assert(island->m_contactCount == 0);
+		b2Assert(island->m_jointCount == 0);
+		DestroyIsland(island);
+	}
+	else
+	{
+		// The body may have been a bridge between the remaining bodies.
+		++island->m_constraintRemoveCount;
+	}
+}
+
+void b2IslandManager::SynchronizeContact(b2Contact* contact)
+{
+	// Only touching, solid contacts connect bodies. Whether the contact is
+	// enabled is decided per step, so that is checked when the island is solved.
+	bool link = contact->IsTouching() &&
+				contact->GetFixtureA()->IsSensor() == false &&
+				contact->GetFixtureB()->IsSensor() == false;
+
+	if (link == (contact->m_island != nullptr))
+	{
+		return;
+	}
+
+	if (link)
+	{
+		LinkContact(contact);
+	}
+	else
+	{
+		UnlinkContact(contact);
+	}
+}
+
+void b2IslandManager::LinkContact(b2Contact* contact)
+{
+	b2Assert(contact->m_island == nullptr);
+
+	b2Body* bodyA = contact->GetFixtureA()->GetBody();
+	b2Body* bodyB = contact->GetFixtureB()->GetBody();
+
+	b2PersistentIsland* island = MergeIslands(bodyA->m_island, bodyB->m_island);
+	if (island == nullptr)
+	{
+		return;
+	}
+
+	AddToIsland(island, contact);
+}
+
+void b2IslandManager::UnlinkContact(b2Contact* contact)
+{
+	b2PersistentIsland* island = contact->m_island;
+	if (island == nullptr)
+	{
+		return;
+	}
+
+	RemoveFromIsland(contact);
+	++island->m_constraintRemoveCount;
+}
+
+void b2IslandManager::LinkJoint(b2Joint* joint)
+{
+	if (joint->m_island != nullptr)
+	{
+		return;
+	}
+
+	b2Body* bodyA = joint->m_bodyA;
+	b2Body* bodyB = joint->m_bodyB;
+
+	// Don't simulate joints connected to inactive bodies.
+	if (bodyA->IsActive() == false || bodyB->IsActive() == false)
+	{
+		return;
+	}
+
+	b2PersistentIsland* island = MergeIslands(bodyA->m_island, bodyB->m_island);
+	if (island == nullptr)
+	{
+		return;
+	}
+
+	AddToIsland(island, joint);
+}
+
+void b2IslandManager::UnlinkJoint(b2Joint* joint)
+{
+	b2PersistentIsland* island = joint->m_island;
+	if (island == nullptr)
+	{
+		return;
+	}
+
+	RemoveFromIsland(joint);
+	++island->m_constraintRemoveCount;
+}
+
+b2PersistentIsland* b2IslandManager::SplitIsland(b2PersistentIsland* island)
+{
+	b2Assert(island->m_bodyCount > 0);
+
+	int32 stackSize = island->m_bodyCount;
+	b2Body** stack = (b2Body**)m_stackAllocator->Allocate(stackSize * sizeof(b2Body*));
+
+	// Flood fill the constraint graph of the island. Anything still pointing at
+	// the old island has not been visited yet.
+	b2PersistentIsland* last = island;
+	while (island->m_bodyList)
+	{
+		b2PersistentIsland* component = CreateIsland(last);
+		component->m_awake = island->m_awake;
+		last = component;
+
+		b2Body* seed = island->m_bodyList;
+		RemoveFromIsland(seed);
+		AddToIsland(component, seed);
+
+		int32 stackCount = 0;
+		stack[stackCount++] = seed;
+
+		while (stackCount > 0)
+		{
+			b2Body* b = stack[--stackCount];
+
+			for (b2ContactEdge* ce = b->m_contactList; ce; ce = ce->next)
+			{
+				b2Contact* contact = ce->contact;
+				if (contact->m_island != island)
+				{
+					continue;
+				}
+
+				RemoveFromIsland(contact);
+				AddToIsland(component, contact);
+
+				b2Body* other = ce->other;
+				if (other->m_island != island)
+				{
+					continue;
+				}
+
+				RemoveFromIsland(other);
+				AddToIsland(component, other);
+
+				b2Assert(stackCount < stackSize);
+				stack[stackCount++] = other;
+			}
+
+			for (b2JointEdge* je = b->m_jointList; je; je = je->next)
+			{
+				b2Joint* joint = je->joint;
+				if (joint->m_island != island)
+				{
+					continue;
+				}
+
+				RemoveFromIsland(joint);
+				AddToIsland(component, joint);
+
+				b2Body* other = je->other;
+				if (other->m_island != island)
+				{
+					continue;
+				}
+
+				RemoveFromIsland(other);
+				AddToIsland(component, other);
+
+				b2Assert(stackCount < stackSize);
+				stack[stackCount++] = other;
+			}
+		}
+	}
+
+	m_stackAllocator->Free(stack);
+
+	// Every linked constraint touches a body of the island, so nothing is left behind.
+	b2Assert(island->m_contactCount == 0);
+	b2Assert(island->m_jointCount == 0);
+
+	b2PersistentIsland* first = island->m_next;
+	DestroyIsland(island);
+	return first;
+}
+
+b2PersistentIsland* b2IslandManager::CreateIsland(b2PersistentIsland* prev)
+{
+	void* mem = m_allocator->Allocate(sizeof(b2PersistentIsland));
+	b2PersistentIsland* island = (b2PersistentIsland*)mem;
+
+	island->m_bodyList = nullptr;
+	island->m_contactList = nullptr;
+	island->m_jointList = nullptr;
+	island->m_bodyCount = 0;
+	island->m_contactCount = 0;
+	island->m_jointCount = 0;
+	island->m_constraintRemoveCount = 0;
+	island->m_awake = false;
+
+	// Insert after prev, or at the head of the list.
+	island->m_prev = prev;
+	if (prev)
+	{
+		island->m_next = prev->m_next;
+		prev->m_next = island;
+	}
+	else
+	{
+		island->m_next = m_islandList;
+		m_islandList = island;
+	}
+
+	if (island->m_next)
+	{
+		island->m_next->m_prev = island;
+	}
+
+	++m_islandCount;
+	return island;
+}
+
+void b2IslandManager::DestroyIsland(b2PersistentIsland* island)
+{
+	if (island->m_prev)
+	{
+		island->m_prev->m_next = island->m_next;
+	}
+
+	if (island->m_next)
+	{
+		island->m_next->m_prev = island->m_prev;
+	}
+
+	if (island == m_islandList)
+	{
+		m_islandList = island->m_next;
+	}
+
+	--m_islandCount;
+	m_allocator->Free(island, sizeof(b2PersistentIsland));
+}
+
+b2PersistentIsland* b2IslandManager::MergeIslands(b2PersistentIsland* islandA, b2PersistentIsland* islandB)
+{
+	if (islandA == nullptr)
+	{
+		return islandB;
+	}
+
+	if (islandB == nullptr || islandA == islandB)
+	{
+		return islandA;
+	}
+
+	// Move the smaller island into the larger one.
+	if (islandA->m_bodyCount < islandB->m_bodyCount)
+	{
+		b2Swap(islandA, islandB);
+	}
+
+	while (islandB->m_bodyList)
+	{
+		b2Body* body = islandB->m_bodyList;
+		RemoveFromIsland(body);
+		AddToIsland(islandA, body);
+	}
+
+	while (islandB->m_contactList)
+	{
+		b2Contact* contact = islandB->m_contactList;
+		RemoveFromIsland(contact);
+		AddToIsland(islandA, contact);
+	}
+
+	while (islandB->m_jointList)
+	{
+		b2Joint* joint = islandB->m_jointList;
+		RemoveFromIsland(joint);
+		AddToIsland(islandA, joint);
+	}
+
+	islandA->m_awake = islandA->m_awake || islandB->m_awake;
+	islandA->m_constraintRemoveCount += islandB->m_constraintRemoveCount;
+
+	DestroyIsland(islandB);
+	return islandA;
+}
+
+void b2IslandManager::AddToIsland(b2PersistentIsland* island, b2Body* body)
+{
+	body->m_island = island;
+	body->m_islandPrev = nullptr;
+	body->m_islandNext = island->m_bodyList;
+	if (island->m_bodyList)
+	{
+		island->m_bodyList->m_islandPrev = body;
+	}
+	island->m_bodyList = body;
+	++island->m_bodyCount;
+}
+
+void b2IslandManager::AddToIsland(b2PersistentIsland* island, b2Contact* contact)
+{
+	contact->m_island = island;
+	contact->m_islandPrev = nullptr;
+	contact->m_islandNext = island->m_contactList;
+	if (island->m_contactList)
+	{
+		island->m_contactList->m_islandPrev = contact;
+	}
+	island->m_contactList = contact;
+	++island->m_contactCount;
+}
+
+void b2IslandManager::AddToIsland(b2PersistentIsland* island, b2Joint* joint)
+{
+	joint->m_island = island;
+	joint->m_islandPrev = nullptr;
+	joint->m_islandNext = island->m_jointList;
+	if (island->m_jointList)
+	{
+		island->m_jointList->m_islandPrev = joint;
+	}
+	island->m_jointList = joint;
+	++island->m_jointCount;
+}
+
+void b2IslandManager::RemoveFromIsland(b2Body* body)
+{
+	b2PersistentIsland* island = body->m_island;
+
+	if (body->m_islandPrev)
+	{
+		body->m_islandPrev->m_islandNext = body->m_islandNext;
+	}
+
+	if (body->m_islandNext)
+	{
+		body->m_islandNext->m_islandPrev = body->m_islandPrev;
+	}
+
+	if (body == island->m_bodyList)
+	{
+		island->m_bodyList = body->m_islandNext;
+	}
+
+	--island->m_bodyCount;
+	body->m_island = nullptr;
+	body->m_islandPrev = nullptr;
+	body->m_islandNext = nullptr;
+}
+
+void b2IslandManager::RemoveFromIsland(b2Contact* contact)
+{
+	b2PersistentIsland* island = contact->m_island;
+
+	if (contact->m_islandPrev)
+	{
+		contact->m_islandPrev->m_islandNext = contact->m_islandNext;
+	}
+
+	if (contact->m_islandNext)
+	{
+		contact->m_islandNext->m_islandPrev = contact->m_islandPrev;
+	}
+
+	if (contact == island->m_contactList)
+	{
+		island->m_contactList = contact->m_islandNext;
+	}
+
+	--island->m_contactCount;
+	contact->m_island = nullptr;
+	contact->m_islandPrev = nullptr;
+	contact->m_islandNext = nullptr;
+}
+
+void b2IslandManager::RemoveFromIsland(b2Joint* joint)
+{
+	b2PersistentIsland* island = joint->m_island;
+
+	if (joint->m_islandPrev)
+	{
+		joint->m_islandPrev->m_islandNext = joint->m_islandNext;
+	}
+
+	if (joint->m_islandNext)
+	{
+		joint->m_islandNext->m_islandPrev = joint->m_islandPrev;
+	}
+
+	if (joint == island->m_jointList)
+	{
+		island->m_jointList = joint->m_islandNext;
+	}
+
+	--island->m_jointCount;
+	joint->m_island = nullptr;
+	joint->m_islandPrev = nullptr;
+	joint->m_islandNext = nullptr;
+}
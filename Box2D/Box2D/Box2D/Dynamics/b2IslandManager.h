@@ -0,0 +1,107 @@
+/*
+* Copyright (c) 2026 the GravTank contributors
+*
+* Written for this project on top of Box2D and released under the same
+* zlib license.
+*
+* This software is provided 'as-is', without any express or implied
+* warranty.  In no event will the authors be held liable for any damages
+* arising from the use of this software.
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+* 1. The origin of this software must not be misrepresented; you must not
+* claim that you wrote the original software. If you use this software
+* in a product, an acknowledgment in the product documentation would be
+* appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+* misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef B2_ISLAND_MANAGER_H
+#define B2_ISLAND_MANAGER_H
+
+#include "Box2D/Common/b2Settings.h"
+
+class b2Body;
+class b2Contact;
+class b2Joint;
+class b2BlockAllocator;
+class b2StackAllocator;
+
+/// A persistent island is a set of non-static bodies connected by touching
+/// contacts and joints. Islands merge as soon as a new constraint connects them,
+/// but they are only split, lazily, when they are about to be solved after a
+/// constraint was removed. This is an internal class.
+struct b2PersistentIsland
+{
+	b2PersistentIsland* m_prev;
+	b2PersistentIsland* m_next;
+
+	b2Body* m_bodyList;
+	b2Contact* m_contactList;
+	b2Joint* m_jointList;
+
+	int32 m_bodyCount;
+	int32 m_contactCount;
+	int32 m_jointCount;
+
+	// The number of constraints removed since the island was last split.
+	// If this is zero the island is known to be connected.
+	int32 m_constraintRemoveCount;
+
+	// Set when any body in the island may be awake.
+	bool m_awake;
+};
+
+// Delegate of b2World. Keeps the persistent islands in sync with the
+// constraint graph so that b2World::Solve does not have to rebuild islands
+// from scratch every step.
+class b2IslandManager
+{
+public:
+	b2IslandManager();
+
+	// Call when a body is created, activated or changes type.
+	void AddBody(b2Body* body);
+
+	// Call when a body is destroyed, deactivated or changes type.
+	void RemoveBody(b2Body* body);
+
+	// Link or unlink a contact depending on whether it is touching and solid.
+	void SynchronizeContact(b2Contact* contact);
+	void UnlinkContact(b2Contact* contact);
+
+	void LinkJoint(b2Joint* joint);
+	void UnlinkJoint(b2Joint* joint);
+
+	// Split an island into its connected components. The components replace the
+	// island in the island list. Returns the first component.
+	b2PersistentIsland* SplitIsland(b2PersistentIsland* island);
+
+	b2PersistentIsland* m_islandList;
+	int32 m_islandCount;
+
+	b2BlockAllocator* m_allocator;
+	b2StackAllocator* m_stackAllocator;
+
+private:
+
+	b2PersistentIsland* CreateIsland(b2PersistentIsland* next);
+	void DestroyIsland(b2PersistentIsland* island);
+
+	b2PersistentIsland* MergeIslands(b2PersistentIsland* islandA, b2PersistentIsland* islandB);
+
+	void LinkContact(b2Contact* contact);
+
+	void AddToIsland(b2PersistentIsland* island, b2Body* body);
+	void AddToIsland(b2PersistentIsland* island, b2Contact* contact);
+	void AddToIsland(b2PersistentIsland* island, b2Joint* joint);
+
+	void RemoveFromIsland(b2Body* body);
+	void RemoveFromIsland(b2Contact* contact);
+	void RemoveFromIsland(b2Joint* joint);
+};
+
+#endif
@@ -0,0 +1,82 @@
+/*
+* Copyright (c) 2026 the GravTank contributors
+*
+* Written for this project on top of Box2D and released under the same
+* zlib license.
+*
+* This software is provided 'as-is', without any express or implied
+* warranty.  In no event will the authors be held liable for any damages
+* arising from the use of this software.
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+* 1. The origin of this software must not be misrepresented; you must not
+* claim that you wrote the original software. If you use this software
+* in a product, an acknowledgment in the product documentation would be
+* appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+* misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "Box2D/Dynamics/b2ShapeQuery.h"
+
+b2ShapeQueryCache::b2ShapeQueryCache()
+{
+	Reset();
+}
+
+void b2ShapeQueryCache::Reset()
+{
+	for (int32 i = 0; i < e_capacity; ++i)
+	{
+		m_entries[i].fixture = nullptr;
+		m_entries[i].childIndex = 0;
+		m_entries[i].cache.count = 0;
+	}
+
+	m_hitCount = 0;
+	m_missCount = 0;
+}
+
+b2SimplexCache* b2ShapeQueryCache::GetSimplexCache(const b2Fixture* fixture, int32 childIndex,
+												   const b2DistanceProxy& proxyA, const b2DistanceProxy& proxyB)
+{
+	// Fixtures come from a block allocator, so the low bits of the address carry little information.
+	size_t key = (size_t)fixture;
+	key = (key >> 4) ^ (key >> 12) ^ (size_t)(childIndex * 31);
+	b2ShapeQueryCacheEntry* entry = m_entries + (key & (e_capacity - 1));
+
+	if (entry->fixture != fixture || entry->childIndex != childIndex)
+	{
+		entry->fixture = fixture;
+		entry->childIndex = childIndex;
+		entry->cache.count = 0;
+		++m_missCount;
+		return &entry->cache;
+	}
+
+	// The fixture may have been destroyed and its memory reused, or the query
+	// shape may have changed. Make sure the cached vertices still exist.
+	b2SimplexCache* cache = &entry->cache;
+	for (int32 i = 0; i < cache->count; ++i)
+	{
+		if (cache->indexA[i] >= proxyA.m_count || cache->indexB[i] >= proxyB.m_count)
+		{
+			cache->count = 0;
+			++m_missCount;
+			return cache;
+		}
+	}
+
+	if (cache->count > 0)
+	{
+		++m_hitCount;
+	}
+	else
+	{
+		++m_missCount;
+	}
+
+	return cache;
+}
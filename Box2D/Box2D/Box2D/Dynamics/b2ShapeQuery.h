@@ -0,0 +1,124 @@
+/*
+* Copyright (c) 2026 the GravTank contributors
+*
+* Written for this project on top of Box2D and released under the same
+* zlib license.
+*
+* This software is provided 'as-is', without any express or implied
+* warranty.  In no event will the authors be held liable for any damages
+* arising from the use of this software.
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+* 1. The origin of this software must not be misrepresented; you must not
+* claim that you wrote the original software. If you use this software
+* in a product, an acknowledgment in the product documentation would be
+* appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+* misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef B2_SHAPE_QUERY_H
+#define B2_SHAPE_QUERY_H
+
+#include "Box2D/Collision/b2Distance.h"
+
+class b2Fixture;
+class b2Shape;
+
+/// Warm start data for repeated shape queries against a world. The GJK simplex
+/// of each fixture found by a query is kept, so when the same query is repeated
+/// next frame with a slowly moving shape it usually converges in one iteration.
+/// The cache is owned by the caller and must only be used with one query shape
+/// at a time. Call Reset when the query shape changes.
+class b2ShapeQueryCache
+{
+public:
+	b2ShapeQueryCache();
+
+	/// Forget all cached simplices.
+	void Reset();
+
+	/// Get the simplex cache for a fixture child. The returned cache is empty if
+	/// the fixture was not seen before or its entry was evicted.
+	/// @param proxyA the distance proxy of the fixture child.
+	/// @param proxyB the distance proxy of the query shape.
+	b2SimplexCache* GetSimplexCache(const b2Fixture* fixture, int32 childIndex,
+									const b2DistanceProxy& proxyA, const b2DistanceProxy& proxyB);
+
+	/// Get the number of lookups that found a warm start.
+	int32 GetHitCount() const;
+
+	/// Get the number of lookups that started cold.
+	int32 GetMissCount() const;
+
+private:
+
+	enum
+	{
+		// Must be a power of two.
+		e_capacity = 128
+	};
+
+	// Entries are direct mapped. A collision simply evicts the old entry,
+	// which only costs a cold start.
+	struct b2ShapeQueryCacheEntry
+	{
+		const b2Fixture* fixture;
+		int32 childIndex;
+		b2SimplexCache cache;
+	};
+
+	b2ShapeQueryCacheEntry m_entries[e_capacity];
+
+	int32 m_hitCount;
+	int32 m_missCount;
+};
+
+/// A shape cast used by b2World::ShapeCastBatch. The shape is swept from
+/// transform.p to transform.p + translation.
+struct b2ShapeCastQuery
+{
+	b2ShapeCastQuery()
+	{
+		shape = nullptr;
+		transform.SetIdentity();
+		translation.SetZero();
+		maskBits = 0xFFFF;
+	}
+
+	/// The query shape. It must have a single child (circle, polygon or edge).
+	const b2Shape* shape;
+
+	/// The initial transform of the shape.
+	b2Transform transform;
+
+	/// The translation of the shape.
+	b2Vec2 translation;
+
+	/// Only fixtures whose category bits match these bits are considered.
+	uint16 maskBits;
+};
+
+/// The closest hit found by b2World::ShapeCastBatch. The fixture is nullptr
+/// if the shape cast did not hit anything.
+struct b2ShapeCastHit
+{
+	b2Fixture* fixture;
+	b2Vec2 point;
+	b2Vec2 normal;
+	float32 fraction;
+};
+
+inline int32 b2ShapeQueryCache::GetHitCount() const
+{
+	return m_hitCount;
+}
+
+inline int32 b2ShapeQueryCache::GetMissCount() const
+{
+	return m_missCount;
+}
+
+#endif
@@ -20,6 +20,7 @@
 #include "Box2D/Dynamics/b2Body.h"
 #include "Box2D/Dynamics/b2Fixture.h"
 #include "Box2D/Dynamics/b2Island.h"
+#include "Box2D/Dynamics/b2ShapeQuery.h"
 #include "Box2D/Dynamics/Joints/b2PulleyJoint.h"
 #include "Box2D/Dynamics/Contacts/b2Contact.h"
 #include "Box2D/Dynamics/Contacts/b2ContactSolver.h"
@@ -30,6 +31,7 @@
 #include "Box2D/Collision/Shapes/b2ChainShape.h"
 #include "Box2D/Collision/Shapes/b2PolygonShape.h"
 #include "Box2D/Collision/b2TimeOfImpact.h"
+#include "Box2D/Collision/b2Distance.h"
 #include "Box2D/Common/b2Draw.h"
 #include "Box2D/Common/b2Timer.h"
 #include <new>
@@ -59,6 +61,10 @@ b2World::b2World(const b2Vec2& gravity)
 	m_inv_dt0 = 0.0f;
 
 	m_contactManager.m_allocator = &m_blockAllocator;
+	m_contactManager.m_islandManager = &m_islandManager;
+
+	m_islandManager.m_allocator = &m_blockAllocator;
+	m_islandManager.m_stackAllocator = &m_stackAllocator;
 
 	memset(&m_profile, 0, sizeof(b2Profile));
 }
@@ -125,6 +131,8 @@ b2Body* b2World::CreateBody(const b2BodyDef* def)
 	m_bodyList = b;
 	++m_bodyCount;
 
+	m_islandManager.AddBody(b);
+
 	return b;
 }
 
@@ -165,6 +173,9 @@ void b2World::DestroyBody(b2Body* b)
 	}
 	b->m_contactList = nullptr;
 
+	// Leave the island graph.
+	m_islandManager.RemoveBody(b);
+
 	// Delete the attached fixtures. This destroys broad-phase proxies.
 	b2Fixture* f = b->m_fixtureList;
 	while (f)
@@ -247,6 +258,13 @@ b2Joint* b2World::CreateJoint(const b2JointDef* def)
 	b2Body* bodyA = def->bodyA;
 	b2Body* bodyB = def->bodyB;
 
+	// The bodies now have joints, so the broad-phase must consult them.
+	bodyA->SynchronizeProxyFilters();
+	bodyB->SynchronizeProxyFilters();
+
+	// Merge the islands of the connected bodies.
+	m_islandManager.LinkJoint(j);
+
 	// If the joint prevents collisions, then flag any contacts for filtering.
 	if (def->collideConnected == false)
 	{
@@ -279,6 +297,8 @@ void b2World::DestroyJoint(b2Joint* j)
 
 	bool collideConnected = j->m_collideConnected;
 
+	m_islandManager.UnlinkJoint(j);
+
 	// Remove from the doubly linked list.
 	if (j->m_prev)
 	{
@@ -341,6 +361,9 @@ void b2World::DestroyJoint(b2Joint* j)
 	j->m_edgeB.prev = nullptr;
 	j->m_edgeB.next = nullptr;
 
+	bodyA->SynchronizeProxyFilters();
+	bodyB->SynchronizeProxyFilters();
+
 	b2Joint::Destroy(j, &m_blockAllocator);
 
 	b2Assert(m_jointCount > 0);
@@ -388,6 +411,7 @@ void b2World::Solve(const b2TimeStep& step)
 	m_profile.solveInit = 0.0f;
 	m_profile.solveVelocity = 0.0f;
 	m_profile.solvePosition = 0.0f;
+	m_profile.broadphase = 0.0f;
 
 	// Size the island for the worst case.
 	b2Island island(m_bodyCount,
@@ -396,135 +420,106 @@ void b2World::Solve(const b2TimeStep& step)
 					&m_stackAllocator,
 					m_contactManager.m_contactListener);
 
-	// Clear all the island flags.
-	for (b2Body* b = m_bodyList; b; b = b->m_next)
-	{
-		b->m_flags &= ~b2Body::e_islandFlag;
-	}
-	for (b2Contact* c = m_contactManager.m_contactList; c; c = c->m_next)
-	{
-		c->m_flags &= ~b2Contact::e_islandFlag;
-	}
-	for (b2Joint* j = m_jointList; j; j = j->m_next)
-	{
-		j->m_islandFlag = false;
-	}
-
-	// Build and simulate all awake islands.
-	int32 stackSize = m_bodyCount;
-	b2Body** stack = (b2Body**)m_stackAllocator.Allocate(stackSize * sizeof(b2Body*));
-	for (b2Body* seed = m_bodyList; seed; seed = seed->m_next)
+	// Solve all awake islands. The islands are kept up to date as constraints
+	// are added and removed, so there is no need to search the whole
+	// constraint graph here.
+	b2PersistentIsland* persistentIsland = m_islandManager.m_islandList;
+	while (persistentIsland)
 	{
-		if (seed->m_flags & b2Body::e_islandFlag)
+		if (persistentIsland->m_awake == false)
 		{
+			persistentIsland = persistentIsland->m_next;
 			continue;
 		}
 
-		if (seed->IsAwake() == false || seed->IsActive() == false)
+		// Constraints were removed, so the island may have come apart.
+		if (persistentIsland->m_constraintRemoveCount > 0)
 		{
-			continue;
+			persistentIsland = m_islandManager.SplitIsland(persistentIsland);
+		}
+
+		// The island is only simulated if one of its bodies is awake.
+		bool awake = false;
+		for (b2Body* b = persistentIsland->m_bodyList; b; b = b->m_islandNext)
+		{
+			if (b->IsAwake())
+			{
+				awake = true;
+				break;
+			}
 		}
 
-		// The seed can be dynamic or kinematic.
-		if (seed->GetType() == b2_staticBody)
+		if (awake == false)
 		{
+			persistentIsland->m_awake = false;
+			persistentIsland = persistentIsland->m_next;
 			continue;
 		}
 
-		// Reset island and stack.
 		island.Clear();
-		int32 stackCount = 0;
-		stack[stackCount++] = seed;
-		seed->m_flags |= b2Body::e_islandFlag;
 
-		// Perform a depth first search (DFS) on the constraint graph.
-		while (stackCount > 0)
+		for (b2Body* b = persistentIsland->m_bodyList; b; b = b->m_islandNext)
 		{
-			// Grab the next body off the stack and add it to the island.
-			b2Body* b = stack[--stackCount];
 			b2Assert(b->IsActive() == true);
 			island.Add(b);
 
 			// Make sure the body is awake (without resetting sleep timer).
 			b->m_flags |= b2Body::e_awakeFlag;
+		}
 
-			// To keep islands as small as possible, we don't
-			// propagate islands across static bodies.
-			if (b->GetType() == b2_staticBody)
+		for (b2Contact* contact = persistentIsland->m_contactList; contact; contact = contact->m_islandNext)
+		{
+			// Is this contact solid and touching?
+			if (contact->IsEnabled() == false ||
+				contact->IsTouching() == false)
 			{
 				continue;
 			}
 
-			// Search all contacts connected to this body.
-			for (b2ContactEdge* ce = b->m_contactList; ce; ce = ce->next)
+			// Skip sensors.
+			bool sensorA = contact->m_fixtureA->m_isSensor;
+			bool sensorB = contact->m_fixtureB->m_isSensor;
+			if (sensorA || sensorB)
 			{
-				b2Contact* contact = ce->contact;
-
-				// Has this contact already been added to an island?
-				if (contact->m_flags & b2Contact::e_islandFlag)
-				{
-					continue;
-				}
-
-				// Is this contact solid and touching?
-				if (contact->IsEnabled() == false ||
-					contact->IsTouching() == false)
-				{
-					continue;
-				}
-
-				// Skip sensors.
-				bool sensorA = contact->m_fixtureA->m_isSensor;
-				bool sensorB = contact->m_fixtureB->m_isSensor;
-				if (sensorA || sensorB)
-				{
-					continue;
-				}
-
-				island.Add(contact);
-				contact->m_flags |= b2Contact::e_islandFlag;
-
-				b2Body* other = ce->other;
-
-				// Was the other body already added to this island?
-				if (other->m_flags & b2Body::e_islandFlag)
-				{
-					continue;
-				}
-
-				b2Assert(stackCount < stackSize);
-				stack[stackCount++] = other;
-				other->m_flags |= b2Body::e_islandFlag;
+				continue;
 			}
 
-			// Search all joints connect to this body.
-			for (b2JointEdge* je = b->m_jointList; je; je = je->next)
+			// Static bodies don't belong to an island, so they are added
+			// to every island that touches them.
+			b2Body* bodyA = contact->m_fixtureA->m_body;
+			b2Body* bodyB = contact->m_fixtureB->m_body;
+			if (bodyA->m_island == nullptr && (bodyA->m_flags & b2Body::e_islandFlag) == 0)
 			{
-				if (je->joint->m_islandFlag == true)
-				{
-					continue;
-				}
-
-				b2Body* other = je->other;
+				island.Add(bodyA);
+				bodyA->m_flags |= b2Body::e_islandFlag | b2Body::e_awakeFlag;
+			}
 
-				// Don't simulate joints connected to inactive bodies.
-				if (other->IsActive() == false)
-				{
-					continue;
-				}
+			if (bodyB->m_island == nullptr && (bodyB->m_flags & b2Body::e_islandFlag) == 0)
+			{
+				island.Add(bodyB);
+				bodyB->m_flags |= b2Body::e_islandFlag | b2Body::e_awakeFlag;
+			}
 
-				island.Add(je->joint);
-				je->joint->m_islandFlag = true;
+			island.Add(contact);
+		}
 
-				if (other->m_flags & b2Body::e_islandFlag)
-				{
-					continue;
-				}
+		for (b2Joint* joint = persistentIsland->m_jointList; joint; joint = joint->m_islandNext)
+		{
+			b2Body* bodyA = joint->m_bodyA;
+			b2Body* bodyB = joint->m_bodyB;
+			if (bodyA->m_island == nullptr && (bodyA->m_flags & b2Body::e_islandFlag) == 0)
+			{
+				island.Add(bodyA);
+				bodyA->m_flags |= b2Body::e_islandFlag | b2Body::e_awakeFlag;
+			}
 
-				b2Assert(stackCount < stackSize);
-				stack[stackCount++] = other;
-				other->m_flags |= b2Body::e_islandFlag;
+			if (bodyB->m_island == nullptr && (bodyB->m_flags & b2Body::e_islandFlag) == 0)
+			{
+				island.Add(bodyB);
+				bodyB->m_flags |= b2Body::e_islandFlag | b2Body::e_awakeFlag;
 			}
+
+			island.Add(joint);
 		}
 
 		b2Profile profile;
@@ -534,6 +529,7 @@ void b2World::Solve(const b2TimeStep& step)
 		m_profile.solvePosition += profile.solvePosition;
 
 		// Post solve cleanup.
+		b2Timer timer;
 		for (int32 i = 0; i < island.m_bodyCount; ++i)
 		{
 			// Allow static bodies to participate in other islands.
@@ -541,35 +537,29 @@ void b2World::Solve(const b2TimeStep& step)
 			if (b->GetType() == b2_staticBody)
 			{
 				b->m_flags &= ~b2Body::e_islandFlag;
-			}
-		}
-	}
-
-	m_stackAllocator.Free(stack);
-
-	{
-		b2Timer timer;
-		// Synchronize fixtures, check for out of range bodies.
-		for (b2Body* b = m_bodyList; b; b = b->GetNext())
-		{
-			// If a body was not in an island then it did not move.
-			if ((b->m_flags & b2Body::e_islandFlag) == 0)
-			{
-				continue;
-			}
-
-			if (b->GetType() == b2_staticBody)
-			{
 				continue;
 			}
 
 			// Update fixtures (for broad-phase).
 			b->SynchronizeFixtures();
 		}
+		m_profile.broadphase += timer.GetMilliseconds();
+
+		// The island solver puts all of the bodies to sleep at once.
+		if (persistentIsland->m_bodyList->IsAwake() == false)
+		{
+			persistentIsland->m_awake = false;
+		}
+
+		persistentIsland = persistentIsland->m_next;
+	}
+
+	{
+		b2Timer timer;
 
 		// Look for new contacts.
 		m_contactManager.FindNewContacts();
-		m_profile.broadphase = timer.GetMilliseconds();
+		m_profile.broadphase += timer.GetMilliseconds();
 	}
 }
 
@@ -733,6 +723,7 @@ void b2World::SolveTOI(const b2TimeStep& step)
 
 		// The TOI contact likely has some new contact points.
 		minContact->Update(m_contactManager.m_contactListener);
+		m_islandManager.SynchronizeContact(minContact);
 		minContact->m_flags &= ~b2Contact::e_toiFlag;
 		++minContact->m_toiCount;
 
@@ -813,6 +804,7 @@ void b2World::SolveTOI(const b2TimeStep& step)
 
 					// Update the contact points
 					contact->Update(m_contactManager.m_contactListener);
+					m_islandManager.SynchronizeContact(contact);
 
 					// Was the contact disabled by the user?
 					if (contact->IsEnabled() == false)
@@ -1028,6 +1020,212 @@ void b2World::RayCast(b2RayCastCallback* callback, const b2Vec2& point1, const b
 	m_contactManager.m_broadPhase.RayCast(&wrapper, input);
 }
 
+static b2SimplexCache* b2GetSimplexCache(b2ShapeQueryCache* cache, b2SimplexCache* coldCache,
+										 const b2Fixture* fixture, int32 childIndex,
+										 const b2DistanceProxy& proxyA, const b2DistanceProxy& proxyB)
+{
+	if (cache)
+	{
+		return cache->GetSimplexCache(fixture, childIndex, proxyA, proxyB);
+	}
+
+	coldCache->count = 0;
+	return coldCache;
+}
+
+struct b2WorldOverlapWrapper
+{
+	bool QueryCallback(int32 proxyId)
+	{
+		b2FixtureProxy* proxy = (b2FixtureProxy*)broadPhase->GetUserData(proxyId);
+		b2Fixture* fixture = proxy->fixture;
+		int32 index = proxy->childIndex;
+
+		b2DistanceInput input;
+		input.proxyA.Set(fixture->GetShape(), index);
+		input.proxyB = queryProxy;
+		input.transformA = fixture->GetBody()->GetTransform();
+		input.transformB = transform;
+		input.useRadii = true;
+
+		b2SimplexCache coldCache;
+		b2SimplexCache* simplexCache = b2GetSimplexCache(cache, &coldCache, fixture, index, input.proxyA, input.proxyB);
+
+		b2DistanceOutput output;
+		b2Distance(&output, simplexCache, &input);
+
+		if (output.distance < 10.0f * b2_epsilon)
+		{
+			return callback->ReportFixture(fixture);
+		}
+
+		return true;
+	}
+
+	const b2BroadPhase* broadPhase;
+	b2QueryCallback* callback;
+	b2ShapeQueryCache* cache;
+	b2DistanceProxy queryProxy;
+	b2Transform transform;
+};
+
+void b2World::OverlapShape(b2QueryCallback* callback, const b2Shape* shape, const b2Transform& transform,
+						   b2ShapeQueryCache* cache) const
+{
+	b2Assert(shape->GetChildCount() == 1);
+
+	b2WorldOverlapWrapper wrapper;
+	wrapper.broadPhase = &m_contactManager.m_broadPhase;
+	wrapper.callback = callback;
+	wrapper.cache = cache;
+	wrapper.queryProxy.Set(shape, 0);
+	wrapper.transform = transform;
+
+	b2AABB aabb;
+	shape->ComputeAABB(&aabb, transform, 0);
+	m_contactManager.m_broadPhase.Query(&wrapper, aabb);
+}
+
+struct b2WorldShapeCastWrapper
+{
+	bool QueryCallback(int32 proxyId)
+	{
+		b2FixtureProxy* proxy = (b2FixtureProxy*)broadPhase->GetUserData(proxyId);
+		b2Fixture* fixture = proxy->fixture;
+		int32 index = proxy->childIndex;
+
+		b2ShapeCastInput input;
+		input.proxyA.Set(fixture->GetShape(), index);
+		input.proxyB = queryProxy;
+		input.transformA = fixture->GetBody()->GetTransform();
+		input.transformB = transform;
+		input.translationB = maxFraction * translation;
+
+		// Run warm started GJK at the start of the sweep first. This cheaply rejects
+		// fixtures that are further away than the remaining cast and fixtures that
+		// already overlap the shape.
+		b2DistanceInput distanceInput;
+		distanceInput.proxyA = input.proxyA;
+		distanceInput.proxyB = input.proxyB;
+		distanceInput.transformA = input.transformA;
+		distanceInput.transformB = input.transformB;
+		distanceInput.useRadii = true;
+
+		b2SimplexCache coldCache;
+		b2SimplexCache* simplexCache = b2GetSimplexCache(cache, &coldCache, fixture, index, input.proxyA, input.proxyB);
+
+		b2DistanceOutput distanceOutput;
+		b2Distance(&distanceOutput, simplexCache, &distanceInput);
+
+		if (distanceOutput.distance < 10.0f * b2_epsilon ||
+			distanceOutput.distance > input.translationB.Length() + b2_linearSlop)
+		{
+			return true;
+		}
+
+		b2ShapeCastOutput output;
+		if (b2ShapeCast(&output, &input) == false)
+		{
+			return true;
+		}
+
+		float32 fraction = maxFraction * output.lambda;
+		float32 value = callback->ReportFixture(fixture, output.point, output.normal, fraction);
+
+		if (value == 0.0f)
+		{
+			// The client has terminated the cast.
+			return false;
+		}
+
+		if (0.0f < value && value < maxFraction)
+		{
+			// Update the cast length.
+			maxFraction = value;
+		}
+
+		return true;
+	}
+
+	const b2BroadPhase* broadPhase;
+	b2RayCastCallback* callback;
+	b2ShapeQueryCache* cache;
+	b2DistanceProxy queryProxy;
+	b2Transform transform;
+	b2Vec2 translation;
+	float32 maxFraction;
+};
+
+void b2World::ShapeCast(b2RayCastCallback* callback, const b2Shape* shape, const b2Transform& transform,
+						const b2Vec2& translation, b2ShapeQueryCache* cache) const
+{
+	b2Assert(shape->GetChildCount() == 1);
+
+	b2WorldShapeCastWrapper wrapper;
+	wrapper.broadPhase = &m_contactManager.m_broadPhase;
+	wrapper.callback = callback;
+	wrapper.cache = cache;
+	wrapper.queryProxy.Set(shape, 0);
+	wrapper.transform = transform;
+	wrapper.translation = translation;
+	wrapper.maxFraction = 1.0f;
+
+	// Query the AABB that covers the whole sweep.
+	b2Transform transform2 = transform;
+	transform2.p += translation;
+
+	b2AABB aabb1, aabb2, aabb;
+	shape->ComputeAABB(&aabb1, transform, 0);
+	shape->ComputeAABB(&aabb2, transform2, 0);
+	aabb.Combine(aabb1, aabb2);
+
+	m_contactManager.m_broadPhase.Query(&wrapper, aabb);
+}
+
+// Finds the closest solid hit for ShapeCastBatch.
+class b2ShapeCastClosestCallback : public b2RayCastCallback
+{
+public:
+	float32 ReportFixture(b2Fixture* fixture, const b2Vec2& point, const b2Vec2& normal, float32 fraction)
+	{
+		if (fixture->IsSensor() || (fixture->GetFilterData().categoryBits & m_maskBits) == 0)
+		{
+			return -1.0f;
+		}
+
+		m_hit->fixture = fixture;
+		m_hit->point = point;
+		m_hit->normal = normal;
+		m_hit->fraction = fraction;
+		return fraction;
+	}
+
+	b2ShapeCastHit* m_hit;
+	uint16 m_maskBits;
+};
+
+void b2World::ShapeCastBatch(b2ShapeCastHit* hits, const b2ShapeCastQuery* queries, int32 count,
+							 b2ShapeQueryCache* caches) const
+{
+	b2ShapeCastClosestCallback callback;
+
+	for (int32 i = 0; i < count; ++i)
+	{
+		const b2ShapeCastQuery* query = queries + i;
+		b2ShapeCastHit* hit = hits + i;
+		hit->fixture = nullptr;
+		hit->point.SetZero();
+		hit->normal.SetZero();
+		hit->fraction = 1.0f;
+
+		callback.m_hit = hit;
+		callback.m_maskBits = query->maskBits;
+
+		b2ShapeQueryCache* cache = caches ? caches + i : nullptr;
+		ShapeCast(&callback, query->shape, query->transform, query->translation, cache);
+	}
+}
+
 void b2World::DrawShape(b2Fixture* fixture, const b2Transform& xf, const b2Color& color)
 {
 	switch (fixture->GetType())
@@ -23,6 +23,7 @@
 #include "Box2D/Common/b2BlockAllocator.h"
 #include "Box2D/Common/b2StackAllocator.h"
 #include "Box2D/Dynamics/b2ContactManager.h"
+#include "Box2D/Dynamics/b2IslandManager.h"
 #include "Box2D/Dynamics/b2WorldCallbacks.h"
 #include "Box2D/Dynamics/b2TimeStep.h"
 
@@ -34,6 +35,10 @@ class b2Body;
 class b2Draw;
 class b2Fixture;
 class b2Joint;
+class b2Shape;
+class b2ShapeQueryCache;
+struct b2ShapeCastQuery;
+struct b2ShapeCastHit;
 
 /// The world class manages all physics entities, dynamic simulation,
 /// and asynchronous queries. The world also contains efficient memory
@@ -121,6 +126,35 @@ public:
 	/// @param point2 the ray ending point
 	void RayCast(b2RayCastCallback* callback, const b2Vec2& point1, const b2Vec2& point2) const;
 
+	/// Query the world for all fixtures that overlap the provided shape. Unlike
+	/// QueryAABB this tests the actual geometry using GJK.
+	/// @param callback a user implemented callback class.
+	/// @param shape the query shape. It must have a single child (circle, polygon or edge).
+	/// @param transform the world transform of the query shape.
+	/// @param cache optional warm start data for repeating this query every frame.
+	void OverlapShape(b2QueryCallback* callback, const b2Shape* shape, const b2Transform& transform,
+					  b2ShapeQueryCache* cache = nullptr) const;
+
+	/// Sweep a shape through the world and report all fixtures in its path. Your callback
+	/// controls the cast just like it does for RayCast. The reported fraction is the
+	/// fraction of the translation at the time of impact. Fixtures that initially
+	/// overlap the shape are not reported, use OverlapShape to find those.
+	/// @param callback a user implemented callback class.
+	/// @param shape the query shape. It must have a single child (circle, polygon or edge).
+	/// @param transform the initial world transform of the query shape.
+	/// @param translation the translation of the query shape.
+	/// @param cache optional warm start data for repeating this query every frame.
+	void ShapeCast(b2RayCastCallback* callback, const b2Shape* shape, const b2Transform& transform,
+				   const b2Vec2& translation, b2ShapeQueryCache* cache = nullptr) const;
+
+	/// Perform many shape casts and find the closest hit for each. Sensors are ignored.
+	/// @param hits receives one result per query.
+	/// @param queries the shape casts.
+	/// @param count the number of queries.
+	/// @param caches optional array with one warm start cache per query.
+	void ShapeCastBatch(b2ShapeCastHit* hits, const b2ShapeCastQuery* queries, int32 count,
+						b2ShapeQueryCache* caches = nullptr) const;
+
 	/// Get the world body list. With the returned body, use b2Body::GetNext to get
 	/// the next body in the world list. A nullptr body indicates the end of the list.
 	/// @return the head of the world body list.
@@ -236,6 +270,7 @@ private:
 	int32 m_flags;
 
 	b2ContactManager m_contactManager;
+	b2IslandManager m_islandManager;
 
 	b2Body* m_bodyList;
 	b2Joint* m_jointList;
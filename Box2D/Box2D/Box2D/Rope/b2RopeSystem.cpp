@@ -0,0 +1,617 @@
+/*
+* Copyright (c) 2026 the GravTank contributors
+*
+* Written for this project. It solves the same rope model as Erin Catto's
+* b2Rope, reorganised to step many ropes together, and is released under
+* the same zlib license as Box2D.
+*
+* This software is provided 'as-is', without any express or implied
+* warranty.  In no event will the authors be held liable for any damages
+* arising from the use of this software.
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+* 1. The origin of this software must not be misrepresented; you must not
+* claim that you wrote the original software. If you use this software
+* in a product, an acknowledgment in the product documentation would be
+* appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+* misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "Box2D/Rope/b2RopeSystem.h"
+#include "Box2D/Common/b2Draw.h"
+
+#include <string.h>
+
+#define b2_nullRope	(-1)
+
+// Up to this fraction of a batch may be padding vertices.
+#define b2_ropePaddingFraction	0.25f
+
+// A batch of ropes stored as structure of arrays. Element (i, lane) of a per
+// vertex or per constraint array lives at index i * b2_ropeLaneCount + lane,
+// so the inner solver loops read b2_ropeLaneCount consecutive floats.
+// Unused lanes and the padding at the end of short ropes have zero inverse
+// mass and zero stiffness, so the solver can run over them without branches.
+struct b2RopeBatch
+{
+	b2RopeBatch* prev;
+	b2RopeBatch* next;
+
+	int32 vertexCount;
+	int32 ropeCount;
+	int32 ropeIds[b2_ropeLaneCount];
+	int32 counts[b2_ropeLaneCount];
+
+	float32 gravityX[b2_ropeLaneCount];
+	float32 gravityY[b2_ropeLaneCount];
+	float32 damping[b2_ropeLaneCount];
+
+	// Per vertex
+	float32* px;
+	float32* py;
+	float32* p0x;
+	float32* p0y;
+	float32* vx;
+	float32* vy;
+	float32* ims;
+
+	// Per stretch constraint
+	float32* Ls;
+	float32* k2s;
+
+	// Per bend constraint
+	float32* as;
+	float32* k3s;
+
+	float32* buffer;
+};
+
+// Polynomial atan2 with a maximum error of about 1e-5 radians. Unlike atan2f
+// this contains no calls or data dependent branches, so it vectorizes.
+static inline float32 b2RopeAtan2(float32 y, float32 x)
+{
+	float32 ax = b2Abs(x);
+	float32 ay = b2Abs(y);
+	float32 mx = b2Max(ax, ay);
+	float32 mn = b2Min(ax, ay);
+	float32 a = mn / (mx + FLT_MIN);
+
+	float32 s = a * a;
+	float32 r = ((-0.0464964749f * s + 0.15931422f) * s - 0.327622764f) * s * a + a;
+
+	r = ay > ax ? 0.5f * b2_pi - r : r;
+	r = x < 0.0f ? b2_pi - r : r;
+	r = y < 0.0f ? -r : r;
+	return r;
+}
+
+static void b2SolveStretch(b2RopeBatch* batch)
+{
+	int32 count2 = batch->vertexCount - 1;
+
+	// Red-black ordering: even constraints share no vertices with each other
+	// and neither do odd constraints.
+	for (int32 color = 0; color < 2; ++color)
+	{
+		for (int32 i = color; i < count2; i += 2)
+		{
+			int32 i1 = i * b2_ropeLaneCount;
+			int32 i2 = i1 + b2_ropeLaneCount;
+
+			float32* px1 = batch->px + i1;
+			float32* py1 = batch->py + i1;
+			float32* px2 = batch->px + i2;
+			float32* py2 = batch->py + i2;
+			const float32* im1 = batch->ims + i1;
+			const float32* im2 = batch->ims + i2;
+			const float32* Ls = batch->Ls + i1;
+			const float32* k2s = batch->k2s + i1;
+
+			for (int32 lane = 0; lane < b2_ropeLaneCount; ++lane)
+			{
+				float32 dx = px2[lane] - px1[lane];
+				float32 dy = py2[lane] - py1[lane];
+
+				float32 L = b2Sqrt(dx * dx + dy * dy);
+				float32 invL = L > b2_epsilon ? 1.0f / L : 0.0f;
+
+				float32 imSum = im1[lane] + im2[lane];
+				float32 invImSum = imSum > 0.0f ? 1.0f / imSum : 0.0f;
+
+				float32 C = k2s[lane] * (Ls[lane] - L) * invL * invImSum;
+				float32 s1 = C * im1[lane];
+				float32 s2 = C * im2[lane];
+
+				px1[lane] -= s1 * dx;
+				py1[lane] -= s1 * dy;
+				px2[lane] += s2 * dx;
+				py2[lane] += s2 * dy;
+			}
+		}
+	}
+}
+
+static void b2SolveBend(b2RopeBatch* batch)
+{
+	int32 count3 = batch->vertexCount - 2;
+
+	// A bend constraint touches three consecutive vertices, so three colors
+	// are needed for the constraints within a color to be independent.
+	for (int32 color = 0; color < 3; ++color)
+	{
+		for (int32 i = color; i < count3; i += 3)
+		{
+			int32 i1 = i * b2_ropeLaneCount;
+			int32 i2 = i1 + b2_ropeLaneCount;
+			int32 i3 = i2 + b2_ropeLaneCount;
+
+			float32* px1 = batch->px + i1;
+			float32* py1 = batch->py + i1;
+			float32* px2 = batch->px + i2;
+			float32* py2 = batch->py + i2;
+			float32* px3 = batch->px + i3;
+			float32* py3 = batch->py + i3;
+			const float32* m1 = batch->ims + i1;
+			const float32* m2 = batch->ims + i2;
+			const float32* m3 = batch->ims + i3;
+			const float32* as = batch->as + i1;
+			const float32* k3s = batch->k3s + i1;
+
+			for (int32 lane = 0; lane < b2_ropeLaneCount; ++lane)
+			{
+				float32 d1x = px2[lane] - px1[lane];
+				float32 d1y = py2[lane] - py1[lane];
+				float32 d2x = px3[lane] - px2[lane];
+				float32 d2y = py3[lane] - py2[lane];
+
+				float32 L1sqr = d1x * d1x + d1y * d1y;
+				float32 L2sqr = d2x * d2x + d2y * d2y;
+
+				bool valid = L1sqr * L2sqr > 0.0f;
+				float32 invL1sqr = valid ? 1.0f / L1sqr : 0.0f;
+				float32 invL2sqr = valid ? 1.0f / L2sqr : 0.0f;
+
+				float32 a = d1x * d2y - d1y * d2x;
+				float32 b = d1x * d2x + d1y * d2y;
+
+				float32 angle = b2RopeAtan2(a, b);
+
+				// Jd1 = (-1 / L1sqr) * d1.Skew(), Jd2 = (1 / L2sqr) * d2.Skew()
+				float32 Jd1x = invL1sqr * d1y;
+				float32 Jd1y = -invL1sqr * d1x;
+				float32 Jd2x = -invL2sqr * d2y;
+				float32 Jd2y = invL2sqr * d2x;
+
+				float32 J1x = -Jd1x;
+				float32 J1y = -Jd1y;
+				float32 J2x = Jd1x - Jd2x;
+				float32 J2y = Jd1y - Jd2y;
+				float32 J3x = Jd2x;
+				float32 J3y = Jd2y;
+
+				float32 mass = m1[lane] * (J1x * J1x + J1y * J1y)
+							 + m2[lane] * (J2x * J2x + J2y * J2y)
+							 + m3[lane] * (J3x * J3x + J3y * J3y);
+				float32 invMass = mass > 0.0f ? 1.0f / mass : 0.0f;
+
+				float32 C = angle - as[lane];
+				C = C > b2_pi ? C - 2.0f * b2_pi : C;
+				C = C < -b2_pi ? C + 2.0f * b2_pi : C;
+
+				float32 impulse = -k3s[lane] * invMass * C;
+
+				float32 s1 = m1[lane] * impulse;
+				float32 s2 = m2[lane] * impulse;
+				float32 s3 = m3[lane] * impulse;
+
+				px1[lane] += s1 * J1x;
+				py1[lane] += s1 * J1y;
+				px2[lane] += s2 * J2x;
+				py2[lane] += s2 * J2y;
+				px3[lane] += s3 * J3x;
+				py3[lane] += s3 * J3y;
+			}
+		}
+	}
+}
+
+b2RopeSystem::b2RopeSystem()
+{
+	m_proxyCapacity = 16;
+	m_proxies = (b2RopeProxy*)b2Alloc(m_proxyCapacity * sizeof(b2RopeProxy));
+
+	// Build a linked list for the free list.
+	for (int32 i = 0; i < m_proxyCapacity - 1; ++i)
+	{
+		m_proxies[i].batch = nullptr;
+		m_proxies[i].next = i + 1;
+	}
+	m_proxies[m_proxyCapacity - 1].batch = nullptr;
+	m_proxies[m_proxyCapacity - 1].next = b2_nullRope;
+	m_freeProxy = 0;
+	m_ropeCount = 0;
+
+	m_batchList = nullptr;
+}
+
+b2RopeSystem::~b2RopeSystem()
+{
+	b2RopeBatch* batch = m_batchList;
+	while (batch)
+	{
+		b2RopeBatch* next = batch->next;
+		DestroyBatch(batch);
+		batch = next;
+	}
+
+	b2Free(m_proxies);
+}
+
+b2RopeBatch* b2RopeSystem::CreateBatch(int32 vertexCount)
+{
+	int32 count2 = vertexCount - 1;
+	int32 count3 = vertexCount - 2;
+	int32 floatCount = b2_ropeLaneCount * (7 * vertexCount + 2 * count2 + 2 * count3);
+
+	b2RopeBatch* batch = (b2RopeBatch*)b2Alloc(sizeof(b2RopeBatch));
+	batch->buffer = (float32*)b2Alloc(floatCount * sizeof(float32));
+	memset(batch->buffer, 0, floatCount * sizeof(float32));
+
+	float32* p = batch->buffer;
+	batch->px = p; p += b2_ropeLaneCount * vertexCount;
+	batch->py = p; p += b2_ropeLaneCount * vertexCount;
+	batch->p0x = p; p += b2_ropeLaneCount * vertexCount;
+	batch->p0y = p; p += b2_ropeLaneCount * vertexCount;
+	batch->vx = p; p += b2_ropeLaneCount * vertexCount;
+	batch->vy = p; p += b2_ropeLaneCount * vertexCount;
+	batch->ims = p; p += b2_ropeLaneCount * vertexCount;
+	batch->Ls = p; p += b2_ropeLaneCount * count2;
+	batch->k2s = p; p += b2_ropeLaneCount * count2;
+	batch->as = p; p += b2_ropeLaneCount * count3;
+	batch->k3s = p; p += b2_ropeLaneCount * count3;
+	b2Assert(p == batch->buffer + floatCount);
+
+	batch->vertexCount = vertexCount;
+	batch->ropeCount = 0;
+	for (int32 lane = 0; lane < b2_ropeLaneCount; ++lane)
+	{
+		batch->ropeIds[lane] = b2_nullRope;
+		batch->counts[lane] = 0;
+		batch->gravityX[lane] = 0.0f;
+		batch->gravityY[lane] = 0.0f;
+		batch->damping[lane] = 0.0f;
+	}
+
+	batch->prev = nullptr;
+	batch->next = m_batchList;
+	if (m_batchList)
+	{
+		m_batchList->prev = batch;
+	}
+	m_batchList = batch;
+
+	return batch;
+}
+
+void b2RopeSystem::DestroyBatch(b2RopeBatch* batch)
+{
+	if (batch->prev)
+	{
+		batch->prev->next = batch->next;
+	}
+
+	if (batch->next)
+	{
+		batch->next->prev = batch->prev;
+	}
+
+	if (batch == m_batchList)
+	{
+		m_batchList = batch->next;
+	}
+
+	b2Free(batch->buffer);
+	b2Free(batch);
+}
+
+int32 b2RopeSystem::CreateRope(const b2RopeDef* def)
+{
+	b2Assert(def->count >= 3);
+	int32 count = def->count;
+
+	// Find a batch with a free lane that is long enough without too much padding.
+	int32 maxVertexCount = count + int32(b2_ropePaddingFraction * count);
+	b2RopeBatch* batch = m_batchList;
+	while (batch)
+	{
+		if (batch->ropeCount < b2_ropeLaneCount && count <= batch->vertexCount && batch->vertexCount <= maxVertexCount)
+		{
+			break;
+		}
+
+		batch = batch->next;
+	}
+
+	if (batch == nullptr)
+	{
+		batch = CreateBatch(count);
+	}
+
+	int32 lane = 0;
+	while (batch->ropeIds[lane] != b2_nullRope)
+	{
+		++lane;
+	}
+
+	// Allocate a proxy, growing the pool if needed.
+	if (m_freeProxy == b2_nullRope)
+	{
+		b2RopeProxy* oldProxies = m_proxies;
+		m_proxyCapacity *= 2;
+		m_proxies = (b2RopeProxy*)b2Alloc(m_proxyCapacity * sizeof(b2RopeProxy));
+		memcpy(m_proxies, oldProxies, m_ropeCount * sizeof(b2RopeProxy));
+		b2Free(oldProxies);
+
+		for (int32 i = m_ropeCount; i < m_proxyCapacity - 1; ++i)
+		{
+			m_proxies[i].batch = nullptr;
+			m_proxies[i].next = i + 1;
+		}
+		m_proxies[m_proxyCapacity - 1].batch = nullptr;
+		m_proxies[m_proxyCapacity - 1].next = b2_nullRope;
+		m_freeProxy = m_ropeCount;
+	}
+
+	int32 ropeId = m_freeProxy;
+	b2RopeProxy* proxy = m_proxies + ropeId;
+	m_freeProxy = proxy->next;
+	proxy->batch = batch;
+	proxy->lane = lane;
+	proxy->count = count;
+	proxy->next = b2_nullRope;
+	++m_ropeCount;
+
+	batch->ropeIds[lane] = ropeId;
+	batch->counts[lane] = count;
+	batch->gravityX[lane] = def->gravity.x;
+	batch->gravityY[lane] = def->gravity.y;
+	batch->damping[lane] = def->damping;
+	++batch->ropeCount;
+
+	int32 vertexCount = batch->vertexCount;
+	for (int32 i = 0; i < vertexCount; ++i)
+	{
+		int32 index = i * b2_ropeLaneCount + lane;
+
+		// Padding vertices sit on the last vertex and have no mass.
+		b2Vec2 v = def->vertices[b2Min(i, count - 1)];
+		batch->px[index] = v.x;
+		batch->py[index] = v.y;
+		batch->p0x[index] = v.x;
+		batch->p0y[index] = v.y;
+		batch->vx[index] = 0.0f;
+		batch->vy[index] = 0.0f;
+
+		float32 m = i < count ? def->masses[i] : 0.0f;
+		batch->ims[index] = m > 0.0f ? 1.0f / m : 0.0f;
+	}
+
+	for (int32 i = 0; i < vertexCount - 1; ++i)
+	{
+		int32 index = i * b2_ropeLaneCount + lane;
+
+		if (i < count - 1)
+		{
+			batch->Ls[index] = b2Distance(def->vertices[i], def->vertices[i + 1]);
+			batch->k2s[index] = def->k2;
+		}
+		else
+		{
+			batch->Ls[index] = 0.0f;
+			batch->k2s[index] = 0.0f;
+		}
+	}
+
+	for (int32 i = 0; i < vertexCount - 2; ++i)
+	{
+		int32 index = i * b2_ropeLaneCount + lane;
+
+		if (i < count - 2)
+		{
+			b2Vec2 d1 = def->vertices[i + 1] - def->vertices[i];
+			b2Vec2 d2 = def->vertices[i + 2] - def->vertices[i + 1];
+
+			float32 a = b2Cross(d1, d2);
+			float32 b = b2Dot(d1, d2);
+
+			batch->as[index] = b2Atan2(a, b);
+			batch->k3s[index] = def->k3;
+		}
+		else
+		{
+			batch->as[index] = 0.0f;
+			batch->k3s[index] = 0.0f;
+		}
+	}
+
+	return ropeId;
+}
+
+void b2RopeSystem::DestroyRope(int32 ropeId)
+{
+	b2Assert(0 <= ropeId && ropeId < m_proxyCapacity);
+	b2RopeProxy* proxy = m_proxies + ropeId;
+	b2RopeBatch* batch = proxy->batch;
+	b2Assert(batch != nullptr);
+	int32 lane = proxy->lane;
+
+	--batch->ropeCount;
+	if (batch->ropeCount == 0)
+	{
+		DestroyBatch(batch);
+	}
+	else
+	{
+		// Turn the lane back into padding.
+		batch->ropeIds[lane] = b2_nullRope;
+		batch->counts[lane] = 0;
+
+		int32 vertexCount = batch->vertexCount;
+		for (int32 i = 0; i < vertexCount; ++i)
+		{
+			int32 index = i * b2_ropeLaneCount + lane;
+			batch->px[index] = 0.0f;
+			batch->py[index] = 0.0f;
+			batch->vx[index] = 0.0f;
+			batch->vy[index] = 0.0f;
+			batch->ims[index] = 0.0f;
+		}
+
+		for (int32 i = 0; i < vertexCount - 1; ++i)
+		{
+			batch->k2s[i * b2_ropeLaneCount + lane] = 0.0f;
+		}
+
+		for (int32 i = 0; i < vertexCount - 2; ++i)
+		{
+			batch->k3s[i * b2_ropeLaneCount + lane] = 0.0f;
+		}
+	}
+
+	proxy->batch = nullptr;
+	proxy->next = m_freeProxy;
+	m_freeProxy = ropeId;
+	--m_ropeCount;
+}
+
+int32 b2RopeSystem::GetVertexCount(int32 ropeId) const
+{
+	b2Assert(0 <= ropeId && ropeId < m_proxyCapacity);
+	b2Assert(m_proxies[ropeId].batch != nullptr);
+	return m_proxies[ropeId].count;
+}
+
+b2Vec2 b2RopeSystem::GetVertex(int32 ropeId, int32 index) const
+{
+	b2Assert(0 <= ropeId && ropeId < m_proxyCapacity);
+	const b2RopeProxy* proxy = m_proxies + ropeId;
+	b2Assert(proxy->batch != nullptr);
+	b2Assert(0 <= index && index < proxy->count);
+
+	int32 i = index * b2_ropeLaneCount + proxy->lane;
+	return b2Vec2(proxy->batch->px[i], proxy->batch->py[i]);
+}
+
+void b2RopeSystem::SetVertex(int32 ropeId, int32 index, const b2Vec2& position)
+{
+	b2Assert(0 <= ropeId && ropeId < m_proxyCapacity);
+	const b2RopeProxy* proxy = m_proxies + ropeId;
+	b2Assert(proxy->batch != nullptr);
+	b2Assert(0 <= index && index < proxy->count);
+
+	int32 i = index * b2_ropeLaneCount + proxy->lane;
+	proxy->batch->px[i] = position.x;
+	proxy->batch->py[i] = position.y;
+}
+
+void b2RopeSystem::SetAngle(int32 ropeId, float32 angle)
+{
+	b2Assert(0 <= ropeId && ropeId < m_proxyCapacity);
+	const b2RopeProxy* proxy = m_proxies + ropeId;
+	b2Assert(proxy->batch != nullptr);
+
+	int32 count3 = proxy->count - 2;
+	for (int32 i = 0; i < count3; ++i)
+	{
+		proxy->batch->as[i * b2_ropeLaneCount + proxy->lane] = angle;
+	}
+}
+
+void b2RopeSystem::Step(float32 h, int32 iterations)
+{
+	if (h == 0.0f)
+	{
+		return;
+	}
+
+	for (b2RopeBatch* batch = m_batchList; batch; batch = batch->next)
+	{
+		SolveBatch(batch, h, iterations);
+	}
+}
+
+void b2RopeSystem::SolveBatch(b2RopeBatch* batch, float32 h, int32 iterations)
+{
+	float32 d[b2_ropeLaneCount];
+	float32 gx[b2_ropeLaneCount];
+	float32 gy[b2_ropeLaneCount];
+	for (int32 lane = 0; lane < b2_ropeLaneCount; ++lane)
+	{
+		d[lane] = expf(-h * batch->damping[lane]);
+		gx[lane] = h * batch->gravityX[lane];
+		gy[lane] = h * batch->gravityY[lane];
+	}
+
+	int32 count = batch->vertexCount * b2_ropeLaneCount;
+
+	for (int32 i = 0; i < count; i += b2_ropeLaneCount)
+	{
+		float32* px = batch->px + i;
+		float32* py = batch->py + i;
+		float32* p0x = batch->p0x + i;
+		float32* p0y = batch->p0y + i;
+		float32* vx = batch->vx + i;
+		float32* vy = batch->vy + i;
+		const float32* ims = batch->ims + i;
+
+		for (int32 lane = 0; lane < b2_ropeLaneCount; ++lane)
+		{
+			p0x[lane] = px[lane];
+			p0y[lane] = py[lane];
+
+			float32 g = ims[lane] > 0.0f ? 1.0f : 0.0f;
+			vx[lane] = d[lane] * (vx[lane] + g * gx[lane]);
+			vy[lane] = d[lane] * (vy[lane] + g * gy[lane]);
+
+			px[lane] += h * vx[lane];
+			py[lane] += h * vy[lane];
+		}
+	}
+
+	for (int32 i = 0; i < iterations; ++i)
+	{
+		b2SolveStretch(batch);
+		b2SolveBend(batch);
+		b2SolveStretch(batch);
+	}
+
+	float32 inv_h = 1.0f / h;
+	for (int32 i = 0; i < count; ++i)
+	{
+		batch->vx[i] = inv_h * (batch->px[i] - batch->p0x[i]);
+		batch->vy[i] = inv_h * (batch->py[i] - batch->p0y[i]);
+	}
+}
+
+void b2RopeSystem::Draw(b2Draw* draw) const
+{
+	b2Color c(0.4f, 0.5f, 0.7f);
+
+	for (const b2RopeBatch* batch = m_batchList; batch; batch = batch->next)
+	{
+		for (int32 lane = 0; lane < b2_ropeLaneCount; ++lane)
+		{
+			for (int32 i = 0; i < batch->counts[lane] - 1; ++i)
+			{
+				int32 i1 = i * b2_ropeLaneCount + lane;
+				int32 i2 = i1 + b2_ropeLaneCount;
+				b2Vec2 p1(batch->px[i1], batch->py[i1]);
+				b2Vec2 p2(batch->px[i2], batch->py[i2]);
+				draw->DrawSegment(p1, p2, c);
+			}
+		}
+	}
+}
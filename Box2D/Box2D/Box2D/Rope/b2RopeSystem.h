@@ -0,0 +1,104 @@
+/*
+* Copyright (c) 2026 the GravTank contributors
+*
+* Written for this project. It solves the same rope model as Erin Catto's
+* b2Rope, reorganised to step many ropes together, and is released under
+* the same zlib license as Box2D.
+*
+* This software is provided 'as-is', without any express or implied
+* warranty.  In no event will the authors be held liable for any damages
+* arising from the use of this software.
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+* 1. The origin of this software must not be misrepresented; you must not
+* claim that you wrote the original software. If you use this software
+* in a product, an acknowledgment in the product documentation would be
+* appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+* misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef B2_ROPE_SYSTEM_H
+#define B2_ROPE_SYSTEM_H
+
+#include "Box2D/Rope/b2Rope.h"
+
+class b2Draw;
+
+/// The number of ropes solved side by side. The solver loops run over this
+/// many lanes so the compiler can map them onto 4-wide SIMD registers.
+#define b2_ropeLaneCount	4
+
+struct b2RopeBatch;
+
+/// A container that simulates many ropes together. It uses the same model as
+/// b2Rope but the ropes are packed into batches of b2_ropeLaneCount ropes that
+/// share structure-of-arrays buffers, and each constraint is solved across all
+/// ropes of a batch at once. Within a rope the constraints are solved in
+/// independent colors (red-black for stretching, three colors for bending) so
+/// the result does not depend on how the ropes are packed.
+/// Use this for large numbers of decorative cables. Ropes with similar vertex
+/// counts pack best.
+class b2RopeSystem
+{
+public:
+	b2RopeSystem();
+	~b2RopeSystem();
+
+	/// Add a rope to the system. The definition is copied.
+	/// @return a rope id that stays valid until the rope is destroyed.
+	int32 CreateRope(const b2RopeDef* def);
+
+	/// Remove a rope from the system.
+	void DestroyRope(int32 ropeId);
+
+	/// Simulate all ropes.
+	void Step(float32 timeStep, int32 iterations);
+
+	/// Get the number of ropes in the system.
+	int32 GetRopeCount() const
+	{
+		return m_ropeCount;
+	}
+
+	/// Get the number of vertices of a rope.
+	int32 GetVertexCount(int32 ropeId) const;
+
+	/// Get the current position of a rope vertex.
+	b2Vec2 GetVertex(int32 ropeId, int32 index) const;
+
+	/// Move a vertex. This is intended for vertices with zero mass, such
+	/// as the ends of a cable attached to a moving body.
+	void SetVertex(int32 ropeId, int32 index, const b2Vec2& position);
+
+	/// Set the target bending angle of a rope.
+	void SetAngle(int32 ropeId, float32 angle);
+
+	/// Draw all ropes.
+	void Draw(b2Draw* draw) const;
+
+private:
+
+	struct b2RopeProxy
+	{
+		b2RopeBatch* batch;
+		int32 lane;
+		int32 count;
+		int32 next;
+	};
+
+	b2RopeBatch* CreateBatch(int32 vertexCount);
+	void DestroyBatch(b2RopeBatch* batch);
+	void SolveBatch(b2RopeBatch* batch, float32 h, int32 iterations);
+
+	b2RopeProxy* m_proxies;
+	int32 m_proxyCapacity;
+	int32 m_freeProxy;
+	int32 m_ropeCount;
+
+	b2RopeBatch* m_batchList;
+};
+
+#endif
@@ -0,0 +1,124 @@
+/*
+* Copyright (c) 2026 the GravTank contributors
+*
+* Written for this project and released under the same zlib license as
+* Box2D.
+*
+* This software is provided 'as-is', without any express or implied
+* warranty.  In no event will the authors be held liable for any damages
+* arising from the use of this software.
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+* 1. The origin of this software must not be misrepresented; you must not
+* claim that you wrote the original software. If you use this software
+* in a product, an acknowledgment in the product documentation would be
+* appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+* misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "Box2D/Box2D.h"
+#include "Box2D/Rope/b2Rope.h"
+#include "Box2D/Rope/b2RopeSystem.h"
+
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+
+// Times stepping many ropes one b2Rope at a time against stepping the same
+// ropes in a b2RopeSystem. Each rope hangs from a pinned first vertex and
+// swings under gravity. The two solvers visit the constraints in a different
+// order, so their results are close but not identical; the largest distance
+// between matching vertices is printed as a check that both simulate the
+// same thing.
+
+static const int32 kRopeCount = 400;
+static const int32 kVertexCount = 40;
+static const int32 kStepCount = 600;
+static const int32 kIterations = 8;
+static const float32 kTimeStep = 1.0f / 60.0f;
+
+// b2Timer on Linux keeps microseconds unsigned, so it can wrap between seconds
+static float32 GetMilliseconds(const std::chrono::steady_clock::time_point& start)
+{
+	return std::chrono::duration<float32, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+static void MakeRopeDef(int32 ropeIndex, b2Vec2* vertices, float32* masses, b2RopeDef* def)
+{
+	// vary the starting angle so the ropes don't all move in step
+	float32 angle = 0.5f * ropeIndex / kRopeCount;
+	for (int32 i = 0; i < kVertexCount; ++i)
+	{
+		vertices[i].Set(0.25f * i * cosf(angle), -0.25f * i * sinf(angle));
+		masses[i] = i == 0 ? 0.0f : 1.0f;
+	}
+
+	def->vertices = vertices;
+	def->count = kVertexCount;
+	def->masses = masses;
+	def->gravity.Set(0.0f, -10.0f);
+	def->damping = 0.1f;
+	def->k2 = 1.0f;
+	def->k3 = 0.5f;
+}
+
+int main(int argc, char** argv)
+{
+	B2_NOT_USED(argc);
+	B2_NOT_USED(argv);
+
+	b2Vec2 vertices[kVertexCount];
+	float32 masses[kVertexCount];
+
+	b2Rope* ropes = new b2Rope[kRopeCount];
+	b2RopeSystem system;
+	for (int32 i = 0; i < kRopeCount; ++i)
+	{
+		b2RopeDef def;
+		MakeRopeDef(i, vertices, masses, &def);
+		ropes[i].Initialize(&def);
+		system.CreateRope(&def);
+	}
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (int32 step = 0; step < kStepCount; ++step)
+	{
+		for (int32 i = 0; i < kRopeCount; ++i)
+		{
+			ropes[i].Step(kTimeStep, kIterations);
+		}
+	}
+	float32 ropeTime = GetMilliseconds(start);
+
+	start = std::chrono::steady_clock::now();
+	for (int32 step = 0; step < kStepCount; ++step)
+	{
+		system.Step(kTimeStep, kIterations);
+	}
+	float32 systemTime = GetMilliseconds(start);
+
+	float32 maxDistance = 0.0f;
+	bool finite = true;
+	for (int32 i = 0; i < kRopeCount; ++i)
+	{
+		const b2Vec2* ropeVertices = ropes[i].GetVertices();
+		for (int32 j = 0; j < kVertexCount; ++j)
+		{
+			b2Vec2 v = system.GetVertex(i, j);
+			finite = finite && v.IsValid();
+			maxDistance = b2Max(maxDistance, b2Distance(v, ropeVertices[j]));
+		}
+	}
+
+	printf("%d ropes of %d vertices, %d steps of %d iterations\n", kRopeCount, kVertexCount, kStepCount, kIterations);
+	printf("b2Rope       %8.3f ms per step\n", ropeTime / kStepCount);
+	printf("b2RopeSystem %8.3f ms per step (%.2fx)\n", systemTime / kStepCount, ropeTime / systemTime);
+	printf("largest vertex distance between the two: %.4f\n", maxDistance);
+
+	delete [] ropes;
+
+	return finite ? 0 : 1;
+}
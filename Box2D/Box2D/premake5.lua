@@ -122,6 +122,13 @@ project "HelloWorld"
 	includedirs { "." }
 	links { "Box2D" }
 
+project "RopeBenchmark"
+	kind "ConsoleApp"
+	language "C++"
+	files { "RopeBenchmark/RopeBenchmark.cpp" }
+	includedirs { "." }
+	links { "Box2D" }
+
 project "Testbed"
 	kind "ConsoleApp"
 	language "C++"
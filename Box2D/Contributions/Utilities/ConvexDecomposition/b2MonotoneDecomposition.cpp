@@ -0,0 +1,610 @@
+/*
+ * Copyright (c) 2026 the GravTank contributors
+ *
+ * Written for this project alongside the ConvexDecomposition contribution.
+ * It shares no code with Eric Jordan's b2Polygon/b2Triangle and is
+ * released under the same zlib license as Box2D.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include "b2MonotoneDecomposition.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <map>
+#include <set>
+
+namespace {
+
+enum VertexType {
+	START_VERTEX,
+	END_VERTEX,
+	SPLIT_VERTEX,
+	MERGE_VERTEX,
+	REGULAR_VERTEX
+};
+
+	/*
+	 * True if p comes before q in the sweep. Ties in y are broken by x, which
+	 * is the same as rotating the plane by a tiny angle, so no two vertices
+	 * are ever at the same height.
+	 */
+bool Above(const b2Vec2& p, const b2Vec2& q) {
+	return p.y > q.y || (p.y == q.y && p.x < q.x);
+}
+
+struct SweepState {
+	const b2Vec2* v;
+	int32 n;
+	float32 sweepY;
+	float32 queryX;
+};
+
+	/*
+	 * x coordinate where edge e (from v[e] to v[e+1]) crosses the sweep line.
+	 * Edge -1 is the query point used for lookups.
+	 */
+float32 EdgeX(const SweepState* s, int32 e) {
+	if (e < 0) return s->queryX;
+	const b2Vec2& a = s->v[e];
+	const b2Vec2& b = s->v[(e + 1) % s->n];
+	if (a.y == b.y) return b2Min(a.x, b.x);
+	float32 t = (s->sweepY - a.y) / (b.y - a.y);
+	return a.x + t * (b.x - a.x);
+}
+
+	/*
+	 * Orders the edges cut by the sweep line from left to right. Edges that
+	 * share their upper vertex are ordered by where they go below it.
+	 */
+struct EdgeOrder {
+	const SweepState* s;
+
+	explicit EdgeOrder(const SweepState* state) : s(state) {}
+
+	bool operator()(int32 e1, int32 e2) const {
+		float32 x1 = EdgeX(s, e1);
+		float32 x2 = EdgeX(s, e2);
+		if (x1 != x2) return x1 < x2;
+		if (e1 < 0 || e2 < 0) return false;
+
+		const b2Vec2& a1 = s->v[e1];
+		const b2Vec2& b1 = s->v[(e1 + 1) % s->n];
+		const b2Vec2& a2 = s->v[e2];
+		const b2Vec2& b2 = s->v[(e2 + 1) % s->n];
+		if (a1.y != b1.y && a2.y != b2.y) {
+			float32 slope1 = (b1.x - a1.x) / (b1.y - a1.y);
+			float32 slope2 = (b2.x - a2.x) / (b2.y - a2.y);
+			if (slope1 != slope2) return slope1 > slope2;
+		}
+		return e1 < e2;
+	}
+};
+
+typedef std::set<int32, EdgeOrder> SweepStatus;
+
+VertexType ClassifyVertex(const std::vector<b2Vec2>& v, int32 i) {
+	int32 n = (int32)v.size();
+	const b2Vec2& prev = v[(i + n - 1) % n];
+	const b2Vec2& curr = v[i];
+	const b2Vec2& next = v[(i + 1) % n];
+
+	bool prevBelow = Above(curr, prev);
+	bool nextBelow = Above(curr, next);
+	bool convex = b2Cross(curr - prev, next - curr) > 0.0f;
+
+	if (prevBelow && nextBelow) return convex ? START_VERTEX : SPLIT_VERTEX;
+	if (!prevBelow && !nextBelow) return convex ? END_VERTEX : MERGE_VERTEX;
+	return REGULAR_VERTEX;
+}
+
+	/*
+	 * Plane sweep that finds the diagonals splitting a CCW polygon into
+	 * y-monotone pieces. See de Berg et al., Computational Geometry, ch. 3.
+	 */
+void MonotoneDiagonals(const std::vector<b2Vec2>& v, std::vector<std::pair<int32, int32> >& diagonals) {
+	int32 n = (int32)v.size();
+
+	std::vector<int32> order(n);
+	for (int32 i = 0; i < n; ++i) order[i] = i;
+	std::sort(order.begin(), order.end(), [&v](int32 a, int32 b) { return Above(v[a], v[b]); });
+
+	std::vector<VertexType> types(n);
+	for (int32 i = 0; i < n; ++i) types[i] = ClassifyVertex(v, i);
+
+	SweepState state;
+	state.v = &v[0];
+	state.n = n;
+	state.sweepY = 0.0f;
+	state.queryX = 0.0f;
+
+	SweepStatus status((EdgeOrder(&state)));
+	std::vector<SweepStatus::iterator> edgeIt(n, status.end());
+	std::vector<int32> helper(n, -1);
+
+	// The edge directly left of vertex i.
+	auto leftEdge = [&](int32 i) -> int32 {
+		state.queryX = v[i].x;
+		SweepStatus::iterator it = status.upper_bound(-1);
+		b2Assert(it != status.begin());
+		--it;
+		return *it;
+	};
+
+	auto insertEdge = [&](int32 e, int32 h) {
+		edgeIt[e] = status.insert(e).first;
+		helper[e] = h;
+	};
+
+	auto removeEdge = [&](int32 e, int32 i) {
+		if (helper[e] >= 0 && types[helper[e]] == MERGE_VERTEX) diagonals.push_back(std::make_pair(i, helper[e]));
+		status.erase(edgeIt[e]);
+		edgeIt[e] = status.end();
+	};
+
+	for (int32 k = 0; k < n; ++k) {
+		int32 i = order[k];
+		int32 prevEdge = (i + n - 1) % n;
+		state.sweepY = v[i].y;
+
+		switch (types[i]) {
+			case START_VERTEX:
+				insertEdge(i, i);
+				break;
+
+			case END_VERTEX:
+				removeEdge(prevEdge, i);
+				break;
+
+			case SPLIT_VERTEX: {
+				int32 e = leftEdge(i);
+				diagonals.push_back(std::make_pair(i, helper[e]));
+				helper[e] = i;
+				insertEdge(i, i);
+				break;
+			}
+
+			case MERGE_VERTEX: {
+				removeEdge(prevEdge, i);
+				int32 e = leftEdge(i);
+				if (types[helper[e]] == MERGE_VERTEX) diagonals.push_back(std::make_pair(i, helper[e]));
+				helper[e] = i;
+				break;
+			}
+
+			case REGULAR_VERTEX:
+				if (Above(v[(i + n - 1) % n], v[i])) {
+					// Left chain, the interior is to the right.
+					removeEdge(prevEdge, i);
+					insertEdge(i, i);
+				} else {
+					int32 e = leftEdge(i);
+					if (types[helper[e]] == MERGE_VERTEX) diagonals.push_back(std::make_pair(i, helper[e]));
+					helper[e] = i;
+				}
+				break;
+		}
+	}
+}
+
+	/*
+	 * Walks the faces of the polygon split by the diagonals. Each face is
+	 * returned as a CCW list of vertex indices.
+	 */
+void TraceFaces(const std::vector<b2Vec2>& v, std::vector<std::pair<int32, int32> >& diagonals,
+				std::vector<std::vector<int32> >& faces) {
+	int32 n = (int32)v.size();
+
+	// Drop repeated diagonals and any that coincide with a boundary edge.
+	for (size_t i = 0; i < diagonals.size(); ++i) {
+		int32 a = diagonals[i].first;
+		int32 b = diagonals[i].second;
+		diagonals[i] = std::make_pair(b2Min(a, b), b2Max(a, b));
+	}
+	std::sort(diagonals.begin(), diagonals.end());
+	diagonals.erase(std::unique(diagonals.begin(), diagonals.end()), diagonals.end());
+	diagonals.erase(std::remove_if(diagonals.begin(), diagonals.end(), [n](const std::pair<int32, int32>& d) {
+		return d.first == d.second || d.second - d.first == 1 || d.second - d.first == n - 1;
+	}), diagonals.end());
+
+	std::vector<std::vector<int32> > adjacent(n);
+	for (int32 i = 0; i < n; ++i) {
+		adjacent[i].push_back((i + 1) % n);
+		adjacent[i].push_back((i + n - 1) % n);
+	}
+	for (size_t i = 0; i < diagonals.size(); ++i) {
+		int32 a = diagonals[i].first;
+		int32 b = diagonals[i].second;
+		adjacent[a].push_back(b);
+		adjacent[b].push_back(a);
+	}
+
+	// Sort the neighbors of each vertex counterclockwise by angle.
+	std::vector<std::vector<float32> > angles(n);
+	std::vector<std::vector<bool> > used(n);
+	for (int32 i = 0; i < n; ++i) {
+		std::vector<int32>& adj = adjacent[i];
+		std::vector<std::pair<float32, int32> > sorted(adj.size());
+		for (size_t j = 0; j < adj.size(); ++j) {
+			b2Vec2 d = v[adj[j]] - v[i];
+			sorted[j] = std::make_pair(atan2f(d.y, d.x), adj[j]);
+		}
+		std::sort(sorted.begin(), sorted.end());
+
+		angles[i].resize(adj.size());
+		used[i].resize(adj.size());
+		for (size_t j = 0; j < adj.size(); ++j) {
+			angles[i][j] = sorted[j].first;
+			adj[j] = sorted[j].second;
+			// Boundary edges against the winding face the outside.
+			used[i][j] = adj[j] == (i + n - 1) % n;
+		}
+	}
+
+	for (int32 i = 0; i < n; ++i) {
+		for (size_t j = 0; j < adjacent[i].size(); ++j) {
+			if (used[i][j]) continue;
+
+			std::vector<int32> face;
+			int32 curr = i;
+			int32 slot = (int32)j;
+			while (!used[curr][slot]) {
+				used[curr][slot] = true;
+				face.push_back(curr);
+
+				// The next edge of the face on our left is the first one
+				// clockwise from the edge we arrived on.
+				int32 next = adjacent[curr][slot];
+				b2Vec2 d = v[curr] - v[next];
+				float32 angle = atan2f(d.y, d.x);
+				const std::vector<float32>& a = angles[next];
+				int32 back = (int32)(std::lower_bound(a.begin(), a.end(), angle) - a.begin());
+				b2Assert(adjacent[next][back] == curr);
+				int32 degree = (int32)a.size();
+				slot = (back + degree - 1) % degree;
+				curr = next;
+			}
+
+			faces.push_back(face);
+		}
+	}
+}
+
+void AddTriangle(const std::vector<b2Vec2>& v, int32 a, int32 b, int32 c, std::vector<std::vector<int32> >& triangles) {
+	float32 area = b2Cross(v[b] - v[a], v[c] - v[a]);
+	if (area == 0.0f) return;
+
+	std::vector<int32> t(3);
+	t[0] = a;
+	t[1] = area > 0.0f ? b : c;
+	t[2] = area > 0.0f ? c : b;
+	triangles.push_back(t);
+}
+
+	/*
+	 * Linear time triangulation of a y-monotone CCW polygon.
+	 */
+void TriangulateMonotone(const std::vector<b2Vec2>& v, const std::vector<int32>& face,
+						 std::vector<std::vector<int32> >& triangles) {
+	int32 m = (int32)face.size();
+	if (m == 3) {
+		AddTriangle(v, face[0], face[1], face[2], triangles);
+		return;
+	}
+
+	int32 top = 0;
+	int32 bottom = 0;
+	for (int32 i = 1; i < m; ++i) {
+		if (Above(v[face[i]], v[face[top]])) top = i;
+		if (Above(v[face[bottom]], v[face[i]])) bottom = i;
+	}
+
+	// Merge the two chains into sweep order. Going CCW from the top walks
+	// down the left chain, going CW walks down the right chain.
+	std::vector<int32> sorted;
+	std::vector<int32> chain;
+	sorted.reserve(m);
+	chain.reserve(m);
+	sorted.push_back(face[top]);
+	chain.push_back(0);
+	int32 l = (top + 1) % m;
+	int32 r = (top + m - 1) % m;
+	while (l != bottom || r != bottom) {
+		if (r == bottom || (l != bottom && Above(v[face[l]], v[face[r]]))) {
+			sorted.push_back(face[l]);
+			chain.push_back(1);
+			l = (l + 1) % m;
+		} else {
+			sorted.push_back(face[r]);
+			chain.push_back(2);
+			r = (r + m - 1) % m;
+		}
+	}
+	sorted.push_back(face[bottom]);
+	chain.push_back(0);
+
+	std::vector<int32> stack;
+	stack.push_back(0);
+	stack.push_back(1);
+
+	for (int32 j = 2; j < m - 1; ++j) {
+		int32 uj = sorted[j];
+		if (chain[j] != chain[stack.back()]) {
+			while (stack.size() > 1) {
+				int32 a = stack.back();
+				stack.pop_back();
+				AddTriangle(v, uj, sorted[a], sorted[stack.back()], triangles);
+			}
+			stack.clear();
+			stack.push_back(j - 1);
+			stack.push_back(j);
+		} else {
+			int32 last = stack.back();
+			stack.pop_back();
+			while (!stack.empty()) {
+				const b2Vec2& pTop = v[sorted[stack.back()]];
+				const b2Vec2& pLast = v[sorted[last]];
+				const b2Vec2& pj = v[uj];
+				float32 turn = chain[j] == 1 ? b2Cross(pLast - pTop, pj - pLast) : b2Cross(pLast - pj, pTop - pLast);
+				if (turn <= 0.0f) break;
+
+				AddTriangle(v, uj, sorted[last], sorted[stack.back()], triangles);
+				last = stack.back();
+				stack.pop_back();
+			}
+			stack.push_back(last);
+			stack.push_back(j);
+		}
+	}
+
+	int32 ub = sorted[m - 1];
+	while (stack.size() > 1) {
+		int32 a = stack.back();
+		stack.pop_back();
+		AddTriangle(v, ub, sorted[a], sorted[stack.back()], triangles);
+	}
+}
+
+struct InternalEdge {
+	int32 a, b;
+	int32 pieceA, pieceB;
+	float32 lengthSqr;
+};
+
+int32 FindRoot(std::vector<int32>& parent, int32 i) {
+	while (parent[i] != i) {
+		parent[i] = parent[parent[i]];
+		i = parent[i];
+	}
+	return i;
+}
+
+	/*
+	 * Hertel-Mehlhorn: remove each diagonal whose removal keeps both
+	 * neighboring pieces convex and within b2_maxPolygonVertices. Long
+	 * diagonals are tried first, which avoids thin slivers.
+	 */
+void MergePieces(const std::vector<b2Vec2>& v, std::vector<std::vector<int32> >& pieces) {
+	std::vector<InternalEdge> edges;
+	std::map<std::pair<int32, int32>, int32> owner;
+	for (size_t p = 0; p < pieces.size(); ++p) {
+		for (int32 i = 0; i < 3; ++i) {
+			int32 a = pieces[p][i];
+			int32 b = pieces[p][(i + 1) % 3];
+			std::pair<int32, int32> key(b2Min(a, b), b2Max(a, b));
+			std::map<std::pair<int32, int32>, int32>::iterator it = owner.find(key);
+			if (it == owner.end()) {
+				owner[key] = (int32)p;
+			} else {
+				InternalEdge e;
+				e.a = key.first;
+				e.b = key.second;
+				e.pieceA = it->second;
+				e.pieceB = (int32)p;
+				e.lengthSqr = b2DistanceSquared(v[e.a], v[e.b]);
+				edges.push_back(e);
+			}
+		}
+	}
+
+	std::sort(edges.begin(), edges.end(), [](const InternalEdge& e1, const InternalEdge& e2) {
+		return e1.lengthSqr > e2.lengthSqr;
+	});
+
+	std::vector<int32> parent(pieces.size());
+	for (size_t i = 0; i < parent.size(); ++i) parent[i] = (int32)i;
+
+	for (size_t k = 0; k < edges.size(); ++k) {
+		int32 pi = FindRoot(parent, edges[k].pieceA);
+		int32 qi = FindRoot(parent, edges[k].pieceB);
+		if (pi == qi) continue;
+
+		std::vector<int32>& P = pieces[pi];
+		std::vector<int32>& Q = pieces[qi];
+		int32 np = (int32)P.size();
+		int32 nq = (int32)Q.size();
+		if (np + nq - 2 > b2_maxPolygonVertices) continue;
+
+		// P runs s -> t along the diagonal, Q runs t -> s.
+		int32 ip = -1;
+		for (int32 i = 0; i < np; ++i) {
+			int32 a = P[i], b = P[(i + 1) % np];
+			if ((a == edges[k].a && b == edges[k].b) || (a == edges[k].b && b == edges[k].a)) {
+				ip = i;
+				break;
+			}
+		}
+		b2Assert(ip >= 0);
+		int32 s = P[ip];
+		int32 t = P[(ip + 1) % np];
+
+		int32 iq = (int32)(std::find(Q.begin(), Q.end(), t) - Q.begin());
+		b2Assert(Q[(iq + 1) % nq] == s);
+
+		const b2Vec2& vs = v[s];
+		const b2Vec2& vt = v[t];
+		const b2Vec2& prevS = v[P[(ip + np - 1) % np]];
+		const b2Vec2& nextT = v[P[(ip + 2) % np]];
+		const b2Vec2& nextS = v[Q[(iq + 2) % nq]];
+		const b2Vec2& prevT = v[Q[(iq + nq - 1) % nq]];
+
+		if (b2Cross(vs - prevS, nextS - vs) < 0.0f) continue;
+		if (b2Cross(vt - prevT, nextT - vt) < 0.0f) continue;
+
+		std::vector<int32> merged;
+		merged.reserve(np + nq - 2);
+		for (int32 i = 0; i < np; ++i) merged.push_back(P[(ip + 1 + i) % np]);
+		for (int32 i = 2; i < nq; ++i) merged.push_back(Q[(iq + i) % nq]);
+
+		P.swap(merged);
+		Q.clear();
+		parent[qi] = pi;
+	}
+}
+
+	/*
+	 * b2PolygonShape::Set asserts on pieces that weld down to fewer than
+	 * three points or have no area, so apply the same tests first.
+	 */
+bool IsUsableShape(const b2Vec2* vertices, int32 count) {
+	b2Vec2 ps[b2_maxPolygonVertices];
+	int32 unique = 0;
+	for (int32 i = 0; i < count; ++i) {
+		bool weld = false;
+		for (int32 j = 0; j < unique; ++j) {
+			if (b2DistanceSquared(vertices[i], ps[j]) < (0.5f * b2_linearSlop) * (0.5f * b2_linearSlop)) {
+				weld = true;
+				break;
+			}
+		}
+		if (!weld) ps[unique++] = vertices[i];
+	}
+	if (unique < 3) return false;
+
+	float32 area = 0.0f;
+	for (int32 i = 1; i < unique - 1; ++i) {
+		area += 0.5f * b2Cross(ps[i] - ps[0], ps[i + 1] - ps[0]);
+	}
+	return area > b2_epsilon;
+}
+
+}
+
+int32 DecomposeConvexMonotone(const b2Vec2* vertices, int32 count, b2PolygonShape* results, int32 maxShapes) {
+	std::vector<b2Vec2> v;
+	v.reserve(count);
+	for (int32 i = 0; i < count; ++i) {
+		if (v.empty() || !(v.back() == vertices[i])) v.push_back(vertices[i]);
+	}
+	while (v.size() > 1 && v.back() == v.front()) v.pop_back();
+	if (v.size() < 3) return -1;
+
+	float32 area = 0.0f;
+	for (size_t i = 0; i < v.size(); ++i) {
+		area += b2Cross(v[i], v[(i + 1) % v.size()]);
+	}
+	if (area == 0.0f) return -1;
+	if (area < 0.0f) std::reverse(v.begin(), v.end());
+
+	std::vector<std::pair<int32, int32> > diagonals;
+	MonotoneDiagonals(v, diagonals);
+
+	std::vector<std::vector<int32> > faces;
+	TraceFaces(v, diagonals, faces);
+
+	std::vector<std::vector<int32> > pieces;
+	pieces.reserve(v.size());
+	for (size_t i = 0; i < faces.size(); ++i) {
+		TriangulateMonotone(v, faces[i], pieces);
+	}
+
+	MergePieces(v, pieces);
+
+	int32 nShapes = 0;
+	for (size_t i = 0; i < pieces.size(); ++i) {
+		int32 n = (int32)pieces[i].size();
+		if (n < 3) continue;
+
+		b2Vec2 ps[b2_maxPolygonVertices];
+		for (int32 j = 0; j < n; ++j) ps[j] = v[pieces[i][j]];
+		if (!IsUsableShape(ps, n)) continue;
+
+		if (nShapes < maxShapes) results[nShapes].Set(ps, n);
+		++nShapes;
+	}
+	return nShapes;
+}
+
+b2DecompositionCache::b2DecompositionCache() {
+	hitCount = 0;
+	missCount = 0;
+}
+
+uint32 b2DecompositionCache::Hash(const b2Vec2* vertices, int32 count) {
+	// FNV-1a
+	uint32 hash = 2166136261u;
+	const uint8* bytes = (const uint8*)vertices;
+	int32 size = count * (int32)sizeof(b2Vec2);
+	for (int32 i = 0; i < size; ++i) {
+		hash ^= bytes[i];
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+const b2PolygonShape* b2DecompositionCache::Decompose(const b2Vec2* vertices, int32 count, int32* shapeCount) {
+	uint32 hash = Hash(vertices, count);
+
+	typedef std::unordered_multimap<uint32, Entry>::iterator Iterator;
+	std::pair<Iterator, Iterator> range = entries.equal_range(hash);
+	for (Iterator it = range.first; it != range.second; ++it) {
+		const Entry& entry = it->second;
+		if ((int32)entry.outline.size() == count && memcmp(&entry.outline[0], vertices, count * sizeof(b2Vec2)) == 0) {
+			++hitCount;
+			*shapeCount = (int32)entry.shapes.size();
+			return entry.shapes.empty() ? NULL : &entry.shapes[0];
+		}
+	}
+
+	++missCount;
+
+	Entry entry;
+	entry.outline.assign(vertices, vertices + count);
+	entry.shapes.resize(b2Max(count, 1));
+	int32 n = DecomposeConvexMonotone(vertices, count, &entry.shapes[0], count);
+	entry.shapes.resize(b2Max(n, 0));
+
+	Iterator it = entries.insert(std::make_pair(hash, entry));
+	*shapeCount = (int32)it->second.shapes.size();
+	return it->second.shapes.empty() ? NULL : &it->second.shapes[0];
+}
+
+void b2DecompositionCache::DecomposeAndAddTo(const b2Vec2* vertices, int32 count, b2Body* body, const b2FixtureDef* prototype) {
+	int32 nShapes = 0;
+	const b2PolygonShape* shapes = Decompose(vertices, count, &nShapes);
+	for (int32 i = 0; i < nShapes; ++i) {
+		b2FixtureDef def = *prototype;
+		def.shape = &shapes[i];
+		body->CreateFixture(&def);
+	}
+}
+
+void b2DecompositionCache::Clear() {
+	entries.clear();
+	hitCount = 0;
+	missCount = 0;
+}
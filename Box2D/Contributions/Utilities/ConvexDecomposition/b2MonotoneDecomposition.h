@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2026 the GravTank contributors
+ *
+ * Written for this project alongside the ConvexDecomposition contribution.
+ * It shares no code with Eric Jordan's b2Polygon/b2Triangle and is
+ * released under the same zlib license as Box2D.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef B2_MONOTONE_DECOMPOSITION_H
+#define B2_MONOTONE_DECOMPOSITION_H
+
+#include "Box2D/Box2D.h"
+
+#include <unordered_map>
+#include <vector>
+
+	/**
+	 * Decomposes a simple polygon into convex b2PolygonShapes in O(n log n)
+	 * time. The polygon is split into y-monotone pieces with a plane sweep,
+	 * each piece is triangulated in linear time and the triangles are merged
+	 * back together with Hertel-Mehlhorn, which removes every diagonal that
+	 * is not needed for convexity. The result has at most four times as many
+	 * pieces as the optimal decomposition.
+	 *
+	 * This is much faster than DecomposeConvex on large concave outlines, but
+	 * unlike DecomposeConvex it does not try to repair self-intersecting input.
+	 * The vertices may be in either winding order.
+	 *
+	 * Each result has no more than b2_maxPolygonVertices vertices. Pieces too
+	 * small for b2PolygonShape are dropped. Up to maxShapes shapes are written
+	 * to results, but the total number is returned, so the return value can be
+	 * greater than maxShapes. Returns -1 if the polygon has fewer than three
+	 * vertices or no area.
+	 */
+int32 DecomposeConvexMonotone(const b2Vec2* vertices, int32 count, b2PolygonShape* results, int32 maxShapes);
+
+	/**
+	 * Caches convex decompositions by the content of the outline, so loading
+	 * the same level geometry again skips the decomposition entirely. Outlines
+	 * are keyed by a hash of their vertices and compared exactly on lookup.
+	 */
+class b2DecompositionCache {
+
+public:
+	b2DecompositionCache();
+
+	/**
+	 * Returns the decomposition of the outline, computing it with
+	 * DecomposeConvexMonotone on a miss. shapeCount receives the number of
+	 * shapes. The shapes stay valid until the cache is cleared.
+	 */
+	const b2PolygonShape* Decompose(const b2Vec2* vertices, int32 count, int32* shapeCount);
+
+	/**
+	 * Decomposes the outline and adds a fixture for every piece to the body.
+	 * All fields of the prototype are used except the shape.
+	 */
+	void DecomposeAndAddTo(const b2Vec2* vertices, int32 count, b2Body* body, const b2FixtureDef* prototype);
+
+	void Clear();
+
+	int32 GetHitCount() const { return hitCount; }
+	int32 GetMissCount() const { return missCount; }
+
+private:
+	struct Entry {
+		std::vector<b2Vec2> outline;
+		std::vector<b2PolygonShape> shapes;
+	};
+
+	static uint32 Hash(const b2Vec2* vertices, int32 count);
+
+	std::unordered_multimap<uint32, Entry> entries;
+	int32 hitCount;
+	int32 missCount;
+};
+
+#endif
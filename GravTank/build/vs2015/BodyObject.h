@@ -1,7 +1,7 @@
 #pragma once
 
 #include "game_object.h"
-#include <box2d/Box2D.h>
+#include <Box2D/Box2D.h>
 #include "primitive_builder.h"
 
 class BodyObject : public GameObject
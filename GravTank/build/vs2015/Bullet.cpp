@@ -8,7 +8,7 @@ Bullet::Bullet(b2Vec2 pos, b2World* world, PrimitiveBuilder* builder) :
 {
 	SetBulletType(NOBULLET);
 	// setup the mesh
-	set_mesh(m_builder->CreateSphereMesh(0.2f, 10, 10));
+	set_mesh(m_builder->GetSphereMesh(0.2f, 10, 10));
 
 	// create a physics body
 	b2BodyDef body_def;
@@ -94,7 +94,7 @@ Bullet::~Bullet()
 {
 	m_world->DestroyBody(m_body);
 	m_body = NULL;
-	delete mesh_;
+	m_builder->ReleaseMesh(mesh_);
 	mesh_ = NULL;
 	CleanUp();
 }
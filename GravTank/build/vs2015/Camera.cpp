@@ -1,6 +1,6 @@
 #include "Camera.h"
 #include <system/platform.h>
-#include <box2d/Box2D.h>
+#include <Box2D/Box2D.h>
 
 Camera::Camera()
 {
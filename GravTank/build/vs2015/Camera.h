@@ -1,6 +1,6 @@
 #pragma once
 #include <system/platform.h>
-#include <box2d/Box2D.h>
+#include <Box2D/Box2D.h>
 
 // FRAMEWORK FORWARD DECLARATIONS
 namespace gef
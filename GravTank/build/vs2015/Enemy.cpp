@@ -51,7 +51,7 @@ void Enemy::Init()
 	direction = 1;
 
 	// setup the mesh for the Enemy
-	set_mesh(m_builder->CreateSphereMesh(1.0f, 10, 10));
+	set_mesh(m_builder->GetSphereMesh(1.0f, 10, 10));
 
 	// create a physics body for the enemy
 	b2BodyDef enemy_body_def;
@@ -233,7 +233,7 @@ Enemy::~Enemy()
 		m_audioManager->StopPlayingSampleVoice(voice_id_shoot);
 	m_world->DestroyBody(m_body);
 	m_body = NULL;
-	delete mesh_;
+	m_builder->ReleaseMesh(mesh_);
 	mesh_ = NULL;
 	m_audioManager = NULL;
 	bullet = NULL;
@@ -2,7 +2,7 @@
 #include "game_object.h"
 #include "primitive_builder.h"
 #include "Bullet.h"
-#include "graphics\material.h"
+#include "graphics/material.h"
 #include <audio/audio_manager.h>
 
 
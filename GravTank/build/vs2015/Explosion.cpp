@@ -9,7 +9,7 @@ Explosion::Explosion(b2Vec2 pos, b2World* world, PrimitiveBuilder* builder) :
 	SetBulletType(NOBULLET);
 	// setup the mesh
 	gef::Vector4 halfDimensions(1.5f, 1.5f, 0.01f);
-	set_mesh(m_builder->CreateBoxMesh(halfDimensions));
+	set_mesh(m_builder->GetBoxMesh(halfDimensions));
 
 	// create a physics body
 	b2BodyDef body_def;
@@ -107,7 +107,7 @@ Explosion::~Explosion()
 {
 	m_world->DestroyBody(m_body);
 	m_body = NULL;
-	delete mesh_;
+	m_builder->ReleaseMesh(mesh_);
 	mesh_ = NULL;
 	CleanUp();
 }
@@ -1,12 +1,15 @@
 #include "GameManager.h"
 #include <graphics/mesh.h>
 
+//dimensions of a block
+static const gef::Vector4 building_half_dimensions(2.0f, 2.0f, 0.5f);
 
-
-GameManager::GameManager(b2World* world, PrimitiveBuilder* builder, gef::AudioManager* audioManager, int shootID, int moveID) :
+GameManager::GameManager(gef::Platform& platform, b2World* world, PrimitiveBuilder* builder, gef::AudioManager* audioManager, int shootID, int moveID) :
 	m_world(world),
 	m_builder(builder)
 {
+	m_levelMesh = new LevelMesh(platform, width, height, building_half_dimensions);
+
 	//start in menu state
 	m_state = MENU;
 	//level 1 first
@@ -64,15 +67,12 @@ void GameManager::LoadLevel()
 		}
 	}
 
-	//dimensions of a block
-	gef::Vector4 building_half_dimensions(2.0f, 2.0f, 0.5f);
-
 	b2FixtureDef fixture_def;
 
 	b2BodyDef body_def;
 
 	b2PolygonShape shape;
-	
+
 	for (int i = 0; i < width; i++)
 	{
 		for (int j = 0; j < height; j++)
@@ -86,10 +86,8 @@ void GameManager::LoadLevel()
 
 				// 1 loads a level block in that position, with a body so objects can make contact with it
 				case 1:
-					// setup the mesh for the block
+					//the block is drawn as part of the level mesh, so its object has no mesh of its own
 					levelBlocks[i][j].blockObject = new GameObject();
-					levelBlocks[i][j].blockMesh = m_builder->CreateBoxMesh(building_half_dimensions);
-					levelBlocks[i][j].blockObject->set_mesh(levelBlocks[i][j].blockMesh);
 
 					// create physics body
 					body_def.type = b2_staticBody;
@@ -113,6 +111,8 @@ void GameManager::LoadLevel()
 					//set gameobject type to tile
 					levelBlocks[i][j].blockObject->SetType(TILE);
 
+					m_levelMesh->SetCell(i, j, true);
+
 					break;
 				
 				//2 set the player start position to the current position (no block)
@@ -248,6 +248,9 @@ void GameManager::LoadLevel()
 	}
 
 	enemiesAlive = enemyCount;
+
+	//Reset cleared every cell, but only the chunks whose blocks differ from the last level are rebuilt
+	m_levelMesh->Bake();
 }
 
 void GameManager::SetBlockNull(int i, int j)
@@ -255,7 +258,6 @@ void GameManager::SetBlockNull(int i, int j)
 	//set a block to NULL
 	levelBlocks[i][j].blockObject = NULL;
 	levelBlocks[i][j].blockBody = NULL;
-	levelBlocks[i][j].blockMesh = NULL;
 }
 
 //set all blocks and enemies to null to prepare for loading next level
@@ -265,8 +267,6 @@ void GameManager::Reset()
 	{
 		for (int j = 0; j < height; j++)
 		{
-			delete levelBlocks[i][j].blockMesh;
-			levelBlocks[i][j].blockMesh = NULL;
 			delete levelBlocks[i][j].blockObject;
 			levelBlocks[i][j].blockObject = NULL;
 
@@ -275,6 +275,8 @@ void GameManager::Reset()
 				m_world->DestroyBody(levelBlocks[i][j].blockBody);
 				levelBlocks[i][j].blockBody = NULL;
 			}
+
+			m_levelMesh->SetCell(i, j, false);
 		}
 	}
 	for (int i = 0; i < enemyCount; i++)
@@ -313,6 +315,11 @@ GameObject* GameManager::GetBlock(int i, int j)
 	return levelBlocks[i][j].blockObject;
 }
 
+LevelMesh* GameManager::GetLevelMesh()
+{
+	return m_levelMesh;
+}
+
 Enemy* GameManager::GetEnemy(int i)
 {
 	return enemies[i];
@@ -379,4 +386,6 @@ void GameManager::SetLevels()
 
 GameManager::~GameManager()
 {
+	delete m_levelMesh;
+	m_levelMesh = NULL;
 }
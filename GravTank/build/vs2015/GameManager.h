@@ -2,14 +2,14 @@
 #include <maths/vector2.h>
 #include "primitive_builder.h"
 #include <graphics/mesh_instance.h>
-#include <box2d/Box2D.h>
+#include <Box2D/Box2D.h>
 #include "game_object.h"
 #include "Enemy.h"
+#include "LevelMesh.h"
 
 //blocks make up the level layout
 struct Block
 {
-	gef::Mesh* blockMesh;
 	GameObject* blockObject;
 	b2Body* blockBody;
 };
@@ -23,7 +23,7 @@ enum GameState
 class GameManager
 {
 public:
-	GameManager(b2World* world_, PrimitiveBuilder* builder, gef::AudioManager* audioManager, int shootID, int moveID);
+	GameManager(gef::Platform& platform, b2World* world_, PrimitiveBuilder* builder, gef::AudioManager* audioManager, int shootID, int moveID);
 	~GameManager();
 
 	void LoadLevel();
@@ -31,6 +31,8 @@ public:
 	void ResetAll();
 	void RenderLevel();
 	GameObject* GetBlock(int i, int j);
+	//the blocks of the current level baked into a few meshes
+	LevelMesh* GetLevelMesh();
 	b2Vec2 GetStartPosition();
 	void NextLevel();
 	GameState GetState();
@@ -58,6 +60,8 @@ private:
 	b2World* m_world;
 	//
 	PrimitiveBuilder* m_builder;
+	//the blocks drawn as merged meshes with hidden faces removed
+	LevelMesh* m_levelMesh;
 	b2Vec2 StartPosition;
 	int enemyCount;
 	int enemiesAlive;
@@ -0,0 +1,355 @@
+#include "LevelMesh.h"
+#include <graphics/primitive.h>
+#include <system/platform.h>
+#include <gef.h>
+
+
+LevelMesh::LevelMesh(gef::Platform& platform, int width, int height, const gef::Vector4& blockHalfSize) :
+	m_platform(platform),
+	m_width(width),
+	m_height(height),
+	m_halfSize(blockHalfSize),
+	m_chunksBuilt(0)
+{
+	m_chunkRows = (height + kChunkSize - 1) / kChunkSize;
+	m_chunkColumns = (width + kChunkSize - 1) / kChunkSize;
+
+	m_cells.resize(width * height, false);
+	m_bakedCells.resize(width * height, false);
+	m_merged.resize(width * height, false);
+
+	Chunk chunk;
+	chunk.mesh = NULL;
+	chunk.dirty = false;
+	chunk.vertexCount = 0;
+	chunk.triangleCount = 0;
+	m_chunks.resize(m_chunkRows * m_chunkColumns, chunk);
+}
+
+void LevelMesh::SetCell(int i, int j, bool solid)
+{
+	if (i < 0 || i >= m_height || j < 0 || j >= m_width || m_cells[i * m_width + j] == solid)
+		return;
+
+	m_cells[i * m_width + j] = solid;
+
+	//the faces of the neighbouring blocks change too, and they can be in other chunks
+	MarkDirty(i, j);
+	MarkDirty(i - 1, j);
+	MarkDirty(i + 1, j);
+	MarkDirty(i, j - 1);
+	MarkDirty(i, j + 1);
+}
+
+bool LevelMesh::GetCell(int i, int j)
+{
+	return IsSolid(i, j);
+}
+
+void LevelMesh::Clear()
+{
+	for (int i = 0; i < m_height; i++)
+	{
+		for (int j = 0; j < m_width; j++)
+		{
+			SetCell(i, j, false);
+		}
+	}
+}
+
+void LevelMesh::Bake()
+{
+	for (int chunkRow = 0; chunkRow < m_chunkRows; chunkRow++)
+	{
+		for (int chunkColumn = 0; chunkColumn < m_chunkColumns; chunkColumn++)
+		{
+			Chunk& chunk = m_chunks[chunkRow * m_chunkColumns + chunkColumn];
+			if (!chunk.dirty)
+				continue;
+
+			if (ChunkChanged(chunkRow, chunkColumn))
+				BuildChunk(chunkRow, chunkColumn);
+			else
+				chunk.dirty = false;
+		}
+	}
+
+	m_bakedCells = m_cells;
+}
+
+int LevelMesh::GetChunkCount()
+{
+	return (int)m_chunks.size();
+}
+
+gef::MeshInstance* LevelMesh::GetChunk(int chunk)
+{
+	if (m_chunks[chunk].mesh == NULL)
+		return NULL;
+
+	return &m_chunks[chunk].instance;
+}
+
+int LevelMesh::GetVertexCount()
+{
+	int vertexCount = 0;
+	for (size_t chunk = 0; chunk < m_chunks.size(); chunk++)
+		vertexCount += m_chunks[chunk].vertexCount;
+	return vertexCount;
+}
+
+int LevelMesh::GetTriangleCount()
+{
+	int triangleCount = 0;
+	for (size_t chunk = 0; chunk < m_chunks.size(); chunk++)
+		triangleCount += m_chunks[chunk].triangleCount;
+	return triangleCount;
+}
+
+int LevelMesh::GetChunksBuilt()
+{
+	return m_chunksBuilt;
+}
+
+bool LevelMesh::IsSolid(int i, int j)
+{
+	//everything outside the grid is empty, so the faces on the edge of the level are kept
+	if (i < 0 || i >= m_height || j < 0 || j >= m_width)
+		return false;
+
+	return m_cells[i * m_width + j];
+}
+
+void LevelMesh::MarkDirty(int i, int j)
+{
+	if (i < 0 || i >= m_height || j < 0 || j >= m_width)
+		return;
+
+	m_chunks[(i / kChunkSize) * m_chunkColumns + j / kChunkSize].dirty = true;
+}
+
+bool LevelMesh::ChunkChanged(int chunkRow, int chunkColumn)
+{
+	//the faces on the edge of a chunk depend on the cells just outside it
+	int firstRow = chunkRow * kChunkSize - 1;
+	int lastRow = (chunkRow + 1) * kChunkSize + 1;
+	int firstColumn = chunkColumn * kChunkSize - 1;
+	int lastColumn = (chunkColumn + 1) * kChunkSize + 1;
+
+	for (int i = firstRow < 0 ? 0 : firstRow; i < lastRow && i < m_height; i++)
+	{
+		for (int j = firstColumn < 0 ? 0 : firstColumn; j < lastColumn && j < m_width; j++)
+		{
+			if (m_cells[i * m_width + j] != m_bakedCells[i * m_width + j])
+				return true;
+		}
+	}
+
+	return false;
+}
+
+void LevelMesh::BuildChunk(int chunkRow, int chunkColumn)
+{
+	Chunk& chunk = m_chunks[chunkRow * m_chunkColumns + chunkColumn];
+	chunk.dirty = false;
+
+	delete chunk.mesh;
+	chunk.mesh = NULL;
+	chunk.instance.set_mesh(NULL);
+	chunk.vertexCount = 0;
+	chunk.triangleCount = 0;
+
+	const int firstRow = chunkRow * kChunkSize;
+	const int lastRow = firstRow + kChunkSize < m_height ? firstRow + kChunkSize : m_height;
+	const int firstColumn = chunkColumn * kChunkSize;
+	const int lastColumn = firstColumn + kChunkSize < m_width ? firstColumn + kChunkSize : m_width;
+
+	const float blockWidth = m_halfSize.x() * 2.0f;
+	const float blockHeight = m_halfSize.y() * 2.0f;
+	const float blockDepth = m_halfSize.z() * 2.0f;
+
+	m_vertices.clear();
+	m_indices.clear();
+
+	//front and back faces, grow each rectangle along the row then down while every cell under it is a block
+	for (int i = firstRow; i < lastRow; i++)
+	{
+		for (int j = firstColumn; j < lastColumn; j++)
+			m_merged[i * m_width + j] = false;
+	}
+	for (int i = firstRow; i < lastRow; i++)
+	{
+		for (int j = firstColumn; j < lastColumn; j++)
+		{
+			if (!IsSolid(i, j) || m_merged[i * m_width + j])
+				continue;
+
+			int columns = 1;
+			while (j + columns < lastColumn && IsSolid(i, j + columns) && !m_merged[i * m_width + j + columns])
+				columns++;
+
+			int rows = 1;
+			bool rowFilled = true;
+			while (i + rows < lastRow && rowFilled)
+			{
+				for (int column = j; column < j + columns; column++)
+				{
+					if (!IsSolid(i + rows, column) || m_merged[(i + rows) * m_width + column])
+					{
+						rowFilled = false;
+						break;
+					}
+				}
+				if (rowFilled)
+					rows++;
+			}
+
+			for (int row = i; row < i + rows; row++)
+			{
+				for (int column = j; column < j + columns; column++)
+					m_merged[row * m_width + column] = true;
+			}
+
+			const float left = blockWidth * j - m_halfSize.x();
+			const float right = left + blockWidth * columns;
+			const float top = -blockHeight * i + m_halfSize.y();
+			const gef::Vector4 across(blockWidth * columns, 0.0f, 0.0f);
+			const gef::Vector4 down(0.0f, -blockHeight * rows, 0.0f);
+
+			AddQuad(gef::Vector4(left, top, m_halfSize.z()), across, down, gef::Vector4(0.0f, 0.0f, 1.0f), (float)columns, (float)rows);
+			AddQuad(gef::Vector4(right, top, -m_halfSize.z()), across * -1.0f, down, gef::Vector4(0.0f, 0.0f, -1.0f), (float)columns, (float)rows);
+		}
+	}
+
+	//left and right faces, merged down each column while the block next to them stays empty
+	const gef::Vector4 intoScreen(0.0f, 0.0f, -blockDepth);
+	const gef::Vector4 outOfScreen(0.0f, 0.0f, blockDepth);
+	for (int j = firstColumn; j < lastColumn; j++)
+	{
+		for (int side = -1; side <= 1; side += 2)
+		{
+			int i = firstRow;
+			while (i < lastRow)
+			{
+				if (!IsSolid(i, j) || IsSolid(i, j + side))
+				{
+					i++;
+					continue;
+				}
+
+				int rows = 1;
+				while (i + rows < lastRow && IsSolid(i + rows, j) && !IsSolid(i + rows, j + side))
+					rows++;
+
+				const float x = blockWidth * j + m_halfSize.x() * side;
+				const float top = -blockHeight * i + m_halfSize.y();
+				const gef::Vector4 down(0.0f, -blockHeight * rows, 0.0f);
+				if (side > 0)
+					AddQuad(gef::Vector4(x, top, m_halfSize.z()), intoScreen, down, gef::Vector4(1.0f, 0.0f, 0.0f), 1.0f, (float)rows);
+				else
+					AddQuad(gef::Vector4(x, top, -m_halfSize.z()), outOfScreen, down, gef::Vector4(-1.0f, 0.0f, 0.0f), 1.0f, (float)rows);
+
+				i += rows;
+			}
+		}
+	}
+
+	//top and bottom faces, merged along each row while the block above or below stays empty
+	//row i - 1 is above row i
+	for (int i = firstRow; i < lastRow; i++)
+	{
+		for (int side = -1; side <= 1; side += 2)
+		{
+			int j = firstColumn;
+			while (j < lastColumn)
+			{
+				if (!IsSolid(i, j) || IsSolid(i + side, j))
+				{
+					j++;
+					continue;
+				}
+
+				int columns = 1;
+				while (j + columns < lastColumn && IsSolid(i, j + columns) && !IsSolid(i + side, j + columns))
+					columns++;
+
+				const float left = blockWidth * j - m_halfSize.x();
+				const float y = -blockHeight * i - m_halfSize.y() * side;
+				const gef::Vector4 across(blockWidth * columns, 0.0f, 0.0f);
+				if (side < 0)
+					AddQuad(gef::Vector4(left, y, -m_halfSize.z()), across, outOfScreen, gef::Vector4(0.0f, 1.0f, 0.0f), (float)columns, 1.0f);
+				else
+					AddQuad(gef::Vector4(left, y, m_halfSize.z()), across, intoScreen, gef::Vector4(0.0f, -1.0f, 0.0f), (float)columns, 1.0f);
+
+				j += columns;
+			}
+		}
+	}
+
+	if (m_vertices.empty())
+		return;
+
+	chunk.mesh = m_platform.CreateMesh();
+	chunk.mesh->InitVertexBuffer(m_platform, &m_vertices[0], (int)m_vertices.size(), sizeof(gef::Mesh::Vertex));
+	chunk.mesh->AllocatePrimitives(1);
+
+	gef::Primitive* primitive = chunk.mesh->GetPrimitive(0);
+	primitive->InitIndexBuffer(m_platform, &m_indices[0], (int)m_indices.size(), sizeof(Int32));
+	primitive->set_type(gef::TRIANGLE_LIST);
+
+	//bounds so the renderer can cull chunks that are off screen
+	gef::Vector4 boundsMin(m_vertices[0].px, m_vertices[0].py, m_vertices[0].pz);
+	gef::Vector4 boundsMax = boundsMin;
+	for (size_t vertex = 1; vertex < m_vertices.size(); vertex++)
+	{
+		const gef::Vector4 position(m_vertices[vertex].px, m_vertices[vertex].py, m_vertices[vertex].pz);
+		boundsMin = gef::Vector4(position.x() < boundsMin.x() ? position.x() : boundsMin.x(), position.y() < boundsMin.y() ? position.y() : boundsMin.y(), position.z() < boundsMin.z() ? position.z() : boundsMin.z());
+		boundsMax = gef::Vector4(position.x() > boundsMax.x() ? position.x() : boundsMax.x(), position.y() > boundsMax.y() ? position.y() : boundsMax.y(), position.z() > boundsMax.z() ? position.z() : boundsMax.z());
+	}
+	gef::Aabb aabb(boundsMin, boundsMax);
+	chunk.mesh->set_aabb(aabb);
+	chunk.mesh->set_bounding_sphere(gef::Sphere(aabb));
+
+	chunk.instance.set_mesh(chunk.mesh);
+	chunk.vertexCount = (int)m_vertices.size();
+	chunk.triangleCount = (int)m_indices.size() / 3;
+	m_chunksBuilt++;
+}
+
+void LevelMesh::AddQuad(const gef::Vector4& origin, const gef::Vector4& u, const gef::Vector4& v, const gef::Vector4& normal, float uRepeat, float vRepeat)
+{
+	const Int32 first = (Int32)m_vertices.size();
+
+	//same corner order and winding as the faces of PrimitiveBuilder::CreateBoxMesh
+	const gef::Vector4 corners[4] = { origin, origin + u, origin + v, origin + u + v };
+	const float uvs[4][2] = { { 0.0f, 0.0f }, { uRepeat, 0.0f }, { 0.0f, vRepeat }, { uRepeat, vRepeat } };
+	for (int corner = 0; corner < 4; corner++)
+	{
+		gef::Mesh::Vertex vertex;
+		vertex.px = corners[corner].x();
+		vertex.py = corners[corner].y();
+		vertex.pz = corners[corner].z();
+		vertex.nx = normal.x();
+		vertex.ny = normal.y();
+		vertex.nz = normal.z();
+		vertex.u = uvs[corner][0];
+		vertex.v = uvs[corner][1];
+		m_vertices.push_back(vertex);
+	}
+
+	m_indices.push_back(first);
+	m_indices.push_back(first + 1);
+	m_indices.push_back(first + 2);
+	m_indices.push_back(first + 1);
+	m_indices.push_back(first + 3);
+	m_indices.push_back(first + 2);
+}
+
+LevelMesh::~LevelMesh()
+{
+	for (size_t chunk = 0; chunk < m_chunks.size(); chunk++)
+	{
+		delete m_chunks[chunk].mesh;
+		m_chunks[chunk].mesh = NULL;
+	}
+}
@@ -0,0 +1,82 @@
+#pragma once
+#include <maths/vector4.h>
+#include <graphics/mesh.h>
+#include <graphics/mesh_instance.h>
+#include <vector>
+
+namespace gef
+{
+	class Platform;
+}
+
+//bakes the blocks of a level grid into a few merged meshes
+//faces between neighbouring blocks are dropped and the faces left on each side are merged into rectangles
+//the grid is split into chunks so changing a cell only rebuilds the chunks around it
+class LevelMesh
+{
+public:
+	//cell i, j is a block centred on (2 * halfSize.x * j, -2 * halfSize.y * i), the same layout as the GameManager
+	LevelMesh(gef::Platform& platform, int width, int height, const gef::Vector4& blockHalfSize);
+	~LevelMesh();
+
+	//set whether there is a block in row i, column j
+	void SetCell(int i, int j, bool solid);
+	bool GetCell(int i, int j);
+	//remove every block
+	void Clear();
+
+	//rebuild the meshes for the chunks whose cells differ from the last bake
+	//cells that were changed and then changed back, such as when the next level
+	//has a block where the last one did, don't cause a rebuild
+	void Bake();
+
+	int GetChunkCount();
+	//NULL if there are no blocks in the chunk
+	gef::MeshInstance* GetChunk(int chunk);
+
+	//size of the baked meshes
+	int GetVertexCount();
+	int GetTriangleCount();
+	//number of chunk meshes built since the level mesh was created
+	int GetChunksBuilt();
+
+private:
+	//cells along each side of a chunk
+	static const int kChunkSize = 8;
+
+	struct Chunk
+	{
+		gef::Mesh* mesh;
+		gef::MeshInstance instance;
+		bool dirty;
+		int vertexCount;
+		int triangleCount;
+	};
+
+	bool IsSolid(int i, int j);
+	void MarkDirty(int i, int j);
+	//whether any cell the chunk's faces depend on differs from the last bake
+	bool ChunkChanged(int chunkRow, int chunkColumn);
+	void BuildChunk(int chunkRow, int chunkColumn);
+	//add a quad with corners origin, origin + u, origin + v and origin + u + v
+	//the texture repeats uRepeat times along u and vRepeat times along v
+	void AddQuad(const gef::Vector4& origin, const gef::Vector4& u, const gef::Vector4& v, const gef::Vector4& normal, float uRepeat, float vRepeat);
+
+	gef::Platform& m_platform;
+	int m_width;
+	int m_height;
+	gef::Vector4 m_halfSize;
+	int m_chunkRows;
+	int m_chunkColumns;
+	int m_chunksBuilt;
+
+	std::vector<bool> m_cells;
+	//the cells as they were when the chunks were last built
+	std::vector<bool> m_bakedCells;
+	std::vector<Chunk> m_chunks;
+
+	//scratch space reused by each chunk build
+	std::vector<gef::Mesh::Vertex> m_vertices;
+	std::vector<Int32> m_indices;
+	std::vector<bool> m_merged;
+};
@@ -1,5 +1,5 @@
 #pragma once
-#include "graphics\sprite.h"
+#include "graphics/sprite.h"
 
 
 
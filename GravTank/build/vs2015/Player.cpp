@@ -50,7 +50,7 @@ void Player::InitBody()
 
 	//mesh half dimensions
 	gef::Vector4 halfDimensions(0.75f, 0.75f, 0.75f);
-	set_mesh(m_builder->CreateBoxMesh(halfDimensions));
+	set_mesh(m_builder->GetBoxMesh(halfDimensions));
 	
 	
 
@@ -108,7 +108,7 @@ void Player::CreateTurret()
 	turretRot = 0;
 	gef::Vector4 halfSize(0.125f, 0.75f, 0);
 	turret = new GameObject();
-	turret->set_mesh(m_builder->CreateBoxMesh(halfSize));
+	turret->set_mesh(m_builder->GetBoxMesh(halfSize));
 
 	PositionTurret(0, 1);
 	turret->SetType(NONE);
@@ -129,7 +129,7 @@ void Player::PositionTurret(float x, float y)
 	// build object transformation matrix
 	gef::Matrix44 object_transform = object_rotation;
 	object_transform.SetTranslation(object_translation);
-	turret->set_transform(object_transform);
+	turret->set_transform(object_transform, gef::MeshInstance::kRigid);
 }
 
 
@@ -324,6 +324,9 @@ void Player::SetMoveSound(bool play)
 
 Player::~Player()
 {
+	m_builder->ReleaseMesh(mesh_);
+	mesh_ = NULL;
+	m_builder->ReleaseMesh(turret->mesh());
 	delete turret;
 	turret = NULL;
 	bullet = NULL;
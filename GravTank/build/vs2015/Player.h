@@ -2,7 +2,7 @@
 #include "game_object.h"
 #include "Bullet.h"
 #include "Explosion.h"
-#include <box2d/Box2D.h>
+#include <Box2D/Box2D.h>
 #include <audio/audio_manager.h>
 
 class Player : public GameObject
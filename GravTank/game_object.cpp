@@ -28,7 +28,8 @@ void GameObject::UpdateFromSimulation(const b2Body* body)
 		// build object transformation matrix
 		gef::Matrix44 object_transform = object_rotation;
 		object_transform.SetTranslation(object_translation);
-		set_transform(object_transform);
+		//rotation and translation only, so the renderer can skip the full inverse
+		set_transform(object_transform, gef::MeshInstance::kRigid);
 	}
 }
 
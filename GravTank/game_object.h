@@ -2,7 +2,7 @@
 #define _GAME_OBJECT_H
 
 #include <graphics/mesh_instance.h>
-#include <box2d/Box2D.h>
+#include <Box2D/Box2D.h>
 
 //Gameobject type for resolving collisions
 enum ObjectType
@@ -0,0 +1,38 @@
+#include <platform/linux/system/platform_linux_null.h>
+#include <platform/null/input/sony_controller_input_manager_null.h>
+#include <system/debug_log.h>
+#include "scene_app.h"
+#include <cstdlib>
+#include <cstring>
+
+// Headless build for profiling the game on Linux.
+// Run from the media directory:
+//   scene_app_headless [--frames N] [--fixed-dt SECONDS] [--input SCRIPT]
+int main(int argc, char* argv[])
+{
+	unsigned int frame_limit = 1000;
+	float fixed_frame_time = 0.0f;
+
+	for (int arg = 1; arg < argc; ++arg)
+	{
+		if (strcmp(argv[arg], "--frames") == 0 && arg + 1 < argc)
+			frame_limit = strtoul(argv[++arg], NULL, 10);
+		else if (strcmp(argv[arg], "--fixed-dt") == 0 && arg + 1 < argc)
+			fixed_frame_time = (float)atof(argv[++arg]);
+		else if (strcmp(argv[arg], "--input") == 0 && arg + 1 < argc)
+			gef::SonyControllerInputManagerNull::set_default_script_filename(argv[++arg]);
+	}
+
+	// initialisation
+	gef::PlatformLinuxNull platform(960, 544, frame_limit);
+	platform.set_fixed_frame_time(fixed_frame_time);
+
+	SceneApp myApp(platform);
+	myApp.Run();
+
+	const double elapsed_time = platform.GetElapsedTime();
+	gef::DebugOut("%u frames in %.3fs (%.3fms per frame)\n", platform.frame_count(), elapsed_time,
+		platform.frame_count() ? elapsed_time * 1000.0 / platform.frame_count() : 0.0);
+
+	return 0;
+}
@@ -0,0 +1,27 @@
+cbuffer MatrixBuffer
+{
+	matrix proj_matrix;
+};
+
+struct VertexInput
+{
+    float3 position : POSITION;
+    float2 uv : TEXCOORD;
+    float4 colour : COLOR;
+};
+
+struct PixelInput
+{
+    float4 position : SV_POSITION;
+    float4 colour : COLOR;
+    float2 uv : TEXCOORD;
+};
+
+void VS( in VertexInput input,
+         out PixelInput output )
+{
+    // the corners are already in screen space, only the projection is left
+    output.position = mul(float4(input.position, 1), proj_matrix);
+    output.uv = input.uv;
+    output.colour = input.colour;
+}
@@ -2,6 +2,8 @@
 #include <graphics/mesh.h>
 #include <system/platform.h>
 #include <graphics/primitive.h>
+#include <graphics/vertex_buffer.h>
+#include <graphics/index_buffer.h>
 #include <maths/math_utils.h>
 #include <vector>
 #include <math.h>
@@ -52,6 +54,135 @@ void PrimitiveBuilder::CleanUp()
 
 	delete default_cube_mesh_;
 	default_cube_mesh_ = NULL;
+
+	// anything still shared was never released, free it anyway
+	for (MeshCache::iterator entry = mesh_cache_.begin(); entry != mesh_cache_.end(); ++entry)
+		delete entry->second.mesh;
+	mesh_cache_.clear();
+	cached_meshes_.clear();
+	mesh_cache_stats_.meshes = 0;
+	mesh_cache_stats_.references = 0;
+	mesh_cache_stats_.bytes = 0;
+}
+
+//
+// GetBoxMesh
+//
+gef::Mesh* PrimitiveBuilder::GetBoxMesh(const gef::Vector4& half_size, gef::Vector4 centre, gef::Material** materials)
+{
+	MeshKey key;
+	key.shape = MeshKey::kBox;
+	key.sizes[0] = half_size.x();
+	key.sizes[1] = half_size.y();
+	key.sizes[2] = half_size.z();
+	key.sizes[3] = centre.x();
+	key.sizes[4] = centre.y();
+	key.sizes[5] = centre.z();
+	if (materials)
+	{
+		for (int face = 0; face < 6; ++face)
+			key.materials[face] = materials[face];
+	}
+
+	gef::Mesh* mesh = FindCachedMesh(key);
+	if (mesh == NULL)
+	{
+		mesh = CreateBoxMesh(half_size, centre, materials);
+		AddCachedMesh(key, mesh);
+	}
+	return mesh;
+}
+
+//
+// GetSphereMesh
+//
+gef::Mesh* PrimitiveBuilder::GetSphereMesh(const float radius, const int phi, const int theta, gef::Vector4 centre, gef::Material* material)
+{
+	MeshKey key;
+	key.shape = MeshKey::kSphere;
+	key.sizes[0] = radius;
+	key.sizes[1] = centre.x();
+	key.sizes[2] = centre.y();
+	key.sizes[3] = centre.z();
+	key.phi = phi;
+	key.theta = theta;
+	key.materials[0] = material;
+
+	gef::Mesh* mesh = FindCachedMesh(key);
+	if (mesh == NULL)
+	{
+		mesh = CreateSphereMesh(radius, phi, theta, centre, material);
+		AddCachedMesh(key, mesh);
+	}
+	return mesh;
+}
+
+//
+// ReleaseMesh
+//
+void PrimitiveBuilder::ReleaseMesh(const gef::Mesh* mesh)
+{
+	if (mesh == NULL)
+		return;
+
+	std::map<const gef::Mesh*, MeshCache::iterator>::iterator cached_mesh = cached_meshes_.find(mesh);
+	if (cached_mesh == cached_meshes_.end())
+		return;
+
+	MeshCacheEntry& entry = cached_mesh->second->second;
+	mesh_cache_stats_.references--;
+	if (--entry.references == 0)
+	{
+		mesh_cache_stats_.meshes--;
+		mesh_cache_stats_.bytes -= entry.bytes;
+		delete entry.mesh;
+		mesh_cache_.erase(cached_mesh->second);
+		cached_meshes_.erase(cached_mesh);
+	}
+}
+
+//
+// FindCachedMesh
+//
+gef::Mesh* PrimitiveBuilder::FindCachedMesh(const MeshKey& key)
+{
+	MeshCache::iterator entry = mesh_cache_.find(key);
+	if (entry == mesh_cache_.end())
+		return NULL;
+
+	entry->second.references++;
+	mesh_cache_stats_.references++;
+	mesh_cache_stats_.cache_hits++;
+	return entry->second.mesh;
+}
+
+//
+// AddCachedMesh
+//
+void PrimitiveBuilder::AddCachedMesh(const MeshKey& key, gef::Mesh* mesh)
+{
+	MeshCacheEntry entry;
+	entry.mesh = mesh;
+	entry.references = 1;
+
+	// the data uploaded for the vertex buffer and every index buffer
+	entry.bytes = 0;
+	if (mesh->vertex_buffer())
+		entry.bytes += mesh->vertex_buffer()->num_vertices() * mesh->vertex_buffer()->vertex_byte_size();
+	for (UInt32 primitive_index = 0; primitive_index < mesh->num_primitives(); ++primitive_index)
+	{
+		const gef::IndexBuffer* index_buffer = mesh->GetPrimitive(primitive_index)->index_buffer();
+		if (index_buffer)
+			entry.bytes += index_buffer->num_indices() * index_buffer->index_byte_size();
+	}
+
+	MeshCache::iterator added = mesh_cache_.insert(std::make_pair(key, entry)).first;
+	cached_meshes_[mesh] = added;
+
+	mesh_cache_stats_.meshes++;
+	mesh_cache_stats_.references++;
+	mesh_cache_stats_.meshes_created++;
+	mesh_cache_stats_.bytes += entry.bytes;
 }
 
 //
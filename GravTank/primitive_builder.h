@@ -1,9 +1,12 @@
 #ifndef _PRIMITIVE_BUILDER_H
 #define _PRIMITIVE_BUILDER_H
 
+#include <gef.h>
 #include <maths/vector4.h>
 #include <graphics/material.h>
 #include <cstddef>
+#include <cstring>
+#include <map>
 
 namespace gef
 {
@@ -11,6 +14,23 @@ namespace gef
 	class Platform;
 }
 
+/// @brief Counts for the meshes shared by PrimitiveBuilder::GetBoxMesh and GetSphereMesh.
+struct MeshCacheStats
+{
+	/// meshes in the cache
+	UInt32 meshes;
+	/// references held to the meshes in the cache
+	UInt32 references;
+	/// meshes built for the cache since the builder was created
+	UInt32 meshes_created;
+	/// requests answered with a mesh that was already in the cache
+	UInt32 cache_hits;
+	/// vertex and index data held by the meshes in the cache
+	UInt32 bytes;
+
+	MeshCacheStats() : meshes(0), references(0), meshes_created(0), cache_hits(0), bytes(0) {}
+};
+
 class PrimitiveBuilder
 {
 public:
@@ -42,6 +62,25 @@ public:
 	/// @param[in] materials	Pointer to material used to render all faces. NULL is valid.
 	gef::Mesh* CreateSphereMesh(const float radius, const int phi, const int theta, gef::Vector4 centre = gef::Vector4(0.0f, 0.0f, 0.0f), gef::Material* material = NULL);
 
+	/// @brief Get a box shaped mesh shared with everything else that asked for the same box.
+	/// @return The shared mesh, created on the first request
+	/// @note Takes the same parameters as CreateBoxMesh. Every call must be matched by a call to ReleaseMesh, do not delete the mesh.
+	gef::Mesh* GetBoxMesh(const gef::Vector4& half_size, gef::Vector4 centre = gef::Vector4(0.0f, 0.0f, 0.0f), gef::Material** materials = NULL);
+
+	/// @brief Get a sphere shaped mesh shared with everything else that asked for the same sphere.
+	/// @return The shared mesh, created on the first request
+	/// @note Takes the same parameters as CreateSphereMesh. Every call must be matched by a call to ReleaseMesh, do not delete the mesh.
+	gef::Mesh* GetSphereMesh(const float radius, const int phi, const int theta, gef::Vector4 centre = gef::Vector4(0.0f, 0.0f, 0.0f), gef::Material* material = NULL);
+
+	/// @brief Release a reference to a mesh from GetBoxMesh or GetSphereMesh.
+	/// @param[in] mesh		The mesh. It is deleted when nothing else is using it. NULL is valid.
+	void ReleaseMesh(const gef::Mesh* mesh);
+
+	/// @brief Get the counts for the shared meshes.
+	inline const MeshCacheStats& mesh_cache_stats() const {
+		return mesh_cache_stats_;
+	}
+
 
 	/// @brief Get the default cube mesh.
 	/// @return The mesh for the default cube.
@@ -81,6 +120,42 @@ public:
 	}
 
 protected:
+	/// Everything that decides what a primitive mesh looks like.
+	struct MeshKey
+	{
+		enum Shape
+		{
+			kBox = 0,
+			kSphere
+		};
+
+		Int32 shape;
+		/// half size and centre for boxes, radius and centre for spheres
+		float sizes[6];
+		Int32 phi;
+		Int32 theta;
+		const gef::Material* materials[6];
+
+		// keys are compared as raw bytes, so every field, unused sizes and padding
+		// included, starts at zero
+		MeshKey() { memset(this, 0, sizeof(MeshKey)); }
+		bool operator<(const MeshKey& key) const { return memcmp(this, &key, sizeof(MeshKey)) < 0; }
+	};
+
+	struct MeshCacheEntry
+	{
+		gef::Mesh* mesh;
+		UInt32 references;
+		UInt32 bytes;
+	};
+
+	typedef std::map<MeshKey, MeshCacheEntry> MeshCache;
+
+	/// @brief Return the cached mesh for the key and add a reference to it.
+	/// @return NULL if the key wasn't in the cache. Nothing is added, call AddCachedMesh with the new mesh
+	gef::Mesh* FindCachedMesh(const MeshKey& key);
+	void AddCachedMesh(const MeshKey& key, gef::Mesh* mesh);
+
 	gef::Platform& platform_;
 
 	gef::Mesh* default_cube_mesh_;
@@ -90,6 +165,10 @@ protected:
 	gef::Material blue_material_;
 	gef::Material green_material_;
 	gef::Material orange_material_;
+
+	MeshCache mesh_cache_;
+	std::map<const gef::Mesh*, MeshCache::iterator> cached_meshes_;
+	MeshCacheStats mesh_cache_stats_;
 };
 
 #endif // _PRIMITIVE_BUILDER_H
\ No newline at end of file
@@ -17,6 +17,11 @@ SceneApp::SceneApp(gef::Platform& platform) :
 	primitive_builder_(NULL),
 	font_(NULL),
 	world_(NULL),
+	ground_mesh_(NULL),
+	backMesh(NULL),
+	backMesh2(NULL),
+	asset_loader_(NULL),
+	texture_cache_(NULL),
 	audio_manager_(NULL),
 	sfx_id_shoot(-1),
 	sfx_id_move(-1),
@@ -26,8 +31,17 @@ SceneApp::SceneApp(gef::Platform& platform) :
 
 void SceneApp::Init()
 {
+	//start decoding textures first so it overlaps the rest of the setup
+	asset_loader_ = new gef::AssetLoader(platform_);
+	texture_cache_ = new gef::TextureCache(platform_);
+	texture_cache_->OpenCacheFile("textures.cache");
+	asset_loader_->set_texture_cache(texture_cache_);
+	LoadTextures();
+
 	//sprite renderer for drawing sprites on the screen
 	sprite_renderer_ = gef::SpriteRenderer::Create(platform_);
+	//the HUD and text share a few textures, so batch them into a few draws
+	sprite_renderer_->set_batching_enabled(true);
 
 	//input manager handles the controls
 	input_manager_ = platform_.CreateInputManager();
@@ -36,7 +50,9 @@ void SceneApp::Init()
 	audio_manager_ = gef::AudioManager::Create();
 
 	// create the renderer for draw 3D geometry
+	// draws are queued and sorted so shared state is only bound once
 	renderer_3d_ = gef::Renderer3D::Create(platform_);
+	renderer_3d_->set_render_queue_enabled(true);
 
 	// initialise primitive builder to make create some 3D geometry easier
 	primitive_builder_ = new PrimitiveBuilder(platform_);
@@ -67,7 +83,7 @@ void SceneApp::Init()
 	world_ = new b2World(gravity);
 
 	///Initialise game manager and load the first level
-	gameManager = new GameManager(world_, primitive_builder_, audio_manager_, sfx_id_shoot, sfx_id_move);
+	gameManager = new GameManager(platform_, world_, primitive_builder_, audio_manager_, sfx_id_shoot, sfx_id_move);
 	gameManager->LoadLevel();
 
 	//initialise player
@@ -77,7 +93,7 @@ void SceneApp::Init()
 
 	InitBackground();
 
-	//Loads all requires pngs and set textures materials and sprites
+	//Waits for the pngs and set textures materials and sprites
 	InitTextures();
 	
 	//Creates the front  menu
@@ -107,7 +123,9 @@ void SceneApp::CleanUp()
 	delete ground_mesh_;
 	ground_mesh_ = NULL;
 
-	delete backMesh2;
+	primitive_builder_->ReleaseMesh(backMesh);
+	backMesh = NULL;
+	primitive_builder_->ReleaseMesh(backMesh2);
 	backMesh2 = NULL;
 
 	delete input_manager_;
@@ -118,6 +136,10 @@ void SceneApp::CleanUp()
 	delete gameManager;
 	gameManager = NULL;
 
+	//the player gives its meshes back to the primitive builder
+	delete player;
+	player = NULL;
+
 	delete primitive_builder_;
 	primitive_builder_ = NULL;
 
@@ -127,9 +149,6 @@ void SceneApp::CleanUp()
 	delete sprite_renderer_;
 	sprite_renderer_ = NULL;
 
-	delete player;
-	player = NULL;
-
 	// free up audio assets
 	if (audio_manager_)
 	{
@@ -145,6 +164,12 @@ void SceneApp::CleanUp()
 	delete audio_manager_;
 	audio_manager_ = NULL;
 
+	delete asset_loader_;
+	asset_loader_ = NULL;
+
+	//deletes the textures as well
+	delete texture_cache_;
+	texture_cache_ = NULL;
 }
 
 bool SceneApp::Update(float frame_time)
@@ -161,6 +186,9 @@ bool SceneApp::Update(float frame_time)
 	//fps scale for multiplying anything else with a velocity
 	fpsScale = 60.0f / fps_;
 
+	//finish off any background loads, a couple of milliseconds a frame at most
+	asset_loader_->Update(0.002f);
+
 	//update controls
 	if (input_manager_)
 	{
@@ -612,6 +640,9 @@ void SceneApp::Render()
 		renderer_3d_->set_view_matrix(view_matrix);
 
 		// draw 3d geometry
+		// stats() covers the last frame only
+		renderer_3d_->ResetStats();
+		sprite_renderer_->ResetStats();
 		renderer_3d_->Begin();
 
 		//draw background mesh
@@ -625,14 +656,12 @@ void SceneApp::Render()
 		renderer_3d_->set_override_material(NULL);
 
 		//draw all tiles from gamemanager current level
+		//the blocks are baked into a few chunk meshes with the hidden faces removed
 		renderer_3d_->set_override_material(tileMaterial);
-		for (int i = 0; i < levelWidth; i++)
+		for (int chunk = 0; chunk < gameManager->GetLevelMesh()->GetChunkCount(); chunk++)
 		{
-			for (int j = 0; j < levelHeight; j++)
-			{
-				if (gameManager->GetBlock(i, j) != NULL)
-					renderer_3d_->DrawMesh(*gameManager->GetBlock(i, j));
-			}
+			if (gameManager->GetLevelMesh()->GetChunk(chunk) != NULL)
+				renderer_3d_->DrawMesh(*gameManager->GetLevelMesh()->GetChunk(chunk));
 		}
 		renderer_3d_->set_override_material(NULL);
 
@@ -673,14 +702,18 @@ void SceneApp::Render()
 		}
 		renderer_3d_->set_override_material(NULL);
 
-		//draw explosions
-		renderer_3d_->set_override_material(explodeMaterial);
+		renderer_3d_->End();
+
+		//draw explosions in their own pass, after the sorted geometry, so
+		//they blend over it
 		if (player->IsExploding())
 		{
+			renderer_3d_->Begin(false);
+			renderer_3d_->set_override_material(explodeMaterial);
 			renderer_3d_->DrawMesh(*player->GetExplosionMesh());
+			renderer_3d_->set_override_material(NULL);
+			renderer_3d_->End();
 		}
-		renderer_3d_->set_override_material(NULL);
-		renderer_3d_->End();
 
 		// start drawing sprites, but don't clear the frame buffer
 		sprite_renderer_->Begin(false);
@@ -702,16 +735,19 @@ void SceneApp::DrawHUD()
 		//font_->RenderText(sprite_renderer_, gef::Vector4(850.0f, 510.0f, -0.9f), 1.0f, 0xffffffff, gef::TJ_LEFT, "FPS: %.1f", fps_);
 
 		//draw letters HEALTH on the health squares so people know thats the health
-		font_->RenderText(sprite_renderer_, gef::Vector4(healths[0].position().x() - 10.0f, healths[0].position().y() - 15.0f, -1.0f), 1.0f, 0xff000000, gef::TJ_LEFT, "H");
-		font_->RenderText(sprite_renderer_, gef::Vector4(healths[1].position().x() - 10.0f, healths[1].position().y() - 15.0f, -1.0f), 1.0f, 0xff000000, gef::TJ_LEFT, "E");
-		font_->RenderText(sprite_renderer_, gef::Vector4(healths[2].position().x() - 10.0f, healths[2].position().y() - 15.0f, -1.0f), 1.0f, 0xff000000, gef::TJ_LEFT, "A");
-		font_->RenderText(sprite_renderer_, gef::Vector4(healths[3].position().x() - 10.0f, healths[3].position().y() - 15.0f, -1.0f), 1.0f, 0xff000000, gef::TJ_LEFT, "L");
-		font_->RenderText(sprite_renderer_, gef::Vector4(healths[4].position().x() - 10.0f, healths[4].position().y() - 15.0f, -1.0f), 1.0f, 0xff000000, gef::TJ_LEFT, "T");
-		font_->RenderText(sprite_renderer_, gef::Vector4(healths[5].position().x() - 10.0f, healths[5].position().y() - 15.0f, -1.0f), 1.0f, 0xff000000, gef::TJ_LEFT, "H");
+		//all the HUD text goes into one layout so it is drawn as one run
+		const char* healthLetters = "HEALTH";
+		hudText.Begin();
+		for (int i = 0; i < 6; i++)
+		{
+			hudText.AddText(*font_, gef::Vector4(healths[i].position().x() - 10.0f, healths[i].position().y() - 15.0f, -1.0f), 1.0f, 0xff000000, gef::TJ_LEFT, "%c", healthLetters[i]);
+		}
 
 		//display enemies remaining and current level number
-		font_->RenderText(sprite_renderer_, gef::Vector4(15.0f, 510.0f, -0.9f), 1.0f, 0xffffffff, gef::TJ_LEFT, "Enemies left: %i", enemiesLeft);
-		font_->RenderText(sprite_renderer_, gef::Vector4(850.0f, 15.0f, -0.9f), 1.0f, 0xffffffff, gef::TJ_LEFT, "Level  %i", levelNo);
+		hudText.AddText(*font_, gef::Vector4(15.0f, 510.0f, -0.9f), 1.0f, 0xffffffff, gef::TJ_LEFT, "Enemies left: %i", enemiesLeft);
+		hudText.AddText(*font_, gef::Vector4(850.0f, 15.0f, -0.9f), 1.0f, 0xffffffff, gef::TJ_LEFT, "Level  %i", levelNo);
+		hudText.End();
+		hudText.Draw(sprite_renderer_);
 	}
 	
 }
@@ -734,8 +770,11 @@ void SceneApp::DrawMenu()
 	}
 	if (font_)
 	{
-		font_->RenderText(sprite_renderer_, gef::Vector4(320.0f, 305.0f, -0.9f), 2.0f, 0xff000000, gef::TJ_LEFT, "Begin");
-		font_->RenderText(sprite_renderer_, gef::Vector4(320.0f, 405.0f, -0.9f), 2.0f, 0xff000000, gef::TJ_LEFT, "Difficulty : %s", difficulty);
+		menuText.Begin();
+		menuText.AddText(*font_, gef::Vector4(320.0f, 305.0f, -0.9f), 2.0f, 0xff000000, gef::TJ_LEFT, "Begin");
+		menuText.AddText(*font_, gef::Vector4(320.0f, 405.0f, -0.9f), 2.0f, 0xff000000, gef::TJ_LEFT, "Difficulty : %s", difficulty);
+		menuText.End();
+		menuText.Draw(sprite_renderer_);
 	}
 }
 
@@ -746,10 +785,10 @@ void SceneApp::InitBackground()
 	gef::Vector4 back_half_dimensions2(60.0f, 60.0f, 0.1f);
 
 	// setup the mesh for the backgrounds
-	backMesh = primitive_builder_->CreateBoxMesh(back_half_dimensions);
+	backMesh = primitive_builder_->GetBoxMesh(back_half_dimensions);
 	back.set_mesh(backMesh);
 
-	backMesh2 = primitive_builder_->CreateBoxMesh(back_half_dimensions2);
+	backMesh2 = primitive_builder_->GetBoxMesh(back_half_dimensions2);
 	back2.set_mesh(backMesh2);
 	
 	//setup the background rotations
@@ -763,9 +802,9 @@ void SceneApp::InitBackground()
 	// build background transformation matrix
 	gef::Matrix44 object_transform = object_rotation;
 	object_transform.SetTranslation(object_translation);
-	back.set_transform(object_transform);
+	back.set_transform(object_transform, gef::MeshInstance::kRigid);
 	object_transform.SetTranslation(object_translation2);
-	back2.set_transform(object_transform);
+	back2.set_transform(object_transform, gef::MeshInstance::kRigid);
 }
 
 
@@ -792,6 +831,10 @@ void SceneApp::CleanUpFont()
 {
 	delete font_;
 	font_ = NULL;
+
+	//the layouts hold glyphs that use the font texture
+	hudText.Clear();
+	menuText.Clear();
 }
 
 
@@ -984,59 +1027,79 @@ void SceneApp::PlayerDeath()
 	gameManager->ResetAll();
 }
 
+void SceneApp::LoadTextures()
+{
+	static const char* textureFilenames[NUM_TEXTURES] =
+	{
+		"player.png",
+		"enemy.png",
+		"explode.png",
+		"tile.png",
+		"background.png",
+		"black.png",
+		"menuBack.png",
+		"pause.png"
+	};
+
+	for (int i = 0; i < NUM_TEXTURES; i++)
+		textureLoads[i] = asset_loader_->LoadTexture(textureFilenames[i]);
+}
+
 void SceneApp::InitTextures()
 {
+	//wait for the pngs that are still decoding
+	asset_loader_->Finish();
+
 	//Initialise textures, materials and sprites
-	pngLoader.Load("player.png", platform_, playerImage);
-	playerTexture = gef::Texture::Create(platform_, playerImage);
+	playerTexture = asset_loader_->texture(textureLoads[PLAYER_TEXTURE]);
 	playerMaterial = new gef::Material();
 	//playerMaterial.set_colour(0xff0000ff);
 	playerMaterial->set_texture(playerTexture);
 
-	pngLoader.Load("enemy.png", platform_, enemyImage);
-	enemyTexture = gef::Texture::Create(platform_, enemyImage);
+	enemyTexture = asset_loader_->texture(textureLoads[ENEMY_TEXTURE]);
 	enemyMaterial = new gef::Material();
 	//enemyMaterial.set_colour(0xff0000ff);
 	enemyMaterial->set_texture(enemyTexture);
 
-	pngLoader.Load("explode.png", platform_, explodeImage);
-	explodeTexture = gef::Texture::Create(platform_, explodeImage);
+	explodeTexture = asset_loader_->texture(textureLoads[EXPLODE_TEXTURE]);
 	explodeMaterial = new gef::Material();
 	//enemyMaterial.set_colour(0xff0000ff);
 	explodeMaterial->set_texture(explodeTexture);
 
 
-	pngLoader.Load("tile.png", platform_, tileImage);
-	tileTexture = gef::Texture::Create(platform_, tileImage);
+	tileTexture = asset_loader_->texture(textureLoads[TILE_TEXTURE]);
 	tileMaterial = new gef::Material();
 	//tileMaterial.set_colour(0xff0000ff);
 	tileMaterial->set_texture(tileTexture);
 
-	pngLoader.Load("background.png", platform_, backImage);
-	backTexture = gef::Texture::Create(platform_, backImage);
+	backTexture = asset_loader_->texture(textureLoads[BACK_TEXTURE]);
 	backMaterial = new gef::Material();
 	//mat.set_colour(0xff0000ff);
 	backMaterial->set_texture(backTexture);
 
-	pngLoader.Load("black.png", platform_, blackImage);
-	blackTexture = gef::Texture::Create(platform_, blackImage);
+	blackTexture = asset_loader_->texture(textureLoads[BLACK_TEXTURE]);
 	blackMaterial = new gef::Material();
 	//mat.set_colour(0xff0000ff);
 	blackMaterial->set_texture(blackTexture);
 
 
-	pngLoader.Load("menuBack.png", platform_, menuImage);
-	menuTexture = gef::Texture::Create(platform_, menuImage);
+	menuTexture = asset_loader_->texture(textureLoads[MENU_TEXTURE]);
 	menuMaterial = new gef::Material();
 	//mat.set_colour(0xff0000ff);
 	menuMaterial->set_texture(menuTexture);
 
-	pngLoader.Load("pause.png", platform_, pauseImage);
-	pauseTexture = gef::Texture::Create(platform_, pauseImage);
+	pauseTexture = asset_loader_->texture(textureLoads[PAUSE_TEXTURE]);
 	//mat.set_colour(0xff0000ff);
 	pauseSprite.set_texture(pauseTexture);
 	pauseSprite.set_height(544);
 	pauseSprite.set_width(960);
 	pauseSprite.set_position(gef::Vector4(480, 272, 0));
+
+	//the textures belong to the texture cache, so the loads can be freed
+	for (int i = 0; i < NUM_TEXTURES; i++)
+		asset_loader_->Release(textureLoads[i]);
+
+	//only writes anything if a png wasn't in the cache file yet
+	texture_cache_->SaveCacheFile();
 }
 
@@ -5,18 +5,22 @@
 #include <maths/vector2.h>
 #include "primitive_builder.h"
 #include <graphics/mesh_instance.h>
-#include <box2d/Box2D.h>
+#include <Box2D/Box2D.h>
 #include "game_object.h"
 #include "Camera.h"
 #include "Menu.h"
 #include "GameManager.h"
 #include "Enemy.h"
 #include "Player.h"
-#include "graphics\sprite.h"
-#include "graphics\texture.h"
-#include "graphics\image_data.h"
-#include "assets\png_loader.h"
+#include "graphics/sprite.h"
+#include "graphics/texture.h"
+#include "graphics/image_data.h"
+#include "assets/png_loader.h"
+#include <assets/asset_loader.h>
+#include <assets/texture_cache.h>
 #include <audio/audio_manager.h>
+#include <graphics/text_layout.h>
+#include <vector>
 
 
 // FRAMEWORK FORWARD DECLARATIONS
@@ -64,6 +68,9 @@ private:
     
 	gef::SpriteRenderer* sprite_renderer_;
 	gef::Font* font_;
+	//text is only laid out again when it changes
+	gef::TextLayout hudText;
+	gef::TextLayout menuText;
 	gef::Renderer3D* renderer_3d_;
 
 	gef::InputManager* input_manager_;
@@ -123,37 +130,46 @@ private:
 	float fpsScale; // for scaling speeds up when fps drops
 
 	//Image texture material and sprites
-	gef::PNGLoader pngLoader;
-	
+	enum TextureId
+	{
+		PLAYER_TEXTURE,
+		ENEMY_TEXTURE,
+		EXPLODE_TEXTURE,
+		TILE_TEXTURE,
+		BACK_TEXTURE,
+		BLACK_TEXTURE,
+		MENU_TEXTURE,
+		PAUSE_TEXTURE,
+		NUM_TEXTURES
+	};
+	//pngs are decoded on the asset loader's worker threads while the rest of Init runs
+	gef::AssetLoader* asset_loader_;
+	//owns the textures, and keeps them decoded in a cache file so later runs skip the png decoding
+	gef::TextureCache* texture_cache_;
+	gef::AssetLoader::Handle textureLoads[NUM_TEXTURES];
+
 	gef::ImageData healthImage;
 	gef::Texture* healthTexture;
 
-	gef::ImageData playerImage;
 	gef::Texture* playerTexture;
 	gef::Material* playerMaterial;
 
-	gef::ImageData enemyImage;
 	gef::Texture* enemyTexture;
 	gef::Material* enemyMaterial;
 
-	gef::ImageData explodeImage;
 	gef::Texture* explodeTexture;
 	gef::Material* explodeMaterial;
 
-	gef::ImageData tileImage;
 	gef::Texture* tileTexture;
 	gef::Material* tileMaterial;
 
-	gef::ImageData backImage;
 	gef::Texture* backTexture;
 	gef::Material* backMaterial;
 
-	gef::ImageData blackImage;
 	gef::Texture* blackTexture;
 	gef::Material* blackMaterial;
 	gef::Sprite blackSprite;
 
-	gef::ImageData menuImage;
 	gef::Texture* menuTexture;
 	gef::Material* menuMaterial;
 	gef::Sprite menuSprite;
@@ -168,10 +184,12 @@ private:
 	gef::Material* startMaterial;
 	gef::Sprite startSprite;
 
-	gef::ImageData pauseImage;
 	gef::Texture* pauseTexture;
 	gef::Sprite pauseSprite;
 
+	//Starts loading the pngs in the background
+	void LoadTextures();
+	//Waits for the pngs then sets textures materials and sprites
 	void InitTextures();
 
 	void DrawMenu();
@@ -2,6 +2,38 @@
 
 namespace gef
 {
+	// Find the first key after time, or the number of keys if there isn't one.
+	// key_hint is where the last search for these keys ended. Playback usually
+	// stays between the same keys or moves on to the next pair, so those are
+	// checked before searching all of the keys.
+	template <typename Key>
+	static UInt32 FindNextKey(const std::vector<Key>& keys, const float time, const UInt32 key_hint)
+	{
+		const UInt32 num_keys = (UInt32)keys.size();
+
+		for(UInt32 keyIndex = key_hint; keyIndex <= key_hint+1 && keyIndex <= num_keys; ++keyIndex)
+		{
+			if((keyIndex == 0 || keys[keyIndex-1].time <= time) && (keyIndex == num_keys || keys[keyIndex].time > time))
+				return keyIndex;
+		}
+
+		UInt32 first = 0;
+		UInt32 count = num_keys;
+		while(count > 0)
+		{
+			const UInt32 step = count / 2;
+			if(keys[first+step].time <= time)
+			{
+				first += step+1;
+				count -= step+1;
+			}
+			else
+				count = step;
+		}
+
+		return first;
+	}
+
 	AnimNode::AnimNode(Type type) :
 		type_(type),
 		name_id_(0)
@@ -46,96 +78,82 @@ namespace gef
 
 	const Vector4 TransformAnimNode::GetTranslation(const float _time) const
 	{
-		return GetVector(_time, this->translation_keys_);
+		UInt32 key_cursor = 0;
+		return GetVector(_time, this->translation_keys_, key_cursor);
 	}
 
 	const Vector4 TransformAnimNode::GetScale(const float _time) const
 	{
-		return GetVector(_time, this->scale_keys_);
+		UInt32 key_cursor = 0;
+		return GetVector(_time, this->scale_keys_, key_cursor);
 	}
 
 	const Quaternion TransformAnimNode::GetRotation(const float _time) const
 	{
-		Quaternion result;
-		result.Identity();
+		TransformAnimCursor cursor;
+		return GetRotation(_time, cursor);
+	}
 
-		const QuaternionKey* pPrevKey = NULL;
-		const QuaternionKey* pNextKey = NULL;
-		UInt32 keyIndex;
-		for(keyIndex=0;keyIndex<this->rotation_keys_.size();keyIndex++)
-		{
+	const Vector4 TransformAnimNode::GetTranslation(const float _time, TransformAnimCursor& cursor) const
+	{
+		return GetVector(_time, this->translation_keys_, cursor.translation_key);
+	}
 
-			if(this->rotation_keys_[keyIndex].time > _time)
-			{
-				pNextKey = &this->rotation_keys_[keyIndex];
+	const Vector4 TransformAnimNode::GetScale(const float _time, TransformAnimCursor& cursor) const
+	{
+		return GetVector(_time, this->scale_keys_, cursor.scale_key);
+	}
 
-				if(keyIndex > 0)
-					pPrevKey = &this->rotation_keys_[keyIndex-1];
+	const Quaternion TransformAnimNode::GetRotation(const float _time, TransformAnimCursor& cursor) const
+	{
+		Quaternion result;
+		result.Identity();
 
-				break;
-			}
-		}
+		if(this->rotation_keys_.empty())
+			return result;
 
-		if(keyIndex == this->rotation_keys_.size())
-		{
-			pNextKey =  &this->rotation_keys_[keyIndex-1];
-		}
+		cursor.rotation_key = FindNextKey(this->rotation_keys_, _time, cursor.rotation_key);
+		const UInt32 keyIndex = cursor.rotation_key;
 
-		if(pPrevKey)
+		// before the first key or after the last one the nearest key is used
+		if(keyIndex == 0)
+			result = this->rotation_keys_.front().value;
+		else if(keyIndex == this->rotation_keys_.size())
+			result = this->rotation_keys_.back().value;
+		else
 		{
-			if(pNextKey)
-			{
-				float t = (_time - pPrevKey->time) / (pNextKey->time - pPrevKey->time);
-				result.Slerp(pPrevKey->value, pNextKey->value, t);
-			}
-			else
-				result = pPrevKey->value;
+			const QuaternionKey& prevKey = this->rotation_keys_[keyIndex-1];
+			const QuaternionKey& nextKey = this->rotation_keys_[keyIndex];
+			float t = (_time - prevKey.time) / (nextKey.time - prevKey.time);
+			result.Slerp(prevKey.value, nextKey.value, t);
 		}
-		else if(pNextKey)
-				result = pNextKey->value;
 
 		return result;
 	}
 
-	const Vector4 TransformAnimNode::GetVector(float _time, const std::vector<Vector3Key>& _keys) const
+	const Vector4 TransformAnimNode::GetVector(float _time, const std::vector<Vector3Key>& _keys, UInt32& key_cursor) const
 	{
 		Vector4 result(0.f, 0.f, 0.f);
 
-		const Vector3Key* pPrevKey = NULL;
-		const Vector3Key* pNextKey = NULL;
-		UInt32 keyIndex;
-		for(keyIndex=0;keyIndex<_keys.size();keyIndex++)
-		{
-
-			if(_keys[keyIndex].time > _time)
-			{
-				pNextKey = &_keys[keyIndex];
-
-				if(keyIndex > 0)
-					pPrevKey = &_keys[keyIndex-1];
+		if(_keys.empty())
+			return result;
 
-				break;
-			}
-		}
+		key_cursor = FindNextKey(_keys, _time, key_cursor);
+		const UInt32 keyIndex = key_cursor;
 
-		if(keyIndex == _keys.size())
+		// before the first key or after the last one the nearest key is used
+		if(keyIndex == 0)
+			result = _keys.front().value;
+		else if(keyIndex == _keys.size())
+			result = _keys.back().value;
+		else
 		{
-			pNextKey =  &_keys[keyIndex-1];
+			const Vector3Key& prevKey = _keys[keyIndex-1];
+			const Vector3Key& nextKey = _keys[keyIndex];
+			float t = (_time - prevKey.time) / (nextKey.time - prevKey.time);
+			result.Lerp(prevKey.value, nextKey.value, t);
 		}
 
-		if(pPrevKey)
-		{
-			if(pNextKey)
-			{
-				float t = (_time - pPrevKey->time) / (pNextKey->time - pPrevKey->time);
-				result.Lerp(pPrevKey->value, pNextKey->value, t);
-			}
-			else
-				result = pPrevKey->value;
-		}
-		else if(pNextKey)
-			result = pNextKey->value;
-
 		return result;
 	}
 
@@ -246,40 +264,23 @@ namespace gef
 	{
 		float result = 0.0f;
 
-		const ChannelKey* pPrevKey = NULL;
-		const ChannelKey* pNextKey = NULL;
-		UInt32 keyIndex;
-		for(keyIndex=0;keyIndex<keys_.size();keyIndex++)
-		{
-
-			if(keys_[keyIndex].time > time)
-			{
-				pNextKey = &keys_[keyIndex];
-
-				if(keyIndex > 0)
-					pPrevKey = &keys_[keyIndex-1];
+		if(keys_.empty())
+			return result;
 
-				break;
-			}
-		}
+		const UInt32 keyIndex = FindNextKey(keys_, time, 0);
 
-		if(keyIndex == keys_.size())
-		{
-			pNextKey =  &keys_[keyIndex-1];
-		}
-
-		if(pPrevKey)
+		// before the first key or after the last one the nearest key is used
+		if(keyIndex == 0)
+			result = keys_.front().value;
+		else if(keyIndex == keys_.size())
+			result = keys_.back().value;
+		else
 		{
-			if(pNextKey)
-			{
-				float t = (time - pPrevKey->time) / (pNextKey->time - pPrevKey->time);
-				result = (1.0f - t)*pPrevKey->value +t*pNextKey->value;
-			}
-			else
-				result = pPrevKey->value;
+			const ChannelKey& prevKey = keys_[keyIndex-1];
+			const ChannelKey& nextKey = keys_[keyIndex];
+			float t = (time - prevKey.time) / (nextKey.time - prevKey.time);
+			result = (1.0f - t)*prevKey.value +t*nextKey.value;
 		}
-		else if(pNextKey)
-			result = pNextKey->value;
 
 		return result;
 	}
@@ -56,6 +56,24 @@ namespace gef
 		float time;
 	};
 
+	// The keys a TransformAnimNode was last sampled between, one for each set of keys.
+	// Keep one for each joint of a playing animation and pass it back in every time the
+	// joint is sampled. Each index is only a starting point for the search, so a cursor
+	// used with a different node or time just falls back to a binary search.
+	struct TransformAnimCursor
+	{
+		TransformAnimCursor() :
+			scale_key(0),
+			rotation_key(0),
+			translation_key(0)
+		{
+		}
+
+		UInt32 scale_key;
+		UInt32 rotation_key;
+		UInt32 translation_key;
+	};
+
 	class TransformAnimNode : public AnimNode
 	{
 	public:
@@ -66,6 +84,12 @@ namespace gef
 		const Vector4 GetScale(const float time) const;
 		const Quaternion GetRotation(const float time) const;
 
+		// the same as above, but the search for the keys starts from the cursor
+		// and the cursor is updated with the keys that were found
+		const Vector4 GetTranslation(const float time, TransformAnimCursor& cursor) const;
+		const Vector4 GetScale(const float time, TransformAnimCursor& cursor) const;
+		const Quaternion GetRotation(const float time, TransformAnimCursor& cursor) const;
+
 		inline const std::vector<Vector3Key>& scale_keys() const {return scale_keys_;}
 		inline std::vector<Vector3Key>& scale_keys() { return const_cast<std::vector<Vector3Key>&>(static_cast<const TransformAnimNode&>(*this).scale_keys()); }
 		inline const std::vector<QuaternionKey>& rotation_keys() const {return rotation_keys_;}
@@ -79,7 +103,7 @@ namespace gef
 		bool Write(std::ostream& stream) const;
 
 	private:
-		const Vector4 GetVector(const float _time, const std::vector<Vector3Key>& keys) const;
+		const Vector4 GetVector(const float _time, const std::vector<Vector3Key>& keys, UInt32& key_cursor) const;
 
 		std::vector<Vector3Key> scale_keys_;
 		std::vector<QuaternionKey> rotation_keys_;
@@ -0,0 +1,81 @@
+#include <animation/animation_binding.h>
+#include <animation/animation.h>
+#include <animation/skeleton.h>
+
+namespace gef
+{
+	AnimationBinding::AnimationBinding() :
+		skeleton_(NULL),
+		animation_(NULL)
+	{
+	}
+
+	void AnimationBinding::Bind(const Skeleton& skeleton, const Animation& animation)
+	{
+		skeleton_ = &skeleton;
+		animation_ = &animation;
+
+		joint_nodes_.assign(skeleton.joint_count(), NULL);
+		for(Int32 joint_index = 0; joint_index < skeleton.joint_count(); ++joint_index)
+		{
+			const AnimNode* anim_node = animation.FindNode(skeleton.joint(joint_index).name_id);
+			if(anim_node && anim_node->type() == AnimNode::kTransform)
+				joint_nodes_[joint_index] = static_cast<const TransformAnimNode*>(anim_node);
+		}
+	}
+
+	AnimationBindingCache::~AnimationBindingCache()
+	{
+		Clear();
+	}
+
+	const AnimationBinding& AnimationBindingCache::GetBinding(const Skeleton& skeleton, const Animation& animation)
+	{
+		const BindingKey key(&skeleton, &animation);
+		BindingMap::iterator binding_iter = bindings_.find(key);
+		if(binding_iter != bindings_.end())
+			return *binding_iter->second;
+
+		AnimationBinding* binding = new AnimationBinding();
+		binding->Bind(skeleton, animation);
+		bindings_[key] = binding;
+		return *binding;
+	}
+
+	void AnimationBindingCache::RemoveSkeleton(const Skeleton& skeleton)
+	{
+		BindingMap::iterator binding_iter = bindings_.begin();
+		while(binding_iter != bindings_.end())
+		{
+			if(binding_iter->first.first == &skeleton)
+			{
+				delete binding_iter->second;
+				bindings_.erase(binding_iter++);
+			}
+			else
+				++binding_iter;
+		}
+	}
+
+	void AnimationBindingCache::RemoveAnimation(const Animation& animation)
+	{
+		BindingMap::iterator binding_iter = bindings_.begin();
+		while(binding_iter != bindings_.end())
+		{
+			if(binding_iter->first.second == &animation)
+			{
+				delete binding_iter->second;
+				bindings_.erase(binding_iter++);
+			}
+			else
+				++binding_iter;
+		}
+	}
+
+	void AnimationBindingCache::Clear()
+	{
+		for(BindingMap::iterator binding_iter = bindings_.begin(); binding_iter != bindings_.end(); ++binding_iter)
+			delete binding_iter->second;
+		bindings_.clear();
+	}
+}
@@ -0,0 +1,65 @@
+#ifndef _GEF_ANIMATION_BINDING_H
+#define _GEF_ANIMATION_BINDING_H
+
+#include <gef.h>
+#include <vector>
+#include <map>
+#include <utility>
+
+namespace gef
+{
+	class Skeleton;
+	class Animation;
+	class TransformAnimNode;
+
+	// The node of an Animation that drives each joint of a Skeleton.
+	//
+	// Bind looks up every joint's node by name once, so playback can index
+	// the table by joint rather than search the clip's map every frame.
+	class AnimationBinding
+	{
+	public:
+		AnimationBinding();
+
+		void Bind(const Skeleton& skeleton, const Animation& animation);
+
+		// NULL for joints the clip doesn't animate
+		inline const TransformAnimNode* joint_node(const Int32 joint_index) const { return joint_nodes_[joint_index]; }
+		inline const std::vector<const TransformAnimNode*>& joint_nodes() const { return joint_nodes_; }
+		inline Int32 joint_count() const { return (Int32)joint_nodes_.size(); }
+
+		inline const Skeleton* skeleton() const { return skeleton_; }
+		inline const Animation* animation() const { return animation_; }
+
+	private:
+		std::vector<const TransformAnimNode*> joint_nodes_;
+		const Skeleton* skeleton_;
+		const Animation* animation_;
+	};
+
+	// Bindings shared by everything that plays the same clip on the same skeleton.
+	// Bindings hold pointers into the skeleton and clip, so remove them before
+	// either is deleted. Not thread safe, fetch bindings before handing work to other threads.
+	class AnimationBindingCache
+	{
+	public:
+		~AnimationBindingCache();
+
+		// binds the pair the first time it is asked for
+		const AnimationBinding& GetBinding(const Skeleton& skeleton, const Animation& animation);
+
+		void RemoveSkeleton(const Skeleton& skeleton);
+		void RemoveAnimation(const Animation& animation);
+		void Clear();
+
+		inline Int32 binding_count() const { return (Int32)bindings_.size(); }
+
+	private:
+		typedef std::pair<const Skeleton*, const Animation*> BindingKey;
+		typedef std::map<BindingKey, AnimationBinding*> BindingMap;
+
+		BindingMap bindings_;
+	};
+}
+
+#endif // _GEF_ANIMATION_BINDING_H
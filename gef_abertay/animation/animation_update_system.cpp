@@ -0,0 +1,150 @@
+#include <animation/animation_update_system.h>
+#include <animation/skeleton.h>
+#include <system/job_system.h>
+
+namespace gef
+{
+	AnimationUpdateSystem::AnimationUpdateSystem(JobSystem* job_system) :
+		job_system_(job_system)
+	{
+	}
+
+	Int32 AnimationUpdateSystem::AddInstance(const SkeletonPose& bind_pose)
+	{
+		Instance instance;
+		instance.bind_pose = &bind_pose;
+		for(Int32 layer = 0; layer < kMaxLayers; ++layer)
+		{
+			instance.layers[layer].binding = NULL;
+			instance.layers[layer].time = 0.0f;
+		}
+		instance.blend_weight = 0.0f;
+		instance.pose_transform.SetIdentity();
+		instance.has_pose_transform = false;
+		instance.active = true;
+		instance.first_joint = (UInt32)local_poses_.size();
+		instance.joint_count = bind_pose.skeleton() ? bind_pose.skeleton()->joint_count() : 0;
+
+		local_poses_.insert(local_poses_.end(), bind_pose.local_pose().begin(), bind_pose.local_pose().end());
+		blend_poses_.insert(blend_poses_.end(), bind_pose.local_pose().begin(), bind_pose.local_pose().end());
+		global_poses_.insert(global_poses_.end(), bind_pose.global_pose().begin(), bind_pose.global_pose().end());
+		skinning_matrices_.resize(skinning_matrices_.size() + instance.joint_count);
+		for(Int32 joint_num = 0; joint_num < instance.joint_count; ++joint_num)
+			skinning_matrices_[instance.first_joint + joint_num] = bind_pose.skeleton()->joint(joint_num).inv_bind_pose * bind_pose.global_pose()[joint_num];
+
+		instances_.push_back(instance);
+		return (Int32)instances_.size() - 1;
+	}
+
+	void AnimationUpdateSystem::RemoveAllInstances()
+	{
+		instances_.clear();
+		local_poses_.clear();
+		blend_poses_.clear();
+		global_poses_.clear();
+		skinning_matrices_.clear();
+		binding_cache_.Clear();
+	}
+
+	void AnimationUpdateSystem::SetClip(const Int32 instance_num, const Int32 layer_num, const Animation* clip)
+	{
+		Instance& instance = instances_[instance_num];
+		Layer& layer = instance.layers[layer_num];
+		const AnimationBinding* binding = clip && instance.joint_count > 0 ? &binding_cache_.GetBinding(*instance.bind_pose->skeleton(), *clip) : NULL;
+		if(layer.binding == binding)
+			return;
+
+		layer.binding = binding;
+		layer.cursors.assign(instance.joint_count, TransformAnimCursor());
+	}
+
+	void AnimationUpdateSystem::SetTime(const Int32 instance, const Int32 layer, const float time)
+	{
+		instances_[instance].layers[layer].time = time;
+	}
+
+	void AnimationUpdateSystem::SetBlendWeight(const Int32 instance, const float blend_weight)
+	{
+		instances_[instance].blend_weight = blend_weight;
+	}
+
+	void AnimationUpdateSystem::SetPoseTransform(const Int32 instance, const Matrix44& pose_transform)
+	{
+		instances_[instance].pose_transform = pose_transform;
+		instances_[instance].has_pose_transform = true;
+	}
+
+	void AnimationUpdateSystem::SetActive(const Int32 instance, const bool active)
+	{
+		instances_[instance].active = active;
+	}
+
+	void AnimationUpdateSystem::Update()
+	{
+		// a few characters for each range, so a range is enough work to be worth handing to a worker
+		const Int32 instances_per_range = 4;
+		if(job_system_)
+			job_system_->ParallelFor((Int32)instances_.size(), instances_per_range, UpdateInstances, this);
+		else
+			UpdateInstances(this, 0, (Int32)instances_.size());
+	}
+
+	void AnimationUpdateSystem::UpdateInstances(void* user_data, const Int32 begin, const Int32 end)
+	{
+		AnimationUpdateSystem* update_system = static_cast<AnimationUpdateSystem*>(user_data);
+		for(Int32 instance_num = begin; instance_num < end; ++instance_num)
+		{
+			Instance& instance = update_system->instances_[instance_num];
+			if(instance.active && instance.joint_count > 0)
+				update_system->UpdateInstance(instance);
+		}
+	}
+
+	void AnimationUpdateSystem::UpdateInstance(Instance& instance)
+	{
+		const JointPose* bind_pose = &instance.bind_pose->local_pose().front();
+		JointPose* local_pose = &local_poses_[instance.first_joint];
+		Matrix44* global_pose = &global_poses_[instance.first_joint];
+		Matrix44* skinning_matrices = &skinning_matrices_[instance.first_joint];
+
+		SampleLayer(instance.layers[0], instance.joint_count, bind_pose, local_pose);
+
+		if(instance.blend_weight > 0.0f)
+		{
+			JointPose* blend_pose = &blend_poses_[instance.first_joint];
+			SampleLayer(instance.layers[1], instance.joint_count, bind_pose, blend_pose);
+			for(Int32 joint_num = 0; joint_num < instance.joint_count; ++joint_num)
+				local_pose[joint_num].Linear2TransformBlend(local_pose[joint_num], blend_pose[joint_num], instance.blend_weight);
+		}
+
+		// parents always come before their children, so the parent's global pose is ready
+		const std::vector<Joint>& joints = instance.bind_pose->skeleton()->joints();
+		for(Int32 joint_num = 0; joint_num < instance.joint_count; ++joint_num)
+		{
+			const Joint& joint = joints[joint_num];
+			if(joint.parent == -1)
+			{
+				global_pose[joint_num] = local_pose[joint_num].GetMatrix();
+				if(instance.has_pose_transform)
+					global_pose[joint_num] = global_pose[joint_num] * instance.pose_transform;
+			}
+			else
+				global_pose[joint_num] = local_pose[joint_num].GetMatrix() * global_pose[joint.parent];
+
+			skinning_matrices[joint_num] = joint.inv_bind_pose * global_pose[joint_num];
+		}
+	}
+
+	void AnimationUpdateSystem::SampleLayer(Layer& layer, const Int32 joint_count, const JointPose* bind_pose, JointPose* pose) const
+	{
+		if(!layer.binding)
+		{
+			for(Int32 joint_num = 0; joint_num < joint_count; ++joint_num)
+				pose[joint_num] = bind_pose[joint_num];
+			return;
+		}
+
+		for(Int32 joint_num = 0; joint_num < joint_count; ++joint_num)
+			SkeletonPose::SampleJointPose(layer.binding->joint_node(joint_num), bind_pose[joint_num], layer.time, layer.cursors[joint_num], pose[joint_num]);
+	}
+}
@@ -0,0 +1,101 @@
+#ifndef _GEF_ANIMATION_UPDATE_SYSTEM_H
+#define _GEF_ANIMATION_UPDATE_SYSTEM_H
+
+#include <gef.h>
+#include <maths/matrix44.h>
+#include <animation/joint.h>
+#include <animation/animation.h>
+#include <animation/animation_binding.h>
+#include <vector>
+
+namespace gef
+{
+	class SkeletonPose;
+	class JobSystem;
+
+	// Poses every animated character in one batch each frame.
+	//
+	// Each instance samples up to kMaxLayers clips, blends them, then works out
+	// its global pose and skinning matrices. Instances are independent, so Update
+	// spreads them over the workers of a JobSystem. The joints of all instances
+	// are packed end to end in shared buffers that are only resized by
+	// AddInstance, so a frame's update doesn't allocate, and the skinning matrices
+	// of an instance can be passed straight to Renderer3D::DrawSkinnedMesh.
+	class AnimationUpdateSystem
+	{
+	public:
+		// clips sampled and blended for each instance
+		static const Int32 kMaxLayers = 2;
+
+		// job_system can be NULL to update every instance on the calling thread
+		AnimationUpdateSystem(JobSystem* job_system = NULL);
+
+		// adds a character posed with the skeleton of bind_pose and returns its index
+		// bind_pose is used until the instance is removed, so it must stay alive
+		// the matrix buffers grow, so pointers returned for other instances are no longer valid
+		Int32 AddInstance(const SkeletonPose& bind_pose);
+		// also removes the bindings, so clips and skeletons can be deleted after
+		void RemoveAllInstances();
+
+		// the clip is bound to the instance's skeleton through binding_cache(), so the nodes
+		// aren't looked up every frame. A NULL clip leaves the layer in the bind pose
+		void SetClip(const Int32 instance, const Int32 layer, const Animation* clip);
+		void SetTime(const Int32 instance, const Int32 layer, const float time);
+		// how far to blend from layer 0 towards layer 1, layer 1 isn't sampled at 0
+		void SetBlendWeight(const Int32 instance, const float blend_weight);
+		// applied to the root joints, the same as the pose_transform of SkeletonPose::CalculateGlobalPose
+		void SetPoseTransform(const Int32 instance, const Matrix44& pose_transform);
+		// inactive instances keep the pose from their last update
+		void SetActive(const Int32 instance, const bool active);
+
+		// samples, blends and poses every active instance
+		void Update();
+
+		// bindings for the clips that have been set, shared by instances with the same skeleton
+		inline AnimationBindingCache& binding_cache() { return binding_cache_; }
+
+		inline Int32 instance_count() const { return (Int32)instances_.size(); }
+		inline Int32 joint_count(const Int32 instance) const { return instances_[instance].joint_count; }
+		inline const JointPose* local_pose(const Int32 instance) const { return &local_poses_[instances_[instance].first_joint]; }
+		inline const Matrix44* global_pose(const Int32 instance) const { return &global_poses_[instances_[instance].first_joint]; }
+		// inverse bind pose * global pose for each joint, the bone matrices for skinning
+		inline const Matrix44* skinning_matrices(const Int32 instance) const { return &skinning_matrices_[instances_[instance].first_joint]; }
+
+	private:
+		struct Layer
+		{
+			// NULL when the layer has no clip
+			const AnimationBinding* binding;
+			float time;
+			std::vector<TransformAnimCursor> cursors;
+		};
+
+		struct Instance
+		{
+			const SkeletonPose* bind_pose;
+			Layer layers[kMaxLayers];
+			float blend_weight;
+			Matrix44 pose_transform;
+			bool has_pose_transform;
+			bool active;
+			UInt32 first_joint;
+			Int32 joint_count;
+		};
+
+		static void UpdateInstances(void* user_data, const Int32 begin, const Int32 end);
+		void UpdateInstance(Instance& instance);
+		void SampleLayer(Layer& layer, const Int32 joint_count, const JointPose* bind_pose, JointPose* pose) const;
+
+		JobSystem* job_system_;
+		AnimationBindingCache binding_cache_;
+		std::vector<Instance> instances_;
+
+		// one entry for each joint of every instance, starting at Instance::first_joint
+		std::vector<JointPose> local_poses_;
+		std::vector<JointPose> blend_poses_;
+		std::vector<Matrix44> global_poses_;
+		std::vector<Matrix44> skinning_matrices_;
+	};
+}
+
+#endif // _GEF_ANIMATION_UPDATE_SYSTEM_H
@@ -0,0 +1,327 @@
+#include <animation/blend_tree.h>
+#include <animation/animation_binding.h>
+#include <animation/pose_pool.h>
+#include <animation/skeleton.h>
+#include <math.h>
+
+namespace gef
+{
+	// normalised lerp along the shorter path
+	static const Quaternion BlendRotation(const Quaternion& start, const Quaternion& end, const float time)
+	{
+		const float dot = start.x*end.x + start.y*end.y + start.z*end.z + start.w*end.w;
+		Quaternion result = start*(1.0f-time) + end*(dot < 0.0f ? -time : time);
+		result.Normalise();
+		return result;
+	}
+
+	// moves pose time of the way towards target
+	static void BlendJointPose(JointPose& pose, const JointPose& target, const float time)
+	{
+		Vector4 scale, translation;
+		scale.Lerp(pose.scale(), target.scale(), time);
+		translation.Lerp(pose.translation(), target.translation(), time);
+		pose.set_scale(scale);
+		pose.set_rotation(BlendRotation(pose.rotation(), target.rotation(), time));
+		pose.set_translation(translation);
+	}
+
+	BlendTree::BlendTree(const SkeletonPose& bind_pose) :
+		bind_pose_(bind_pose),
+		joint_count_((Int32)bind_pose.local_pose().size()),
+		root_(-1)
+	{
+	}
+
+	Int32 BlendTree::AddNode(const NodeType type)
+	{
+		Node node;
+		node.type = type;
+		node.binding = NULL;
+		node.time = 0.0f;
+		node.playback_speed = 1.0f;
+		node.looping = true;
+		node.base = -1;
+		node.layer = -1;
+		node.reference = kBindPose;
+		node.mask = kNoMask;
+		node.weight = 1.0f;
+		nodes_.push_back(node);
+
+		// the last node added is the root until another is chosen
+		root_ = (Int32)nodes_.size() - 1;
+		return root_;
+	}
+
+	Int32 BlendTree::AddClip(const AnimationBinding& binding, const bool looping)
+	{
+		const Int32 clip = AddNode(kClip);
+		nodes_[clip].binding = &binding;
+		nodes_[clip].looping = looping;
+		nodes_[clip].cursors.resize(joint_count_);
+		return clip;
+	}
+
+	Int32 BlendTree::AddBlend()
+	{
+		return AddNode(kBlend);
+	}
+
+	Int32 BlendTree::AddBlendInput(const Int32 blend, const Int32 input, const float weight)
+	{
+		BlendInput blend_input;
+		blend_input.node = input;
+		blend_input.weight = weight;
+		nodes_[blend].inputs.push_back(blend_input);
+		return (Int32)nodes_[blend].inputs.size() - 1;
+	}
+
+	Int32 BlendTree::AddLayer(const Int32 base, const Int32 layer, const Int32 mask)
+	{
+		const Int32 node = AddNode(kLayer);
+		nodes_[node].base = base;
+		nodes_[node].layer = layer;
+		nodes_[node].mask = mask;
+		return node;
+	}
+
+	Int32 BlendTree::AddAdditive(const Int32 base, const Int32 additive, const Int32 reference, const Int32 mask)
+	{
+		const Int32 node = AddNode(kAdditive);
+		nodes_[node].base = base;
+		nodes_[node].layer = additive;
+		nodes_[node].reference = reference;
+		nodes_[node].mask = mask;
+		return node;
+	}
+
+	Int32 BlendTree::AddMask(const std::vector<float>& joint_weights)
+	{
+		masks_.push_back(joint_weights);
+		masks_.back().resize(joint_count_, 0.0f);
+		return (Int32)masks_.size() - 1;
+	}
+
+	Int32 BlendTree::AddJointMask(const StringId root_joint_name, const float weight)
+	{
+		std::vector<float> joint_weights(joint_count_, 0.0f);
+
+		// parents always come before their children, so one pass finds every joint below the root
+		const Skeleton* skeleton = bind_pose_.skeleton();
+		const Int32 root_joint = skeleton ? skeleton->FindJointIndex(root_joint_name) : -1;
+		if(root_joint != -1)
+		{
+			joint_weights[root_joint] = weight;
+			for(Int32 joint_index = root_joint + 1; joint_index < joint_count_; ++joint_index)
+			{
+				const Int32 parent = skeleton->joint(joint_index).parent;
+				if(parent >= root_joint && joint_weights[parent] != 0.0f)
+					joint_weights[joint_index] = weight;
+			}
+		}
+
+		return AddMask(joint_weights);
+	}
+
+	void BlendTree::SetClipTime(const Int32 clip, const float time)
+	{
+		nodes_[clip].time = time;
+	}
+
+	float BlendTree::GetClipTime(const Int32 clip) const
+	{
+		return nodes_[clip].time;
+	}
+
+	void BlendTree::SetPlaybackSpeed(const Int32 clip, const float playback_speed)
+	{
+		nodes_[clip].playback_speed = playback_speed;
+	}
+
+	void BlendTree::SetBlendInputWeight(const Int32 blend, const Int32 input, const float weight)
+	{
+		nodes_[blend].inputs[input].weight = weight;
+	}
+
+	void BlendTree::SetWeight(const Int32 node, const float weight)
+	{
+		nodes_[node].weight = weight;
+	}
+
+	void BlendTree::Update(const float delta_time)
+	{
+		for(std::vector<Node>::iterator node = nodes_.begin(); node != nodes_.end(); ++node)
+		{
+			if(node->type != kClip)
+				continue;
+
+			const float duration = node->binding->animation()->duration();
+			node->time += delta_time*node->playback_speed;
+			if(node->looping && duration > 0.0f)
+			{
+				node->time = fmodf(node->time, duration);
+				if(node->time < 0.0f)
+					node->time += duration;
+			}
+			else if(node->time > duration)
+				node->time = duration;
+			else if(node->time < 0.0f)
+				node->time = 0.0f;
+		}
+	}
+
+	void BlendTree::Evaluate(PosePool& pool, SkeletonPose& pose)
+	{
+		JointPose* local_pose = &pose.local_pose().front();
+		if(root_ == -1)
+		{
+			for(Int32 joint_index = 0; joint_index < joint_count_; ++joint_index)
+				local_pose[joint_index] = bind_pose_.local_pose()[joint_index];
+		}
+		else
+			EvaluateNode(root_, pool, local_pose);
+
+		pose.CalculateGlobalPose();
+	}
+
+	void BlendTree::EvaluateNode(const Int32 node_index, PosePool& pool, JointPose* pose)
+	{
+		Node& node = nodes_[node_index];
+		const JointPose* bind_pose = &bind_pose_.local_pose().front();
+
+		switch(node.type)
+		{
+		case kClip:
+			{
+				const float time = node.time + node.binding->animation()->start_time();
+				for(Int32 joint_index = 0; joint_index < joint_count_; ++joint_index)
+					SkeletonPose::SampleJointPose(node.binding->joint_node(joint_index), bind_pose[joint_index], time, node.cursors[joint_index], pose[joint_index]);
+			}
+			break;
+
+		case kBlend:
+			{
+				// a running weighted average, each input is blended in by its share of the weight so far
+				// inputs with no weight aren't evaluated
+				float total_weight = 0.0f;
+				JointPose* input_pose = NULL;
+				for(std::vector<BlendInput>::const_iterator input = node.inputs.begin(); input != node.inputs.end(); ++input)
+				{
+					if(input->weight <= 0.0f)
+						continue;
+
+					if(total_weight == 0.0f)
+						EvaluateNode(input->node, pool, pose);
+					else
+					{
+						if(!input_pose)
+							input_pose = pool.Acquire();
+						EvaluateNode(input->node, pool, input_pose);
+
+						const float blend = input->weight / (total_weight + input->weight);
+						for(Int32 joint_index = 0; joint_index < joint_count_; ++joint_index)
+							BlendJointPose(pose[joint_index], input_pose[joint_index], blend);
+					}
+					total_weight += input->weight;
+				}
+
+				if(total_weight == 0.0f)
+				{
+					for(Int32 joint_index = 0; joint_index < joint_count_; ++joint_index)
+						pose[joint_index] = bind_pose[joint_index];
+				}
+			}
+			break;
+
+		case kLayer:
+			{
+				EvaluateNode(node.base, pool, pose);
+				if(node.weight <= 0.0f)
+					break;
+
+				JointPose* layer_pose = pool.Acquire();
+				EvaluateNode(node.layer, pool, layer_pose);
+				for(Int32 joint_index = 0; joint_index < joint_count_; ++joint_index)
+				{
+					const float weight = node.weight*MaskWeight(node.mask, joint_index);
+					if(weight > 0.0f)
+						BlendJointPose(pose[joint_index], layer_pose[joint_index], weight);
+				}
+			}
+			break;
+
+		case kAdditive:
+			{
+				EvaluateNode(node.base, pool, pose);
+				if(node.weight <= 0.0f)
+					break;
+
+				JointPose* additive_pose = pool.Acquire();
+				EvaluateNode(node.layer, pool, additive_pose);
+
+				const JointPose* reference_pose = bind_pose;
+				if(node.reference != kBindPose)
+				{
+					JointPose* evaluated_reference_pose = pool.Acquire();
+					EvaluateNode(node.reference, pool, evaluated_reference_pose);
+					reference_pose = evaluated_reference_pose;
+				}
+
+				Quaternion identity;
+				identity.Identity();
+				for(Int32 joint_index = 0; joint_index < joint_count_; ++joint_index)
+				{
+					const float weight = node.weight*MaskWeight(node.mask, joint_index);
+					if(weight <= 0.0f)
+						continue;
+
+					// the change from the reference pose to the additive pose, scaled by the weight
+					Quaternion inverse_reference_rotation;
+					inverse_reference_rotation.Conjugate(reference_pose[joint_index].rotation());
+					const Quaternion delta_rotation = BlendRotation(identity, inverse_reference_rotation * additive_pose[joint_index].rotation(), weight);
+
+					JointPose& joint_pose = pose[joint_index];
+					joint_pose.set_rotation(joint_pose.rotation() * delta_rotation);
+					joint_pose.set_translation(joint_pose.translation() + (additive_pose[joint_index].translation() - reference_pose[joint_index].translation()) * weight);
+					joint_pose.set_scale(joint_pose.scale() + (additive_pose[joint_index].scale() - reference_pose[joint_index].scale()) * weight);
+				}
+			}
+			break;
+		}
+	}
+
+	Int32 BlendTree::PoolPosesNeeded() const
+	{
+		return root_ == -1 ? 0 : PoolPosesNeeded(root_);
+	}
+
+	Int32 BlendTree::PoolPosesNeeded(const Int32 node_index) const
+	{
+		const Node& node = nodes_[node_index];
+		Int32 poses_needed = 0;
+		switch(node.type)
+		{
+		case kClip:
+			break;
+
+		case kBlend:
+			for(std::vector<BlendInput>::const_iterator input = node.inputs.begin(); input != node.inputs.end(); ++input)
+				poses_needed += PoolPosesNeeded(input->node);
+			if(node.inputs.size() > 1)
+				poses_needed += 1;
+			break;
+
+		case kLayer:
+			poses_needed = PoolPosesNeeded(node.base) + PoolPosesNeeded(node.layer) + 1;
+			break;
+
+		case kAdditive:
+			poses_needed = PoolPosesNeeded(node.base) + PoolPosesNeeded(node.layer) + 1;
+			if(node.reference != kBindPose)
+				poses_needed += PoolPosesNeeded(node.reference) + 1;
+			break;
+		}
+
+		return poses_needed;
+	}
+}
@@ -0,0 +1,124 @@
+#ifndef _GEF_BLEND_TREE_H
+#define _GEF_BLEND_TREE_H
+
+#include <gef.h>
+#include <animation/joint.h>
+#include <animation/animation.h>
+#include <system/string_id.h>
+#include <vector>
+
+namespace gef
+{
+	class SkeletonPose;
+	class AnimationBinding;
+	class PosePool;
+
+	// A tree of clips and blends that poses one skeleton.
+	//
+	// The tree is built once from nodes:
+	//  - clip: samples an animation, bound to the skeleton up front
+	//  - blend: a weighted average of any number of inputs
+	//  - layer: blends an input over a base, per joint through a mask
+	//  - additive: adds the difference between an input and a reference pose to a base
+	//
+	// Every node writes its result into a local pose it is given. Nodes that need
+	// somewhere to put the results of their inputs take it from a PosePool, so
+	// evaluating the tree doesn't allocate. Rotations are blended with a
+	// normalised lerp.
+	class BlendTree
+	{
+	public:
+		// for the reference of an additive node, the pose the additive clip is relative to
+		static const Int32 kBindPose = -1;
+		// for a mask, every joint at full weight
+		static const Int32 kNoMask = -1;
+
+		// bind_pose is used while the tree is, so it must stay alive
+		BlendTree(const SkeletonPose& bind_pose);
+
+		// binding must be for this tree's skeleton and last as long as the tree
+		Int32 AddClip(const AnimationBinding& binding, const bool looping = true);
+		Int32 AddBlend();
+		// returns the index of the input in the blend
+		Int32 AddBlendInput(const Int32 blend, const Int32 input, const float weight);
+		Int32 AddLayer(const Int32 base, const Int32 layer, const Int32 mask = kNoMask);
+		Int32 AddAdditive(const Int32 base, const Int32 additive, const Int32 reference = kBindPose, const Int32 mask = kNoMask);
+
+		// a weight for each joint of the skeleton, returns the mask index
+		Int32 AddMask(const std::vector<float>& joint_weights);
+		// weight for the named joint and all the joints below it, 0 for the rest
+		Int32 AddJointMask(const StringId root_joint_name, const float weight = 1.0f);
+
+		inline void set_root(const Int32 root) { root_ = root; }
+		inline Int32 root() const { return root_; }
+
+		// clip nodes
+		void SetClipTime(const Int32 clip, const float time);
+		float GetClipTime(const Int32 clip) const;
+		void SetPlaybackSpeed(const Int32 clip, const float playback_speed);
+		// blend nodes
+		void SetBlendInputWeight(const Int32 blend, const Int32 input, const float weight);
+		// layer and additive nodes, 0 leaves the base as it is
+		void SetWeight(const Int32 node, const float weight);
+
+		// moves the playback time of every clip node on
+		void Update(const float delta_time);
+
+		// sets the local pose from the root node, then the global pose
+		// pose must have been created from this tree's skeleton, pool is reset by the caller once a frame
+		void Evaluate(PosePool& pool, SkeletonPose& pose);
+
+		// the poses Evaluate takes from the pool, for sizing it
+		Int32 PoolPosesNeeded() const;
+
+	private:
+		enum NodeType
+		{
+			kClip = 0,
+			kBlend,
+			kLayer,
+			kAdditive
+		};
+
+		struct BlendInput
+		{
+			Int32 node;
+			float weight;
+		};
+
+		struct Node
+		{
+			NodeType type;
+
+			// clip
+			const AnimationBinding* binding;
+			float time;
+			float playback_speed;
+			bool looping;
+			std::vector<TransformAnimCursor> cursors;
+
+			// blend
+			std::vector<BlendInput> inputs;
+
+			// layer and additive
+			Int32 base;
+			Int32 layer;
+			Int32 reference;
+			Int32 mask;
+			float weight;
+		};
+
+		Int32 AddNode(const NodeType type);
+		void EvaluateNode(const Int32 node_index, PosePool& pool, JointPose* pose);
+		Int32 PoolPosesNeeded(const Int32 node_index) const;
+		inline float MaskWeight(const Int32 mask, const Int32 joint_index) const { return mask == kNoMask ? 1.0f : masks_[mask][joint_index]; }
+
+		const SkeletonPose& bind_pose_;
+		Int32 joint_count_;
+		std::vector<Node> nodes_;
+		std::vector<std::vector<float> > masks_;
+		Int32 root_;
+	};
+}
+
+#endif // _GEF_BLEND_TREE_H
@@ -0,0 +1,535 @@
+#include <animation/compressed_animation.h>
+#include <animation/animation.h>
+#include <animation/skeleton.h>
+#include <maths/simd.h>
+#include <system/memory_stream_buffer.h>
+#include <algorithm>
+#include <cmath>
+
+namespace gef
+{
+	static const float kSqrt2 = 1.41421356f;
+	static const float kTicksPerRange = 65535.0f;
+	static const float kRotationSteps = 32767.0f;
+
+	// interpolation parameter for time between two keys, 0 if the keys are at the same time
+	static float KeyFraction(const float start_time, const float end_time, const float time)
+	{
+		return end_time > start_time ? (time - start_time) / (end_time - start_time) : 0.0f;
+	}
+
+	static float VectorKeyError(const Vector3Key& start, const Vector3Key& end, const Vector3Key& key)
+	{
+		Vector4 value;
+		value.Lerp(start.value, end.value, KeyFraction(start.time, end.time, key.time));
+
+		float error = 0.0f;
+		for(int component = 0; component < 3; ++component)
+			error = std::max(error, fabsf(value[component] - key.value[component]));
+		return error;
+	}
+
+	static float RotationError(const Quaternion& a, const Quaternion& b)
+	{
+		// q and -q are the same rotation
+		const float same_sign = std::max(std::max(fabsf(a.x - b.x), fabsf(a.y - b.y)), std::max(fabsf(a.z - b.z), fabsf(a.w - b.w)));
+		const float opposite_sign = std::max(std::max(fabsf(a.x + b.x), fabsf(a.y + b.y)), std::max(fabsf(a.z + b.z), fabsf(a.w + b.w)));
+		return std::min(same_sign, opposite_sign);
+	}
+
+	// Normalised lerp between two rotations along the shorter path. Keys left after
+	// reduction are close together, so this is near enough to a slerp, and the key
+	// reduction measures its error with this as well. It needs no trig functions.
+	static const Quaternion NlerpRotation(const Quaternion& start, const Quaternion& end, const float time)
+	{
+		Quaternion result;
+#if defined(GEF_SIMD)
+		const simd::Float4 start_values = simd::Load(&start.x);
+		const simd::Float4 end_values = simd::Load(&end.x);
+		const float end_weight = simd::Dot4(start_values, end_values) < 0.0f ? -time : time;
+		const simd::Float4 values = simd::MulAdd(simd::Splat(1.0f-time), start_values, simd::Mul(simd::Splat(end_weight), end_values));
+		const float length_sqr = simd::Dot4(values, values);
+		simd::Store(&result.x, simd::Mul(values, simd::Splat(1.0f / sqrtf(length_sqr))));
+#else
+		const float dot = start.x*end.x + start.y*end.y + start.z*end.z + start.w*end.w;
+		const float end_weight = dot < 0.0f ? -time : time;
+		result = start*(1.0f-time) + end*end_weight;
+		result.Normalise();
+#endif
+		return result;
+	}
+
+	static float RotationKeyError(const QuaternionKey& start, const QuaternionKey& end, const QuaternionKey& key)
+	{
+		return RotationError(NlerpRotation(start.value, end.value, KeyFraction(start.time, end.time, key.time)), key.value);
+	}
+
+	// Pick the keys to keep: the first and last keys, and any key needed so that every
+	// removed key is within tolerance of the interpolation between the kept keys either
+	// side of it. A channel that never moves further than the tolerance keeps one key.
+	template <typename Key, typename KeyError>
+	static void ReduceKeys(const std::vector<Key>& keys, KeyError key_error, const float tolerance, std::vector<UInt32>& kept_keys)
+	{
+		kept_keys.clear();
+		if(keys.empty())
+			return;
+
+		bool constant = true;
+		for(UInt32 key = 1; key < keys.size() && constant; ++key)
+			constant = key_error(keys[0], keys[0], keys[key]) <= tolerance;
+
+		kept_keys.push_back(0);
+		if(constant)
+			return;
+
+		UInt32 anchor = 0;
+		for(UInt32 end = anchor+2; end < keys.size(); ++end)
+		{
+			bool fits = true;
+			for(UInt32 key = anchor+1; key < end && fits; ++key)
+				fits = key_error(keys[anchor], keys[end], keys[key]) <= tolerance;
+
+			if(!fits)
+			{
+				anchor = end-1;
+				kept_keys.push_back(anchor);
+			}
+		}
+		kept_keys.push_back((UInt32)keys.size()-1);
+	}
+
+	CompressedAnimation::CompressedAnimation() :
+		duration_(0.0f),
+		start_time_(0.0f),
+		end_time_(0.0f),
+		tick_start_(0.0f),
+		tick_length_(0.0f),
+		name_id_(0)
+	{
+	}
+
+	void CompressedAnimation::Compress(const Animation& animation, const Settings& settings)
+	{
+		track_name_ids_.clear();
+		tracks_.clear();
+		key_ticks_.clear();
+		key_values_.clear();
+
+		name_id_ = animation.name_id();
+		start_time_ = animation.start_time();
+		end_time_ = animation.end_time();
+		duration_ = animation.duration();
+
+		// the ticks cover the times of every key in the clip
+		float first_key_time = 0.0f;
+		float last_key_time = 0.0f;
+		bool found_key = false;
+		for(std::map<StringId, AnimNode*>::const_iterator anim_node_iter = animation.anim_nodes().begin(); anim_node_iter != animation.anim_nodes().end(); ++anim_node_iter)
+		{
+			if(anim_node_iter->second->type() != AnimNode::kTransform)
+				continue;
+
+			const TransformAnimNode* transform_node = static_cast<const TransformAnimNode*>(anim_node_iter->second);
+			const float channel_times[kNumChannelTypes][2] =
+			{
+				{ transform_node->rotation_keys().empty() ? 0.0f : transform_node->rotation_keys().front().time, transform_node->rotation_keys().empty() ? 0.0f : transform_node->rotation_keys().back().time },
+				{ transform_node->translation_keys().empty() ? 0.0f : transform_node->translation_keys().front().time, transform_node->translation_keys().empty() ? 0.0f : transform_node->translation_keys().back().time },
+				{ transform_node->scale_keys().empty() ? 0.0f : transform_node->scale_keys().front().time, transform_node->scale_keys().empty() ? 0.0f : transform_node->scale_keys().back().time },
+			};
+			const bool channel_has_keys[kNumChannelTypes] = { !transform_node->rotation_keys().empty(), !transform_node->translation_keys().empty(), !transform_node->scale_keys().empty() };
+
+			for(int channel_type = 0; channel_type < kNumChannelTypes; ++channel_type)
+			{
+				if(!channel_has_keys[channel_type])
+					continue;
+
+				if(!found_key || channel_times[channel_type][0] < first_key_time)
+					first_key_time = channel_times[channel_type][0];
+				if(!found_key || channel_times[channel_type][1] > last_key_time)
+					last_key_time = channel_times[channel_type][1];
+				found_key = true;
+			}
+		}
+		tick_start_ = first_key_time;
+		tick_length_ = last_key_time > first_key_time ? (last_key_time - first_key_time) / kTicksPerRange : 0.0f;
+
+		// the nodes are already sorted by name in the map
+		for(std::map<StringId, AnimNode*>::const_iterator anim_node_iter = animation.anim_nodes().begin(); anim_node_iter != animation.anim_nodes().end(); ++anim_node_iter)
+		{
+			if(anim_node_iter->second->type() != AnimNode::kTransform)
+				continue;
+
+			const TransformAnimNode* transform_node = static_cast<const TransformAnimNode*>(anim_node_iter->second);
+
+			Track track;
+			AddRotationChannel(track.channels[kRotation], transform_node->rotation_keys(), settings.rotation_tolerance);
+			AddVectorChannel(track.channels[kTranslation], transform_node->translation_keys(), settings.translation_tolerance);
+			AddVectorChannel(track.channels[kScale], transform_node->scale_keys(), settings.scale_tolerance);
+
+			track_name_ids_.push_back(anim_node_iter->first);
+			tracks_.push_back(track);
+		}
+	}
+
+	void CompressedAnimation::AddVectorChannel(Channel& channel, const std::vector<Vector3Key>& keys, const float tolerance)
+	{
+		std::vector<UInt32> kept_keys;
+		ReduceKeys(keys, VectorKeyError, tolerance, kept_keys);
+
+		channel.first_key = (UInt32)key_ticks_.size();
+		channel.num_keys = (UInt32)kept_keys.size();
+
+		// the range of the kept keys
+		for(int component = 0; component < 3; ++component)
+		{
+			float minimum = 0.0f;
+			float maximum = 0.0f;
+			for(UInt32 kept_key = 0; kept_key < kept_keys.size(); ++kept_key)
+			{
+				const float value = keys[kept_keys[kept_key]].value[component];
+				if(kept_key == 0 || value < minimum)
+					minimum = value;
+				if(kept_key == 0 || value > maximum)
+					maximum = value;
+			}
+			channel.minimum[component] = minimum;
+			channel.scale[component] = (maximum - minimum) / kTicksPerRange;
+		}
+
+		for(UInt32 kept_key = 0; kept_key < kept_keys.size(); ++kept_key)
+		{
+			const Vector3Key& key = keys[kept_keys[kept_key]];
+			key_ticks_.push_back(TimeToTick(key.time));
+			for(int component = 0; component < 3; ++component)
+			{
+				float value = 0.0f;
+				if(channel.scale[component] > 0.0f)
+					value = floorf((key.value[component] - channel.minimum[component]) / channel.scale[component] + 0.5f);
+				key_values_.push_back((UInt16)std::min(std::max(value, 0.0f), kTicksPerRange));
+			}
+		}
+	}
+
+	void CompressedAnimation::AddRotationChannel(Channel& channel, const std::vector<QuaternionKey>& keys, const float tolerance)
+	{
+		std::vector<UInt32> kept_keys;
+		ReduceKeys(keys, RotationKeyError, tolerance, kept_keys);
+
+		channel.first_key = (UInt32)key_ticks_.size();
+		channel.num_keys = (UInt32)kept_keys.size();
+		for(int component = 0; component < 3; ++component)
+		{
+			channel.minimum[component] = 0.0f;
+			channel.scale[component] = 0.0f;
+		}
+
+		for(UInt32 kept_key = 0; kept_key < kept_keys.size(); ++kept_key)
+		{
+			const QuaternionKey& key = keys[kept_keys[kept_key]];
+			key_ticks_.push_back(TimeToTick(key.time));
+
+			UInt16 values[3];
+			QuantiseRotation(key.value, values);
+			key_values_.insert(key_values_.end(), values, values+3);
+		}
+	}
+
+	void CompressedAnimation::QuantiseRotation(const Quaternion& rotation, UInt16* values)
+	{
+		Quaternion normalised = rotation;
+		normalised.Normalise();
+		float components[4] = { normalised.x, normalised.y, normalised.z, normalised.w };
+
+		// the largest component is left out and rebuilt from the others
+		// flip the quaternion so it is positive, then the others are all within +-1/sqrt(2)
+		int largest = 0;
+		for(int component = 1; component < 4; ++component)
+		{
+			if(fabsf(components[component]) > fabsf(components[largest]))
+				largest = component;
+		}
+		const float sign = components[largest] < 0.0f ? -1.0f : 1.0f;
+
+		int value_index = 0;
+		for(int component = 0; component < 4; ++component)
+		{
+			if(component == largest)
+				continue;
+
+			const float value = floorf((sign*components[component]*kSqrt2*0.5f + 0.5f) * kRotationSteps + 0.5f);
+			values[value_index++] = (UInt16)std::min(std::max(value, 0.0f), kRotationSteps);
+		}
+
+		// 15 bits for each value, the top bits of the first two hold the index of the largest component
+		values[0] |= (UInt16)((largest & 1) << 15);
+		values[1] |= (UInt16)((largest >> 1) << 15);
+	}
+
+	const Quaternion CompressedAnimation::DequantiseRotation(const UInt16* values)
+	{
+		const int largest = (values[0] >> 15) | ((values[1] >> 15) << 1);
+
+		// the inverse of the scale and offset in QuantiseRotation
+		const float scale = kSqrt2 / kRotationSteps;
+		const float offset = -0.5f * kSqrt2;
+		const float a = (values[0] & 0x7fff) * scale + offset;
+		const float b = (values[1] & 0x7fff) * scale + offset;
+		const float c = (values[2] & 0x7fff) * scale + offset;
+		const float d = sqrtf(std::max(1.0f - a*a - b*b - c*c, 0.0f));
+
+		switch(largest)
+		{
+		case 0:
+			return Quaternion(d, a, b, c);
+		case 1:
+			return Quaternion(a, d, b, c);
+		case 2:
+			return Quaternion(a, b, d, c);
+		default:
+			return Quaternion(a, b, c, d);
+		}
+	}
+
+	UInt16 CompressedAnimation::TimeToTick(const float time) const
+	{
+		if(tick_length_ <= 0.0f)
+			return 0;
+
+		const float tick = floorf((time - tick_start_) / tick_length_ + 0.5f);
+		return (UInt16)std::min(std::max(tick, 0.0f), kTicksPerRange);
+	}
+
+	float CompressedAnimation::KeyTime(const UInt32 key) const
+	{
+		return tick_start_ + key_ticks_[key]*tick_length_;
+	}
+
+	// Find the first key of the channel after time, or the number of keys if there
+	// isn't one. Checks the keys from the last search first, as TransformAnimNode does.
+	UInt32 CompressedAnimation::FindNextKey(const Channel& channel, const float time, const UInt32 key_hint) const
+	{
+		const UInt32 num_keys = channel.num_keys;
+
+		for(UInt32 key = key_hint; key <= key_hint+1 && key <= num_keys; ++key)
+		{
+			if((key == 0 || KeyTime(channel.first_key+key-1) <= time) && (key == num_keys || KeyTime(channel.first_key+key) > time))
+				return key;
+		}
+
+		UInt32 first = 0;
+		UInt32 count = num_keys;
+		while(count > 0)
+		{
+			const UInt32 step = count / 2;
+			if(KeyTime(channel.first_key+first+step) <= time)
+			{
+				first += step+1;
+				count -= step+1;
+			}
+			else
+				count = step;
+		}
+
+		return first;
+	}
+
+	const Vector4 CompressedAnimation::DequantiseVector(const Channel& channel, const UInt32 key) const
+	{
+		const UInt16* values = &key_values_[(channel.first_key+key)*3];
+		return Vector4(
+			channel.minimum[0] + values[0]*channel.scale[0],
+			channel.minimum[1] + values[1]*channel.scale[1],
+			channel.minimum[2] + values[2]*channel.scale[2]);
+	}
+
+	const Vector4 CompressedAnimation::SampleVector(const Channel& channel, const float time, UInt32& key_cursor) const
+	{
+		if(channel.num_keys == 0)
+			return Vector4(0.0f, 0.0f, 0.0f);
+
+		key_cursor = FindNextKey(channel, time, key_cursor);
+
+		// before the first key or after the last one the nearest key is used
+		if(key_cursor == 0)
+			return DequantiseVector(channel, 0);
+		if(key_cursor == channel.num_keys)
+			return DequantiseVector(channel, channel.num_keys-1);
+
+		Vector4 result;
+		result.Lerp(DequantiseVector(channel, key_cursor-1), DequantiseVector(channel, key_cursor),
+			KeyFraction(KeyTime(channel.first_key+key_cursor-1), KeyTime(channel.first_key+key_cursor), time));
+		return result;
+	}
+
+	const Vector4 CompressedAnimation::GetTranslation(const Int32 track, const float time, TransformAnimCursor& cursor) const
+	{
+		return SampleVector(tracks_[track].channels[kTranslation], time, cursor.translation_key);
+	}
+
+	const Vector4 CompressedAnimation::GetScale(const Int32 track, const float time, TransformAnimCursor& cursor) const
+	{
+		return SampleVector(tracks_[track].channels[kScale], time, cursor.scale_key);
+	}
+
+	const Quaternion CompressedAnimation::GetRotation(const Int32 track, const float time, TransformAnimCursor& cursor) const
+	{
+		Quaternion result;
+		result.Identity();
+
+		const Channel& channel = tracks_[track].channels[kRotation];
+		if(channel.num_keys == 0)
+			return result;
+
+		cursor.rotation_key = FindNextKey(channel, time, cursor.rotation_key);
+		const UInt32 key = cursor.rotation_key;
+
+		// before the first key or after the last one the nearest key is used
+		if(key == 0)
+			result = DequantiseRotation(&key_values_[channel.first_key*3]);
+		else if(key == channel.num_keys)
+			result = DequantiseRotation(&key_values_[(channel.first_key+key-1)*3]);
+		else
+		{
+			result = NlerpRotation(DequantiseRotation(&key_values_[(channel.first_key+key-1)*3]), DequantiseRotation(&key_values_[(channel.first_key+key)*3]),
+				KeyFraction(KeyTime(channel.first_key+key-1), KeyTime(channel.first_key+key), time));
+		}
+
+		return result;
+	}
+
+	Int32 CompressedAnimation::FindTrack(const StringId name_id) const
+	{
+		std::vector<StringId>::const_iterator track = std::lower_bound(track_name_ids_.begin(), track_name_ids_.end(), name_id);
+		if(track == track_name_ids_.end() || *track != name_id)
+			return -1;
+
+		return (Int32)(track - track_name_ids_.begin());
+	}
+
+	void CompressedAnimation::BindSkeleton(const Skeleton& skeleton, std::vector<Int32>& joint_tracks) const
+	{
+		joint_tracks.resize(skeleton.joint_count());
+		for(Int32 joint_index = 0; joint_index < skeleton.joint_count(); ++joint_index)
+			joint_tracks[joint_index] = FindTrack(skeleton.joint(joint_index).name_id);
+	}
+
+	void CompressedAnimation::SamplePose(const std::vector<Int32>& joint_tracks, const SkeletonPose& bind_pose, const float time, std::vector<TransformAnimCursor>& cursors, SkeletonPose& pose, const bool update_global_pose) const
+	{
+		if(cursors.size() != joint_tracks.size())
+			cursors.resize(joint_tracks.size());
+
+		std::vector<JointPose>& local_pose = pose.local_pose();
+		for(UInt32 joint_index = 0; joint_index < joint_tracks.size(); ++joint_index)
+		{
+			const Int32 track = joint_tracks[joint_index];
+			JointPose& joint_pose = local_pose[joint_index];
+			const JointPose& joint_bind_pose = bind_pose.local_pose()[joint_index];
+
+			if(track == -1)
+			{
+				joint_pose = joint_bind_pose;
+				continue;
+			}
+
+			// scale is always 1, as in SkeletonPose::SetPoseFromAnim
+			joint_pose.set_scale(Vector4(1.0f, 1.0f, 1.0f));
+
+			if(tracks_[track].channels[kRotation].num_keys > 0)
+				joint_pose.set_rotation(GetRotation(track, time, cursors[joint_index]));
+			else
+				joint_pose.set_rotation(joint_bind_pose.rotation());
+
+			if(tracks_[track].channels[kTranslation].num_keys > 0)
+				joint_pose.set_translation(GetTranslation(track, time, cursors[joint_index]));
+			else
+				joint_pose.set_translation(joint_bind_pose.translation());
+		}
+
+		if(update_global_pose)
+			pose.CalculateGlobalPose();
+	}
+
+	bool CompressedAnimation::Read(std::istream& stream)
+	{
+		stream.read((char*)&name_id_, sizeof(StringId));
+		stream.read((char*)&start_time_, sizeof(float));
+		stream.read((char*)&end_time_, sizeof(float));
+		stream.read((char*)&tick_start_, sizeof(float));
+		stream.read((char*)&tick_length_, sizeof(float));
+		duration_ = end_time_ - start_time_;
+
+		// counts from a corrupt file must not be able to make the arrays bigger than the data left
+		Int32 num_tracks;
+		stream.read((char*)&num_tracks, sizeof(Int32));
+		if(stream.fail() || num_tracks < 0 || (std::streamoff)num_tracks*(std::streamoff)(sizeof(StringId)+sizeof(Track)) > RemainingStreamSize(stream))
+			return false;
+		track_name_ids_.resize(num_tracks);
+		tracks_.resize(num_tracks);
+		if(num_tracks > 0)
+		{
+			stream.read((char*)&track_name_ids_.front(), sizeof(StringId)*num_tracks);
+			stream.read((char*)&tracks_.front(), sizeof(Track)*num_tracks);
+		}
+
+		Int32 num_keys;
+		stream.read((char*)&num_keys, sizeof(Int32));
+		if(stream.fail() || num_keys < 0 || (std::streamoff)num_keys*(std::streamoff)(sizeof(UInt16)*4) > RemainingStreamSize(stream))
+			return false;
+		key_ticks_.resize(num_keys);
+		key_values_.resize(num_keys*3);
+		if(num_keys > 0)
+		{
+			stream.read((char*)&key_ticks_.front(), sizeof(UInt16)*num_keys);
+			stream.read((char*)&key_values_.front(), sizeof(UInt16)*num_keys*3);
+		}
+
+		// every channel's keys must be in the key arrays
+		for(std::vector<Track>::const_iterator track = tracks_.begin(); track != tracks_.end(); ++track)
+		{
+			for(Int32 channel_type = 0; channel_type < kNumChannelTypes; ++channel_type)
+			{
+				const Channel& channel = track->channels[channel_type];
+				if(channel.first_key > (UInt32)num_keys || channel.num_keys > (UInt32)num_keys - channel.first_key)
+					return false;
+			}
+		}
+
+		return !stream.fail();
+	}
+
+	bool CompressedAnimation::Write(std::ostream& stream) const
+	{
+		stream.write((char*)&name_id_, sizeof(StringId));
+		stream.write((char*)&start_time_, sizeof(float));
+		stream.write((char*)&end_time_, sizeof(float));
+		stream.write((char*)&tick_start_, sizeof(float));
+		stream.write((char*)&tick_length_, sizeof(float));
+
+		Int32 num_tracks = (Int32)tracks_.size();
+		stream.write((char*)&num_tracks, sizeof(Int32));
+		if(num_tracks > 0)
+		{
+			stream.write((char*)&track_name_ids_.front(), sizeof(StringId)*num_tracks);
+			stream.write((char*)&tracks_.front(), sizeof(Track)*num_tracks);
+		}
+
+		Int32 num_keys = (Int32)key_ticks_.size();
+		stream.write((char*)&num_keys, sizeof(Int32));
+		if(num_keys > 0)
+		{
+			stream.write((char*)&key_ticks_.front(), sizeof(UInt16)*num_keys);
+			stream.write((char*)&key_values_.front(), sizeof(UInt16)*num_keys*3);
+		}
+
+		return true;
+	}
+
+	UInt32 CompressedAnimation::memory_size() const
+	{
+		return (UInt32)(sizeof(CompressedAnimation)
+			+ track_name_ids_.size()*sizeof(StringId)
+			+ tracks_.size()*sizeof(Track)
+			+ key_ticks_.size()*sizeof(UInt16)
+			+ key_values_.size()*sizeof(UInt16));
+	}
+}
@@ -0,0 +1,140 @@
+#ifndef _GEF_COMPRESSED_ANIMATION_H
+#define _GEF_COMPRESSED_ANIMATION_H
+
+#include <gef.h>
+#include <system/string_id.h>
+#include <maths/vector4.h>
+#include <maths/quaternion.h>
+#include <vector>
+#include <istream>
+#include <ostream>
+
+namespace gef
+{
+	class Animation;
+	class Skeleton;
+	class SkeletonPose;
+	struct TransformAnimCursor;
+	struct Vector3Key;
+	struct QuaternionKey;
+
+	// A compact copy of an Animation made up of transform tracks.
+	//
+	// Keys that can be rebuilt from their neighbours to within a tolerance are
+	// removed. The keys left are quantised to 16 bit values: rotations store the
+	// smallest three quaternion components and the index of the largest one,
+	// translations and scales are stored as a fraction of each track's range,
+	// and key times are stored as ticks from the start of the clip. Rotations
+	// are blended with a normalised lerp rather than a slerp, both when keys
+	// are removed and when the clip is sampled.
+	//
+	// Tracks are kept in flat arrays sorted by joint name. BindSkeleton looks
+	// up the track for each joint once, and sampling uses that table after.
+	class CompressedAnimation
+	{
+	public:
+		struct Settings
+		{
+			Settings() :
+				rotation_tolerance(0.001f),
+				translation_tolerance(0.001f),
+				scale_tolerance(0.001f)
+			{
+			}
+
+			// the largest difference allowed in any quaternion component
+			float rotation_tolerance;
+			// the largest difference allowed in any component, in scene units
+			float translation_tolerance;
+			float scale_tolerance;
+		};
+
+		CompressedAnimation();
+
+		// builds the compressed clip from the transform nodes in animation
+		void Compress(const Animation& animation, const Settings& settings);
+
+		// fills joint_tracks with the track index for each joint of the skeleton, -1 for joints without a track
+		void BindSkeleton(const Skeleton& skeleton, std::vector<Int32>& joint_tracks) const;
+		Int32 FindTrack(const StringId name_id) const;
+
+		const Vector4 GetTranslation(const Int32 track, const float time, TransformAnimCursor& cursor) const;
+		const Vector4 GetScale(const Int32 track, const float time, TransformAnimCursor& cursor) const;
+		const Quaternion GetRotation(const Int32 track, const float time, TransformAnimCursor& cursor) const;
+
+		// sets the local pose of each joint from the clip, the same way SkeletonPose::SetPoseFromAnim does
+		// joint_tracks comes from BindSkeleton and cursors is kept between calls for the same playback
+		void SamplePose(const std::vector<Int32>& joint_tracks, const SkeletonPose& bind_pose, const float time, std::vector<TransformAnimCursor>& cursors, SkeletonPose& pose, const bool update_global_pose = true) const;
+
+		// returns false if the clip is cut short or its counts don't fit in the data left
+		bool Read(std::istream& stream);
+		bool Write(std::ostream& stream) const;
+
+		// bytes used by the clip, including the key data
+		UInt32 memory_size() const;
+
+		// the name, times and counts written for even an empty clip
+		static const Int32 kMinWriteSize = 28;
+
+		inline Int32 track_count() const { return (Int32)track_name_ids_.size(); }
+		inline StringId track_name_id(const Int32 track) const { return track_name_ids_[track]; }
+		inline UInt32 key_count() const { return (UInt32)key_ticks_.size(); }
+
+		inline float duration() const { return duration_; }
+		inline float start_time() const { return start_time_; }
+		inline float end_time() const { return end_time_; }
+		inline StringId name_id() const { return name_id_; }
+
+		// smallest three quaternion quantisation, exposed so tools can measure the error
+		static void QuantiseRotation(const Quaternion& rotation, UInt16* values);
+		static const Quaternion DequantiseRotation(const UInt16* values);
+
+	private:
+		enum ChannelType
+		{
+			kRotation = 0,
+			kTranslation,
+			kScale,
+			kNumChannelTypes
+		};
+
+		// the keys for one channel of a track are stored together in key_ticks_ and key_values_
+		struct Channel
+		{
+			UInt32 first_key;
+			UInt32 num_keys;
+			// value = minimum + quantised value * scale, unused for rotations
+			float minimum[3];
+			float scale[3];
+		};
+
+		struct Track
+		{
+			Channel channels[kNumChannelTypes];
+		};
+
+		void AddVectorChannel(Channel& channel, const std::vector<Vector3Key>& keys, const float tolerance);
+		void AddRotationChannel(Channel& channel, const std::vector<QuaternionKey>& keys, const float tolerance);
+		UInt16 TimeToTick(const float time) const;
+		UInt32 FindNextKey(const Channel& channel, const float time, const UInt32 key_hint) const;
+		float KeyTime(const UInt32 key) const;
+		const Vector4 DequantiseVector(const Channel& channel, const UInt32 key) const;
+		const Vector4 SampleVector(const Channel& channel, const float time, UInt32& key_cursor) const;
+
+		std::vector<StringId> track_name_ids_;
+		std::vector<Track> tracks_;
+		std::vector<UInt16> key_ticks_;
+		// three values for each key
+		std::vector<UInt16> key_values_;
+
+		float duration_;
+		float start_time_;
+		float end_time_;
+		// time of tick 0 and seconds per tick
+		float tick_start_;
+		float tick_length_;
+		StringId name_id_;
+	};
+}
+
+#endif // _GEF_COMPRESSED_ANIMATION_H
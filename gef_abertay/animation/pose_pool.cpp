@@ -0,0 +1,66 @@
+#include <animation/pose_pool.h>
+
+namespace gef
+{
+	PosePool::PosePool() :
+		storage_(NULL),
+		reserved_(0),
+		joint_count_(0),
+		used_(0),
+		peak_used_(0),
+		overflow_count_(0)
+	{
+	}
+
+	PosePool::~PosePool()
+	{
+		CleanUp();
+	}
+
+	void PosePool::Init(const Int32 joint_count, const Int32 capacity)
+	{
+		CleanUp();
+
+		joint_count_ = joint_count;
+		reserved_ = capacity;
+		storage_ = new JointPose[joint_count * capacity];
+		poses_.reserve(capacity);
+		for(Int32 pose_num = 0; pose_num < capacity; ++pose_num)
+			poses_.push_back(&storage_[pose_num * joint_count]);
+	}
+
+	void PosePool::CleanUp()
+	{
+		for(size_t pose_num = reserved_; pose_num < poses_.size(); ++pose_num)
+			delete[] poses_[pose_num];
+		poses_.clear();
+
+		delete[] storage_;
+		storage_ = NULL;
+		reserved_ = 0;
+		joint_count_ = 0;
+		used_ = 0;
+		peak_used_ = 0;
+		overflow_count_ = 0;
+	}
+
+	JointPose* PosePool::Acquire()
+	{
+		if(used_ == (Int32)poses_.size())
+		{
+			// the overflow pose is kept, so this only happens once for each extra pose needed
+			poses_.push_back(new JointPose[joint_count_]);
+			++overflow_count_;
+		}
+
+		JointPose* pose = poses_[used_++];
+		if(used_ > peak_used_)
+			peak_used_ = used_;
+		return pose;
+	}
+
+	void PosePool::Reset()
+	{
+		used_ = 0;
+	}
+}
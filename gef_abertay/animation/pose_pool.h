@@ -0,0 +1,52 @@
+#ifndef _GEF_POSE_POOL_H
+#define _GEF_POSE_POOL_H
+
+#include <gef.h>
+#include <animation/joint.h>
+#include <vector>
+
+namespace gef
+{
+	// Scratch local poses that last until the end of the frame.
+	//
+	// The poses are allocated up front in one block. Acquire hands them out in
+	// order and Reset takes them all back, so poses used for the intermediate
+	// results of a blend tree don't touch the heap. If more poses are asked for
+	// than were reserved, extra ones are allocated and counted so the capacity
+	// can be raised.
+	class PosePool
+	{
+	public:
+		PosePool();
+		~PosePool();
+
+		// joint_count must be at least the joint count of every skeleton the poses are used for
+		void Init(const Int32 joint_count, const Int32 capacity);
+		void CleanUp();
+
+		// a pose with joint_count joints, valid until Reset
+		JointPose* Acquire();
+		// call once a frame, after all the poses from the last frame are finished with
+		void Reset();
+
+		inline Int32 joint_count() const { return joint_count_; }
+		inline Int32 capacity() const { return (Int32)poses_.size(); }
+		inline Int32 used() const { return used_; }
+		// the most poses in use at once since Init
+		inline Int32 peak_used() const { return peak_used_; }
+		// poses allocated because the pool ran out
+		inline UInt32 overflow_count() const { return overflow_count_; }
+
+	private:
+		// one entry for each pose, pointing into storage_ or at an overflow pose
+		std::vector<JointPose*> poses_;
+		JointPose* storage_;
+		Int32 reserved_;
+		Int32 joint_count_;
+		Int32 used_;
+		Int32 peak_used_;
+		UInt32 overflow_count_;
+	};
+}
+
+#endif // _GEF_POSE_POOL_H
@@ -1,5 +1,6 @@
 #include <animation/skeleton.h>
 #include <animation/animation.h>
+#include <animation/animation_binding.h>
 
 namespace gef
 {
@@ -130,61 +131,88 @@ namespace gef
 
 	void SkeletonPose::SetPoseFromAnim(const Animation& anim, const SkeletonPose& bind_pose, float time, const bool updateGlobalPose)
 	{
-		for (Int32 joint_index = 0; joint_index < skeleton_->joints().size(); ++joint_index)
+		// there are no cursors kept between calls, so each joint starts from a fresh one on
+		// the stack and its keys are found with a search, without allocating anything
+		const Int32 joint_count = (Int32)skeleton_->joints().size();
+		for (Int32 joint_index = 0; joint_index < joint_count; ++joint_index)
 		{
 			const AnimNode* anim_node = anim.FindNode(skeleton_->joints()[joint_index].name_id);
-			JointPose& joint_pose = local_pose_[joint_index];
+			const TransformAnimNode* transform_node = anim_node && anim_node->type() == AnimNode::kTransform ? static_cast<const TransformAnimNode*>(anim_node) : NULL;
+			TransformAnimCursor cursor;
+			SampleJointPose(transform_node, bind_pose.local_pose()[joint_index], time, cursor, local_pose_[joint_index]);
+		}
 
-//			if(joint_index != 1)
-//				anim_node = NULL;
-			if(anim_node)
-			{
-				if(anim_node->type() == AnimNode::kTransform) // this should always be true since the find uses the joint transform name
-				{
-					const TransformAnimNode* transform_node = static_cast<const TransformAnimNode*>(anim_node);
-
-					// scale
-					if(transform_node->scale_keys().size() > 0.f)
-						joint_pose.set_scale(transform_node->GetScale(time));
-					else
-						joint_pose.set_scale(bind_pose.local_pose()[joint_index].scale());
-					joint_pose.set_scale(gef::Vector4(1.f, 1.f, 1.f));
-
-					// rotation
-					if(transform_node->rotation_keys().size() > 0.f)
-						joint_pose.set_rotation(transform_node->GetRotation(time));
-					else
-						joint_pose.set_rotation(bind_pose.local_pose()[joint_index].rotation());
-
-					// translation
-					if(transform_node->translation_keys().size() > 0.f)
-						joint_pose.set_translation(transform_node->GetTranslation(time));
-					else
-						joint_pose.set_translation(bind_pose.local_pose()[joint_index].translation());
-				}
-			}
-			else
-			{
-				joint_pose = bind_pose.local_pose()[joint_index];
-			}
+		if(updateGlobalPose)
+			CalculateGlobalPose();
+	}
 
-			// check to see if there is a pose transform
-			// if so use it to transform any root joints
-//			if(pose_transform && joint_index == 1)
-//				joint_pose.Set(joint_pose.GetMatrix() * *pose_transform);
+	void SkeletonPose::SetPoseFromAnim(const Animation& anim, const SkeletonPose& bind_pose, float time, std::vector<TransformAnimCursor>& cursors, const bool updateGlobalPose)
+	{
+		if (cursors.size() != skeleton_->joints().size())
+			cursors.resize(skeleton_->joints().size());
 
-#ifdef REMOVE_BIND_POSE
-			gef::Matrix44 inv_local_joint_orient;
-			inv_local_joint_orient.AffineInverse(bind_pose.local_pose()[joint_index].GetMatrix());
-			inv_local_joint_orient.SetTranslation(gef::Vector4(0.f, 0.f, 0.f));
-			joint_pose.Set(inv_local_joint_orient * joint_pose.GetMatrix());
-#endif
+		for (Int32 joint_index = 0; joint_index < skeleton_->joints().size(); ++joint_index)
+		{
+			// this should always be a transform node since the find uses the joint transform name
+			const AnimNode* anim_node = anim.FindNode(skeleton_->joints()[joint_index].name_id);
+			const TransformAnimNode* transform_node = anim_node && anim_node->type() == AnimNode::kTransform ? static_cast<const TransformAnimNode*>(anim_node) : NULL;
+			SampleJointPose(transform_node, bind_pose.local_pose()[joint_index], time, cursors[joint_index], local_pose_[joint_index]);
 		}
 
 		if(updateGlobalPose)
 			CalculateGlobalPose();
 	}
 
+	void SkeletonPose::SetPoseFromAnim(const AnimationBinding& binding, const SkeletonPose& bind_pose, float time, std::vector<TransformAnimCursor>& cursors, const bool updateGlobalPose)
+	{
+		// the binding has a node for each joint of its own skeleton, so it can't be used with another
+		if (binding.skeleton() != skeleton_)
+			return;
+
+		if (cursors.size() != skeleton_->joints().size())
+			cursors.resize(skeleton_->joints().size());
+
+		const Int32 joint_count = (Int32)skeleton_->joints().size();
+		for (Int32 joint_index = 0; joint_index < joint_count; ++joint_index)
+			SampleJointPose(binding.joint_node(joint_index), bind_pose.local_pose()[joint_index], time, cursors[joint_index], local_pose_[joint_index]);
+
+		if(updateGlobalPose)
+			CalculateGlobalPose();
+	}
+
+	void SkeletonPose::SampleJointPose(const TransformAnimNode* transform_node, const JointPose& bind_joint_pose, const float time, TransformAnimCursor& cursor, JointPose& joint_pose)
+	{
+		if(transform_node)
+		{
+			// scale
+			// the scale is always overwritten below, so don't sample it
+			joint_pose.set_scale(gef::Vector4(1.f, 1.f, 1.f));
+
+			// rotation
+			if(transform_node->rotation_keys().size() > 0.f)
+				joint_pose.set_rotation(transform_node->GetRotation(time, cursor));
+			else
+				joint_pose.set_rotation(bind_joint_pose.rotation());
+
+			// translation
+			if(transform_node->translation_keys().size() > 0.f)
+				joint_pose.set_translation(transform_node->GetTranslation(time, cursor));
+			else
+				joint_pose.set_translation(bind_joint_pose.translation());
+		}
+		else
+		{
+			joint_pose = bind_joint_pose;
+		}
+
+#ifdef REMOVE_BIND_POSE
+		gef::Matrix44 inv_local_joint_orient;
+		inv_local_joint_orient.AffineInverse(bind_joint_pose.GetMatrix());
+		inv_local_joint_orient.SetTranslation(gef::Vector4(0.f, 0.f, 0.f));
+		joint_pose.Set(inv_local_joint_orient * joint_pose.GetMatrix());
+#endif
+	}
+
 	void SkeletonPose::Linear2PoseBlend(const SkeletonPose& start_pose, const SkeletonPose& end_pose, const float time)
 	{
 		// assume _startPose _endPose and "this" pose all have the same number of joints
@@ -265,6 +293,27 @@ namespace gef
 	}
 
 
+	gef::Matrix44 SkeletonPose::GetGlobalJointTransformFromAnim(const AnimationBinding& binding, const SkeletonPose& bind_pose, float time, const Int32 joint_index)
+	{
+		const gef::Skeleton* skeleton = bind_pose.skeleton();
+
+		// a binding for another skeleton has no node for this joint, so the bind pose is used
+		if(binding.skeleton() != skeleton)
+			return bind_pose.global_pose()[joint_index];
+
+		// calculate the transform for this joint
+		TransformAnimCursor cursor;
+		JointPose joint_pose;
+		SampleJointPose(binding.joint_node(joint_index), bind_pose.local_pose()[joint_index], time, cursor, joint_pose);
+
+		// multiply the joint transform by all the parent joint transforms
+		Int32 parent = skeleton->joint(joint_index).parent;
+		if(parent == -1)
+			return joint_pose.GetMatrix();
+		else
+			return joint_pose.GetMatrix() * GetGlobalJointTransformFromAnim(binding, bind_pose, time, parent);
+	}
+
 	gef::Matrix44 SkeletonPose::GetJointTransformFromAnim(const class Animation& anim, const SkeletonPose& bind_pose, float time, const Int32 joint_index)
 	{
 		const gef::Skeleton* skeleton = bind_pose.skeleton();
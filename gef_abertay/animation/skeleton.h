@@ -13,6 +13,8 @@
 namespace gef
 {
 	struct Joint;
+	struct TransformAnimCursor;
+	class AnimationBinding;
 
 	class Skeleton
 	{
@@ -47,10 +49,21 @@ namespace gef
 		void CalculateGlobalPose(const gef::Matrix44 * const pose_transform = NULL);
 		void CalculateLocalPose(const std::vector<Matrix44>& global_pose);
 		void SetPoseFromAnim(const class Animation& _anim, const SkeletonPose& _bindPose, const float _time, const bool _updateGlobalPose = true);
+		// as above, with a key cursor for each joint that is kept between calls so the keys
+		// are found without a search while the playback time moves forward
+		void SetPoseFromAnim(const class Animation& _anim, const SkeletonPose& _bindPose, const float _time, std::vector<TransformAnimCursor>& _cursors, const bool _updateGlobalPose = true);
+		// as above, with the node for each joint taken from a binding of the animation to this pose's skeleton
+		// the pose is left as it is if the binding was made for a different skeleton
+		void SetPoseFromAnim(const AnimationBinding& _binding, const SkeletonPose& _bindPose, const float _time, std::vector<TransformAnimCursor>& _cursors, const bool _updateGlobalPose = true);
 	//	void SetLocalJointPoseFromAnim(JointPose& _jointPose, const UInt32 _jointNum, const JointPose& _jointBindPose, const class Anim& _anim, const float _time);
 		void Linear2PoseBlend(const SkeletonPose& _startPose, const SkeletonPose& _endPose, const float _time);
 
 		static gef::Matrix44 GetGlobalJointTransformFromAnim(const class Animation* _anim, const SkeletonPose& _bindPose, float _time, const Int32 joint_index);
+		// the bind pose's transform for the joint if the binding was made for a different skeleton
+		static gef::Matrix44 GetGlobalJointTransformFromAnim(const AnimationBinding& _binding, const SkeletonPose& _bindPose, float _time, const Int32 joint_index);
+		// sets joint_pose from the node, or to the bind pose when transform_node is NULL
+		static void SampleJointPose(const class TransformAnimNode* transform_node, const JointPose& bind_joint_pose, const float time, TransformAnimCursor& cursor, JointPose& joint_pose);
+
 		static gef::Matrix44 GetJointTransformFromAnim(const class Animation& _anim, const SkeletonPose& _bindPose, float _time, const Int32 joint_index);
 
 		void CreateBindPose(const Skeleton* const skeleton);
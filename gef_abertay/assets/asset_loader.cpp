@@ -0,0 +1,347 @@
+#include <assets/asset_loader.h>
+#include <assets/png_loader.h>
+#include <graphics/image_data.h>
+#include <graphics/texture.h>
+#include <graphics/scene.h>
+#include <audio/audio_manager.h>
+#include <chrono>
+
+namespace gef
+{
+	AssetLoader::AssetLoader(const Platform& platform, const Int32 worker_count) :
+		platform_(platform),
+		texture_cache_(NULL),
+		pending_count_(0),
+		stopping_(false)
+	{
+		for(Int32 worker_num = 0; worker_num < worker_count; ++worker_num)
+			workers_.push_back(std::thread(&AssetLoader::WorkerLoop, this));
+	}
+
+	AssetLoader::~AssetLoader()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			stopping_ = true;
+			load_queue_.clear();
+		}
+		work_available_.notify_all();
+
+		for(std::vector<std::thread>::iterator worker = workers_.begin(); worker != workers_.end(); ++worker)
+			worker->join();
+
+		// a scene that never got to the main thread step has no owner yet
+		for(std::vector<Request*>::iterator request = requests_.begin(); request != requests_.end(); ++request)
+		{
+			if(*request)
+			{
+				delete (*request)->image_data;
+				delete (*request)->decoded_texture;
+				if((*request)->state != kLoaded)
+					delete (*request)->scene;
+			}
+			delete *request;
+		}
+	}
+
+	Int32 AssetLoader::DefaultWorkerCount()
+	{
+		// hardware_concurrency can return 0 when the count isn't known
+		Int32 thread_count = (Int32)std::thread::hardware_concurrency();
+		return thread_count > 2 ? thread_count - 1 : 1;
+	}
+
+	AssetLoader::Handle AssetLoader::LoadTexture(const char* filename, CompletionCallback callback, void* user_data)
+	{
+		Request* request = new Request();
+		request->type = kTexture;
+		request->filename = filename;
+		// a texture the cache already has doesn't need loading
+		if(texture_cache_)
+			request->texture = texture_cache_->FindTexture(filename);
+		request->callback = callback;
+		request->user_data = user_data;
+		return AddRequest(request);
+	}
+
+	AssetLoader::Handle AssetLoader::LoadScene(const char* filename, CompletionCallback callback, void* user_data)
+	{
+		Request* request = new Request();
+		request->type = kScene;
+		request->filename = filename;
+		request->callback = callback;
+		request->user_data = user_data;
+		return AddRequest(request);
+	}
+
+	AssetLoader::Handle AssetLoader::LoadSample(const char* filename, AudioManager& audio_manager, CompletionCallback callback, void* user_data)
+	{
+		Request* request = new Request();
+		request->type = kSample;
+		request->filename = filename;
+		request->audio_manager = &audio_manager;
+		request->callback = callback;
+		request->user_data = user_data;
+		return AddRequest(request);
+	}
+
+	AssetLoader::Handle AssetLoader::LoadMusic(const char* filename, AudioManager& audio_manager, CompletionCallback callback, void* user_data)
+	{
+		Request* request = new Request();
+		request->type = kMusic;
+		request->filename = filename;
+		request->audio_manager = &audio_manager;
+		request->callback = callback;
+		request->user_data = user_data;
+		return AddRequest(request);
+	}
+
+	AssetLoader::Handle AssetLoader::Load(LoadFunction load, FinishFunction finish, CompletionCallback callback, void* user_data)
+	{
+		Request* request = new Request();
+		request->type = kCustom;
+		request->load = load;
+		request->finish = finish;
+		request->callback = callback;
+		request->user_data = user_data;
+		return AddRequest(request);
+	}
+
+	AssetLoader::Handle AssetLoader::AddRequest(Request* request)
+	{
+		request->state = kLoading;
+		request->sample_id = -1;
+		const bool has_load_step = (request->type == kTexture && !request->texture) || request->type == kScene || (request->type == kCustom && request->load);
+
+		// loads with nothing to do on a worker, or no workers to do it, go straight to the main thread step
+		const bool queue_load = has_load_step && !workers_.empty();
+		if(!queue_load)
+			request->state = !has_load_step || RunLoad(*request) ? kFinalising : kFailed;
+
+		std::lock_guard<std::mutex> lock(mutex_);
+
+		Handle handle;
+		if(free_handles_.empty())
+		{
+			handle = (Handle)requests_.size();
+			requests_.push_back(request);
+		}
+		else
+		{
+			handle = free_handles_.back();
+			free_handles_.pop_back();
+			requests_[handle] = request;
+		}
+		++pending_count_;
+
+		if(queue_load)
+		{
+			load_queue_.push_back(handle);
+			work_available_.notify_one();
+		}
+		else
+			finish_queue_.push_back(handle);
+
+		return handle;
+	}
+
+	void AssetLoader::WorkerLoop()
+	{
+		std::unique_lock<std::mutex> lock(mutex_);
+		for(;;)
+		{
+			while(!stopping_ && load_queue_.empty())
+				work_available_.wait(lock);
+
+			if(stopping_)
+				return;
+
+			const Handle handle = load_queue_.front();
+			load_queue_.pop_front();
+
+			// requests_ can grow while the lock isn't held, but the request itself doesn't move
+			Request* request = requests_[handle];
+			lock.unlock();
+			const bool success = RunLoad(*request);
+			lock.lock();
+
+			request->state = success ? kFinalising : kFailed;
+			finish_queue_.push_back(handle);
+			load_done_.notify_all();
+		}
+	}
+
+	bool AssetLoader::RunLoad(Request& request)
+	{
+		switch(request.type)
+		{
+		case kTexture:
+			if(texture_cache_)
+			{
+				request.decoded_texture = new TextureCache::DecodedTexture();
+				texture_cache_->Decode(request.filename.c_str(), *request.decoded_texture);
+				return request.decoded_texture->success;
+			}
+			else
+			{
+				request.image_data = new ImageData();
+				PNGLoader png_loader;
+				png_loader.Load(request.filename.c_str(), platform_, *request.image_data);
+				return request.image_data->image() != NULL;
+			}
+
+		case kScene:
+			request.scene = new Scene();
+			if(request.scene->ReadSceneFromFile(platform_, request.filename.c_str()))
+				return true;
+			delete request.scene;
+			request.scene = NULL;
+			return false;
+
+		case kCustom:
+			return request.load(request.user_data);
+
+		default:
+			return true;
+		}
+	}
+
+	bool AssetLoader::RunFinish(Request& request)
+	{
+		switch(request.type)
+		{
+		case kTexture:
+			if(request.texture)
+				return true;
+			if(texture_cache_)
+			{
+				request.texture = texture_cache_->Add(*request.decoded_texture);
+				delete request.decoded_texture;
+				request.decoded_texture = NULL;
+				return request.texture != NULL;
+			}
+			request.texture = Texture::Create(platform_, *request.image_data);
+			delete request.image_data;
+			request.image_data = NULL;
+			return request.texture != NULL;
+
+		case kSample:
+			request.sample_id = request.audio_manager->LoadSample(request.filename.c_str(), platform_);
+			return request.sample_id != -1;
+
+		case kMusic:
+			return request.audio_manager->LoadMusic(request.filename.c_str(), platform_) != -1;
+
+		case kCustom:
+			return request.finish ? request.finish(request.user_data) : true;
+
+		default:
+			return true;
+		}
+	}
+
+	bool AssetLoader::FinishNext()
+	{
+		Handle handle;
+		Request* request;
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			if(finish_queue_.empty())
+				return false;
+
+			handle = finish_queue_.front();
+			finish_queue_.pop_front();
+			request = requests_[handle];
+		}
+
+		// the workers are done with the request, so only the main thread uses it now
+		bool success = request->state == kFinalising;
+		if(success)
+			success = RunFinish(*request);
+		else
+		{
+			delete request->image_data;
+			request->image_data = NULL;
+			delete request->decoded_texture;
+			request->decoded_texture = NULL;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			request->state = success ? kLoaded : kFailed;
+			--pending_count_;
+		}
+
+		if(request->callback)
+			request->callback(request->user_data, handle, success);
+
+		return true;
+	}
+
+	void AssetLoader::Update(const float time_budget)
+	{
+		const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		while(FinishNext())
+		{
+			const std::chrono::duration<float> time_used = std::chrono::steady_clock::now() - start;
+			if(time_used.count() >= time_budget)
+				break;
+		}
+	}
+
+	void AssetLoader::Finish()
+	{
+		for(;;)
+		{
+			while(FinishNext())
+			{
+			}
+
+			// wait for the workers to hand over more, the main thread steps themselves don't need the lock
+			std::unique_lock<std::mutex> lock(mutex_);
+			if(pending_count_ == 0)
+				return;
+			while(finish_queue_.empty())
+				load_done_.wait(lock);
+		}
+	}
+
+	AssetLoader::State AssetLoader::state(const Handle handle) const
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		return requests_[handle]->state;
+	}
+
+	Int32 AssetLoader::pending_count() const
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		return pending_count_;
+	}
+
+	Texture* AssetLoader::texture(const Handle handle) const
+	{
+		return state(handle) == kLoaded ? requests_[handle]->texture : NULL;
+	}
+
+	Scene* AssetLoader::scene(const Handle handle) const
+	{
+		return state(handle) == kLoaded ? requests_[handle]->scene : NULL;
+	}
+
+	Int32 AssetLoader::sample_id(const Handle handle) const
+	{
+		return state(handle) == kLoaded ? requests_[handle]->sample_id : -1;
+	}
+
+	void AssetLoader::Release(const Handle handle)
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		Request* request = requests_[handle];
+		if(!request || (request->state != kLoaded && request->state != kFailed))
+			return;
+
+		delete request;
+		requests_[handle] = NULL;
+		free_handles_.push_back(handle);
+	}
+}
@@ -0,0 +1,153 @@
+#ifndef _GEF_ASSET_LOADER_H
+#define _GEF_ASSET_LOADER_H
+
+#include <gef.h>
+#include <assets/texture_cache.h>
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace gef
+{
+	class Platform;
+	class Texture;
+	class Scene;
+	class ImageData;
+	class AudioManager;
+
+	// Loads assets in the background so the main thread doesn't wait on them.
+	//
+	// A load has up to two steps. The first runs on a worker thread and does the
+	// file reading and decoding. The second runs on the main thread in Update, for
+	// the work that has to happen there, such as creating textures, then the
+	// completion callback is called. Update stops starting second steps once the
+	// frame's time budget is used, so many loads finishing at once are spread
+	// over a few frames rather than causing a hitch.
+	//
+	// The audio managers aren't thread safe, so samples and music only have a
+	// main thread step.
+	class AssetLoader
+	{
+	public:
+		typedef Int32 Handle;
+		static const Handle kInvalidHandle = -1;
+
+		enum State
+		{
+			kLoading = 0,
+			// the worker step is done and the main thread step is waiting for Update
+			kFinalising,
+			kLoaded,
+			kFailed
+		};
+
+		// the worker thread step of a custom load, returns false if the load failed
+		typedef bool (*LoadFunction)(void* user_data);
+		// the main thread step of a custom load, only called if the worker step succeeded
+		typedef bool (*FinishFunction)(void* user_data);
+		// called on the main thread once a load is loaded or failed
+		typedef void (*CompletionCallback)(void* user_data, const Handle handle, const bool success);
+
+		AssetLoader(const Platform& platform, const Int32 worker_count = DefaultWorkerCount());
+		// waits for the worker steps in progress, loads still queued are dropped
+		~AssetLoader();
+
+		// the loaded texture and scene are owned by the caller, apart from textures from a texture cache
+		Handle LoadTexture(const char* filename, CompletionCallback callback = NULL, void* user_data = NULL);
+		Handle LoadScene(const char* filename, CompletionCallback callback = NULL, void* user_data = NULL);
+		Handle LoadSample(const char* filename, AudioManager& audio_manager, CompletionCallback callback = NULL, void* user_data = NULL);
+		Handle LoadMusic(const char* filename, AudioManager& audio_manager, CompletionCallback callback = NULL, void* user_data = NULL);
+		// either step can be NULL
+		Handle Load(LoadFunction load, FinishFunction finish, CompletionCallback callback = NULL, void* user_data = NULL);
+
+		// call once a frame on the main thread, runs main thread steps until time_budget seconds
+		// have been used. At least one is run each call, so loading always moves on
+		void Update(const float time_budget);
+		// blocks until every load has been loaded or failed, with no budget
+		void Finish();
+
+		State state(const Handle handle) const;
+		inline bool loaded(const Handle handle) const { return state(handle) == kLoaded; }
+		// loads that haven't been loaded or failed yet
+		Int32 pending_count() const;
+
+		// the results of loads that succeeded, NULL or -1 until then
+		Texture* texture(const Handle handle) const;
+		Scene* scene(const Handle handle) const;
+		Int32 sample_id(const Handle handle) const;
+
+		// frees a finished load so its handle can be reused, the loaded asset isn't deleted
+		void Release(const Handle handle);
+
+		// texture loads are decoded and created through the cache, so a file already loaded
+		// isn't loaded again and the cache owns the textures. Set before loading any textures
+		inline void set_texture_cache(TextureCache* texture_cache) { texture_cache_ = texture_cache; }
+		inline TextureCache* texture_cache() const { return texture_cache_; }
+
+		// one worker for each hardware thread apart from the main one, at least one so loads are never on the main thread
+		static Int32 DefaultWorkerCount();
+
+	private:
+		enum AssetType
+		{
+			kTexture = 0,
+			kScene,
+			kSample,
+			kMusic,
+			kCustom
+		};
+
+		struct Request
+		{
+			AssetType type;
+			std::string filename;
+			LoadFunction load;
+			FinishFunction finish;
+			CompletionCallback callback;
+			void* user_data;
+			AudioManager* audio_manager;
+
+			State state;
+			ImageData* image_data;
+			// instead of image_data when there's a texture cache
+			TextureCache::DecodedTexture* decoded_texture;
+			Texture* texture;
+			Scene* scene;
+			Int32 sample_id;
+		};
+
+		Handle AddRequest(Request* request);
+		void WorkerLoop();
+		// the worker thread step, returns false if the load failed
+		bool RunLoad(Request& request);
+		// the main thread step, returns false if the load failed
+		bool RunFinish(Request& request);
+		// runs the main thread step and callback of the next load waiting for them, returns false if there wasn't one
+		bool FinishNext();
+
+		const Platform& platform_;
+		TextureCache* texture_cache_;
+
+		// indexed by handle, NULL for released handles
+		std::vector<Request*> requests_;
+		std::vector<Handle> free_handles_;
+		Int32 pending_count_;
+
+		std::vector<std::thread> workers_;
+		// loads waiting for a worker
+		std::deque<Handle> load_queue_;
+		// loads waiting for the main thread step
+		std::deque<Handle> finish_queue_;
+		mutable std::mutex mutex_;
+		// signalled when a load is queued or the workers should stop
+		std::condition_variable work_available_;
+		// signalled when a worker step finishes
+		std::condition_variable load_done_;
+		bool stopping_;
+	};
+}
+
+#endif // _GEF_ASSET_LOADER_H
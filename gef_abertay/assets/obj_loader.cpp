@@ -1,7 +1,6 @@
 #include <assets/obj_loader.h>
 #include <vector>
 #include <maths/vector4.h>
-#include <maths/vector2.h>
 #include <graphics/mesh.h>
 #include <graphics/primitive.h>
 #include <system/platform.h>
@@ -10,350 +9,826 @@
 #include <graphics/texture.h>
 #include <graphics/image_data.h>
 #include <system/file.h>
-#include <system/memory_stream_buffer.h>
+#include <system/job_system.h>
+#include <system/hash.h>
 #include <graphics/material.h>
 
+#include <cstddef>
 #include <cstdio>
 #include <cstring>
-#include <istream>
+#include <cfloat>
+#include <cmath>
+#include <fstream>
 
 namespace gef
 {
 
+// each parsing job gets about this much of the file
+static const Int32 kChunkSize = 256*1024;
+// vertices past this in a face are ignored
+static const Int32 kMaxFaceVertices = 64;
+static const Int32 kTrianglesPerRange = 16384;
 
-bool OBJLoader::Load(const char* filename, Platform& platform, Model& model)
+static const UInt32 kCacheMagic = 0x434a424f; // "OBJC"
+static const UInt32 kCacheVersion = 3;
+
+struct OBJCacheHeader
 {
-	bool success = true;
+	UInt32 magic;
+	UInt32 version;
+	Int32 source_size;
+	UInt32 pad;
+	UInt64 source_hash;
+	Int32 vertex_count;
+	Int32 primitive_count;
+	Int32 texture_count;
+	// the texture filenames follow the primitives, each with a terminating zero
+	Int32 texture_names_size;
+	Int32 material_library_count;
+	// then for each .mtl file its hash, its size and its filename with a terminating zero
+	Int32 material_libraries_size;
+};
+
+// indices into the file's positions, uvs and normals, -1 where the face has none
+struct OBJFaceVertex
+{
+	Int32 position;
+	Int32 uv;
+	Int32 normal;
+};
 
-	std::vector<Texture*> textures;
-	std::vector<gef::Vector4> positions;
-	std::vector<gef::Vector4> normals;
-	std::vector<gef::Vector2> uvs;
-	std::vector<Int32> face_indices;
-	std::vector<Int32> primitive_indices;
-	std::vector<Int32> texture_indices;
+struct OBJMaterialChange
+{
+	// the faces from here on use the material
+	Int32 first_triangle;
+	std::string name;
+};
 
-	std::map<std::string, Int32> materials;
+struct OBJChunk
+{
+	const char* begin;
+	const char* end;
+
+	// the count pass fills these in
+	Int32 position_count;
+	Int32 uv_count;
+	Int32 normal_count;
+	Int32 triangle_count;
+
+	// where the chunk's data goes in the whole file's arrays
+	Int32 first_position;
+	Int32 first_uv;
+	Int32 first_normal;
+	Int32 first_triangle;
+
+	// the parse pass fills these in
+	std::vector<OBJMaterialChange> material_changes;
+	std::vector<std::string> material_libraries;
+};
+
+struct OBJParseJob
+{
+	std::vector<OBJChunk> chunks;
+	Int32 position_count;
+	Int32 uv_count;
+	Int32 normal_count;
+
+	// 3 floats a position and normal, 2 a uv
+	std::vector<float> positions;
+	std::vector<float> uvs;
+	std::vector<float> normals;
+	// 3 a triangle
+	std::vector<OBJFaceVertex> face_vertices;
+
+	Mesh::Vertex* vertices;
+};
+
+static inline bool IsSpace(const char c)
+{
+	return c == ' ' || c == '\t' || c == '\r';
+}
 
-	std::string obj_filename(filename);
-	void* obj_file_data = NULL;
-	Int32 file_size = 0;
-	gef::File* file = gef::File::Create();
+static inline const char* SkipSpaces(const char* p, const char* end)
+{
+	while(p < end && IsSpace(*p))
+		++p;
+	return p;
+}
 
-	success = file->Open(obj_filename.c_str());
-	if(success)
+// the start of the next line
+static inline const char* SkipLine(const char* p, const char* end)
+{
+	const char* new_line = (const char*)memchr(p, '\n', end - p);
+	return new_line ? new_line + 1 : end;
+}
+
+static inline const char* SkipToken(const char* p, const char* end)
+{
+	while(p < end && !IsSpace(*p) && *p != '\n')
+		++p;
+	return p;
+}
+
+// true if the line at p starts with keyword and then a space
+static inline bool MatchKeyword(const char* p, const char* end, const char* keyword, const Int32 length)
+{
+	return end - p > length && memcmp(p, keyword, length) == 0 && IsSpace(p[length]);
+}
+
+// the rest of the line without the spaces around it
+static std::string ReadName(const char* p, const char* end)
+{
+	p = SkipSpaces(p, end);
+	const char* name_end = p;
+	while(name_end < end && *name_end != '\n')
+		++name_end;
+	while(name_end > p && IsSpace(name_end[-1]))
+		--name_end;
+	return std::string(p, name_end);
+}
+
+static double Pow10(const Int32 exponent)
+{
+	// exact as doubles, so the common short numbers are correctly rounded
+	static const double powers[] =
 	{
-		success = file->GetSize(file_size);
-		if(success)
+		1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+	};
+	return exponent <= 22 ? powers[exponent] : pow(10.0, exponent);
+}
+
+// value is 0 if there isn't a number at p, anything after the number is left for the caller
+static const char* ParseFloat(const char* p, const char* end, float& value)
+{
+	p = SkipSpaces(p, end);
+	value = 0.0f;
+
+	const char* start = p;
+	bool negative = false;
+	if(p < end && (*p == '-' || *p == '+'))
+	{
+		negative = *p == '-';
+		++p;
+	}
+
+	// up to 19 significant digits fit in the mantissa, the rest only move the decimal point
+	UInt64 mantissa = 0;
+	Int32 significant_digits = 0;
+	Int32 exponent = 0;
+	bool has_digits = false;
+	for(; p < end && *p >= '0' && *p <= '9'; ++p)
+	{
+		has_digits = true;
+		if(significant_digits < 19)
 		{
-			obj_file_data = malloc(file_size);
-			success = obj_file_data != NULL;
-			if(success)
+			mantissa = mantissa*10 + (*p - '0');
+			if(mantissa)
+				++significant_digits;
+		}
+		else
+			++exponent;
+	}
+	if(p < end && *p == '.')
+	{
+		for(++p; p < end && *p >= '0' && *p <= '9'; ++p)
+		{
+			has_digits = true;
+			if(significant_digits < 19)
 			{
-				Int32 bytes_read;
-				success = file->Read(obj_file_data, file_size, bytes_read);
-				if(success)
-					success = bytes_read == file_size;
+				mantissa = mantissa*10 + (*p - '0');
+				if(mantissa)
+					++significant_digits;
+				--exponent;
 			}
 		}
 	}
+	if(!has_digits)
+		return start;
 
-	if(!success)
+	if(p < end && (*p == 'e' || *p == 'E'))
 	{
-		free(obj_file_data);
-		obj_file_data = NULL;
+		const char* exponent_start = p++;
+		bool negative_exponent = false;
+		if(p < end && (*p == '-' || *p == '+'))
+		{
+			negative_exponent = *p == '-';
+			++p;
+		}
+		if(p < end && *p >= '0' && *p <= '9')
+		{
+			Int32 written_exponent = 0;
+			for(; p < end && *p >= '0' && *p <= '9'; ++p)
+			{
+				if(written_exponent < 10000)
+					written_exponent = written_exponent*10 + (*p - '0');
+			}
+			exponent += negative_exponent ? -written_exponent : written_exponent;
+		}
+		else
+			p = exponent_start;
+	}
 
-		delete file;
-		file = NULL;
-		return false;
+	double result = (double)mantissa;
+	if(mantissa && exponent < 0)
+		result = exponent < -300 ? 0.0 : result / Pow10(-exponent);
+	else if(mantissa && exponent > 0)
+		result = exponent > 300 ? HUGE_VAL : result * Pow10(exponent);
+
+	value = (float)(negative ? -result : result);
+	return p;
+}
+
+// value is 0 if there isn't a number at p
+static const char* ParseInt(const char* p, const char* end, Int32& value)
+{
+	bool negative = false;
+	if(p < end && (*p == '-' || *p == '+'))
+	{
+		negative = *p == '-';
+		++p;
 	}
-	gef::MemoryStreamBuffer buffer((char*)obj_file_data, file_size);
-	std::istream stream(&buffer);
 
+	Int32 result = 0;
+	for(; p < end && *p >= '0' && *p <= '9'; ++p)
+		result = result*10 + (*p - '0');
+
+	value = negative ? -result : result;
+	return p;
+}
+
+// from a one based or negative relative index to a zero based one, -1 if it doesn't refer to anything
+static inline Int32 ResolveIndex(const Int32 index, const Int32 count_so_far, const Int32 count)
+{
+	const Int32 resolved = index > 0 ? index - 1 : count_so_far + index;
+	return index != 0 && resolved >= 0 && resolved < count ? resolved : -1;
+}
+
+// a face vertex is one token of v, v/vt, v//vn or v/vt/vn
+static const char* ParseFaceVertex(const char* p, const char* token_end, OBJFaceVertex& face_vertex)
+{
+	face_vertex.uv = 0;
+	face_vertex.normal = 0;
+	p = ParseInt(p, token_end, face_vertex.position);
+	if(p < token_end && *p == '/')
 	{
-		while( !stream.eof() )
-		{
-		    char line[128];
-			stream >> line;
-			if ( strcmp( line, "mtllib" ) == 0 )
-			{
-				char material_filename[256];
-				stream >> material_filename;
+		++p;
+		if(p < token_end && *p != '/')
+			p = ParseInt(p, token_end, face_vertex.uv);
+		if(p < token_end && *p == '/')
+			p = ParseInt(p + 1, token_end, face_vertex.normal);
+	}
+	return token_end;
+}
 
-				LoadMaterials(platform, material_filename, materials, textures);
-			}
+// the count pass and the parse pass must agree on the number of face vertices on a line
+static Int32 CountFaceVertices(const char* p, const char* end)
+{
+	Int32 vertex_count = 0;
+	for(;;)
+	{
+		p = SkipSpaces(p, end);
+		if(p == end || *p == '\n' || *p == '#')
+			break;
+		p = SkipToken(p, end);
+		++vertex_count;
+	}
+	return vertex_count < kMaxFaceVertices ? vertex_count : kMaxFaceVertices;
+}
 
-			// vertices
-			else if ( strcmp( line, "v" ) == 0 )
+static void CountChunks(void* user_data, const Int32 begin, const Int32 end)
+{
+	OBJParseJob& job = *(OBJParseJob*)user_data;
+	for(Int32 chunk_num = begin; chunk_num < end; ++chunk_num)
+	{
+		OBJChunk& chunk = job.chunks[chunk_num];
+		chunk.position_count = 0;
+		chunk.uv_count = 0;
+		chunk.normal_count = 0;
+		chunk.triangle_count = 0;
+
+		for(const char* line = chunk.begin; line < chunk.end; line = SkipLine(line, chunk.end))
+		{
+			const char* p = SkipSpaces(line, chunk.end);
+			if(MatchKeyword(p, chunk.end, "v", 1))
+				++chunk.position_count;
+			else if(MatchKeyword(p, chunk.end, "vt", 2))
+				++chunk.uv_count;
+			else if(MatchKeyword(p, chunk.end, "vn", 2))
+				++chunk.normal_count;
+			else if(MatchKeyword(p, chunk.end, "f", 1))
 			{
-				float x, y, z;
-				stream >> x;
-				stream >> y;
-				stream >> z;
-				positions.push_back(gef::Vector4(x, y, z));
+				const Int32 face_vertex_count = CountFaceVertices(p + 1, chunk.end);
+				if(face_vertex_count >= 3)
+					chunk.triangle_count += face_vertex_count - 2;
 			}
+		}
+	}
+}
 
-			// normals
-			else if ( strcmp( line, "vn" ) == 0 )
+static void ParseChunks(void* user_data, const Int32 begin, const Int32 end)
+{
+	OBJParseJob& job = *(OBJParseJob*)user_data;
+	for(Int32 chunk_num = begin; chunk_num < end; ++chunk_num)
+	{
+		OBJChunk& chunk = job.chunks[chunk_num];
+		float* position = job.positions.empty() ? NULL : &job.positions[chunk.first_position*3];
+		float* uv = job.uvs.empty() ? NULL : &job.uvs[chunk.first_uv*2];
+		float* normal = job.normals.empty() ? NULL : &job.normals[chunk.first_normal*3];
+		OBJFaceVertex* triangle = job.face_vertices.empty() ? NULL : &job.face_vertices[chunk.first_triangle*3];
+		Int32 position_count = chunk.first_position;
+		Int32 uv_count = chunk.first_uv;
+		Int32 normal_count = chunk.first_normal;
+		Int32 triangle_count = 0;
+
+		for(const char* line = chunk.begin; line < chunk.end; line = SkipLine(line, chunk.end))
+		{
+			const char* p = SkipSpaces(line, chunk.end);
+			if(MatchKeyword(p, chunk.end, "v", 1))
 			{
-				float nx, ny, nz;
-				stream >> nx;
-				stream >> ny;
-				stream >> nz;
-				normals.push_back(gef::Vector4(nx, ny, nz));
+				p = ParseFloat(p + 1, chunk.end, position[0]);
+				p = ParseFloat(p, chunk.end, position[1]);
+				ParseFloat(p, chunk.end, position[2]);
+				position += 3;
+				++position_count;
 			}
-
-			// uvs
-			else if ( strcmp( line, "vt" ) == 0 )
+			else if(MatchKeyword(p, chunk.end, "vt", 2))
 			{
-				float u, v;
-				stream >> u;
-				stream >> v;
-				uvs.push_back(gef::Vector2(u, v));
+				p = ParseFloat(p + 2, chunk.end, uv[0]);
+				ParseFloat(p, chunk.end, uv[1]);
+				uv += 2;
+				++uv_count;
 			}
-
-			else if(strcmp( line, "usemtl" ) == 0)
+			else if(MatchKeyword(p, chunk.end, "vn", 2))
 			{
-
-				char material_name[256];
-				stream >> material_name;
-
-				// any time the material is changed
-				// a new primitive is created
-				primitive_indices.push_back((Int32)face_indices.size());
-
-				texture_indices.push_back(materials[material_name]);
+				p = ParseFloat(p + 2, chunk.end, normal[0]);
+				p = ParseFloat(p, chunk.end, normal[1]);
+				ParseFloat(p, chunk.end, normal[2]);
+				normal += 3;
+				++normal_count;
 			}
-			else if ( strcmp( line, "f" ) == 0 )
+			else if(MatchKeyword(p, chunk.end, "f", 1))
 			{
-				Int32 vertexIndex[3], uvIndex[3], normalIndex[3];
-/*
-    //std::string vertex1, vertex2, vertex3;
-				Int32 matches = fscanf(file, "%d/%d/%d %d/%d/%d %d/%d/%d\n", &vertexIndex[0], &uvIndex[0], &normalIndex[0], &vertexIndex[1], &uvIndex[1], &normalIndex[1], &vertexIndex[2], &uvIndex[2], &normalIndex[2] );
-				if (matches != 9)
+				OBJFaceVertex face[kMaxFaceVertices];
+				const Int32 face_vertex_count = CountFaceVertices(p + 1, chunk.end);
+				++p;
+				for(Int32 face_vertex_num = 0; face_vertex_num < face_vertex_count; ++face_vertex_num)
 				{
-//					printf("File can't be read by our simple parser : ( Try exporting with other options\n");
-					success = false;
+					p = SkipSpaces(p, chunk.end);
+					p = ParseFaceVertex(p, SkipToken(p, chunk.end), face[face_vertex_num]);
+
+					// relative indices count back from the data before this line, from the whole file
+					OBJFaceVertex& face_vertex = face[face_vertex_num];
+					face_vertex.position = ResolveIndex(face_vertex.position, position_count, job.position_count);
+					face_vertex.uv = ResolveIndex(face_vertex.uv, uv_count, job.uv_count);
+					face_vertex.normal = ResolveIndex(face_vertex.normal, normal_count, job.normal_count);
 				}
-*/
-
-				stream >> vertexIndex[0]; stream.ignore(); stream >> uvIndex[0]; stream.ignore(); stream >> normalIndex[0];
-				stream >> vertexIndex[1]; stream.ignore(); stream >> uvIndex[1]; stream.ignore(); stream >> normalIndex[1];
-				stream >> vertexIndex[2]; stream.ignore(); stream >> uvIndex[2]; stream.ignore(); stream >> normalIndex[2];
 
-				face_indices.push_back(vertexIndex[2]);
-				face_indices.push_back(uvIndex[2]);
-				face_indices.push_back(normalIndex[2]);
-
-				face_indices.push_back(vertexIndex[1]);
-				face_indices.push_back(uvIndex[1]);
-				face_indices.push_back(normalIndex[1]);
-
-				face_indices.push_back(vertexIndex[0]);
-				face_indices.push_back(uvIndex[0]);
-				face_indices.push_back(normalIndex[0]);
+				// a fan around the first vertex, with the winding reversed
+				for(Int32 face_vertex_num = 2; face_vertex_num < face_vertex_count; ++face_vertex_num)
+				{
+					triangle[0] = face[face_vertex_num];
+					triangle[1] = face[face_vertex_num-1];
+					triangle[2] = face[0];
+					triangle += 3;
+					++triangle_count;
+				}
+			}
+			else if(MatchKeyword(p, chunk.end, "usemtl", 6))
+			{
+				OBJMaterialChange material_change;
+				material_change.first_triangle = chunk.first_triangle + triangle_count;
+				material_change.name = ReadName(p + 6, chunk.end);
+				chunk.material_changes.push_back(material_change);
 			}
+			else if(MatchKeyword(p, chunk.end, "mtllib", 6))
+				chunk.material_libraries.push_back(ReadName(p + 6, chunk.end));
 		}
+	}
+}
 
-		// don't need the font file data any more
-		free(obj_file_data);
-		obj_file_data = NULL;
-
-		// finished reading the file
-//		fclose(file);
-		// start building the mesh
-		Int32 num_faces = (Int32)face_indices.size() / 9;
-		Int32 num_vertices = num_faces*3;
-
-		// create vertex buffer
-		gef::Mesh::Vertex* vertices = new gef::Mesh::Vertex[num_vertices];
+static void BuildVertices(void* user_data, const Int32 begin, const Int32 end)
+{
+	const OBJParseJob& job = *(const OBJParseJob*)user_data;
+	for(Int32 vertex_num = begin*3; vertex_num < end*3; ++vertex_num)
+	{
+		const OBJFaceVertex& face_vertex = job.face_vertices[vertex_num];
+		Mesh::Vertex& vertex = job.vertices[vertex_num];
 
-		// need to record min and max position values for mesh bounds
-		gef::Vector4 pos_min(FLT_MAX, FLT_MAX, FLT_MAX), pos_max(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+		if(face_vertex.position != -1)
+		{
+			const float* position = &job.positions[face_vertex.position*3];
+			vertex.px = position[0];
+			vertex.py = position[1];
+			vertex.pz = position[2];
+		}
+		else
+			vertex.px = vertex.py = vertex.pz = 0.0f;
 
-		for(Int32 vertex_num = 0; vertex_num < num_vertices; ++vertex_num)
+		if(face_vertex.normal != -1)
 		{
-			gef::Mesh::Vertex* vertex = &vertices[vertex_num];
-			gef::Vector4 position = positions[face_indices[vertex_num*3]-1];
-			gef::Vector2 uv = uvs[face_indices[vertex_num*3+1]-1];
-			gef::Vector4 normal = normals[face_indices[vertex_num*3+2]-1];
-
-			vertex->px = position.x();
-			vertex->py = position.y();
-			vertex->pz = position.z();
-			vertex->nx = normal.x();
-			vertex->ny = normal.y();
-			vertex->nz = normal.z();
-			vertex->u = uv.x;
-			vertex->v = -uv.y;
-
-			// update min and max positions for bounds
-			if (position.x() < pos_min.x())
-				pos_min.set_x(position.x());
-			if (position.y() < pos_min.y())
-				pos_min.set_y(position.y());
-			if (position.z() < pos_min.z())
-				pos_min.set_z(position.z());
-			if (position.x() > pos_max.x())
-				pos_max.set_x(position.x());
-			if (position.y() > pos_max.y())
-				pos_max.set_y(position.y());
-			if (position.z() > pos_max.z())
-				pos_max.set_z(position.z());
+			const float* normal = &job.normals[face_vertex.normal*3];
+			vertex.nx = normal[0];
+			vertex.ny = normal[1];
+			vertex.nz = normal[2];
 		}
+		else
+			vertex.nx = vertex.ny = vertex.nz = 0.0f;
 
+		if(face_vertex.uv != -1)
+		{
+			const float* uv = &job.uvs[face_vertex.uv*2];
+			vertex.u = uv[0];
+			vertex.v = -uv[1];
+		}
+		else
+			vertex.u = vertex.v = 0.0f;
+	}
+}
 
-		Mesh* mesh = new Mesh(platform);
-		model.set_mesh(mesh);
-		model.set_textures(textures);
+bool OBJLoader::IsMaterialLibraryCurrent(const MaterialLibrary& material_library) const
+{
+	File* file = File::Create();
+	Int32 file_size = 0;
+	const char* mtl_data = file->Open(material_library.filename.c_str()) ? (const char*)file->Map(file_size) : NULL;
+	const bool current = mtl_data ? material_library.size == file_size && material_library.hash == GetDataHash(mtl_data, file_size) : material_library.size == -1;
+	delete file;
+	return current;
+}
 
-		// set bounds
-		gef::Aabb aabb(pos_min, pos_max);
-		gef::Sphere sphere(aabb);
-		mesh->set_aabb(aabb);
-		mesh->set_bounding_sphere(sphere);
+OBJLoader::OBJLoader() :
+	job_system_(NULL),
+	cache_enabled_(false)
+{
+}
 
+bool OBJLoader::Load(const char* filename, Platform& platform, Model& model)
+{
+	File* file = File::Create();
+	Int32 file_size = 0;
+	const char* obj_data = file->Open(filename) ? (const char*)file->Map(file_size) : NULL;
+	if(!obj_data)
+	{
+		delete file;
+		return false;
+	}
 
-		// create materials for each texture
-		for(std::vector<Texture*>::iterator texture=textures.begin(); texture != textures.end(); ++texture)
+	ParsedModel parsed_model;
+	bool success = false;
+	if(cache_enabled_)
+	{
+		const std::string cache_filename = std::string(filename) + ".cache";
+		const UInt64 source_hash = GetDataHash(obj_data, file_size);
+		success = ReadCache(cache_filename, file_size, source_hash, parsed_model);
+		if(!success)
 		{
-			Material* material = new Material();
-			material->set_texture(*texture);
-			model.AddMaterial(material);
+			success = Parse(obj_data, file_size, parsed_model);
+			if(success)
+				WriteCache(cache_filename, file_size, source_hash, parsed_model);
 		}
+	}
+	else
+		success = Parse(obj_data, file_size, parsed_model);
 
-		mesh->InitVertexBuffer(platform, vertices, num_vertices, sizeof(gef::Mesh::Vertex));
-
-		// create primitives
-		mesh->AllocatePrimitives((UInt32)primitive_indices.size());
+	// the parsed model doesn't point into the file
+	delete file;
 
-		std::vector<UInt32*> indices;
-		indices.resize(primitive_indices.size());
-		for(UInt32 primitive_num=0;primitive_num<primitive_indices.size();++primitive_num)
-		{
-			Int32 index_count = 0;
+	if(success)
+		BuildModel(platform, parsed_model, model);
+	return success;
+}
 
-			if(primitive_num == primitive_indices.size()-1)
-				index_count = (Int32)face_indices.size() - primitive_indices[primitive_num];
-			else
-				index_count = primitive_indices[primitive_num+1] - primitive_indices[primitive_num];
+bool OBJLoader::Parse(const char* obj_data, const Int32 size, ParsedModel& parsed_model) const
+{
+	const char* obj_end = obj_data + size;
+	OBJParseJob job;
 
-			// 9 indices per triangle, index count is the number of vertices in this primitive
-			index_count /= 3;
+	// chunks end on line ends so no line is split between jobs
+	for(const char* chunk_begin = obj_data; chunk_begin < obj_end; )
+	{
+		OBJChunk chunk = OBJChunk();
+		chunk.begin = chunk_begin;
+		chunk.end = obj_end - chunk_begin > kChunkSize ? SkipLine(chunk_begin + kChunkSize, obj_end) : obj_end;
+		job.chunks.push_back(chunk);
+		chunk_begin = chunk.end;
+	}
+	const Int32 chunk_count = (Int32)job.chunks.size();
+
+	if(job_system_)
+		job_system_->ParallelFor(chunk_count, 1, CountChunks, &job);
+	else
+		CountChunks(&job, 0, chunk_count);
+
+	// each chunk's data goes after the data of the chunks before it
+	job.position_count = 0;
+	job.uv_count = 0;
+	job.normal_count = 0;
+	Int32 triangle_count = 0;
+	for(std::vector<OBJChunk>::iterator chunk = job.chunks.begin(); chunk != job.chunks.end(); ++chunk)
+	{
+		chunk->first_position = job.position_count;
+		chunk->first_uv = job.uv_count;
+		chunk->first_normal = job.normal_count;
+		chunk->first_triangle = triangle_count;
+		job.position_count += chunk->position_count;
+		job.uv_count += chunk->uv_count;
+		job.normal_count += chunk->normal_count;
+		triangle_count += chunk->triangle_count;
+	}
 
-			indices[primitive_num] = new UInt32[index_count];
+	if(triangle_count == 0)
+		return false;
 
-			for(Int32 index=0;index<index_count;++index)
-				indices[primitive_num][index] = primitive_indices[primitive_num]+index;
+	job.positions.resize(job.position_count*3);
+	job.uvs.resize(job.uv_count*2);
+	job.normals.resize(job.normal_count*3);
+	job.face_vertices.resize(triangle_count*3);
 
-			mesh->GetPrimitive(primitive_num)->set_type(gef::TRIANGLE_LIST);
-			mesh->GetPrimitive(primitive_num)->InitIndexBuffer(platform, indices[primitive_num], index_count, sizeof(UInt32));
-//			mesh->GetPrimitive(primitive_num)->InitIndexBuffer(platform, indices[primitive_num], 3, sizeof(UInt32));
+	if(job_system_)
+		job_system_->ParallelFor(chunk_count, 1, ParseChunks, &job);
+	else
+		ParseChunks(&job, 0, chunk_count);
 
+	parsed_model.vertices.resize(triangle_count*3);
+	job.vertices = &parsed_model.vertices[0];
+	if(job_system_)
+		job_system_->ParallelFor(triangle_count, kTrianglesPerRange, BuildVertices, &job);
+	else
+		BuildVertices(&job, 0, triangle_count);
 
-			Int32 texture_index = texture_indices[primitive_num];
-			if(texture_index == -1)
-				mesh->GetPrimitive(primitive_num)->set_material(NULL);
-			else
-				mesh->GetPrimitive(primitive_num)->set_material(model.material(texture_index));
-			//mesh->GetPrimitive(primitive_num)->set_texture(textures_[0]);
-		}
+	// the materials, in the order they were in the file
+	std::map<std::string, Int32> materials;
+	for(std::vector<OBJChunk>::const_iterator chunk = job.chunks.begin(); chunk != job.chunks.end(); ++chunk)
+	{
+		for(std::vector<std::string>::const_iterator material_library = chunk->material_libraries.begin(); material_library != chunk->material_libraries.end(); ++material_library)
+			LoadMaterials(material_library->c_str(), materials, parsed_model);
+	}
 
-		// mesh construction complete
-		// clean up
-		DeleteArrayNull(vertices);
-		for(UInt32 primitive_num=0;primitive_num<indices.size();++primitive_num)
-			DeleteArrayNull(indices[primitive_num]);
+	// a new primitive each time the material changes, faces before the first usemtl don't have one
+	ParsedPrimitive primitive;
+	primitive.first_vertex = 0;
+	primitive.texture_index = -1;
+	for(std::vector<OBJChunk>::const_iterator chunk = job.chunks.begin(); chunk != job.chunks.end(); ++chunk)
+	{
+		for(std::vector<OBJMaterialChange>::const_iterator material_change = chunk->material_changes.begin(); material_change != chunk->material_changes.end(); ++material_change)
+		{
+			primitive.vertex_count = material_change->first_triangle*3 - primitive.first_vertex;
+			if(primitive.vertex_count > 0)
+				parsed_model.primitives.push_back(primitive);
 
+			std::map<std::string, Int32>::const_iterator material = materials.find(material_change->name);
+			primitive.first_vertex = material_change->first_triangle*3;
+			primitive.texture_index = material != materials.end() ? material->second : -1;
+		}
 	}
-	return success;
+	primitive.vertex_count = triangle_count*3 - primitive.first_vertex;
+	if(primitive.vertex_count > 0)
+		parsed_model.primitives.push_back(primitive);
+
+	return true;
 }
 
-bool OBJLoader::LoadMaterials(Platform& platform, const char* filename, std::map<std::string, Int32>& materials, std::vector<Texture*>& textures)
+bool OBJLoader::LoadMaterials(const char* filename, std::map<std::string, Int32>& materials, ParsedModel& parsed_model) const
 {
-	PNGLoader png_loader;
+	File* file = File::Create();
+	Int32 file_size = 0;
+	const char* mtl_data = file->Open(filename) ? (const char*)file->Map(file_size) : NULL;
 
-	bool success = true;
+	// recorded even when it can't be read, so the cache is dropped if it turns up later
+	MaterialLibrary material_library;
+	material_library.filename = filename;
+	material_library.size = mtl_data ? file_size : -1;
+	material_library.hash = mtl_data ? GetDataHash(mtl_data, file_size) : 0;
+	parsed_model.material_libraries.push_back(material_library);
 
+	if(!mtl_data)
+	{
+		delete file;
+		return false;
+	}
 
-	std::string mtl_filename(filename);
-	void* mtl_file_data = NULL;
-	Int32 file_size = 0;
-	gef::File* file = gef::File::Create();
-	success = file->Open(mtl_filename.c_str());
-	if(success)
+	std::map<std::string, std::string> material_name_mappings;
+	std::string material_name;
+	const char* mtl_end = mtl_data + file_size;
+	for(const char* line = mtl_data; line < mtl_end; line = SkipLine(line, mtl_end))
 	{
-		success = file->GetSize(file_size);
-		if(success)
+		const char* p = SkipSpaces(line, mtl_end);
+		if(MatchKeyword(p, mtl_end, "newmtl", 6))
 		{
-			mtl_file_data = malloc(file_size);
-			success = mtl_file_data != NULL;
-			if(success)
-			{
-				Int32 bytes_read;
-				success = file->Read(mtl_file_data, file_size, bytes_read);
-				if(success)
-					success = bytes_read == file_size;
-			}
+			material_name = ReadName(p + 6, mtl_end);
+			material_name_mappings[material_name] = "";
 		}
+		else if(MatchKeyword(p, mtl_end, "map_Kd", 6))
+			material_name_mappings[material_name] = ReadName(p + 6, mtl_end);
 	}
+	delete file;
 
-	if(!success)
+	for(std::map<std::string, std::string>::iterator iter = material_name_mappings.begin(); iter != material_name_mappings.end(); ++iter)
 	{
-		free(mtl_file_data);
-		mtl_file_data = NULL;
+		if(iter->second.compare("") != 0)
+		{
+			parsed_model.texture_filenames.push_back(iter->second);
+			materials[iter->first] = (Int32)parsed_model.texture_filenames.size()-1;
+		}
+		else
+		{
+			materials[iter->first] = -1;
+		}
+	}
 
+	return true;
+}
+
+bool OBJLoader::ReadCache(const std::string& cache_filename, const Int32 source_size, const UInt64 source_hash, ParsedModel& parsed_model) const
+{
+	File* file = File::Create();
+	Int32 file_size = 0;
+	const char* cache_data = file->Open(cache_filename.c_str()) ? (const char*)file->Map(file_size) : NULL;
+	if(!cache_data || file_size < (Int32)sizeof(OBJCacheHeader))
+	{
 		delete file;
-		file = NULL;
 		return false;
 	}
-	gef::MemoryStreamBuffer buffer((char*)mtl_file_data, file_size);
-	std::istream stream(&buffer);
 
+	OBJCacheHeader header;
+	memcpy(&header, cache_data, sizeof(header));
+	const UInt64 expected_size = sizeof(OBJCacheHeader) + (UInt64)header.vertex_count*sizeof(Mesh::Vertex) + (UInt64)header.primitive_count*sizeof(ParsedPrimitive)
+		+ (UInt64)header.texture_names_size + (UInt64)header.material_libraries_size;
+	bool success = header.magic == kCacheMagic && header.version == kCacheVersion
+		&& header.source_size == source_size && header.source_hash == source_hash
+		&& header.vertex_count > 0 && header.primitive_count >= 0 && header.texture_count >= 0 && header.texture_names_size >= 0
+		&& header.material_library_count >= 0 && header.material_libraries_size >= 0
+		&& expected_size == (UInt64)file_size;
 
+	if(success)
 	{
-		std::map<std::string, std::string> material_name_mappings;
-		char material_name[256];
-		while( !stream.eof() )
+		const char* data = cache_data + sizeof(OBJCacheHeader);
+		parsed_model.vertices.resize(header.vertex_count);
+		memcpy(&parsed_model.vertices[0], data, header.vertex_count*sizeof(Mesh::Vertex));
+		data += header.vertex_count*sizeof(Mesh::Vertex);
+
+		parsed_model.primitives.resize(header.primitive_count);
+		if(header.primitive_count)
+			memcpy(&parsed_model.primitives[0], data, header.primitive_count*sizeof(ParsedPrimitive));
+		data += header.primitive_count*sizeof(ParsedPrimitive);
+
+		const char* names_end = data + header.texture_names_size;
+		for(Int32 texture_num = 0; success && texture_num < header.texture_count; ++texture_num)
 		{
-		    char line[128];
-			stream >> line;
-
-			if ( strcmp( line, "newmtl" ) == 0 )
-			{
-				stream >> material_name;
-				material_name_mappings[material_name] = "";
-			}
-			else if(strcmp( line, "map_Kd" ) == 0)
+			const char* name_end = (const char*)memchr(data, 0, names_end - data);
+			success = name_end != NULL;
+			if(success)
 			{
-				char texture_name[256];
-				stream >> texture_name;
-				material_name_mappings[material_name] = texture_name;
+				parsed_model.texture_filenames.push_back(std::string(data, name_end));
+				data = name_end + 1;
 			}
 		}
 
-		free(mtl_file_data);
-		mtl_file_data = NULL;
-
-		for(std::map<std::string, std::string>::iterator iter = material_name_mappings.begin(); iter != material_name_mappings.end(); ++iter)
+		// the materials are only current if every .mtl file is the same as when the cache was written
+		data = names_end;
+		const char* libraries_end = data + header.material_libraries_size;
+		for(Int32 library_num = 0; success && library_num < header.material_library_count; ++library_num)
 		{
-			if(iter->second.compare("") != 0)
+			MaterialLibrary material_library;
+			const char* name_end = NULL;
+			success = libraries_end - data > (ptrdiff_t)(sizeof(UInt64) + sizeof(Int32));
+			if(success)
 			{
-				gef::ImageData image_data;
-				png_loader.Load(iter->second.c_str(), platform, image_data);
-				Texture* texture = gef::Texture::Create(platform, image_data);
-				textures.push_back(texture);
-				materials[iter->first] = (Int32)textures.size()-1;
+				memcpy(&material_library.hash, data, sizeof(UInt64));
+				memcpy(&material_library.size, data + sizeof(UInt64), sizeof(Int32));
+				data += sizeof(UInt64) + sizeof(Int32);
+				name_end = (const char*)memchr(data, 0, libraries_end - data);
+				success = name_end != NULL;
 			}
-			else
+			if(success)
 			{
-				materials[iter->first] = -1;
+				material_library.filename = std::string(data, name_end);
+				data = name_end + 1;
+				success = IsMaterialLibraryCurrent(material_library);
+				parsed_model.material_libraries.push_back(material_library);
 			}
 		}
+
+		for(std::vector<ParsedPrimitive>::const_iterator primitive = parsed_model.primitives.begin(); success && primitive != parsed_model.primitives.end(); ++primitive)
+		{
+			success = primitive->first_vertex >= 0 && primitive->vertex_count > 0 && primitive->first_vertex + primitive->vertex_count <= header.vertex_count
+				&& primitive->texture_index >= -1 && primitive->texture_index < header.texture_count;
+		}
 	}
 
+	delete file;
+
+	if(!success)
+	{
+		parsed_model.vertices.clear();
+		parsed_model.primitives.clear();
+		parsed_model.texture_filenames.clear();
+		parsed_model.material_libraries.clear();
+	}
 	return success;
+}
 
+bool OBJLoader::WriteCache(const std::string& cache_filename, const Int32 source_size, const UInt64 source_hash, const ParsedModel& parsed_model) const
+{
+	std::ofstream stream(cache_filename.c_str(), std::ios::out | std::ios::binary);
+	if(!stream.is_open())
+		return false;
+
+	OBJCacheHeader header;
+	memset(&header, 0, sizeof(header));
+	header.magic = kCacheMagic;
+	header.version = kCacheVersion;
+	header.source_size = source_size;
+	header.source_hash = source_hash;
+	header.vertex_count = (Int32)parsed_model.vertices.size();
+	header.primitive_count = (Int32)parsed_model.primitives.size();
+	header.texture_count = (Int32)parsed_model.texture_filenames.size();
+	for(std::vector<std::string>::const_iterator texture_filename = parsed_model.texture_filenames.begin(); texture_filename != parsed_model.texture_filenames.end(); ++texture_filename)
+		header.texture_names_size += (Int32)texture_filename->size() + 1;
+	header.material_library_count = (Int32)parsed_model.material_libraries.size();
+	for(std::vector<MaterialLibrary>::const_iterator material_library = parsed_model.material_libraries.begin(); material_library != parsed_model.material_libraries.end(); ++material_library)
+		header.material_libraries_size += (Int32)(sizeof(UInt64) + sizeof(Int32) + material_library->filename.size() + 1);
+
+	stream.write((const char*)&header, sizeof(header));
+	stream.write((const char*)&parsed_model.vertices[0], parsed_model.vertices.size()*sizeof(Mesh::Vertex));
+	if(!parsed_model.primitives.empty())
+		stream.write((const char*)&parsed_model.primitives[0], parsed_model.primitives.size()*sizeof(ParsedPrimitive));
+	for(std::vector<std::string>::const_iterator texture_filename = parsed_model.texture_filenames.begin(); texture_filename != parsed_model.texture_filenames.end(); ++texture_filename)
+		stream.write(texture_filename->c_str(), texture_filename->size() + 1);
+	for(std::vector<MaterialLibrary>::const_iterator material_library = parsed_model.material_libraries.begin(); material_library != parsed_model.material_libraries.end(); ++material_library)
+	{
+		stream.write((const char*)&material_library->hash, sizeof(UInt64));
+		stream.write((const char*)&material_library->size, sizeof(Int32));
+		stream.write(material_library->filename.c_str(), material_library->filename.size() + 1);
+	}
+
+	return stream.good();
+}
+
+void OBJLoader::BuildModel(Platform& platform, const ParsedModel& parsed_model, Model& model) const
+{
+	PNGLoader png_loader;
+	std::vector<Texture*> textures;
+	for(std::vector<std::string>::const_iterator texture_filename = parsed_model.texture_filenames.begin(); texture_filename != parsed_model.texture_filenames.end(); ++texture_filename)
+	{
+		ImageData image_data;
+		png_loader.Load(texture_filename->c_str(), platform, image_data);
+		textures.push_back(Texture::Create(platform, image_data));
+	}
+
+	// need to record min and max position values for mesh bounds
+	Vector4 pos_min(FLT_MAX, FLT_MAX, FLT_MAX), pos_max(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+	for(std::vector<Mesh::Vertex>::const_iterator vertex = parsed_model.vertices.begin(); vertex != parsed_model.vertices.end(); ++vertex)
+	{
+		if (vertex->px < pos_min.x())
+			pos_min.set_x(vertex->px);
+		if (vertex->py < pos_min.y())
+			pos_min.set_y(vertex->py);
+		if (vertex->pz < pos_min.z())
+			pos_min.set_z(vertex->pz);
+		if (vertex->px > pos_max.x())
+			pos_max.set_x(vertex->px);
+		if (vertex->py > pos_max.y())
+			pos_max.set_y(vertex->py);
+		if (vertex->pz > pos_max.z())
+			pos_max.set_z(vertex->pz);
+	}
+
+	Mesh* mesh = new Mesh(platform);
+	model.set_mesh(mesh);
+	model.set_textures(textures);
+
+	// set bounds
+	Aabb aabb(pos_min, pos_max);
+	Sphere sphere(aabb);
+	mesh->set_aabb(aabb);
+	mesh->set_bounding_sphere(sphere);
+
+	// create materials for each texture
+	for(std::vector<Texture*>::iterator texture=textures.begin(); texture != textures.end(); ++texture)
+	{
+		Material* material = new Material();
+		material->set_texture(*texture);
+		model.AddMaterial(material);
+	}
+
+	const Int32 num_vertices = (Int32)parsed_model.vertices.size();
+	mesh->InitVertexBuffer(platform, &parsed_model.vertices[0], num_vertices, sizeof(Mesh::Vertex));
+
+	// the vertices aren't shared, so each primitive's indices are just its range of vertices
+	std::vector<UInt32> indices(num_vertices);
+	for(Int32 index = 0; index < num_vertices; ++index)
+		indices[index] = index;
+
+	mesh->AllocatePrimitives((UInt32)parsed_model.primitives.size());
+	for(UInt32 primitive_num = 0; primitive_num < parsed_model.primitives.size(); ++primitive_num)
+	{
+		const ParsedPrimitive& parsed_primitive = parsed_model.primitives[primitive_num];
+		Primitive* primitive = mesh->GetPrimitive(primitive_num);
+		primitive->set_type(TRIANGLE_LIST);
+		primitive->InitIndexBuffer(platform, &indices[parsed_primitive.first_vertex], parsed_primitive.vertex_count, sizeof(UInt32));
+		primitive->set_material(parsed_primitive.texture_index == -1 ? NULL : model.material(parsed_primitive.texture_index));
+	}
 }
 
 }
@@ -2,6 +2,7 @@
 #define _GEF_OBJ_LOADER_H
 
 #include <gef.h>
+#include <graphics/mesh.h>
 #include <map>
 #include <string>
 #include <vector>
@@ -11,15 +12,72 @@ namespace gef
 	class Platform;
 	class Model;
 	class Texture;
+	class JobSystem;
 
+	// Loads a Wavefront .obj file and the .mtl files it uses into a Model.
+	//
+	// The file is parsed in place in two passes over chunks of whole lines. The
+	// first counts the vertices and faces in each chunk, so every array is sized
+	// once, and the second parses each chunk straight into its part of the arrays.
+	// The chunks are independent, so both passes are spread over the workers of a
+	// JobSystem when there is one. Faces with more than three vertices are split
+	// into fans of triangles.
+	//
+	// With the cache enabled, the parsed model is written next to the .obj and
+	// read from there by later loads, as long as the .obj hasn't changed.
 	class OBJLoader
 	{
 	public:
+		OBJLoader();
+
 		bool Load(const char* filename, Platform& platform, Model& model);
+
+		// job_system can be NULL to parse on the calling thread
+		inline void set_job_system(JobSystem* job_system) { job_system_ = job_system; }
+		inline JobSystem* job_system() const { return job_system_; }
+		// the cache is written to the .obj filename with .cache on the end, and is only used
+		// while the .obj and the .mtl files it uses are the same as when it was written
+		inline void set_cache_enabled(const bool cache_enabled) { cache_enabled_ = cache_enabled; }
+		inline bool cache_enabled() const { return cache_enabled_; }
+
 	private:
-		bool LoadMaterials(Platform& platform, const char* filename, std::map<std::string, Int32>& materials, std::vector<Texture*>& textures);
+		struct ParsedPrimitive
+		{
+			Int32 first_vertex;
+			Int32 vertex_count;
+			// into texture_filenames, -1 for no texture
+			Int32 texture_index;
+		};
+
+		// a .mtl file the model's materials came from, so the cache can tell when it has changed
+		struct MaterialLibrary
+		{
+			std::string filename;
+			// -1 if the file couldn't be read
+			Int32 size;
+			UInt64 hash;
+		};
+
+		// everything from the files needed to build the model
+		struct ParsedModel
+		{
+			std::vector<Mesh::Vertex> vertices;
+			std::vector<ParsedPrimitive> primitives;
+			std::vector<std::string> texture_filenames;
+			std::vector<MaterialLibrary> material_libraries;
+		};
+
+		bool Parse(const char* obj_data, const Int32 size, ParsedModel& parsed_model) const;
+		bool LoadMaterials(const char* filename, std::map<std::string, Int32>& materials, ParsedModel& parsed_model) const;
+		bool IsMaterialLibraryCurrent(const MaterialLibrary& material_library) const;
+		bool ReadCache(const std::string& cache_filename, const Int32 source_size, const UInt64 source_hash, ParsedModel& parsed_model) const;
+		bool WriteCache(const std::string& cache_filename, const Int32 source_size, const UInt64 source_hash, const ParsedModel& parsed_model) const;
+		void BuildModel(Platform& platform, const ParsedModel& parsed_model, Model& model) const;
+
+		JobSystem* job_system_;
+		bool cache_enabled_;
 	};
 }
 
 
-#endif // _OBJ_LOADER_H
\ No newline at end of file
+#endif // _GEF_OBJ_LOADER_H
@@ -46,206 +46,88 @@ namespace gef
 
     void PNGLoader::Load(const char* filename, const Platform& platform, ImageData& image_data)
     {
-        File* png_file   = gef::File::Create();
+        File* png_file = gef::File::Create();
 
-        bool success = png_file->Open(filename);
-        if(success)
-        {
-            // read entire file
-            UInt8* buffer = NULL;
-            Int32 file_size;
-            success = png_file->GetSize(file_size);
-            if(success)
-            {
-                buffer = new UInt8[file_size];
-                Int32 bytes_read;
-                success = png_file->Read(buffer, file_size, bytes_read);
-
-                if(success)
-                    success = png_file->Close();
-
-                if(success)
-                {
-                    png_structp png_ptr;
-                    png_infop info_ptr;
-                    UInt32 sig_read = 0;
-                    png_uint_32 width = 0;
-                    png_uint_32 height = 0;
-                    int bitDepth = 0;
-                    int colorType = -1;
-
-
-                    /* Create and initialize the png_struct
-                     * with the desired error handler
-                     * functions.  If you want to use the
-                     * default stderr and longjump method,
-                     * you can supply NULL for the last
-                     * three parameters.  We also supply the
-                     * the compiler header file version, so
-                     * that we know if the application
-                     * was compiled with a compatible version
-                     * of the library.  REQUIRED
-                     */
-                    png_ptr = png_create_read_struct(PNG_LIBPNG_VER_STRING,	NULL, NULL, NULL);
-
-                    if(png_ptr == NULL)
-                    {
-                        success = false;
-                        png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
-                        delete[] buffer;
-                        buffer = NULL;
-                    }
-
-                    if(success)
-                    {
-                        /* Allocate/initialize the memory
-                         * for image information.  REQUIRED. */
-                        info_ptr = png_create_info_struct(png_ptr);
-                        if (info_ptr == NULL)
-                        {
-                            success = false;
-                            delete[] buffer;
-                            buffer = NULL;
-                            png_destroy_read_struct(&png_ptr, NULL, NULL);
-                        }
-                    }
-
-                    if(success)
-                    {
-                        /* Set error handling if you are
-                         * using the setjmp/longjmp method
-                         * (this is the normal method of
-                         * doing things with libpng).
-                         * REQUIRED unless you  set up
-                         * your own error handlers in
-                         * the png_create_read_struct()
-                         * earlier.
-                         */
-                        if (setjmp(png_jmpbuf(png_ptr)))
-                        {
-                            success = false;
-                            delete[] buffer;
-                            buffer = NULL;
-
-                            /* Free all of the memory associated
-                             * with the png_ptr and info_ptr */
-                            png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
-                        }
-                    }
-
-                    if(success)
-                    {
-						PNGData data;
-						data.p = buffer;
-						data.len = file_size;
-
-                        png_set_read_fn(png_ptr, &data, ReadDataFromInputStream);
-
-                        /* If we have already
-                         * read some of the signature */
-                        png_set_sig_bytes(png_ptr, sig_read);
-
-                        png_read_info(png_ptr, info_ptr);
-
-                        png_uint_32 retval = png_get_IHDR(png_ptr, info_ptr,
-                                &width,
-                                &height,
-                                &bitDepth,
-                                &colorType,
-                                NULL, NULL, NULL);
-
-                        if(retval != 1)
-                        {
-                            success = false;
-                            delete[] buffer;
-                            buffer = NULL;
-
-                            /* Free all of the memory associated
-                             * with the png_ptr and info_ptr */
-                            png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
-                        }
-                    }
-
-                    if(success)
-                    {
-                        if(colorType == PNG_COLOR_TYPE_RGB)
-                        {
-                            png_set_add_alpha(png_ptr, 0xff, PNG_FILLER_AFTER);
-                            png_read_update_info(png_ptr, info_ptr);
+        // the file is only needed until it's decoded
+        Int32 file_size = 0;
+        const void* buffer = png_file->Open(filename) ? png_file->Map(file_size) : NULL;
+        if(buffer)
+            Decode(buffer, file_size, image_data);
 
-                            png_uint_32 retval = png_get_IHDR(png_ptr, info_ptr,
-                                    &width,
-                                    &height,
-                                    &bitDepth,
-                                    &colorType,
-                                    NULL, NULL, NULL);
-
-                            if(retval != 1)
-                            {
-                                success = false;
-                                delete[] buffer;
-                                buffer = NULL;
-
-                                /* Free all of the memory associated
-                                 * with the png_ptr and info_ptr */
-                                png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
-                            }
-
-                        }
-                    }
-
-                    if(success)
-                    {
-                        image_data.set_width(width);
-                        image_data.set_height(height);
-                        UInt32 row_bytes = (UInt32)png_get_rowbytes(png_ptr, info_ptr);
-                        UInt8* image_bytes = (UInt8*)malloc(row_bytes * height);
-                        image_data.set_image(image_bytes);
-
-                        switch(colorType)
-                        {
-                            case PNG_COLOR_TYPE_RGB:
-                                //      ParseRGB(outImage, png_ptr, info_ptr);
-                                break;
-
-                            case PNG_COLOR_TYPE_RGB_ALPHA:
-                                //outHasAlpha = true;
-                                ParseRGBA(image_data.image(), png_ptr, info_ptr, width, height);
-                                break;
-                        }
-                    }
-                }
-
-                // done
-                delete[] buffer;
-                buffer = NULL;
-            }
-        }
+        delete png_file;
     }
 
-    void PNGLoader::ParseRGBA(UInt8* out_image_buffer, void* the_png_ptr,
-            const void* the_info_ptr, UInt32 width, UInt32 height)
+    bool PNGLoader::Decode(const void* png_data, const Int32 png_size, ImageData& image_data)
     {
-        png_structp png_ptr = (png_structp)the_png_ptr;
-        png_infop info_ptr = (png_infop)the_info_ptr;
-
-        const png_uint_32 bytesPerRow = (png_uint_32)png_get_rowbytes(png_ptr, info_ptr);
-        UInt8* rowData = new UInt8[bytesPerRow];
-        const UInt32 kBytesPerPixel = bytesPerRow / width;
+        png_structp png_ptr;
+        png_infop info_ptr = NULL;
+        png_uint_32 width = 0;
+        png_uint_32 height = 0;
+        int bitDepth = 0;
+        int colorType = -1;
+
+        // must stay in scope until all the rows are read
+        PNGData data;
+        data.p = (png_bytep)png_data;
+        data.len = png_size;
+
+        // the rows are decoded straight into the image, so it's freed here if libpng fails part way through
+        UInt8* volatile image_bytes = NULL;
+        png_bytep* volatile row_pointers = NULL;
+
+        png_ptr = png_create_read_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
+        if(png_ptr == NULL)
+            return false;
+
+        info_ptr = png_create_info_struct(png_ptr);
+        if(info_ptr == NULL)
+        {
+            png_destroy_read_struct(&png_ptr, NULL, NULL);
+            return false;
+        }
 
-        // read single row at a time
-        for(UInt32 rowIdx = 0; rowIdx < height; ++rowIdx)
+        if(setjmp(png_jmpbuf(png_ptr)))
         {
-            png_read_row(png_ptr, (png_bytep)rowData, NULL);
+            free(image_bytes);
+            delete[] row_pointers;
+            png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
+            return false;
+        }
+
+        png_set_read_fn(png_ptr, &data, ReadDataFromInputStream);
+        png_read_info(png_ptr, info_ptr);
 
-            const UInt32 rowOffset = rowIdx * width;
-            UInt32 pixel_byte_offset = rowOffset*kBytesPerPixel;
-            memcpy(&out_image_buffer[pixel_byte_offset], rowData, width*kBytesPerPixel);
+        png_uint_32 retval = png_get_IHDR(png_ptr, info_ptr, &width, &height, &bitDepth, &colorType, NULL, NULL, NULL);
+        if(retval == 1 && colorType == PNG_COLOR_TYPE_RGB)
+        {
+            png_set_add_alpha(png_ptr, 0xff, PNG_FILLER_AFTER);
+            png_read_update_info(png_ptr, info_ptr);
+            retval = png_get_IHDR(png_ptr, info_ptr, &width, &height, &bitDepth, &colorType, NULL, NULL, NULL);
         }
 
-        delete [] rowData;
+        // rgb has the alpha filled in, so both come out as 8 bit rgba
+        if(retval != 1 || bitDepth != 8 || (colorType != PNG_COLOR_TYPE_RGB && colorType != PNG_COLOR_TYPE_RGB_ALPHA))
+        {
+            png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
+            return false;
+        }
 
-    }  // end ParseRGBA()
+        const UInt32 row_bytes = (UInt32)png_get_rowbytes(png_ptr, info_ptr);
+        image_bytes = (UInt8*)malloc(row_bytes * height);
+        row_pointers = new png_bytep[height];
+        for(UInt32 row_num = 0; row_num < height; ++row_num)
+            row_pointers[row_num] = image_bytes + row_num*row_bytes;
+
+        // libpng still decodes a row at a time, but into the image rather than through a copy
+        png_read_image(png_ptr, row_pointers);
+        png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
+        delete[] row_pointers;
+
+        image_data.set_width(width);
+        image_data.set_height(height);
+        image_data.set_image(image_bytes);
+        return true;
+    }
 
     UInt32 PNGLoader::NextPowerOfTwo(const UInt32 value)
     {
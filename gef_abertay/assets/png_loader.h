@@ -17,8 +17,10 @@ namespace gef
 		~PNGLoader();
 
 		void Load(const char* filename, const Platform& platform, ImageData& image_data);
+		// decodes a png that is already in memory to 8 bit rgba, returns false if it can't be
+		// safe to call from any thread, each call has its own decoder state
+		bool Decode(const void* png_data, const Int32 png_size, ImageData& image_data);
 	private:
-		void ParseRGBA(UInt8* out_image_buffer, void* png_ptr, const void* info_ptr, UInt32 width, UInt32 height);
 		UInt32 NextPowerOfTwo(const UInt32 value);
 	};
 
@@ -0,0 +1,411 @@
+#include <assets/texture_cache.h>
+#include <assets/png_loader.h>
+#include <graphics/texture.h>
+#include <system/file.h>
+#include <system/hash.h>
+#include <system/job_system.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+namespace gef
+{
+	static const UInt32 kCacheMagic = 0x43585447; // "GTXC"
+	static const UInt32 kCacheVersion = 2;
+	// pixel data starts on this boundary, so it can be handed straight to the graphics api
+	static const UInt32 kCacheAlignment = 16;
+
+	struct TextureCacheHeader
+	{
+		UInt32 magic;
+		UInt32 version;
+		Int32 entry_count;
+		UInt32 pad;
+	};
+
+	// one for each image, after the header. The pixels are 8 bit rgba rows with no padding
+	struct TextureCacheEntry
+	{
+		UInt64 content_hash;
+		UInt32 content_size;
+		UInt32 width;
+		UInt32 height;
+		UInt32 pad;
+		UInt64 offset;
+	};
+
+	struct TextureDecodeJob
+	{
+		const TextureCache* texture_cache;
+		const char* const* filenames;
+		TextureCache::DecodedTexture* decoded_textures;
+	};
+
+	static void DecodeTextures(void* user_data, const Int32 begin, const Int32 end)
+	{
+		const TextureDecodeJob& job = *(const TextureDecodeJob*)user_data;
+		for(Int32 texture_num = begin; texture_num < end; ++texture_num)
+			job.texture_cache->Decode(job.filenames[texture_num], job.decoded_textures[texture_num]);
+	}
+
+	static inline UInt64 AlignCacheOffset(const UInt64 offset)
+	{
+		return (offset + kCacheAlignment - 1) & ~(UInt64)(kCacheAlignment - 1);
+	}
+
+	static inline UInt64 CachePixelsSize(const UInt32 width, const UInt32 height)
+	{
+		return (UInt64)width*height*4;
+	}
+
+	static inline UInt32 ReadBigEndian(const UInt8* bytes)
+	{
+		return ((UInt32)bytes[0] << 24) | ((UInt32)bytes[1] << 16) | ((UInt32)bytes[2] << 8) | (UInt32)bytes[3];
+	}
+
+	// the dimensions from the IHDR chunk, which always comes first, so they are known without decoding
+	static void ReadPNGSize(const UInt8* png_data, const Int32 png_size, UInt32& width, UInt32& height)
+	{
+		static const UInt8 kPNGStart[] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n', 0, 0, 0, 13, 'I', 'H', 'D', 'R' };
+
+		width = 0;
+		height = 0;
+		if(png_size >= (Int32)sizeof(kPNGStart) + 8 && memcmp(png_data, kPNGStart, sizeof(kPNGStart)) == 0)
+		{
+			width = ReadBigEndian(png_data + sizeof(kPNGStart));
+			height = ReadBigEndian(png_data + sizeof(kPNGStart) + 4);
+		}
+	}
+
+	TextureCache::ContentKey::ContentKey() :
+		hash(0),
+		size(0),
+		width(0),
+		height(0)
+	{
+	}
+
+	bool TextureCache::ContentKey::operator<(const ContentKey& key) const
+	{
+		if(hash != key.hash)
+			return hash < key.hash;
+		if(size != key.size)
+			return size < key.size;
+		if(width != key.width)
+			return width < key.width;
+		return height < key.height;
+	}
+
+	TextureCache::DecodedTexture::DecodedTexture() :
+		from_cache_file(false),
+		success(false)
+	{
+	}
+
+	TextureCache::DecodedTexture::~DecodedTexture()
+	{
+		if(from_cache_file)
+			image_data.set_image(NULL);
+	}
+
+	TextureCache::TextureCache(const Platform& platform, JobSystem* job_system) :
+		platform_(platform),
+		job_system_(job_system),
+		cache_file_(NULL)
+	{
+	}
+
+	TextureCache::~TextureCache()
+	{
+		for(std::vector<Texture*>::iterator texture = textures_.begin(); texture != textures_.end(); ++texture)
+			delete *texture;
+
+		CloseCacheFile();
+		FreeNewCacheEntries();
+	}
+
+	void TextureCache::Load(const char* const* filenames, const Int32 count, Texture** textures)
+	{
+		// each file that isn't loaded yet is only decoded once, even if it's in the list more than once
+		std::vector<const char*> new_filenames;
+		std::map<std::string, bool> queued;
+		for(Int32 texture_num = 0; texture_num < count; ++texture_num)
+		{
+			if(!FindTexture(filenames[texture_num]) && queued.insert(std::make_pair(std::string(filenames[texture_num]), true)).second)
+				new_filenames.push_back(filenames[texture_num]);
+		}
+
+		if(!new_filenames.empty())
+		{
+			const Int32 new_count = (Int32)new_filenames.size();
+			std::vector<DecodedTexture> decoded_textures(new_count);
+
+			TextureDecodeJob job;
+			job.texture_cache = this;
+			job.filenames = &new_filenames[0];
+			job.decoded_textures = &decoded_textures[0];
+			if(job_system_)
+				job_system_->ParallelFor(new_count, 1, DecodeTextures, &job);
+			else
+				DecodeTextures(&job, 0, new_count);
+
+			// the textures are created in the order they were asked for, so which of two files
+			// with the same contents owns the texture doesn't depend on the decode order
+			for(std::vector<DecodedTexture>::iterator decoded_texture = decoded_textures.begin(); decoded_texture != decoded_textures.end(); ++decoded_texture)
+				Add(*decoded_texture);
+		}
+
+		if(textures)
+		{
+			for(Int32 texture_num = 0; texture_num < count; ++texture_num)
+				textures[texture_num] = FindTexture(filenames[texture_num]);
+		}
+	}
+
+	Texture* TextureCache::GetTexture(const char* filename)
+	{
+		Texture* texture = NULL;
+		Load(&filename, 1, &texture);
+		return texture;
+	}
+
+	Texture* TextureCache::FindTexture(const char* filename) const
+	{
+		std::map<std::string, Texture*>::const_iterator texture = filename_textures_.find(filename);
+		return texture != filename_textures_.end() ? texture->second : NULL;
+	}
+
+	void TextureCache::Decode(const char* filename, DecodedTexture& decoded_texture) const
+	{
+		decoded_texture.filename = filename;
+		decoded_texture.success = false;
+
+		File* file = File::Create();
+		Int32 file_size = 0;
+		const void* png_data = file->Open(filename) ? file->Map(file_size) : NULL;
+		if(png_data)
+		{
+			ContentKey& content_key = decoded_texture.content_key;
+			content_key.hash = GetDataHash(png_data, file_size);
+			content_key.size = (UInt32)file_size;
+			ReadPNGSize((const UInt8*)png_data, file_size, content_key.width, content_key.height);
+
+			std::map<ContentKey, CacheEntry>::const_iterator cache_entry = cache_entries_.find(content_key);
+			if(cache_entry != cache_entries_.end())
+			{
+				decoded_texture.image_data.set_width(content_key.width);
+				decoded_texture.image_data.set_height(content_key.height);
+				decoded_texture.image_data.set_image(const_cast<UInt8*>(cache_entry->second.pixels));
+				decoded_texture.from_cache_file = true;
+				decoded_texture.success = true;
+			}
+			else
+			{
+				PNGLoader png_loader;
+				decoded_texture.success = png_loader.Decode(png_data, file_size, decoded_texture.image_data);
+			}
+		}
+		delete file;
+	}
+
+	Texture* TextureCache::Add(DecodedTexture& decoded_texture)
+	{
+		Texture* texture = FindTexture(decoded_texture.filename.c_str());
+		if(texture || !decoded_texture.success)
+			return texture;
+
+		std::map<ContentKey, Texture*>::const_iterator content_texture = content_textures_.find(decoded_texture.content_key);
+		if(content_texture != content_textures_.end())
+			texture = content_texture->second;
+		else
+		{
+			texture = Texture::Create(platform_, decoded_texture.image_data);
+			if(!texture)
+				return NULL;
+
+			textures_.push_back(texture);
+			content_textures_[decoded_texture.content_key] = texture;
+
+			// only the map's keys are read by Decode, so this is safe while it runs on other threads
+			if(decoded_texture.from_cache_file)
+			{
+				std::map<ContentKey, CacheEntry>::iterator cache_entry = cache_entries_.find(decoded_texture.content_key);
+				if(cache_entry != cache_entries_.end())
+					cache_entry->second.used = true;
+			}
+
+			// keep the pixels until they have been written to the cache file. The key's
+			// dimensions give the size of the pixels there, so they have to match the image
+			const ContentKey& content_key = decoded_texture.content_key;
+			if(!cache_filename_.empty() && !decoded_texture.from_cache_file
+				&& content_key.width == decoded_texture.image_data.width() && content_key.height == decoded_texture.image_data.height())
+			{
+				NewCacheEntry new_cache_entry;
+				new_cache_entry.content_key = content_key;
+				new_cache_entry.pixels = decoded_texture.image_data.image();
+				new_cache_entries_.push_back(new_cache_entry);
+				decoded_texture.image_data.set_image(NULL);
+			}
+		}
+
+		filename_textures_[decoded_texture.filename] = texture;
+		return texture;
+	}
+
+	bool TextureCache::OpenCacheFile(const char* filename)
+	{
+		CloseCacheFile();
+		cache_filename_ = filename;
+
+		cache_file_ = File::Create();
+		Int32 file_size = 0;
+		const UInt8* cache_data = cache_file_->Open(filename) ? (const UInt8*)cache_file_->Map(file_size) : NULL;
+		if(!cache_data || file_size < (Int32)sizeof(TextureCacheHeader))
+		{
+			CloseCacheFile();
+			return false;
+		}
+
+		TextureCacheHeader header;
+		memcpy(&header, cache_data, sizeof(header));
+		bool success = header.magic == kCacheMagic && header.version == kCacheVersion && header.entry_count >= 0
+			&& sizeof(TextureCacheHeader) + (UInt64)header.entry_count*sizeof(TextureCacheEntry) <= (UInt64)file_size;
+
+		for(Int32 entry_num = 0; success && entry_num < header.entry_count; ++entry_num)
+		{
+			TextureCacheEntry entry;
+			memcpy(&entry, cache_data + sizeof(TextureCacheHeader) + entry_num*sizeof(TextureCacheEntry), sizeof(entry));
+
+			success = entry.offset <= (UInt64)file_size && CachePixelsSize(entry.width, entry.height) <= (UInt64)file_size - entry.offset;
+			if(success)
+			{
+				ContentKey content_key;
+				content_key.hash = entry.content_hash;
+				content_key.size = entry.content_size;
+				content_key.width = entry.width;
+				content_key.height = entry.height;
+				CacheEntry& cache_entry = cache_entries_[content_key];
+				cache_entry.pixels = cache_data + entry.offset;
+				cache_entry.used = false;
+			}
+		}
+
+		if(!success)
+			CloseCacheFile();
+		return success;
+	}
+
+	bool TextureCache::SaveCacheFile()
+	{
+		Int32 used_entry_count = 0;
+		for(std::map<ContentKey, CacheEntry>::const_iterator cache_entry = cache_entries_.begin(); cache_entry != cache_entries_.end(); ++cache_entry)
+		{
+			if(cache_entry->second.used)
+				++used_entry_count;
+		}
+
+		if(cache_filename_.empty() || (new_cache_entries_.empty() && used_entry_count == (Int32)cache_entries_.size()))
+			return true;
+
+		// the old file is still mapped, so the new one is written alongside it and swapped in after
+		const std::string temp_filename = cache_filename_ + ".tmp";
+		bool success;
+		{
+			std::ofstream stream(temp_filename.c_str(), std::ios::out | std::ios::binary);
+			success = stream.is_open();
+			if(success)
+			{
+				TextureCacheHeader header;
+				header.magic = kCacheMagic;
+				header.version = kCacheVersion;
+				header.entry_count = used_entry_count + (Int32)new_cache_entries_.size();
+				header.pad = 0;
+				stream.write((const char*)&header, sizeof(header));
+
+				// the entries, then the pixels in the same order
+				std::vector<const UInt8*> pixels;
+				std::vector<UInt64> pixels_sizes;
+				UInt64 offset = AlignCacheOffset(sizeof(TextureCacheHeader) + (UInt64)header.entry_count*sizeof(TextureCacheEntry));
+				for(std::map<ContentKey, CacheEntry>::const_iterator cache_entry = cache_entries_.begin(); cache_entry != cache_entries_.end(); ++cache_entry)
+				{
+					if(!cache_entry->second.used)
+						continue;
+
+					TextureCacheEntry entry;
+					entry.content_hash = cache_entry->first.hash;
+					entry.content_size = cache_entry->first.size;
+					entry.width = cache_entry->first.width;
+					entry.height = cache_entry->first.height;
+					entry.pad = 0;
+					entry.offset = offset;
+					stream.write((const char*)&entry, sizeof(entry));
+
+					pixels.push_back(cache_entry->second.pixels);
+					pixels_sizes.push_back(CachePixelsSize(entry.width, entry.height));
+					offset = AlignCacheOffset(offset + pixels_sizes.back());
+				}
+				for(std::vector<NewCacheEntry>::const_iterator new_cache_entry = new_cache_entries_.begin(); new_cache_entry != new_cache_entries_.end(); ++new_cache_entry)
+				{
+					TextureCacheEntry entry;
+					entry.content_hash = new_cache_entry->content_key.hash;
+					entry.content_size = new_cache_entry->content_key.size;
+					entry.width = new_cache_entry->content_key.width;
+					entry.height = new_cache_entry->content_key.height;
+					entry.pad = 0;
+					entry.offset = offset;
+					stream.write((const char*)&entry, sizeof(entry));
+
+					pixels.push_back(new_cache_entry->pixels);
+					pixels_sizes.push_back(CachePixelsSize(entry.width, entry.height));
+					offset = AlignCacheOffset(offset + pixels_sizes.back());
+				}
+
+				static const char padding[kCacheAlignment] = { 0 };
+				for(size_t pixels_num = 0; pixels_num < pixels.size(); ++pixels_num)
+				{
+					const UInt64 position = (UInt64)stream.tellp();
+					stream.write(padding, (std::streamsize)(AlignCacheOffset(position) - position));
+					stream.write((const char*)pixels[pixels_num], (std::streamsize)pixels_sizes[pixels_num]);
+				}
+
+				success = stream.good();
+			}
+		}
+
+		if(success)
+		{
+			const std::string cache_filename = cache_filename_;
+			CloseCacheFile();
+			FreeNewCacheEntries();
+
+			// rename won't replace a file on every platform
+			remove(cache_filename.c_str());
+			success = rename(temp_filename.c_str(), cache_filename.c_str()) == 0;
+			OpenCacheFile(cache_filename.c_str());
+
+			// everything written was in use, so it's kept by the next save too
+			for(std::map<ContentKey, CacheEntry>::iterator cache_entry = cache_entries_.begin(); cache_entry != cache_entries_.end(); ++cache_entry)
+				cache_entry->second.used = true;
+		}
+		else
+			remove(temp_filename.c_str());
+
+		return success;
+	}
+
+	void TextureCache::CloseCacheFile()
+	{
+		cache_entries_.clear();
+		delete cache_file_;
+		cache_file_ = NULL;
+	}
+
+	void TextureCache::FreeNewCacheEntries()
+	{
+		// the pixels came from PNGLoader, which allocates them with malloc
+		for(std::vector<NewCacheEntry>::iterator new_cache_entry = new_cache_entries_.begin(); new_cache_entry != new_cache_entries_.end(); ++new_cache_entry)
+			free(new_cache_entry->pixels);
+		new_cache_entries_.clear();
+	}
+}
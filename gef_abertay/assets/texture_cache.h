@@ -0,0 +1,125 @@
+#ifndef _GEF_TEXTURE_CACHE_H
+#define _GEF_TEXTURE_CACHE_H
+
+#include <gef.h>
+#include <graphics/image_data.h>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace gef
+{
+	class Platform;
+	class Texture;
+	class File;
+	class JobSystem;
+
+	// Creates each texture once, however many times it is asked for.
+	//
+	// Textures are looked up by filename first, then by the png's contents, so
+	// copies of the same image under different names share a texture too. The
+	// contents are matched by a hash of the file together with its size and
+	// the image's dimensions. A batch of pngs passed to Load is decoded at once, spread over
+	// the workers of a JobSystem.
+	//
+	// The decoded images can also be kept in a cache file of raw rgba pixels,
+	// keyed the same way. Images found there are used straight from the file's
+	// memory instead of being decoded, and a changed png has a new key, so it's
+	// decoded again.
+	//
+	// The cache owns the textures it creates and deletes them with it.
+	class TextureCache
+	{
+	public:
+		// what a png's contents are matched by
+		struct ContentKey
+		{
+			ContentKey();
+			bool operator<(const ContentKey& key) const;
+
+			UInt64 hash;
+			UInt32 size;
+			// from the png's header, 0 if it doesn't have one
+			UInt32 width;
+			UInt32 height;
+		};
+
+		// the worker thread half of loading one texture
+		struct DecodedTexture
+		{
+			DecodedTexture();
+			~DecodedTexture();
+
+			std::string filename;
+			ContentKey content_key;
+			ImageData image_data;
+			// the pixels are in the cache file's memory, so image_data doesn't own them
+			bool from_cache_file;
+			bool success;
+		};
+
+		// job_system can be NULL to decode on the calling thread
+		TextureCache(const Platform& platform, JobSystem* job_system = NULL);
+		~TextureCache();
+
+		// loads the files that aren't already loaded, textures is filled in with one texture
+		// for each file, NULL where it couldn't be loaded. textures can be NULL
+		void Load(const char* const* filenames, const Int32 count, Texture** textures = NULL);
+		// loads the file on its own if it isn't already loaded, NULL if it can't be
+		Texture* GetTexture(const char* filename);
+		// NULL if the file hasn't been loaded
+		Texture* FindTexture(const char* filename) const;
+
+		// reads the file's contents and decodes it, or finds it in the cache file
+		// const and safe to call from any thread, as long as the cache file isn't
+		// opened or saved at the same time
+		void Decode(const char* filename, DecodedTexture& decoded_texture) const;
+		// creates the texture for a decoded file, or returns the one already created for
+		// the same contents. Only call from the thread that owns the cache
+		Texture* Add(DecodedTexture& decoded_texture);
+
+		// the cache file is read here and kept open, images decoded after this are
+		// written to it by SaveCacheFile. Returns false if there wasn't a usable cache
+		// file, which isn't an error the first time
+		bool OpenCacheFile(const char* filename);
+		// writes the images from the cache file that were used since it was opened and the
+		// ones decoded since then, and reopens it. Images that weren't asked for, such as
+		// older versions of an edited png, are left out, so the file doesn't keep growing.
+		// Does nothing if nothing was decoded and every image in the file was used
+		bool SaveCacheFile();
+
+		inline Int32 texture_count() const { return (Int32)textures_.size(); }
+
+	private:
+		struct CacheEntry
+		{
+			const UInt8* pixels;
+			// set by Add, so SaveCacheFile only keeps what is still in use
+			bool used;
+		};
+
+		// an image decoded since the cache file was opened, waiting to be written to it
+		struct NewCacheEntry
+		{
+			ContentKey content_key;
+			UInt8* pixels;
+		};
+
+		void CloseCacheFile();
+		void FreeNewCacheEntries();
+
+		const Platform& platform_;
+		JobSystem* job_system_;
+
+		std::vector<Texture*> textures_;
+		std::map<std::string, Texture*> filename_textures_;
+		std::map<ContentKey, Texture*> content_textures_;
+
+		std::string cache_filename_;
+		File* cache_file_;
+		std::map<ContentKey, CacheEntry> cache_entries_;
+		std::vector<NewCacheEntry> new_cache_entries_;
+	};
+}
+
+#endif // _GEF_TEXTURE_CACHE_H
@@ -0,0 +1,145 @@
+#include <graphics/cpu_skinning.h>
+#include <graphics/mesh_data.h>
+#include <maths/matrix44.h>
+#include <maths/vector4.h>
+#include <maths/simd.h>
+#include <system/job_system.h>
+#include <math.h>
+
+namespace gef
+{
+	// vertices skinned by each range, enough to be worth handing to a worker
+	static const Int32 kVerticesPerRange = 1024;
+
+#if defined(GEF_SIMD)
+	static inline const float* MatrixRow(const Matrix44& matrix, const Int32 row)
+	{
+		return reinterpret_cast<const float*>(&matrix) + row*4;
+	}
+
+	static inline void SkinVertex(const Mesh::SkinnedVertex& vertex, const Matrix44* bone_matrices, Vector4* position, Vector4* normal)
+	{
+		// blend the bone matrices, then transform once, rather than transforming by every bone
+		simd::Float4 row0, row1, row2, row3;
+		{
+			const Matrix44& bone_matrix = bone_matrices[vertex.bone_indices[0]];
+			const simd::Float4 weight = simd::Splat(vertex.bone_weights[0]);
+			row0 = simd::Mul(weight, simd::Load(MatrixRow(bone_matrix, 0)));
+			row1 = simd::Mul(weight, simd::Load(MatrixRow(bone_matrix, 1)));
+			row2 = simd::Mul(weight, simd::Load(MatrixRow(bone_matrix, 2)));
+			row3 = simd::Mul(weight, simd::Load(MatrixRow(bone_matrix, 3)));
+		}
+		for(Int32 influence = 1; influence < 4; ++influence)
+		{
+			if(vertex.bone_weights[influence] == 0.0f)
+				continue;
+
+			const Matrix44& bone_matrix = bone_matrices[vertex.bone_indices[influence]];
+			const simd::Float4 weight = simd::Splat(vertex.bone_weights[influence]);
+			row0 = simd::MulAdd(weight, simd::Load(MatrixRow(bone_matrix, 0)), row0);
+			row1 = simd::MulAdd(weight, simd::Load(MatrixRow(bone_matrix, 1)), row1);
+			row2 = simd::MulAdd(weight, simd::Load(MatrixRow(bone_matrix, 2)), row2);
+			row3 = simd::MulAdd(weight, simd::Load(MatrixRow(bone_matrix, 3)), row3);
+		}
+
+		// position with w of 1
+		simd::Float4 skinned_position = simd::MulAdd(simd::Splat(vertex.px), row0, row3);
+		skinned_position = simd::MulAdd(simd::Splat(vertex.py), row1, skinned_position);
+		skinned_position = simd::MulAdd(simd::Splat(vertex.pz), row2, skinned_position);
+		simd::Store(reinterpret_cast<float*>(position), skinned_position);
+
+		if(normal)
+		{
+			// normal with w of 0, so the translation row is left out
+			simd::Float4 skinned_normal = simd::Mul(simd::Splat(vertex.nx), row0);
+			skinned_normal = simd::MulAdd(simd::Splat(vertex.ny), row1, skinned_normal);
+			skinned_normal = simd::MulAdd(simd::Splat(vertex.nz), row2, skinned_normal);
+
+			const float length_sqr = simd::Dot4(skinned_normal, skinned_normal);
+			if(length_sqr > 0.0f)
+				skinned_normal = simd::Mul(skinned_normal, simd::Splat(1.0f / sqrtf(length_sqr)));
+			simd::Store(reinterpret_cast<float*>(normal), skinned_normal);
+		}
+	}
+#else
+	static inline void SkinVertex(const Mesh::SkinnedVertex& vertex, const Matrix44* bone_matrices, Vector4* position, Vector4* normal)
+	{
+		// blend the bone matrices, then transform once, rather than transforming by every bone
+		float blended[4][4];
+		{
+			const Matrix44& bone_matrix = bone_matrices[vertex.bone_indices[0]];
+			const float weight = vertex.bone_weights[0];
+			for(Int32 row = 0; row < 4; ++row)
+				for(Int32 column = 0; column < 4; ++column)
+					blended[row][column] = weight*bone_matrix.m(row, column);
+		}
+		for(Int32 influence = 1; influence < 4; ++influence)
+		{
+			const float weight = vertex.bone_weights[influence];
+			if(weight == 0.0f)
+				continue;
+
+			const Matrix44& bone_matrix = bone_matrices[vertex.bone_indices[influence]];
+			for(Int32 row = 0; row < 4; ++row)
+				for(Int32 column = 0; column < 4; ++column)
+					blended[row][column] = weight*bone_matrix.m(row, column) + blended[row][column];
+		}
+
+		// position with w of 1
+		float skinned_position[4];
+		for(Int32 column = 0; column < 4; ++column)
+			skinned_position[column] = vertex.pz*blended[2][column] + (vertex.py*blended[1][column] + (vertex.px*blended[0][column] + blended[3][column]));
+		position->set_value(skinned_position[0], skinned_position[1], skinned_position[2], skinned_position[3]);
+
+		if(normal)
+		{
+			// normal with w of 0, so the translation row is left out
+			float skinned_normal[4];
+			for(Int32 column = 0; column < 4; ++column)
+				skinned_normal[column] = vertex.nz*blended[2][column] + (vertex.ny*blended[1][column] + vertex.nx*blended[0][column]);
+
+			const float length_sqr = skinned_normal[0]*skinned_normal[0] + skinned_normal[1]*skinned_normal[1] + skinned_normal[2]*skinned_normal[2] + skinned_normal[3]*skinned_normal[3];
+			const float scale = length_sqr > 0.0f ? 1.0f / sqrtf(length_sqr) : 1.0f;
+			normal->set_value(skinned_normal[0]*scale, skinned_normal[1]*scale, skinned_normal[2]*scale, skinned_normal[3]*scale);
+		}
+	}
+#endif
+
+	CpuSkinner::CpuSkinner(JobSystem* job_system) :
+		job_system_(job_system)
+	{
+	}
+
+	void CpuSkinner::Skin(const Mesh::SkinnedVertex* vertices, const Int32 vertex_count, const Matrix44* bone_matrices, const Int32 bone_count, Vector4* positions, Vector4* normals) const
+	{
+		if(vertex_count <= 0 || bone_count <= 0)
+			return;
+
+		SkinJob job;
+		job.vertices = vertices;
+		job.bone_matrices = bone_matrices;
+		job.positions = positions;
+		job.normals = normals;
+
+		if(job_system_)
+			job_system_->ParallelFor(vertex_count, kVerticesPerRange, SkinVertices, &job);
+		else
+			SkinVertices(&job, 0, vertex_count);
+	}
+
+	bool CpuSkinner::Skin(const VertexData& vertex_data, const Matrix44* bone_matrices, const Int32 bone_count, Vector4* positions, Vector4* normals) const
+	{
+		if(vertex_data.vertex_byte_size != sizeof(Mesh::SkinnedVertex))
+			return false;
+
+		Skin(static_cast<const Mesh::SkinnedVertex*>(vertex_data.vertices), vertex_data.num_vertices, bone_matrices, bone_count, positions, normals);
+		return true;
+	}
+
+	void CpuSkinner::SkinVertices(void* user_data, const Int32 begin, const Int32 end)
+	{
+		const SkinJob& job = *static_cast<const SkinJob*>(user_data);
+		for(Int32 vertex_num = begin; vertex_num < end; ++vertex_num)
+			SkinVertex(job.vertices[vertex_num], job.bone_matrices, &job.positions[vertex_num], job.normals ? &job.normals[vertex_num] : NULL);
+	}
+}
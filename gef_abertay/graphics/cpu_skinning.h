@@ -0,0 +1,52 @@
+#ifndef _GEF_CPU_SKINNING_H
+#define _GEF_CPU_SKINNING_H
+
+#include <gef.h>
+#include <graphics/mesh.h>
+#include <cstddef>
+
+namespace gef
+{
+	class Matrix44;
+	class Vector4;
+	class JobSystem;
+	struct VertexData;
+
+	// Skins vertices on the CPU, for platforms and tools with no GPU to do it.
+	//
+	// Takes the four influence Mesh::SkinnedVertex format written by
+	// Scene::FixUpSkinWeights and the same bone matrices that are passed to
+	// Renderer3D::DrawSkinnedMesh. The matrices of a vertex's bones are blended
+	// by weight, then the position and normal are transformed by the result,
+	// which gives the same positions as the skinning shaders. Vertices are
+	// independent, so ranges of them are spread over the workers of a JobSystem.
+	class CpuSkinner
+	{
+	public:
+		// job_system can be NULL to skin every vertex on the calling thread
+		CpuSkinner(JobSystem* job_system = NULL);
+
+		// writes vertex_count skinned positions, with w of 1, and normals, with w of 0 and normalised
+		// every bone index must be less than bone_count, normals can be NULL if they aren't needed
+		void Skin(const Mesh::SkinnedVertex* vertices, const Int32 vertex_count, const Matrix44* bone_matrices, const Int32 bone_count, Vector4* positions, Vector4* normals) const;
+		// returns false without skinning anything if the vertices aren't Mesh::SkinnedVertex
+		bool Skin(const VertexData& vertex_data, const Matrix44* bone_matrices, const Int32 bone_count, Vector4* positions, Vector4* normals) const;
+
+		inline JobSystem* job_system() const { return job_system_; }
+
+	private:
+		struct SkinJob
+		{
+			const Mesh::SkinnedVertex* vertices;
+			const Matrix44* bone_matrices;
+			Vector4* positions;
+			Vector4* normals;
+		};
+
+		static void SkinVertices(void* user_data, const Int32 begin, const Int32 end);
+
+		JobSystem* job_system_;
+	};
+}
+
+#endif // _GEF_CPU_SKINNING_H
@@ -0,0 +1,63 @@
+#include <graphics/default_3d_instanced_shader.h>
+#include <graphics/shader_interface.h>
+#include <graphics/mesh.h>
+
+namespace gef
+{
+	Default3DInstancedShader::Default3DInstancedShader(const Platform& platform)
+		: view_projection_matrix_variable_index_(-1)
+	{
+		device_interface_ = ShaderInterface::Create(platform);
+
+		char* vs_shader_source = NULL;
+		Int32 vs_shader_source_length = 0;
+		LoadShader("default_3d_instanced_shader_vs", "shaders/gef", &vs_shader_source, vs_shader_source_length, platform);
+
+		char* ps_shader_source = NULL;
+		Int32 ps_shader_source_length = 0;
+		LoadShader("default_3d_shader_ps", "shaders/gef", &ps_shader_source, ps_shader_source_length, platform);
+
+		device_interface_->SetVertexShaderSource(vs_shader_source, vs_shader_source_length);
+		device_interface_->SetPixelShaderSource(ps_shader_source, ps_shader_source_length);
+
+		delete[] vs_shader_source;
+		vs_shader_source = NULL;
+		delete[] ps_shader_source;
+		ps_shader_source = NULL;
+
+		view_projection_matrix_variable_index_ = device_interface_->AddVertexShaderVariable("view_projection", ShaderInterface::kMatrix44);
+		light_position_variable_index_ = device_interface_->AddVertexShaderVariable("light_position", ShaderInterface::kVector4, 4);
+
+		material_colour_variable_index_ = device_interface_->AddPixelShaderVariable("material_colour", ShaderInterface::kVector4);
+		ambient_light_colour_variable_index_ = device_interface_->AddPixelShaderVariable("ambient_light_colour", ShaderInterface::kVector4);
+		light_colour_variable_index_ = device_interface_->AddPixelShaderVariable("light_colour", ShaderInterface::kVector4, 4);
+
+		texture_sampler_index_ = device_interface_->AddTextureSampler("texture_sampler");
+
+		device_interface_->AddVertexParameter("position", ShaderInterface::kVector3, 0, "POSITION", 0);
+		device_interface_->AddVertexParameter("normal", ShaderInterface::kVector3, 12, "NORMAL", 0);
+		device_interface_->AddVertexParameter("uv", ShaderInterface::kVector2, 24, "TEXCOORD", 0);
+		device_interface_->set_vertex_size(sizeof(Mesh::Vertex));
+
+		// the rows of the world matrix, as stored in a Matrix44
+		device_interface_->AddInstanceParameter("world0", ShaderInterface::kVector4, 0, "WORLD", 0);
+		device_interface_->AddInstanceParameter("world1", ShaderInterface::kVector4, 16, "WORLD", 1);
+		device_interface_->AddInstanceParameter("world2", ShaderInterface::kVector4, 32, "WORLD", 2);
+		device_interface_->AddInstanceParameter("world3", ShaderInterface::kVector4, 48, "WORLD", 3);
+		device_interface_->set_instance_size(sizeof(Matrix44));
+		device_interface_->CreateVertexFormat();
+
+		device_interface_->CreateProgram();
+	}
+
+	Default3DInstancedShader::~Default3DInstancedShader()
+	{
+	}
+
+	void Default3DInstancedShader::SetMeshData(const gef::MeshInstance& /*mesh_instance*/)
+	{
+		gef::Matrix44 view_projectionT;
+		view_projectionT.Transpose(view_projection_matrix_);
+		device_interface_->SetVertexShaderVariable(view_projection_matrix_variable_index_, &view_projectionT);
+	}
+}
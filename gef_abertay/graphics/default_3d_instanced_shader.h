@@ -0,0 +1,27 @@
+#ifndef _GEF_DEFAULT_3D_INSTANCED_SHADER_H
+#define _GEF_DEFAULT_3D_INSTANCED_SHADER_H
+
+#include <graphics/default_3d_shader.h>
+
+namespace gef
+{
+	/// The default 3D shader with the world matrix read from an instance
+	/// buffer, one matrix per instance, instead of from the constant buffer.
+	/// Normals are transformed by the world matrix and renormalised, which
+	/// is only correct for rotations and uniform scales.
+	class Default3DInstancedShader : public Default3DShader
+	{
+	public:
+		Default3DInstancedShader(const Platform& platform);
+		~Default3DInstancedShader();
+
+		/// Uploads the view projection matrix set by SetSceneData.
+		/// The mesh instance transform is not used.
+		void SetMeshData(const gef::MeshInstance& mesh_instance);
+
+	protected:
+		Int32 view_projection_matrix_variable_index_;
+	};
+}
+
+#endif // _GEF_DEFAULT_3D_INSTANCED_SHADER_H
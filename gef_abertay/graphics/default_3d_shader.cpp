@@ -130,8 +130,8 @@ namespace gef
 		gef::Matrix44 wvp = mesh_instance.transform() * view_projection_matrix_;
 
 		// calculate the transpose of inverse world matrix to transform normals in shader
-		Matrix44 inv_world;
-		inv_world.Inverse(mesh_instance.transform());
+		// the instance keeps the inverse until its transform changes
+		const Matrix44& inv_world = mesh_instance.inverse_transform();
 		//inv_world_transpose_matrix.Transpose(inv_world);
 
 		// take transpose of matrices for the shaders
@@ -125,13 +125,13 @@ namespace gef
 		device_interface_->SetVertexShaderVariable(light_position_variable_index_, (float*)light_positions);
 
 		// need to transpose the bone matrices for the shader
-		if (bone_matrices_variable_index_ != -1)
+		if (bone_matrices_variable_index_ != -1 && shader_data.bone_matrices())
 		{
-			UInt32 matrix_index = 0;
-			for (std::vector<gef::Matrix44>::const_iterator matrix_iter = shader_data.bone_matrices()->begin(); matrix_iter != shader_data.bone_matrices()->end(); ++matrix_iter, ++matrix_index)
-				mesh_data_.bones_matrices[matrix_index].Transpose((*matrix_iter));
+			const Int32 bone_count = shader_data.bone_count() < MAX_NUM_BONE_MATRICES ? shader_data.bone_count() : MAX_NUM_BONE_MATRICES;
+			for (Int32 matrix_index = 0; matrix_index < bone_count; ++matrix_index)
+				mesh_data_.bones_matrices[matrix_index].Transpose(shader_data.bone_matrices()[matrix_index]);
 
-			device_interface_->SetVertexShaderVariable(bone_matrices_variable_index_, (float*)&mesh_data_.bones_matrices[0], (Int32)shader_data.bone_matrices()->size());
+			device_interface_->SetVertexShaderVariable(bone_matrices_variable_index_, (float*)&mesh_data_.bones_matrices[0], bone_count);
 		}
 
 		device_interface_->SetPixelShaderVariable(ambient_light_colour_variable_index_, (float*)&ambient_light_colour);
@@ -144,8 +144,8 @@ namespace gef
 		gef::Matrix44 wvp = mesh_instance.transform() * view_projection_matrix_;
 
 		// calculate the transpose of inverse world matrix to transform normals in shader
-		Matrix44 inv_world;
-		inv_world.Inverse(mesh_instance.transform());
+		// the instance keeps the inverse until its transform changes
+		const Matrix44& inv_world = mesh_instance.inverse_transform();
 		//inv_world_transpose_matrix.Transpose(inv_world);
 
 		// take transpose of matrices for the shaders
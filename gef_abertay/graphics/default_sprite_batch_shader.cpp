@@ -0,0 +1,49 @@
+#include <graphics/default_sprite_batch_shader.h>
+#include <graphics/shader_interface.h>
+#include <graphics/sprite_renderer.h>
+#include <cstddef>
+
+namespace gef
+{
+	DefaultSpriteBatchShader::DefaultSpriteBatchShader(const Platform& platform)
+	{
+		device_interface_ = ShaderInterface::Create(platform);
+
+		char* vs_shader_source = NULL;
+		Int32 vs_shader_source_length = 0;
+		LoadShader("default_sprite_batch_shader_vs", "shaders/gef", &vs_shader_source, vs_shader_source_length, platform);
+
+		char* ps_shader_source = NULL;
+		Int32 ps_shader_source_length = 0;
+		LoadShader("default_sprite_shader_ps", "shaders/gef", &ps_shader_source, ps_shader_source_length, platform);
+
+		device_interface_->SetVertexShaderSource(vs_shader_source, vs_shader_source_length);
+		device_interface_->SetPixelShaderSource(ps_shader_source, ps_shader_source_length);
+
+		delete[] vs_shader_source;
+		vs_shader_source = NULL;
+		delete[] ps_shader_source;
+		ps_shader_source = NULL;
+
+		projection_matrix_variable_index_ = device_interface_->AddVertexShaderVariable("proj_matrix", ShaderInterface::kMatrix44);
+		texture_sampler_index_ = device_interface_->AddTextureSampler("texture_sampler");
+
+		device_interface_->AddVertexParameter("position", ShaderInterface::kVector3, (Int32)offsetof(SpriteRenderer::SpriteVertex, position), "POSITION", 0);
+		device_interface_->AddVertexParameter("uv", ShaderInterface::kVector2, (Int32)offsetof(SpriteRenderer::SpriteVertex, uv), "TEXCOORD", 0);
+		device_interface_->AddVertexParameter("colour", ShaderInterface::kVector4, (Int32)offsetof(SpriteRenderer::SpriteVertex, colour), "COLOR", 0);
+		device_interface_->set_vertex_size((Int32)sizeof(SpriteRenderer::SpriteVertex));
+
+		device_interface_->CreateVertexFormat();
+
+		device_interface_->CreateProgram();
+	}
+
+	DefaultSpriteBatchShader::~DefaultSpriteBatchShader()
+	{
+	}
+
+	void DefaultSpriteBatchShader::SetBatchData(const Texture* texture)
+	{
+		device_interface_->SetTextureSampler(texture_sampler_index_, texture);
+	}
+}
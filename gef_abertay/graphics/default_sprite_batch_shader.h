@@ -0,0 +1,23 @@
+#ifndef _GEF_DEFAULT_SPRITE_BATCH_SHADER_H
+#define _GEF_DEFAULT_SPRITE_BATCH_SHADER_H
+
+#include <graphics/default_sprite_shader.h>
+
+namespace gef
+{
+	/// The default sprite shader for batches of sprites whose corners have
+	/// already been placed on screen. Each vertex carries its own position,
+	/// uv and colour, so a whole batch only needs the projection matrix and
+	/// one texture.
+	class DefaultSpriteBatchShader : public DefaultSpriteShader
+	{
+	public:
+		DefaultSpriteBatchShader(const Platform& platform);
+		~DefaultSpriteBatchShader();
+
+		/// Set the texture shared by every sprite in the batch.
+		void SetBatchData(const Texture* texture);
+	};
+}
+
+#endif // _GEF_DEFAULT_SPRITE_BATCH_SHADER_H
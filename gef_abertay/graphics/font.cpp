@@ -182,53 +182,71 @@ void Font::RenderText(SpriteRenderer* renderer, const class Vector4& pos, const
 	char text_buffer[256];
 
 	va_start(args, text);
-	std::vsprintf(text_buffer, text, args);
+	std::vsnprintf(text_buffer, sizeof(text_buffer), text, args);
+	va_end(args);
 
 	UInt32 character_count = (UInt32)strlen(text_buffer);
-	float string_length = GetStringLength(text_buffer);
+	Vector2 cursor = Vector2(GetTextStart(pos, scale, justification, text_buffer), pos.y());
 
-	Vector2 cursor = Vector2(pos.x(), pos.y());
-
-	switch(justification)
+	Sprite sprite;
+	sprite.set_texture(font_texture_);
+	for (UInt32 character_index = 0; character_index < character_count; ++character_index)
 	{
-	case TJ_CENTRE:
-		cursor.x -= string_length*0.5f*scale;
-		break;
-	case TJ_RIGHT:
-		cursor.x -= string_length*scale;
-		break;
-	default:
-		break;
+		cursor.x += BuildGlyph(text_buffer[character_index], cursor, pos.z(), scale, colour, sprite);
+		renderer->DrawSprite(sprite);
 	}
+}
+
+void Font::LayoutText(const Vector4& pos, const float scale, const UInt32 colour, const TextJustification justification, const char* text, std::vector<Sprite>& glyphs) const
+{
+	if(!text)
+		return;
+
+	UInt32 character_count = (UInt32)strlen(text);
+	Vector2 cursor = Vector2(GetTextStart(pos, scale, justification, text), pos.y());
 
 	Sprite sprite;
 	sprite.set_texture(font_texture_);
 	for (UInt32 character_index = 0; character_index < character_count; ++character_index)
 	{
-		Int32 CharX = character_set.Chars[static_cast<UInt32>(text_buffer[character_index])].x;
-		Int32 CharY = character_set.Chars[static_cast<UInt32>(text_buffer[character_index])].y;
-		Int32 Width = character_set.Chars[static_cast<UInt32>(text_buffer[character_index])].Width;
-		Int32 Height = character_set.Chars[static_cast<UInt32>(text_buffer[character_index])].Height;
-		Int32 OffsetX = character_set.Chars[static_cast<UInt32>(text_buffer[character_index])].XOffset;
-		Int32 OffsetY = character_set.Chars[static_cast<UInt32>(text_buffer[character_index])].YOffset;
-
-		Vector2 uv_pos((float) CharX / (float) character_set.Width,  ((float) (CharY) / (float) character_set.Height));
-		Vector2 uv_size((float) (Width) / (float) character_set.Width, (float)(Height) / (float) character_set.Height);
-		Vector2 size(((float)Width)*scale, ((float)Height)*scale);
-		Vector4 sprite_position = Vector4(cursor.x+((float)OffsetX*scale)+size.x*0.5f, cursor.y + scale*((float)Height*0.5f +  (float)OffsetY), pos.z());
-
-		sprite.set_position(sprite_position);
-		sprite.set_width(size.x);
-		sprite.set_height(size.y);
-		sprite.set_uv_position(uv_pos);
-		sprite.set_uv_width(uv_size.x);
-		sprite.set_uv_height(uv_size.y);
-		sprite.set_colour(colour);
-		renderer->DrawSprite(sprite);
-		cursor.x += ((float)character_set.Chars[static_cast<UInt32>(text_buffer[character_index])].XAdvance)*scale;
+		cursor.x += BuildGlyph(text[character_index], cursor, pos.z(), scale, colour, sprite);
+		glyphs.push_back(sprite);
+	}
+}
+
+float Font::GetTextStart(const Vector4& pos, const float scale, const TextJustification justification, const char* text) const
+{
+	switch(justification)
+	{
+	case TJ_CENTRE:
+		return pos.x() - GetStringLength(text)*0.5f*scale;
+	case TJ_RIGHT:
+		return pos.x() - GetStringLength(text)*scale;
+	default:
+		return pos.x();
 	}
 }
 
+float Font::BuildGlyph(const char character, const Vector2& cursor, const float depth, const float scale, const UInt32 colour, Sprite& sprite) const
+{
+	const CharDescriptor& descriptor = character_set.Chars[static_cast<UInt8>(character)];
+
+	Vector2 uv_pos((float) descriptor.x / (float) character_set.Width,  ((float) (descriptor.y) / (float) character_set.Height));
+	Vector2 uv_size((float) (descriptor.Width) / (float) character_set.Width, (float)(descriptor.Height) / (float) character_set.Height);
+	Vector2 size(((float)descriptor.Width)*scale, ((float)descriptor.Height)*scale);
+	Vector4 sprite_position = Vector4(cursor.x+((float)descriptor.XOffset*scale)+size.x*0.5f, cursor.y + scale*((float)descriptor.Height*0.5f +  (float)descriptor.YOffset), depth);
+
+	sprite.set_position(sprite_position);
+	sprite.set_width(size.x);
+	sprite.set_height(size.y);
+	sprite.set_uv_position(uv_pos);
+	sprite.set_uv_width(uv_size.x);
+	sprite.set_uv_height(uv_size.y);
+	sprite.set_colour(colour);
+
+	return ((float)descriptor.XAdvance)*scale;
+}
+
 float Font::GetStringLength(const char * text) const
 {
 	float length = 0.0f;
@@ -238,7 +256,7 @@ float Font::GetStringLength(const char * text) const
 
 
 		for( UInt32 character_index = 0; character_index < string_length; ++character_index )
-			length += ((float)character_set.Chars[static_cast<UInt32>(text[character_index])].XAdvance);
+			length += ((float)character_set.Chars[static_cast<UInt8>(text[character_index])].XAdvance);
 	}
 
 	return length;
@@ -3,6 +3,7 @@
 
 #include <gef.h>
 #include <istream>
+#include <vector>
 
 namespace gef
 {
@@ -11,6 +12,8 @@ namespace gef
 	class Texture;
 	class Platform;
 	class Vector4;
+	class Vector2;
+	class Sprite;
 
 	enum TextJustification
 	{
@@ -28,6 +31,11 @@ namespace gef
 		void RenderText(SpriteRenderer* renderer, const Vector4& pos, const float scale, const UInt32 colour, const TextJustification justification, const char * text, ...) const;
 		float GetStringLength(const char * text) const;
 
+		/// Build a sprite for every character of the text, the same as
+		/// RenderText would draw, and add them to glyphs.
+		/// Used by TextLayout to keep the sprites between frames.
+		void LayoutText(const Vector4& pos, const float scale, const UInt32 colour, const TextJustification justification, const char* text, std::vector<Sprite>& glyphs) const;
+
 		inline Texture* font_texture() { return font_texture_; }
 	private:
 		struct CharDescriptor
@@ -55,6 +63,13 @@ namespace gef
 
 		bool ParseFont( std::istream& Stream, Font::Charset& CharsetDesc );
 
+		/// @return where the first character starts for the justification
+		float GetTextStart(const Vector4& pos, const float scale, const TextJustification justification, const char* text) const;
+
+		/// Set up the sprite for a character at the cursor.
+		/// @return how far to move the cursor for the next character
+		float BuildGlyph(const char character, const Vector2& cursor, const float depth, const float scale, const UInt32 colour, Sprite& sprite) const;
+
 		Charset character_set;
 		class Texture* font_texture_;
 
@@ -2,12 +2,15 @@
 #include <graphics/primitive.h>
 #include <graphics/vertex_buffer.h>
 #include <system/platform.h>
+#include <cfloat>
 
 namespace gef
 {
 	Mesh::Mesh(Platform& platform) :
 	num_primitives_(0),
 	primitives_(NULL),
+	// no bounds until they are set, so the mesh is never frustum culled
+	bounding_sphere_(Vector4(0.0f, 0.0f, 0.0f), FLT_MAX),
 	vertex_buffer_(NULL),
 	platform_(platform)
 	{
@@ -64,13 +64,14 @@ namespace gef
 
 
 	VertexData::VertexData() :
-		vertices(NULL)
+		vertices(NULL),
+		mapped(false)
 	{
 	}
 
 	VertexData::~VertexData()
 	{
-		if (vertices)
+		if (vertices && !mapped)
 		{
 			free(vertices);
 			vertices = NULL;
@@ -107,13 +108,15 @@ namespace gef
 
 	PrimitiveData::PrimitiveData() :
 		indices(NULL),
-		material_name_id(0)
+		material_name_id(0),
+		mapped(false)
 	{
 	}
 
 	PrimitiveData::~PrimitiveData()
 	{
-		free(indices);
+		if (!mapped)
+			free(indices);
 		indices = NULL;
 	}
 
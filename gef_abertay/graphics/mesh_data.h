@@ -36,6 +36,8 @@ namespace gef
 		Int32 num_indices;
 		Int32 index_byte_size;
 		PrimitiveType type;
+		// indices point into a scene file mapped into memory, so aren't freed
+		bool mapped;
 	};
 
 	struct VertexData
@@ -49,6 +51,8 @@ namespace gef
 		void* vertices;
 		Int32 num_vertices;
 		Int32 vertex_byte_size;
+		// vertices point into a scene file mapped into memory, so aren't freed
+		bool mapped;
 	};
 
 
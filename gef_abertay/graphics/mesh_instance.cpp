@@ -4,8 +4,54 @@
 namespace gef
 {
 	MeshInstance::MeshInstance() :
-		mesh_(NULL)
+		mesh_(NULL),
+		transform_kind_(kRigid),
+		inverse_transform_valid_(false)
 	{
 		transform_.SetIdentity();
 	}
+
+	const Matrix44& MeshInstance::inverse_transform() const
+	{
+		if (!inverse_transform_valid_)
+		{
+			CalculateInverseTransform(transform_, transform_kind_, inverse_transform_);
+			inverse_transform_valid_ = true;
+		}
+
+		return inverse_transform_;
+	}
+
+	void MeshInstance::CalculateInverseTransform(const Matrix44& transform, const TransformKind kind, Matrix44& inverse)
+	{
+		if (kind == kGeneral)
+		{
+			inverse.Inverse(transform);
+			return;
+		}
+
+		// the rotation part is orthogonal, so its inverse is its transpose.
+		// With a uniform scale s the transpose is s*R^-1, so divide by s^2
+		float inv_scale_sqr = 1.0f;
+		if (kind == kUniformScale)
+		{
+			const float scale_sqr = transform.GetRow(0).LengthSqr();
+			if (scale_sqr > 0.0f)
+				inv_scale_sqr = 1.0f / scale_sqr;
+		}
+
+		const Vector4& translation = transform.GetRow(3);
+		for (int row = 0; row < 3; ++row)
+		{
+			const Vector4& axis = transform.GetRow(row);
+			inverse.set_m(0, row, axis.x() * inv_scale_sqr);
+			inverse.set_m(1, row, axis.y() * inv_scale_sqr);
+			inverse.set_m(2, row, axis.z() * inv_scale_sqr);
+			inverse.set_m(3, row, -(translation.x()*axis.x() + translation.y()*axis.y() + translation.z()*axis.z()) * inv_scale_sqr);
+		}
+		inverse.set_m(0, 3, 0.0f);
+		inverse.set_m(1, 3, 0.0f);
+		inverse.set_m(2, 3, 0.0f);
+		inverse.set_m(3, 3, 1.0f);
+	}
 }
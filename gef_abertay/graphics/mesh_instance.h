@@ -13,6 +13,17 @@ namespace gef
 	class MeshInstance
 	{
 	public:
+		/// What the transform is made of, so its inverse can be found cheaply.
+		enum TransformKind
+		{
+			/// any affine transform, inverted in full
+			kGeneral = 0,
+			/// rotation, translation and the same scale on every axis
+			kUniformScale,
+			/// rotation and translation only
+			kRigid
+		};
+
 		/// @brief Default constructor.
 		MeshInstance();
 
@@ -22,7 +33,28 @@ namespace gef
 
 		/// @brief Set the transform
 		/// @param[in] transform	the transformation matrix
-		void set_transform(const Matrix44& transform) { transform_ = transform; }
+		/// @param[in] kind			what the transform is made of. Passing kRigid or
+		///							kUniformScale lets the inverse skip the full 4x4 inversion
+		void set_transform(const Matrix44& transform, const TransformKind kind = kGeneral)
+		{
+			transform_ = transform;
+			transform_kind_ = kind;
+			inverse_transform_valid_ = false;
+		}
+
+		/// @brief Get what the transform is made of
+		TransformKind transform_kind() const { return transform_kind_; }
+
+		/// @brief Get the inverse of the transform, used to transform normals
+		/// @return The inverse transformation matrix
+		/// @note The inverse is calculated on first use and kept until the transform changes
+		const Matrix44& inverse_transform() const;
+
+		/// @brief Calculate the inverse of a transform of a given kind
+		/// @param[in] transform	the transformation matrix
+		/// @param[in] kind			what the transform is made of
+		/// @param[out] inverse		the inverse transformation matrix
+		static void CalculateInverseTransform(const Matrix44& transform, const TransformKind kind, Matrix44& inverse);
 
 		/// @brief Get the mesh
 		/// @return The mesh
@@ -39,6 +71,13 @@ namespace gef
 
 		/// The mesh
 		const Mesh* mesh_;
+
+		/// What the transformation matrix is made of.
+		TransformKind transform_kind_;
+
+		/// The inverse of the transformation matrix, valid when inverse_transform_valid_ is set.
+		mutable Matrix44 inverse_transform_;
+		mutable bool inverse_transform_valid_;
 	};
 }
 
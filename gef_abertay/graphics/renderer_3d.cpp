@@ -2,15 +2,30 @@
 #include <graphics/shader.h>
 #include <system/platform.h>
 #include <graphics/texture.h>
+#include <graphics/mesh.h>
+#include <graphics/primitive.h>
+#include <graphics/vertex_buffer.h>
+#include <graphics/index_buffer.h>
+#include <graphics/shader_interface.h>
+#include <maths/vector4.h>
+#include <maths/sphere.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 
 namespace gef
 {
 	Renderer3D::Renderer3D(Platform& platform) :
+		inv_world_transpose_matrix_valid_(false),
+		world_transform_kind_(MeshInstance::kRigid),
 		shader_(NULL),
-		override_material_(NULL),
-		platform_(platform),
 		default_shader_(platform),
-		default_skinned_mesh_shader_(platform)
+		default_skinned_mesh_shader_(platform),
+		override_material_(NULL),
+		render_queue_enabled_(false),
+		frustum_culling_enabled_(true),
+		culling_frustum_dirty_(true),
+		platform_(platform)
 	{
 		projection_matrix_.SetIdentity();
 		view_matrix_.SetIdentity();
@@ -30,6 +45,11 @@ namespace gef
 	}
 
 	void Renderer3D::DrawSkinnedMesh(const MeshInstance& mesh_instance, const std::vector<Matrix44>& bone_matrices, bool use_default_shader)
+	{
+		DrawSkinnedMesh(mesh_instance, bone_matrices.empty() ? NULL : &bone_matrices.front(), (Int32)bone_matrices.size(), use_default_shader);
+	}
+
+	void Renderer3D::DrawSkinnedMesh(const MeshInstance& mesh_instance, const Matrix44* bone_matrices, const Int32 bone_count, bool use_default_shader)
 	{
 		Shader* previous_shader = shader_;
 		if(use_default_shader)
@@ -45,30 +65,339 @@ namespace gef
 			}
 			default_skinned_mesh_shader_data_.set_ambient_light_colour(default_shader_data_.ambient_light_colour());
 
-			default_skinned_mesh_shader_data_.set_bone_matrices(&bone_matrices);
+			default_skinned_mesh_shader_data_.set_bone_matrices(bone_matrices, bone_count);
 
 			SetShader(&default_skinned_mesh_shader_);
 
 			default_skinned_mesh_shader_.SetSceneData(default_skinned_mesh_shader_data_, view_matrix_, projection_matrix_);
 		}
 
+		// the bone matrices are only valid for this call, so skinned
+		// meshes can't wait in the render queue. The bounds are for the
+		// bind pose, so they can't be culled either
+		const bool render_queue_enabled = render_queue_enabled_;
+		const bool frustum_culling_enabled = frustum_culling_enabled_;
+		render_queue_enabled_ = false;
+		frustum_culling_enabled_ = false;
 		DrawMesh(mesh_instance);
+		render_queue_enabled_ = render_queue_enabled;
+		frustum_culling_enabled_ = frustum_culling_enabled;
 
 		if(use_default_shader)
 			SetShader(previous_shader);
 	}
 
-	void Renderer3D::CalculateInverseWorldTransposeMatrix()
+	void Renderer3D::DrawMeshInstanced(const Mesh& mesh, const Matrix44* transforms, const Int32 count, const Material* material, const MeshInstance::TransformKind transform_kind)
+	{
+		Int32 visible_count = count;
+		const Matrix44* visible_transforms = CullInstances(mesh, transforms, visible_count);
+		DrawMeshCopies(mesh, visible_transforms, visible_count, material, transform_kind);
+	}
+
+	void Renderer3D::DrawMeshCopies(const Mesh& mesh, const Matrix44* transforms, const Int32 count, const Material* material, const MeshInstance::TransformKind transform_kind)
+	{
+		const Material* previous_override_material = override_material_;
+		if (material)
+			override_material_ = material;
+
+		// the copies have already been culled
+		const bool frustum_culling_enabled = frustum_culling_enabled_;
+		frustum_culling_enabled_ = false;
+
+		MeshInstance mesh_instance;
+		mesh_instance.set_mesh(&mesh);
+		for (Int32 instance_num = 0; instance_num < count; ++instance_num)
+		{
+			mesh_instance.set_transform(transforms[instance_num], transform_kind);
+			DrawMesh(mesh_instance);
+		}
+
+		frustum_culling_enabled_ = frustum_culling_enabled;
+		override_material_ = previous_override_material;
+	}
+
+	void Renderer3D::AddCullingSphere(const Sphere& bounds, const Matrix44& transform)
+	{
+		const Sphere world_bounds = bounds.Transform(transform);
+		culling_centre_x_.push_back(world_bounds.position().x());
+		culling_centre_y_.push_back(world_bounds.position().y());
+		culling_centre_z_.push_back(world_bounds.position().z());
+		culling_radius_.push_back(world_bounds.radius());
+	}
+
+	Int32 Renderer3D::CullSpheres()
+	{
+		if (culling_frustum_dirty_)
+		{
+			// the OpenGL clip volume contains the D3D one, so these planes
+			// are safe whichever style of projection matrix is set
+			culling_frustum_.ExtractPlanesGL(view_matrix_ * projection_matrix_, true);
+			culling_frustum_dirty_ = false;
+		}
+
+		const Int32 count = (Int32)culling_radius_.size();
+		culling_visible_.resize(count);
+		Int32 num_visible = 0;
+		if (count > 0)
+			num_visible = culling_frustum_.CullSpheres(&culling_centre_x_[0], &culling_centre_y_[0], &culling_centre_z_[0], &culling_radius_[0], count, &culling_visible_[0]);
+
+		stats_.visible_meshes += num_visible;
+		stats_.culled_meshes += count - num_visible;
+
+		culling_centre_x_.clear();
+		culling_centre_y_.clear();
+		culling_centre_z_.clear();
+		culling_radius_.clear();
+
+		return num_visible;
+	}
+
+	bool Renderer3D::IsVisible(const MeshInstance& mesh_instance)
+	{
+		if (!frustum_culling_enabled_ || mesh_instance.mesh() == NULL)
+			return true;
+
+		AddCullingSphere(mesh_instance.mesh()->bounding_sphere(), mesh_instance.transform());
+		return CullSpheres() > 0;
+	}
+
+	const Matrix44* Renderer3D::CullInstances(const Mesh& mesh, const Matrix44* transforms, Int32& count)
+	{
+		if (!frustum_culling_enabled_ || count <= 0)
+			return transforms;
+
+		for (Int32 instance_num = 0; instance_num < count; ++instance_num)
+			AddCullingSphere(mesh.bounding_sphere(), transforms[instance_num]);
+
+		const Int32 num_visible = CullSpheres();
+		if (num_visible == count)
+			return transforms;
+
+		culled_transforms_.clear();
+		for (Int32 instance_num = 0; instance_num < count; ++instance_num)
+		{
+			if (culling_visible_[instance_num])
+				culled_transforms_.push_back(transforms[instance_num]);
+		}
+
+		count = num_visible;
+		return num_visible > 0 ? &culled_transforms_[0] : transforms;
+	}
+
+	void Renderer3D::CalculateInverseWorldTransposeMatrix() const
 	{
 		Matrix44 inv_world;
-		inv_world.Inverse(world_matrix_);
+		MeshInstance::CalculateInverseTransform(world_matrix_, world_transform_kind_, inv_world);
 		inv_world_transpose_matrix_.Transpose(inv_world);
 	}
 
-	void Renderer3D::set_world_matrix(const  Matrix44& matrix)
+	void Renderer3D::set_world_matrix(const  Matrix44& matrix, const MeshInstance::TransformKind transform_kind)
 	{
 		world_matrix_ = matrix;
-		CalculateInverseWorldTransposeMatrix();
+		world_transform_kind_ = transform_kind;
+		inv_world_transpose_matrix_valid_ = false;
 	}
-}
 
+	const Matrix44& Renderer3D::inv_world_transpose_matrix() const
+	{
+		if (!inv_world_transpose_matrix_valid_)
+		{
+			CalculateInverseWorldTransposeMatrix();
+			inv_world_transpose_matrix_valid_ = true;
+		}
+
+		return inv_world_transpose_matrix_;
+	}
+
+	UInt64 Renderer3D::GetSortBits(const void* object, const Int32 num_bits)
+	{
+		// the same object always gets the same bits, so its items end up next
+		// to each other. Two objects can share bits, which only costs a
+		// redundant bind as the submit loop compares the real pointers
+		UInt64 hash = (UInt64)(size_t)object * 0x9E3779B97F4A7C15ULL;
+		return hash >> (64 - num_bits);
+	}
+
+	void Renderer3D::QueueMesh(const MeshInstance& mesh_instance)
+	{
+		const Mesh* mesh = mesh_instance.mesh();
+		if (mesh == NULL || mesh->vertex_buffer() == NULL || shader_ == NULL)
+			return;
+
+		// front to back within a state group so early depth rejection helps.
+		// the bits of a positive float sort the same way as its value, so
+		// the top 16 bits make a coarse, monotonic depth
+		Vector4 view_position = mesh_instance.transform().GetTranslation().Transform(view_matrix_);
+		float depth = fabsf(view_position.z());
+		UInt32 depth_bits;
+		memcpy(&depth_bits, &depth, sizeof(depth_bits));
+
+		const UInt64 shader_bits = GetSortBits(shader_, 8);
+		const UInt64 mesh_bits = GetSortBits(mesh, 20);
+
+		for (UInt32 primitive_index = 0; primitive_index < mesh->num_primitives(); ++primitive_index)
+		{
+			const Primitive* primitive = mesh->GetPrimitive(primitive_index);
+			if (primitive->type() == UNDEFINED || primitive->index_buffer() == NULL)
+				continue;
+
+			RenderQueueItem item;
+			item.instance_index = (UInt32)render_queue_instances_.size();
+			item.shader = shader_;
+			item.material = override_material_ ? override_material_ : primitive->material();
+			item.primitive = primitive;
+
+			const UInt64 material_bits = GetSortBits(item.material, 20);
+
+			// shader:8 | material:20 | mesh:20 | depth:16
+			RenderQueueKey key;
+			key.sort_key = (shader_bits << 56) | (material_bits << 36) | (mesh_bits << 16) | (depth_bits >> 16);
+			key.item_index = (UInt32)render_queue_items_.size();
+
+			render_queue_items_.push_back(item);
+			render_queue_keys_.push_back(key);
+			stats_.queued_items++;
+		}
+
+		// the inverse is cached on the caller's instance, so objects that
+		// haven't moved since the last frame don't calculate it again
+		mesh_instance.inverse_transform();
+		render_queue_instances_.push_back(mesh_instance);
+	}
+
+	void Renderer3D::FlushRenderQueue()
+	{
+		if (render_queue_keys_.empty())
+			return;
+
+		// cull all the queued instances in one batch and drop their items
+		if (frustum_culling_enabled_)
+		{
+			for (std::vector<MeshInstance>::const_iterator instance = render_queue_instances_.begin(); instance != render_queue_instances_.end(); ++instance)
+				AddCullingSphere(instance->mesh()->bounding_sphere(), instance->transform());
+
+			if (CullSpheres() < (Int32)render_queue_instances_.size())
+			{
+				std::vector<RenderQueueKey>::iterator visible_end = render_queue_keys_.begin();
+				for (std::vector<RenderQueueKey>::const_iterator key = render_queue_keys_.begin(); key != render_queue_keys_.end(); ++key)
+				{
+					if (culling_visible_[render_queue_items_[key->item_index].instance_index])
+						*visible_end++ = *key;
+				}
+				render_queue_keys_.erase(visible_end, render_queue_keys_.end());
+			}
+		}
+
+		if (render_queue_keys_.empty())
+		{
+			render_queue_items_.clear();
+			render_queue_instances_.clear();
+			return;
+		}
+
+		std::sort(render_queue_keys_.begin(), render_queue_keys_.end());
+
+		Shader* shader = NULL;
+		const Mesh* mesh = NULL;
+		const VertexBuffer* vertex_buffer = NULL;
+		const IndexBuffer* index_buffer = NULL;
+		const Material* material = NULL;
+		bool material_set = false;
+		const MeshInstance* mesh_instance = NULL;
+
+		for (std::vector<RenderQueueKey>::const_iterator key = render_queue_keys_.begin(); key != render_queue_keys_.end(); ++key)
+		{
+			const RenderQueueItem& item = render_queue_items_[key->item_index];
+
+			if (item.shader != shader)
+			{
+				if (shader)
+				{
+					if (index_buffer)
+						index_buffer->Unbind(platform_);
+					if (material_set)
+						shader->device_interface()->UnbindTextureResources(platform_);
+					vertex_buffer->Unbind(platform_);
+					shader->device_interface()->ClearVertexFormat();
+				}
+
+				shader = item.shader;
+				if (shader == &default_shader_)
+					default_shader_.SetSceneData(default_shader_data_, view_matrix_, projection_matrix_);
+				shader->device_interface()->UseProgram();
+				stats_.shader_changes++;
+
+				// everything else has to be bound again for the new shader
+				mesh = NULL;
+				vertex_buffer = NULL;
+				index_buffer = NULL;
+				material_set = false;
+				mesh_instance = NULL;
+			}
+
+			const Mesh* item_mesh = render_queue_instances_[item.instance_index].mesh();
+			if (item_mesh != mesh)
+			{
+				if (vertex_buffer)
+					vertex_buffer->Unbind(platform_);
+
+				mesh = item_mesh;
+				vertex_buffer = mesh->vertex_buffer();
+				vertex_buffer->Bind(platform_);
+
+				// vertex format must be set after the vertex buffer is bound
+				shader->device_interface()->SetVertexFormat();
+				stats_.vertex_buffer_binds++;
+			}
+
+			// the mesh data only changes when the next instance starts
+			if (&render_queue_instances_[item.instance_index] != mesh_instance)
+			{
+				mesh_instance = &render_queue_instances_[item.instance_index];
+				set_world_matrix(mesh_instance->transform(), mesh_instance->transform_kind());
+				shader->SetMeshData(*mesh_instance);
+			}
+
+			const bool material_changed = !material_set || item.material != material;
+			if (material_changed)
+			{
+				if (material_set)
+					shader->device_interface()->UnbindTextureResources(platform_);
+
+				material = item.material;
+				shader->SetMaterialData(material);
+				material_set = true;
+				stats_.material_changes++;
+			}
+
+			// mesh or material data may have changed, so the variables are always set
+			shader->device_interface()->SetVariableData();
+			if (material_changed)
+				shader->device_interface()->BindTextureResources(platform_);
+
+			if (item.primitive->index_buffer() != index_buffer)
+			{
+				if (index_buffer)
+					index_buffer->Unbind(platform_);
+
+				index_buffer = item.primitive->index_buffer();
+				index_buffer->Bind(platform_);
+				stats_.index_buffer_binds++;
+			}
+
+			SubmitPrimitive(*item.primitive, *vertex_buffer);
+			stats_.draw_calls++;
+		}
+
+		if (index_buffer)
+			index_buffer->Unbind(platform_);
+		if (material_set)
+			shader->device_interface()->UnbindTextureResources(platform_);
+		vertex_buffer->Unbind(platform_);
+		shader->device_interface()->ClearVertexFormat();
+
+		render_queue_items_.clear();
+		render_queue_keys_.clear();
+		render_queue_instances_.clear();
+	}
+}
@@ -3,10 +3,12 @@
 
 #include <gef.h>
 #include <maths/matrix44.h>
+#include <maths/frustum.h>
 #include <graphics/default_3d_shader_data.h>
 #include <graphics/skinned_mesh_shader_data.h>
 #include <graphics/default_3d_shader.h>
 #include <graphics/default_3d_skinning_shader.h>
+#include <graphics/mesh_instance.h>
 #include <vector>
 
 namespace gef
@@ -18,7 +20,39 @@ namespace gef
 	class Texture;
 
 	class Skeleton;
+	class Mesh;
+	class Primitive;
+	class VertexBuffer;
+	class Sphere;
 
+	/// Counts of the work done by a Renderer3D, e.g. over a frame.
+	struct RenderStats
+	{
+		/// draw items recorded by the render queue
+		UInt32 queued_items;
+		UInt32 draw_calls;
+		UInt32 shader_changes;
+		UInt32 material_changes;
+		UInt32 vertex_buffer_binds;
+		UInt32 index_buffer_binds;
+		/// meshes and instances rejected by frustum culling
+		UInt32 culled_meshes;
+		/// meshes and instances that passed frustum culling
+		UInt32 visible_meshes;
+
+		RenderStats() { Reset(); }
+		void Reset()
+		{
+			queued_items = 0;
+			draw_calls = 0;
+			shader_changes = 0;
+			material_changes = 0;
+			vertex_buffer_binds = 0;
+			index_buffer_binds = 0;
+			culled_meshes = 0;
+			visible_meshes = 0;
+		}
+	};
 
 	class Renderer3D
 	{
@@ -45,34 +79,126 @@ namespace gef
 		virtual void SetFillMode(FillMode fill_mode) = 0;
 		virtual void SetDepthTest(DepthTest depth_test) = 0;
 		void DrawSkinnedMesh(const  MeshInstance& mesh_instance, const std::vector<Matrix44>& bone_matrices, bool use_default_shader = true);
+		/// As above, with the bone matrices in any contiguous buffer,
+		/// e.g. the skinning matrices from an AnimationUpdateSystem.
+		void DrawSkinnedMesh(const  MeshInstance& mesh_instance, const Matrix44* bone_matrices, const Int32 bone_count, bool use_default_shader = true);
+
+		/// Draw one copy of the mesh per transform. Backends that support
+		/// instancing pack the transforms into an instance buffer and issue one
+		/// draw per primitive for all copies, using the default shader.
+		/// The base version is a CPU loop over DrawMesh, used by backends
+		/// without instancing and whenever a custom shader is set.
+		/// @param[in] material	used for every primitive when not NULL, otherwise
+		///						materials are chosen as in DrawMesh
+		/// @param[in] transform_kind	what all of the transforms are made of
+		virtual void DrawMeshInstanced(const Mesh& mesh, const Matrix44* transforms, const Int32 count, const Material* material = NULL, const MeshInstance::TransformKind transform_kind = MeshInstance::kGeneral);
 		void SetShader( Shader* shader);
 
 
 
 		inline  Shader* shader() const { return shader_; }
 		inline const Matrix44& view_matrix() const { return view_matrix_; }
-		inline void set_view_matrix(const  Matrix44& matrix) {view_matrix_ = matrix;}
+		inline void set_view_matrix(const  Matrix44& matrix) {view_matrix_ = matrix; culling_frustum_dirty_ = true;}
 		inline const Matrix44& projection_matrix() const { return projection_matrix_; }
-		inline void set_projection_matrix(const  Matrix44& matrix) {projection_matrix_ = matrix;}
+		inline void set_projection_matrix(const  Matrix44& matrix) {projection_matrix_ = matrix; culling_frustum_dirty_ = true;}
 		inline const Matrix44& world_matrix() const { return world_matrix_; }
-		void set_world_matrix(const  Matrix44& matrix);
-		inline const Matrix44& inv_world_transpose_matrix() const { return inv_world_transpose_matrix_; }
+		void set_world_matrix(const  Matrix44& matrix, const MeshInstance::TransformKind transform_kind = MeshInstance::kGeneral);
+
+		/// Calculated on first use after the world matrix changes, using the
+		/// cheaper inverse that the transform kind allows.
+		const Matrix44& inv_world_transpose_matrix() const;
 
 		inline  const Platform& platform() const {return platform_;}
 		inline Default3DShaderData& default_shader_data() { return default_shader_data_; }
 		inline void set_override_material(const Material* material) { override_material_ = material; }
 		inline const Material* override_material() const { return override_material_; }
 
+		/// When the render queue is enabled DrawMesh only records a draw item per
+		/// primitive. The items are sorted by shader, material, mesh and depth
+		/// and drawn at End, skipping binds that would not change any state.
+		/// The shader, override material and mesh transform are captured by
+		/// DrawMesh; view and projection matrices are read at End.
+		/// Skinned meshes are always drawn immediately.
+		inline bool render_queue_enabled() const { return render_queue_enabled_; }
+		inline void set_render_queue_enabled(const bool enabled) { render_queue_enabled_ = enabled; }
+
+		/// When frustum culling is enabled, meshes whose bounding sphere, moved
+		/// by the instance transform, is completely outside the view frustum
+		/// are not drawn. Queued meshes and instanced draws are culled in
+		/// batches. Skinned meshes are never culled, as their bounds don't
+		/// follow the pose. Meshes without bounds have an infinite radius and
+		/// are always drawn. Enabled by default.
+		inline bool frustum_culling_enabled() const { return frustum_culling_enabled_; }
+		inline void set_frustum_culling_enabled(const bool enabled) { frustum_culling_enabled_ = enabled; }
+
+		/// @return counts for the draws since the last call to ResetStats
+		inline const RenderStats& stats() const { return stats_; }
+		inline void ResetStats() { stats_.Reset(); }
+
 		static Renderer3D* Create(Platform& platform);
 	protected:
 		Renderer3D(Platform& platform);
-		void CalculateInverseWorldTransposeMatrix();
+		void CalculateInverseWorldTransposeMatrix() const;
 		inline void set_shader( Shader* shader) { shader_ = shader; }
 
+		/// Issue the draw for one primitive. The shader, vertex buffer,
+		/// textures and index buffer are already bound.
+		virtual void SubmitPrimitive(const Primitive& primitive, const VertexBuffer& vertex_buffer) = 0;
+
+		/// Record draw items for every primitive in the mesh.
+		void QueueMesh(const MeshInstance& mesh_instance);
+
+		/// Sort and draw all the recorded items, then empty the queue.
+		void FlushRenderQueue();
+
+		/// @return false if frustum culling is enabled and the mesh is
+		/// outside the view frustum
+		bool IsVisible(const MeshInstance& mesh_instance);
+
+		/// Remove the transforms that put the mesh outside the view frustum.
+		/// @param[in,out] count	the number of transforms, set to the number
+		///							that are visible
+		/// @return the visible transforms, valid until the next cull
+		const Matrix44* CullInstances(const Mesh& mesh, const Matrix44* transforms, Int32& count);
+
+		/// DrawMesh for each transform, without frustum culling.
+		void DrawMeshCopies(const Mesh& mesh, const Matrix44* transforms, const Int32 count, const Material* material, const MeshInstance::TransformKind transform_kind);
+
+		/// Add the bounds in world space to the spheres tested by CullSpheres.
+		void AddCullingSphere(const Sphere& bounds, const Matrix44& transform);
+
+		/// Test all the added spheres against the view frustum, filling
+		/// culling_visible_, and start a new batch.
+		/// @return the number of visible spheres
+		Int32 CullSpheres();
+
+		struct RenderQueueItem
+		{
+			/// index into render_queue_instances_, shared by the items of one DrawMesh
+			UInt32 instance_index;
+			Shader* shader;
+			const Material* material;
+			const Primitive* primitive;
+		};
+
+		struct RenderQueueKey
+		{
+			UInt64 sort_key;
+			UInt32 item_index;
+
+			// ties keep the order the items were queued in, so the primitives
+			// of an instance stay together
+			bool operator<(const RenderQueueKey& key) const { return sort_key < key.sort_key || (sort_key == key.sort_key && item_index < key.item_index); }
+		};
+
+		static UInt64 GetSortBits(const void* object, const Int32 num_bits);
+
 		Matrix44 projection_matrix_;
 		Matrix44 view_matrix_;
-		Matrix44 inv_world_transpose_matrix_;
+		mutable Matrix44 inv_world_transpose_matrix_;
+		mutable bool inv_world_transpose_matrix_valid_;
 		Matrix44 world_matrix_;
+		MeshInstance::TransformKind world_transform_kind_;
 		Shader* shader_;
 		Default3DShader default_shader_;
 		Default3DSkinningShader default_skinned_mesh_shader_;
@@ -80,6 +206,24 @@ namespace gef
 		SkinnedMeshShaderData default_skinned_mesh_shader_data_;
 		const Material* override_material_;
 
+		bool render_queue_enabled_;
+		RenderStats stats_;
+		std::vector<RenderQueueItem> render_queue_items_;
+		std::vector<RenderQueueKey> render_queue_keys_;
+		std::vector<MeshInstance> render_queue_instances_;
+
+		bool frustum_culling_enabled_;
+		bool culling_frustum_dirty_;
+		Frustum culling_frustum_;
+		// spheres to cull, one array per component so they can be tested
+		// four at a time
+		std::vector<float> culling_centre_x_;
+		std::vector<float> culling_centre_y_;
+		std::vector<float> culling_centre_z_;
+		std::vector<float> culling_radius_;
+		std::vector<UInt8> culling_visible_;
+		std::vector<Matrix44> culled_transforms_;
+
 		Platform& platform_;
 	};
 }
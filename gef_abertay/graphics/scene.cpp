@@ -4,18 +4,154 @@
 #include <graphics/texture.h>
 #include <animation/skeleton.h>
 #include <animation/animation.h>
+#include <animation/compressed_animation.h>
 #include <system/platform.h>
 #include <graphics/image_data.h>
 #include <assets/png_loader.h>
+#include <assets/texture_cache.h>
 #include <graphics/material.h>
 
 #include <system/file.h>
 #include <system/memory_stream_buffer.h>
 #include <fstream>
+#include <sstream>
+#include <vector>
+#include <cstring>
 #include <assert.h>
 
 namespace gef
 {
+	// .scn version 2
+	//
+	// A header, then blobs that each start on a kSceneV2Alignment boundary. The
+	// header gives the count and offset of a table of records for each kind of
+	// data, and the records give the offsets of the blobs they own. Offsets are
+	// from the start of the file, so the file can be used wherever it is loaded
+	// without any pointers being fixed up. Vertices, indices, joints and keys are
+	// stored in the same layout as in memory.
+	static const UInt32 kSceneV2Magic = 0x4e435347;	// "GSCN"
+	static const UInt32 kSceneV2Version = 2;
+	static const UInt32 kSceneV2Alignment = 16;
+
+	struct SceneV2Header
+	{
+		UInt32 magic;
+		UInt32 version;
+		UInt32 file_size;
+		UInt32 string_count;
+		UInt32 strings_offset;				// SceneV2String[string_count]
+		UInt32 material_count;
+		UInt32 materials_offset;			// SceneV2Material[material_count]
+		UInt32 mesh_count;
+		UInt32 meshes_offset;				// SceneV2Mesh[mesh_count]
+		UInt32 skeleton_count;
+		UInt32 skeletons_offset;			// SceneV2Skeleton[skeleton_count]
+		UInt32 animation_count;
+		UInt32 animations_offset;			// SceneV2Animation[animation_count]
+		UInt32 compressed_animation_count;
+		UInt32 compressed_animations_offset;	// each CompressedAnimation as written by CompressedAnimation::Write
+		UInt32 compressed_animations_size;
+	};
+
+	// characters are null terminated as well
+	struct SceneV2String
+	{
+		UInt32 offset;
+		UInt32 length;
+	};
+
+	struct SceneV2Material
+	{
+		StringId name_id;
+		SceneV2String diffuse_texture;
+	};
+
+	struct SceneV2Primitive
+	{
+		StringId material_name_id;
+		UInt32 num_indices;
+		UInt32 index_byte_size;
+		UInt32 type;
+		UInt32 indices_offset;
+	};
+
+	struct SceneV2Mesh
+	{
+		StringId name_id;
+		UInt32 num_vertices;
+		UInt32 vertex_byte_size;
+		UInt32 vertices_offset;
+		UInt32 primitive_count;
+		UInt32 primitives_offset;			// SceneV2Primitive[primitive_count]
+		float aabb_min[4];
+		float aabb_max[4];
+	};
+
+	struct SceneV2Skeleton
+	{
+		UInt32 joint_count;
+		UInt32 joints_offset;				// Joint[joint_count]
+	};
+
+	struct SceneV2AnimNode
+	{
+		StringId name_id;
+		UInt32 type;						// AnimNode::Type
+		// scale, rotation and translation keys for transform nodes, channel nodes only use the first
+		UInt32 key_counts[3];
+		UInt32 key_offsets[3];
+	};
+
+	struct SceneV2Animation
+	{
+		StringId name_id;
+		float start_time;
+		float end_time;
+		UInt32 node_count;
+		UInt32 nodes_offset;				// SceneV2AnimNode[node_count]
+	};
+
+	// appends size bytes to the file on an aligned boundary and returns their offset
+	static UInt32 AppendBlob(std::vector<char>& file_data, const void* data, const size_t size)
+	{
+		const size_t offset = (file_data.size() + kSceneV2Alignment - 1) & ~(size_t)(kSceneV2Alignment - 1);
+		file_data.resize(offset + size, 0);
+		if(size > 0)
+			memcpy(&file_data[offset], data, size);
+		return (UInt32)offset;
+	}
+
+	template <typename T>
+	static UInt32 AppendArray(std::vector<char>& file_data, const std::vector<T>& values)
+	{
+		return AppendBlob(file_data, values.empty() ? NULL : &values.front(), values.size()*sizeof(T));
+	}
+
+	static SceneV2String AppendString(std::vector<char>& file_data, const std::string& text)
+	{
+		SceneV2String result;
+		result.offset = AppendBlob(file_data, text.c_str(), text.length()+1);
+		result.length = (UInt32)text.length();
+		return result;
+	}
+
+	// true if count items of item_size from offset are all inside the file
+	static bool InFile(const UInt32 offset, const UInt32 count, const size_t item_size, const Int32 size)
+	{
+		const UInt64 end = (UInt64)offset + (UInt64)count*item_size;
+		return end <= (UInt64)size;
+	}
+
+	template <typename T>
+	static const T* FileArray(const char* data, const Int32 size, const UInt32 offset, const UInt32 count)
+	{
+		return InFile(offset, count, sizeof(T), size) ? reinterpret_cast<const T*>(data + offset) : NULL;
+	}
+
+	Scene::Scene()
+	{
+	}
+
 	Scene::~Scene()
 	{
 		// free up skeletons
@@ -37,6 +173,13 @@ namespace gef
 		// free up animations
 		for(std::map<gef::StringId, Animation*>::iterator animation_iter = animations.begin(); animation_iter != animations.end(); ++animation_iter)
 			delete animation_iter->second;
+
+		for(std::map<gef::StringId, CompressedAnimation*>::iterator animation_iter = compressed_animations.begin(); animation_iter != compressed_animations.end(); ++animation_iter)
+			delete animation_iter->second;
+
+		// the mesh data that points into the files doesn't free them
+		for(std::list<File*>::iterator file_iter = mapped_files_.begin(); file_iter != mapped_files_.end(); ++file_iter)
+			delete *file_iter;
 	}
 
 	Mesh* Scene::CreateMesh(Platform& platform, const MeshData& mesh_data, const bool read_only)
@@ -76,8 +219,19 @@ namespace gef
 		return mesh;
 	}
 
-	void Scene::CreateMaterials(const Platform& platform)
+	void Scene::CreateMaterials(const Platform& platform, TextureCache* texture_cache)
 	{
+		if(texture_cache)
+		{
+			std::vector<const char*> texture_filenames;
+			for(std::list<MaterialData>::iterator materialIter = material_data.begin();materialIter!=material_data.end();++materialIter)
+			{
+				if(materialIter->diffuse_texture != "")
+					texture_filenames.push_back(materialIter->diffuse_texture.c_str());
+			}
+			if(!texture_filenames.empty())
+				texture_cache->Load(&texture_filenames[0], (Int32)texture_filenames.size());
+		}
 
 		// go through all the materials and create new textures for them
 //		for(std::map<std::string, std::string>::iterator materialIter = materials_.begin();materialIter!=materials_.end();++materialIter)
@@ -89,17 +243,33 @@ namespace gef
 			if(materialIter->diffuse_texture != "")
 			{
 				gef::StringId texture_name_id = gef::GetStringId(materialIter->diffuse_texture);
-				if(textures_map.find(texture_name_id) == textures_map.end())
+				std::map<gef::StringId, Texture*>::iterator texture_iter = textures_map.find(texture_name_id);
+				if(texture_iter != textures_map.end())
+				{
+					// materials that share a texture share the texture object
+					material->set_texture(texture_iter->second);
+				}
+				else
 				{
 					string_id_table.Add(materialIter->diffuse_texture);
 
-					ImageData image_data;
-					PNGLoader png_loader;
-					png_loader.Load(materialIter->diffuse_texture.c_str(), platform, image_data);
-					if(image_data.image() != NULL)
+					Texture* texture = NULL;
+					if(texture_cache)
+						texture = texture_cache->FindTexture(materialIter->diffuse_texture.c_str());
+					else
+					{
+						ImageData image_data;
+						PNGLoader png_loader;
+						png_loader.Load(materialIter->diffuse_texture.c_str(), platform, image_data);
+						if(image_data.image() != NULL)
+						{
+							texture = Texture::Create(platform, image_data);
+							textures.push_back(texture);
+						}
+					}
+
+					if(texture)
 					{
-						Texture* texture = Texture::Create(platform, image_data);
-						textures.push_back(texture);
 						textures_map[texture_name_id] = texture;
 						material->set_texture(texture);
 					}
@@ -109,14 +279,17 @@ namespace gef
 	}
 
 
-	bool Scene::WriteSceneToFile(const Platform& platform, const char* filename) const
+	bool Scene::WriteSceneToFile(const Platform& platform, const char* filename, const Int32 version) const
 	{
 		bool success = true;
 
 		std::ofstream file_stream(filename, std::ios::out | std::ios::binary);
 		if(file_stream.is_open())
 		{
-			success = WriteScene(file_stream);
+			if(version == (Int32)kSceneV2Version)
+				success = WriteSceneV2(file_stream);
+			else
+				success = WriteScene(file_stream);
 		}
 		else
 		{
@@ -138,35 +311,32 @@ namespace gef
 		success = file->Open(filename);
 		if(success)
 		{
-			success = file->GetSize(file_size);
+			file_data = file->Map(file_size);
+			success = file_data != NULL;
+			file->Close();
+
 			if(success)
 			{
-				file_data = malloc(file_size);
-				success = file_data != NULL;
-				if(success)
+				if(IsSceneV2(file_data, file_size))
 				{
-					Int32 bytes_read;
-					success = file->Read(file_data, file_size, bytes_read);
-					if(success)
-						success = bytes_read == file_size;
-				}
+					success = ReadSceneV2(file_data, file_size);
 
-				if(success)
+					// the meshes use the file data, so keep it until the scene is deleted
+					// along with the files read before, which earlier meshes still use
+					mapped_files_.push_back(file);
+					file = NULL;
+				}
+				else
 				{
 					gef::MemoryStreamBuffer stream_buffer((char*)file_data, file_size);
 
 					std::istream input_stream(&stream_buffer);
 					success = ReadScene(input_stream);
-
-					// don't need the font file data any more
-					free(file_data);
-					file_data = NULL;
 				}
-
 			}
-
-			file->Close();
 		}
+
+		delete file;
 		return success;
 	}
 
@@ -251,6 +421,24 @@ namespace gef
 			animations[animation->name_id()] = animation;
 		}
 
+		// compressed animations, older files end before the count
+		Int32 compressed_animation_count = 0;
+		stream.read((char*)&compressed_animation_count, sizeof(Int32));
+		if(stream.fail())
+			compressed_animation_count = 0;
+		else if(compressed_animation_count < 0 || (std::streamoff)compressed_animation_count*CompressedAnimation::kMinWriteSize > RemainingStreamSize(stream))
+			return false;
+
+		for(Int32 animation_num=0;animation_num<compressed_animation_count;++animation_num)
+		{
+			CompressedAnimation* animation = new CompressedAnimation();
+			if(!animation->Read(stream))
+			{
+				delete animation;
+				return false;
+			}
+			compressed_animations[animation->name_id()] = animation;
+		}
 
 		return success;
 	}
@@ -294,9 +482,322 @@ namespace gef
 		for(std::map<gef::StringId, Animation*>::const_iterator animation_iter = animations.begin(); animation_iter != animations.end(); ++animation_iter)
 			animation_iter->second->Write(stream);
 
+		// only written when there are some, so scenes without them are unchanged
+		if(!compressed_animations.empty())
+		{
+			Int32 compressed_animation_count = (Int32)compressed_animations.size();
+			stream.write((char*)&compressed_animation_count, sizeof(Int32));
+			for(std::map<gef::StringId, CompressedAnimation*>::const_iterator animation_iter = compressed_animations.begin(); animation_iter != compressed_animations.end(); ++animation_iter)
+				animation_iter->second->Write(stream);
+		}
+
 		return success;
 	}
 
+	bool Scene::IsSceneV2(const void* data, const Int32 size)
+	{
+		if(!data || size < (Int32)sizeof(SceneV2Header))
+			return false;
+
+		const SceneV2Header* header = static_cast<const SceneV2Header*>(data);
+		return header->magic == kSceneV2Magic && header->version == kSceneV2Version;
+	}
+
+	bool Scene::ReadSceneV2(void* data, const Int32 size)
+	{
+		if(!IsSceneV2(data, size))
+			return false;
+
+		const char* file_data = static_cast<const char*>(data);
+		const SceneV2Header& header = *reinterpret_cast<const SceneV2Header*>(file_data);
+		if(header.file_size != (UInt32)size)
+			return false;
+
+		const SceneV2String* strings = FileArray<SceneV2String>(file_data, size, header.strings_offset, header.string_count);
+		const SceneV2Material* materials = FileArray<SceneV2Material>(file_data, size, header.materials_offset, header.material_count);
+		const SceneV2Mesh* scene_meshes = FileArray<SceneV2Mesh>(file_data, size, header.meshes_offset, header.mesh_count);
+		const SceneV2Skeleton* scene_skeletons = FileArray<SceneV2Skeleton>(file_data, size, header.skeletons_offset, header.skeleton_count);
+		const SceneV2Animation* scene_animations = FileArray<SceneV2Animation>(file_data, size, header.animations_offset, header.animation_count);
+		if(!strings || !materials || !scene_meshes || !scene_skeletons || !scene_animations || !InFile(header.compressed_animations_offset, header.compressed_animations_size, 1, size))
+			return false;
+
+		// string table
+		for(UInt32 string_num=0;string_num<header.string_count;++string_num)
+		{
+			if(!InFile(strings[string_num].offset, strings[string_num].length, 1, size))
+				return false;
+			string_id_table.Add(std::string(file_data + strings[string_num].offset, strings[string_num].length));
+		}
+
+		// materials
+		for(UInt32 material_num=0;material_num<header.material_count;++material_num)
+		{
+			const SceneV2Material& scene_material = materials[material_num];
+			if(!InFile(scene_material.diffuse_texture.offset, scene_material.diffuse_texture.length, 1, size))
+				return false;
+
+			material_data.push_back(MaterialData());
+			MaterialData& material = material_data.back();
+			material.name_id = scene_material.name_id;
+			material.diffuse_texture.assign(file_data + scene_material.diffuse_texture.offset, scene_material.diffuse_texture.length);
+			material_data_map[material.name_id] = &material;
+		}
+
+		// meshes, the vertices and indices are used in place
+		for(UInt32 mesh_num=0;mesh_num<header.mesh_count;++mesh_num)
+		{
+			const SceneV2Mesh& scene_mesh = scene_meshes[mesh_num];
+			const SceneV2Primitive* primitives = FileArray<SceneV2Primitive>(file_data, size, scene_mesh.primitives_offset, scene_mesh.primitive_count);
+			if(!primitives || !InFile(scene_mesh.vertices_offset, scene_mesh.num_vertices, scene_mesh.vertex_byte_size, size))
+				return false;
+
+			meshes.push_back(MeshData());
+			MeshData& mesh = meshes.back();
+			mesh.name_id = scene_mesh.name_id;
+			mesh.aabb.Update(Vector4(scene_mesh.aabb_min[0], scene_mesh.aabb_min[1], scene_mesh.aabb_min[2], scene_mesh.aabb_min[3]));
+			mesh.aabb.Update(Vector4(scene_mesh.aabb_max[0], scene_mesh.aabb_max[1], scene_mesh.aabb_max[2], scene_mesh.aabb_max[3]));
+			mesh.vertex_data.vertices = static_cast<char*>(data) + scene_mesh.vertices_offset;
+			mesh.vertex_data.num_vertices = (Int32)scene_mesh.num_vertices;
+			mesh.vertex_data.vertex_byte_size = (Int32)scene_mesh.vertex_byte_size;
+			mesh.vertex_data.mapped = true;
+
+			mesh.primitives.reserve(scene_mesh.primitive_count);
+			for(UInt32 prim_num=0;prim_num<scene_mesh.primitive_count;++prim_num)
+			{
+				const SceneV2Primitive& scene_primitive = primitives[prim_num];
+				if(!InFile(scene_primitive.indices_offset, scene_primitive.num_indices, scene_primitive.index_byte_size, size))
+					return false;
+
+				PrimitiveData* primitive_data = new PrimitiveData();
+				primitive_data->material_name_id = scene_primitive.material_name_id;
+				primitive_data->num_indices = (Int32)scene_primitive.num_indices;
+				primitive_data->index_byte_size = (Int32)scene_primitive.index_byte_size;
+				primitive_data->type = (PrimitiveType)scene_primitive.type;
+				primitive_data->indices = static_cast<char*>(data) + scene_primitive.indices_offset;
+				primitive_data->mapped = true;
+				mesh.primitives.push_back(primitive_data);
+			}
+		}
+
+		// skeletons, the joints are copied in one go
+		for(UInt32 skeleton_num=0;skeleton_num<header.skeleton_count;++skeleton_num)
+		{
+			const Joint* joints = FileArray<Joint>(file_data, size, scene_skeletons[skeleton_num].joints_offset, scene_skeletons[skeleton_num].joint_count);
+			if(!joints)
+				return false;
+
+			Skeleton* skeleton = new Skeleton();
+			skeleton->joints().assign(joints, joints + scene_skeletons[skeleton_num].joint_count);
+			skeletons.push_back(skeleton);
+		}
+
+		// animations, each set of keys is copied in one go
+		for(UInt32 animation_num=0;animation_num<header.animation_count;++animation_num)
+		{
+			const SceneV2Animation& scene_animation = scene_animations[animation_num];
+			const SceneV2AnimNode* nodes = FileArray<SceneV2AnimNode>(file_data, size, scene_animation.nodes_offset, scene_animation.node_count);
+			if(!nodes)
+				return false;
+
+			Animation* animation = new Animation();
+			animation->set_name_id(scene_animation.name_id);
+			animation->set_start_time(scene_animation.start_time);
+			animation->set_end_time(scene_animation.end_time);
+			animations[animation->name_id()] = animation;
+
+			for(UInt32 node_num=0;node_num<scene_animation.node_count;++node_num)
+			{
+				const SceneV2AnimNode& scene_node = nodes[node_num];
+				if(scene_node.type == AnimNode::kTransform)
+				{
+					const Vector3Key* scale_keys = FileArray<Vector3Key>(file_data, size, scene_node.key_offsets[0], scene_node.key_counts[0]);
+					const QuaternionKey* rotation_keys = FileArray<QuaternionKey>(file_data, size, scene_node.key_offsets[1], scene_node.key_counts[1]);
+					const Vector3Key* translation_keys = FileArray<Vector3Key>(file_data, size, scene_node.key_offsets[2], scene_node.key_counts[2]);
+					if(!scale_keys || !rotation_keys || !translation_keys)
+						return false;
+
+					TransformAnimNode* anim_node = new TransformAnimNode();
+					anim_node->set_name_id(scene_node.name_id);
+					anim_node->scale_keys().assign(scale_keys, scale_keys + scene_node.key_counts[0]);
+					anim_node->rotation_keys().assign(rotation_keys, rotation_keys + scene_node.key_counts[1]);
+					anim_node->translation_keys().assign(translation_keys, translation_keys + scene_node.key_counts[2]);
+					animation->AddNode(anim_node);
+				}
+				else if(scene_node.type == AnimNode::kChannel)
+				{
+					const ChannelKey* keys = FileArray<ChannelKey>(file_data, size, scene_node.key_offsets[0], scene_node.key_counts[0]);
+					if(!keys)
+						return false;
+
+					ChannelAnimNode* anim_node = new ChannelAnimNode();
+					anim_node->set_name_id(scene_node.name_id);
+					anim_node->keys().assign(keys, keys + scene_node.key_counts[0]);
+					animation->AddNode(anim_node);
+				}
+				else
+					return false;
+			}
+
+			animation->CalculateDuration();
+		}
+
+		// compressed animations are already one block each, so they are read through a stream
+		if(header.compressed_animation_count > 0)
+		{
+			gef::MemoryStreamBuffer stream_buffer(static_cast<char*>(data) + header.compressed_animations_offset, header.compressed_animations_size);
+			std::istream stream(&stream_buffer);
+			for(UInt32 animation_num=0;animation_num<header.compressed_animation_count;++animation_num)
+			{
+				CompressedAnimation* animation = new CompressedAnimation();
+				if(!animation->Read(stream))
+				{
+					delete animation;
+					return false;
+				}
+				compressed_animations[animation->name_id()] = animation;
+			}
+		}
+
+		return true;
+	}
+
+	bool Scene::WriteSceneV2(std::ostream& stream) const
+	{
+		std::vector<char> file_data;
+
+		SceneV2Header header;
+		memset(&header, 0, sizeof(SceneV2Header));
+		AppendBlob(file_data, &header, sizeof(SceneV2Header));
+
+		// string table
+		std::vector<SceneV2String> strings;
+		for(std::map<gef::StringId, std::string>::const_iterator string_iter = string_id_table.table().begin(); string_iter != string_id_table.table().end(); ++string_iter)
+			strings.push_back(AppendString(file_data, string_iter->second));
+		header.string_count = (UInt32)strings.size();
+		header.strings_offset = AppendArray(file_data, strings);
+
+		// materials
+		std::vector<SceneV2Material> materials;
+		for(std::list<MaterialData>::const_iterator material_iter = material_data.begin(); material_iter != material_data.end(); ++material_iter)
+		{
+			SceneV2Material material;
+			material.name_id = material_iter->name_id;
+			material.diffuse_texture = AppendString(file_data, material_iter->diffuse_texture);
+			materials.push_back(material);
+		}
+		header.material_count = (UInt32)materials.size();
+		header.materials_offset = AppendArray(file_data, materials);
+
+		// meshes
+		std::vector<SceneV2Mesh> scene_meshes;
+		for(std::list<MeshData>::const_iterator mesh_iter = meshes.begin(); mesh_iter != meshes.end(); ++mesh_iter)
+		{
+			std::vector<SceneV2Primitive> primitives;
+			for(std::vector<PrimitiveData*>::const_iterator prim_iter = mesh_iter->primitives.begin(); prim_iter != mesh_iter->primitives.end(); ++prim_iter)
+			{
+				SceneV2Primitive primitive;
+				primitive.material_name_id = (*prim_iter)->material_name_id;
+				primitive.num_indices = (UInt32)(*prim_iter)->num_indices;
+				primitive.index_byte_size = (UInt32)(*prim_iter)->index_byte_size;
+				primitive.type = (UInt32)(*prim_iter)->type;
+				primitive.indices_offset = AppendBlob(file_data, (*prim_iter)->indices, (size_t)(*prim_iter)->num_indices*(*prim_iter)->index_byte_size);
+				primitives.push_back(primitive);
+			}
+
+			SceneV2Mesh mesh;
+			memset(&mesh, 0, sizeof(SceneV2Mesh));
+			mesh.name_id = mesh_iter->name_id;
+			mesh.num_vertices = (UInt32)mesh_iter->vertex_data.num_vertices;
+			mesh.vertex_byte_size = (UInt32)mesh_iter->vertex_data.vertex_byte_size;
+			mesh.vertices_offset = AppendBlob(file_data, mesh_iter->vertex_data.vertices, (size_t)mesh_iter->vertex_data.num_vertices*mesh_iter->vertex_data.vertex_byte_size);
+			mesh.primitive_count = (UInt32)primitives.size();
+			mesh.primitives_offset = AppendArray(file_data, primitives);
+			for(Int32 axis = 0; axis < 4; ++axis)
+			{
+				mesh.aabb_min[axis] = mesh_iter->aabb.min_vtx()[axis];
+				mesh.aabb_max[axis] = mesh_iter->aabb.max_vtx()[axis];
+			}
+			scene_meshes.push_back(mesh);
+		}
+		header.mesh_count = (UInt32)scene_meshes.size();
+		header.meshes_offset = AppendArray(file_data, scene_meshes);
+
+		// skeletons
+		std::vector<SceneV2Skeleton> scene_skeletons;
+		for(std::list<Skeleton*>::const_iterator skeleton_iter = skeletons.begin();skeleton_iter != skeletons.end(); ++skeleton_iter)
+		{
+			SceneV2Skeleton skeleton;
+			skeleton.joint_count = (UInt32)(*skeleton_iter)->joint_count();
+			skeleton.joints_offset = AppendArray(file_data, (*skeleton_iter)->joints());
+			scene_skeletons.push_back(skeleton);
+		}
+		header.skeleton_count = (UInt32)scene_skeletons.size();
+		header.skeletons_offset = AppendArray(file_data, scene_skeletons);
+
+		// animations
+		std::vector<SceneV2Animation> scene_animations;
+		for(std::map<gef::StringId, Animation*>::const_iterator animation_iter = animations.begin(); animation_iter != animations.end(); ++animation_iter)
+		{
+			const Animation& animation = *animation_iter->second;
+			std::vector<SceneV2AnimNode> nodes;
+			for(std::map<StringId, AnimNode*>::const_iterator node_iter = animation.anim_nodes().begin(); node_iter != animation.anim_nodes().end(); ++node_iter)
+			{
+				SceneV2AnimNode node;
+				memset(&node, 0, sizeof(SceneV2AnimNode));
+				node.name_id = node_iter->second->name_id();
+				node.type = (UInt32)node_iter->second->type();
+				if(node_iter->second->type() == AnimNode::kTransform)
+				{
+					const TransformAnimNode* transform_node = static_cast<const TransformAnimNode*>(node_iter->second);
+					node.key_counts[0] = (UInt32)transform_node->scale_keys().size();
+					node.key_offsets[0] = AppendArray(file_data, transform_node->scale_keys());
+					node.key_counts[1] = (UInt32)transform_node->rotation_keys().size();
+					node.key_offsets[1] = AppendArray(file_data, transform_node->rotation_keys());
+					node.key_counts[2] = (UInt32)transform_node->translation_keys().size();
+					node.key_offsets[2] = AppendArray(file_data, transform_node->translation_keys());
+				}
+				else
+				{
+					const ChannelAnimNode* channel_node = static_cast<const ChannelAnimNode*>(node_iter->second);
+					node.key_counts[0] = (UInt32)channel_node->keys().size();
+					node.key_offsets[0] = AppendArray(file_data, channel_node->keys());
+				}
+				nodes.push_back(node);
+			}
+
+			SceneV2Animation scene_animation;
+			scene_animation.name_id = animation.name_id();
+			scene_animation.start_time = animation.start_time();
+			scene_animation.end_time = animation.end_time();
+			scene_animation.node_count = (UInt32)nodes.size();
+			scene_animation.nodes_offset = AppendArray(file_data, nodes);
+			scene_animations.push_back(scene_animation);
+		}
+		header.animation_count = (UInt32)scene_animations.size();
+		header.animations_offset = AppendArray(file_data, scene_animations);
+
+		// compressed animations
+		if(!compressed_animations.empty())
+		{
+			std::ostringstream compressed_stream(std::ios::out | std::ios::binary);
+			for(std::map<gef::StringId, CompressedAnimation*>::const_iterator animation_iter = compressed_animations.begin(); animation_iter != compressed_animations.end(); ++animation_iter)
+				animation_iter->second->Write(compressed_stream);
+
+			const std::string compressed_data = compressed_stream.str();
+			header.compressed_animation_count = (UInt32)compressed_animations.size();
+			header.compressed_animations_size = (UInt32)compressed_data.size();
+			header.compressed_animations_offset = AppendBlob(file_data, compressed_data.data(), compressed_data.size());
+		}
+
+		header.magic = kSceneV2Magic;
+		header.version = kSceneV2Version;
+		header.file_size = (UInt32)file_data.size();
+		memcpy(&file_data.front(), &header, sizeof(SceneV2Header));
+
+		stream.write(&file_data.front(), file_data.size());
+		return !stream.fail();
+	}
+
 	Skeleton* Scene::FindSkeleton(const MeshData& mesh_data)
 	{
 		Skeleton* result = NULL;
@@ -13,22 +13,35 @@ namespace gef
 	class Mesh;
 	class Texture;
 	class Animation;
+	class CompressedAnimation;
 	class Platform;
 	class Material;
+	class File;
+	class TextureCache;
 
 	class Scene
 	{
 	public:
+		Scene();
 		~Scene();
 
 		Mesh* CreateMesh(Platform& platform, const MeshData& mesh_data, const bool read_only = true);
-		void CreateMaterials(const Platform& platform);
+		// with a texture cache the textures are loaded in one batch and owned by the cache rather than the scene
+		void CreateMaterials(const Platform& platform, TextureCache* texture_cache = NULL);
 
-		bool WriteSceneToFile(const Platform& platform, const char* filename) const;
+		// version 2 files are mapped into memory and the vertex and index data used where it is,
+		// the file stays mapped until the scene is deleted. version 1 files are read through a stream
+		bool WriteSceneToFile(const Platform& platform, const char* filename, const Int32 version = 1) const;
 		bool ReadSceneFromFile(const Platform& platform, const char* filename);
 
 		bool ReadScene(std::istream& Stream);
 		bool WriteScene(std::ostream& Stream) const;
+
+		// version 2 of the file, aligned blobs found through tables of offsets
+		// data isn't copied where it can be used in place, so it must last as long as the scene
+		bool ReadSceneV2(void* data, const Int32 size);
+		bool WriteSceneV2(std::ostream& stream) const;
+		static bool IsSceneV2(const void* data, const Int32 size);
 //		void WriteStringTable(std::istream& Stream) const;
 //		void ReadStringTable(std::istream& Stream);
 
@@ -43,6 +56,8 @@ namespace gef
 		std::list<Material*> materials;
 		std::list<Skeleton*> skeletons;
 		std::map<gef::StringId, Animation*> animations;
+		// written after the other scene data, so files without them read as before
+		std::map<gef::StringId, CompressedAnimation*> compressed_animations;
 		StringIdTable string_id_table;
 
 		std::map<gef::StringId, MaterialData*> material_data_map;
@@ -50,6 +65,10 @@ namespace gef
 		std::map<gef::StringId, Texture*> textures_map;
 
 		std::vector<gef::StringId> skin_cluster_name_ids;
+
+	private:
+		// the version 2 files the mesh data points into, one for each read into the scene
+		std::list<File*> mapped_files_;
 	};
 }
 
@@ -18,6 +18,7 @@ namespace gef
 			pixel_shader_variable_data_(NULL),
 			pixel_shader_variable_data_size_(0),
 			vertex_size_(0),
+			instance_size_(0),
 			vs_shader_source_(NULL),
 			vs_shader_source_size_(0),
 			ps_shader_source_(NULL),
@@ -86,9 +87,16 @@ namespace gef
 		shader_parameter.byte_offset = parameter_byte_offset;
 		shader_parameter.semantic_name = semantic_name;
 		shader_parameter.semantic_index = semantic_index;
+		shader_parameter.per_instance = false;
 		parameters_.push_back(shader_parameter);
 	}
 
+	void ShaderInterface::AddInstanceParameter(const char* parameter_name, VariableType parameter_type, Int32 parameter_byte_offset, const char* semantic_name, int semantic_index)
+	{
+		AddVertexParameter(parameter_name, parameter_type, parameter_byte_offset, semantic_name, semantic_index);
+		parameters_.back().per_instance = true;
+	}
+
 	Int32 ShaderInterface::AddTextureSampler(const char* texture_sampler_name)
 	{
 		TextureSampler texture_sampler;
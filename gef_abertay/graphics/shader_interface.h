@@ -46,6 +46,8 @@ namespace gef
 			Int32 byte_offset;
 			std::string semantic_name;
 			Int32 semantic_index;
+			/// read once per instance from the instance buffer rather than per vertex
+			bool per_instance;
 		};
 
 		struct TextureSampler
@@ -66,6 +68,12 @@ namespace gef
 		void AddVertexParameter(const char* parameter_name, VariableType variable_type, Int32 byte_offset, const char* semantic_name, int semantic_index);
 		inline void set_vertex_size(Int32 vertex_size) {vertex_size_ = vertex_size; }
 
+		/// Instance parameters are laid out in a second buffer, bound next to the
+		/// vertex buffer, that advances once per instance when drawing instanced.
+		void AddInstanceParameter(const char* parameter_name, VariableType variable_type, Int32 byte_offset, const char* semantic_name, int semantic_index);
+		inline void set_instance_size(Int32 instance_size) { instance_size_ = instance_size; }
+		inline Int32 instance_size() const { return instance_size_; }
+
 		Int32 AddVertexShaderVariable(const char* variable_name, VariableType variable_type, Int32 variable_count = 1);
 		void SetVertexShaderVariable(Int32 variable_index, const void* value, Int32 variable_count = -1);
 		Int32 AddPixelShaderVariable(const char* variable_name, VariableType variable_type, Int32 variable_count = 1);
@@ -109,6 +117,7 @@ namespace gef
 		UInt8* pixel_shader_variable_data_;
 		Int32 pixel_shader_variable_data_size_;
 		Int32 vertex_size_;
+		Int32 instance_size_;
 	};
 }
 
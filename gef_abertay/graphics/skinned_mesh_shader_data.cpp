@@ -1,11 +1,19 @@
 #include <graphics/skinned_mesh_shader_data.h>
+#include <maths/matrix44.h>
 #include <cstdlib>
 
 namespace gef
 {
 	SkinnedMeshShaderData::SkinnedMeshShaderData() :
-	bone_matrices_(NULL)
+	bone_matrices_(NULL),
+	bone_count_(0)
 	{
 	}
+
+	void SkinnedMeshShaderData::set_bone_matrices(const std::vector<Matrix44>* const bone_matrices)
+	{
+		bone_matrices_ = bone_matrices && !bone_matrices->empty() ? &bone_matrices->front() : NULL;
+		bone_count_ = bone_matrices ? (Int32)bone_matrices->size() : 0;
+	}
 }
 
@@ -10,12 +10,15 @@ namespace gef
 	public:
 		SkinnedMeshShaderData();
 
-		const std::vector<Matrix44>* const bone_matrices() const { return bone_matrices_; }
+		const Matrix44* bone_matrices() const { return bone_matrices_; }
+		Int32 bone_count() const { return bone_count_; }
 		
-		void set_bone_matrices(const std::vector<Matrix44>* const bone_matrices) { bone_matrices_ = bone_matrices; }
+		void set_bone_matrices(const std::vector<Matrix44>* const bone_matrices);
+		void set_bone_matrices(const Matrix44* const bone_matrices, const Int32 bone_count) { bone_matrices_ = bone_matrices; bone_count_ = bone_count; }
 
 	private:
-		const std::vector<Matrix44>* bone_matrices_;
+		const Matrix44* bone_matrices_;
+		Int32 bone_count_;
 	};
 }
 
@@ -6,6 +6,7 @@
 //#include <libdbg.h>
 #include <cstdlib>
 #include <math.h>
+#include <algorithm>
 #include <graphics/shader.h>
 
 namespace gef
@@ -14,7 +15,8 @@ namespace gef
 SpriteRenderer::SpriteRenderer(Platform& platform) :
 platform_(platform),
 	shader_(NULL),
-	default_shader_(platform_)
+	default_shader_(platform_),
+	batching_enabled_(false)
 {
 	//SCE_DBG_ASSERT(platform_ != NULL);
 }
@@ -79,5 +81,100 @@ void SpriteRenderer::BuildSpriteShaderData(const Sprite& sprite, Matrix44& sprit
         sprite_data.set_m(3,3,colour.a);
 }
 
+void SpriteRenderer::BuildSpriteVertices(const Sprite& sprite, SpriteVertex* vertices)
+{
+	// the same transform the default sprite shader applies to its unit quad
+	float axis_x[2] = { sprite.width(), 0.0f };
+	float axis_y[2] = { 0.0f, sprite.height() };
+	if (sprite.rotation() != 0)
+	{
+		const float cos_rotation = cosf(sprite.rotation());
+		const float sin_rotation = sinf(sprite.rotation());
+		axis_x[0] = cos_rotation*sprite.width();
+		axis_x[1] = sin_rotation*sprite.width();
+		axis_y[0] = -sin_rotation*sprite.height();
+		axis_y[1] = cos_rotation*sprite.height();
+	}
+
+	Colour colour;
+	colour.SetFromAGBR(sprite.colour());
+
+	// triangles in the same winding as the unit quad
+	static const float corners[kVerticesPerSprite][2] = {
+		{ -0.5f, -0.5f }, { 0.5f, -0.5f }, { 0.5f, 0.5f },
+		{ -0.5f, -0.5f }, { 0.5f, 0.5f }, { -0.5f, 0.5f } };
+
+	for (UInt32 vertex_num = 0; vertex_num < kVerticesPerSprite; ++vertex_num)
+	{
+		const float corner_x = corners[vertex_num][0];
+		const float corner_y = corners[vertex_num][1];
+		SpriteVertex& vertex = vertices[vertex_num];
+
+		vertex.position[0] = sprite.position().x() + corner_x*axis_x[0] + corner_y*axis_y[0];
+		vertex.position[1] = sprite.position().y() + corner_x*axis_x[1] + corner_y*axis_y[1];
+		vertex.position[2] = sprite.position().z();
+		vertex.uv[0] = (corner_x + 0.5f)*sprite.uv_width() + sprite.uv_position().x;
+		vertex.uv[1] = (corner_y + 0.5f)*sprite.uv_height() + sprite.uv_position().y;
+		vertex.colour[0] = colour.r;
+		vertex.colour[1] = colour.g;
+		vertex.colour[2] = colour.b;
+		vertex.colour[3] = colour.a;
+	}
+}
+
+void SpriteRenderer::QueueSprite(const Sprite& sprite)
+{
+	// only the depth after projection decides which sprites are behind
+	SpriteQueueKey key;
+	key.depth = sprite.position().z()*projection_matrix_.m(2,2) + projection_matrix_.m(3,2);
+	key.texture = sprite.texture();
+	key.sprite_index = (UInt32)sprite_queue_.size();
+
+	sprite_queue_.push_back(sprite);
+	sprite_queue_keys_.push_back(key);
+}
+
+void SpriteRenderer::FlushSpriteBatch()
+{
+	if (sprite_queue_keys_.empty())
+		return;
+
+	std::sort(sprite_queue_keys_.begin(), sprite_queue_keys_.end());
+
+	sprite_batch_vertices_.resize(sprite_queue_keys_.size()*kVerticesPerSprite);
+	sprite_batches_.clear();
+
+	UInt32 vertex_num = 0;
+	for (std::vector<SpriteQueueKey>::const_iterator key = sprite_queue_keys_.begin(); key != sprite_queue_keys_.end(); ++key)
+	{
+		if (sprite_batches_.empty() || sprite_batches_.back().texture != key->texture)
+		{
+			SpriteBatch batch;
+			batch.texture = key->texture;
+			batch.first_vertex = vertex_num;
+			batch.num_vertices = 0;
+			sprite_batches_.push_back(batch);
+		}
+
+		BuildSpriteVertices(sprite_queue_[key->sprite_index], &sprite_batch_vertices_[vertex_num]);
+		sprite_batches_.back().num_vertices += kVerticesPerSprite;
+		vertex_num += kVerticesPerSprite;
+	}
+
+	SubmitSpriteBatches(&sprite_batch_vertices_[0], vertex_num, &sprite_batches_[0], (UInt32)sprite_batches_.size());
+
+	stats_.sprites += (UInt32)sprite_queue_keys_.size();
+	stats_.batched_sprites += (UInt32)sprite_queue_keys_.size();
+	stats_.draw_calls += (UInt32)sprite_batches_.size();
+	stats_.texture_changes += (UInt32)sprite_batches_.size();
+
+	sprite_queue_.clear();
+	sprite_queue_keys_.clear();
+}
+
+void SpriteRenderer::SubmitSpriteBatches(const SpriteVertex* vertices, const UInt32 num_vertices, const SpriteBatch* batches, const UInt32 num_batches)
+{
+}
+
 
 }
\ No newline at end of file
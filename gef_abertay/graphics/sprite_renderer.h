@@ -1,8 +1,11 @@
 #ifndef _GEF_SPRITE_RENDERER_H
 #define _GEF_SPRITE_RENDERER_H
 
+#include <gef.h>
 #include <maths/matrix44.h>
 #include <graphics/default_sprite_shader.h>
+#include <graphics/sprite.h>
+#include <vector>
 
 namespace gef
 {
@@ -11,6 +14,26 @@ namespace gef
 	class Sprite;
 	class Platform;
 	class Shader;
+	class Texture;
+
+	/// Counts of the work done by a SpriteRenderer, e.g. over a frame.
+	struct SpriteRenderStats
+	{
+		UInt32 sprites;
+		/// sprites that were drawn as part of a batch
+		UInt32 batched_sprites;
+		UInt32 draw_calls;
+		UInt32 texture_changes;
+
+		SpriteRenderStats() { Reset(); }
+		void Reset()
+		{
+			sprites = 0;
+			batched_sprites = 0;
+			draw_calls = 0;
+			texture_changes = 0;
+		}
+	};
 
 	class SpriteRenderer
 	{
@@ -25,11 +48,82 @@ namespace gef
 		inline const Matrix44& projection_matrix() const { return projection_matrix_; }
 		inline void set_projection_matrix(const  Matrix44& matrix) {projection_matrix_ = matrix;}
 
+		/// When batching is enabled DrawSprite only records the sprite. At End
+		/// the sprites are sorted back to front by depth, then by texture, and
+		/// each run of sprites with the same texture is drawn with one draw
+		/// call from a dynamic vertex buffer. Sprites at the same depth can be
+		/// drawn in a different order to the one they were given in, so
+		/// sprites that overlap should have different depths.
+		/// Only sprites drawn with the default shader are batched. Backends
+		/// without batching draw every sprite straight away.
+		inline bool batching_enabled() const { return batching_enabled_; }
+		inline void set_batching_enabled(const bool enabled) { batching_enabled_ = enabled; }
+
+		/// @return counts for the sprites drawn since the last call to ResetStats
+		inline const SpriteRenderStats& stats() const { return stats_; }
+		inline void ResetStats() { stats_.Reset(); }
+
 		static SpriteRenderer* Create(Platform& platform);
+
+		/// A corner of a sprite, already moved to its place on screen. Public
+		/// so the batch shader can describe the same layout.
+		struct SpriteVertex
+		{
+			float position[3];
+			float uv[2];
+			float colour[4];
+		};
 	protected:
 		SpriteRenderer(Platform& platform);
 		void BuildSpriteShaderData(const Sprite& sprite, Matrix44& sprite_data);
 
+		/// A run of sprites that share a texture, drawn with one draw call.
+		struct SpriteBatch
+		{
+			/// NULL for sprites without a texture
+			const Texture* texture;
+			UInt32 first_vertex;
+			UInt32 num_vertices;
+		};
+
+		/// Number of vertices written by BuildSpriteVertices, two triangles.
+		static const UInt32 kVerticesPerSprite = 6;
+
+		/// Write the two triangles of a sprite.
+		static void BuildSpriteVertices(const Sprite& sprite, SpriteVertex* vertices);
+
+		/// Record a sprite to be drawn by FlushSpriteBatch.
+		void QueueSprite(const Sprite& sprite);
+
+		/// Sort the recorded sprites into batches and submit them, then empty
+		/// the queue.
+		void FlushSpriteBatch();
+
+		/// Draw the batches. The vertices of all the batches are in one array.
+		/// The default does nothing, for backends with nothing to draw to and
+		/// those that never queue sprites.
+		virtual void SubmitSpriteBatches(const SpriteVertex* vertices, const UInt32 num_vertices, const SpriteBatch* batches, const UInt32 num_batches);
+
+		struct SpriteQueueKey
+		{
+			/// depth after projection, larger is further away
+			float depth;
+			const Texture* texture;
+			UInt32 sprite_index;
+
+			// furthest first so blending is correct, then grouped by texture.
+			// Only sprites with the same depth and texture keep the order they
+			// were drawn in
+			bool operator<(const SpriteQueueKey& key) const
+			{
+				if (depth != key.depth)
+					return depth > key.depth;
+				if (texture != key.texture)
+					return texture < key.texture;
+				return sprite_index < key.sprite_index;
+			}
+		};
+
 		inline void set_shader( Shader* shader) { shader_ = shader; }
 
 		Platform& platform_;
@@ -37,6 +131,13 @@ namespace gef
 
 		Shader* shader_;
 		DefaultSpriteShader default_shader_;
+
+		bool batching_enabled_;
+		SpriteRenderStats stats_;
+		std::vector<Sprite> sprite_queue_;
+		std::vector<SpriteQueueKey> sprite_queue_keys_;
+		std::vector<SpriteVertex> sprite_batch_vertices_;
+		std::vector<SpriteBatch> sprite_batches_;
 	};
 }
 #endif // _GEF_SPRITE_RENDERER_H
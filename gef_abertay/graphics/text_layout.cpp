@@ -0,0 +1,106 @@
+#include <graphics/text_layout.h>
+#include <graphics/sprite_renderer.h>
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+
+namespace gef
+{
+	TextLayout::TextLayout() :
+		next_run_(0),
+		layout_count_(0)
+	{
+	}
+
+	void TextLayout::Begin()
+	{
+		next_run_ = 0;
+	}
+
+	void TextLayout::AddText(const Font& font, const Vector4& pos, const float scale, const UInt32 colour, const TextJustification justification, const char* text, ...)
+	{
+		if (!text)
+			return;
+
+		va_list args;
+		char text_buffer[256];
+
+		va_start(args, text);
+		std::vsnprintf(text_buffer, sizeof(text_buffer), text, args);
+		va_end(args);
+
+		if (next_run_ < runs_.size())
+		{
+			const TextRun& run = runs_[next_run_];
+			if (run.font == &font && run.position.x() == pos.x() && run.position.y() == pos.y() && run.position.z() == pos.z()
+				&& run.scale == scale && run.colour == colour && run.justification == justification && run.text == text_buffer)
+			{
+				// same as last frame, keep the glyphs
+				next_run_++;
+				return;
+			}
+		}
+		else
+		{
+			TextRun run;
+			run.first_glyph = (UInt32)glyphs_.size();
+			runs_.push_back(run);
+		}
+
+		TextRun& run = runs_[next_run_];
+		run.font = &font;
+		run.position = pos;
+		run.scale = scale;
+		run.colour = colour;
+		run.justification = justification;
+		run.text = text_buffer;
+
+		new_glyphs_.clear();
+		font.LayoutText(pos, scale, colour, justification, text_buffer, new_glyphs_);
+		layout_count_++;
+
+		// replace the old glyphs of this run, moving the glyphs of the runs
+		// after it if the number of characters changed
+		const UInt32 num_new_glyphs = (UInt32)new_glyphs_.size();
+		std::vector<Sprite>::iterator first_glyph = glyphs_.begin() + run.first_glyph;
+		if (num_new_glyphs == run.num_glyphs)
+		{
+			std::copy(new_glyphs_.begin(), new_glyphs_.end(), first_glyph);
+		}
+		else
+		{
+			first_glyph = glyphs_.erase(first_glyph, first_glyph + run.num_glyphs);
+			glyphs_.insert(first_glyph, new_glyphs_.begin(), new_glyphs_.end());
+
+			const Int32 glyph_count_change = (Int32)num_new_glyphs - (Int32)run.num_glyphs;
+			for (UInt32 run_num = next_run_ + 1; run_num < runs_.size(); ++run_num)
+				runs_[run_num].first_glyph += glyph_count_change;
+			run.num_glyphs = num_new_glyphs;
+		}
+
+		next_run_++;
+	}
+
+	void TextLayout::End()
+	{
+		if (next_run_ < runs_.size())
+		{
+			glyphs_.resize(runs_[next_run_].first_glyph);
+			runs_.resize(next_run_);
+		}
+	}
+
+	void TextLayout::Draw(SpriteRenderer* renderer) const
+	{
+		for (std::vector<Sprite>::const_iterator glyph = glyphs_.begin(); glyph != glyphs_.end(); ++glyph)
+			renderer->DrawSprite(*glyph);
+	}
+
+	void TextLayout::Clear()
+	{
+		runs_.clear();
+		glyphs_.clear();
+		next_run_ = 0;
+	}
+}
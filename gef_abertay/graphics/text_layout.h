@@ -0,0 +1,85 @@
+#ifndef _GEF_TEXT_LAYOUT_H
+#define _GEF_TEXT_LAYOUT_H
+
+#include <gef.h>
+#include <graphics/font.h>
+#include <graphics/sprite.h>
+#include <maths/vector4.h>
+#include <string>
+#include <vector>
+
+namespace gef
+{
+	// FORWARD DECLARATIONS
+	class SpriteRenderer;
+
+	/// Keeps the glyph sprites of some text between frames, so text that
+	/// doesn't change isn't laid out again.
+	///
+	/// Text is given the same way as Font::RenderText, once per frame,
+	/// between Begin and End. Each call to AddText is compared with the
+	/// call made in the same place last frame and only laid out again if
+	/// anything is different. The glyphs of every call are kept together,
+	/// so Draw submits them all as one run of sprites with the font
+	/// texture, which a batching SpriteRenderer draws in a single batch.
+	class TextLayout
+	{
+	public:
+		TextLayout();
+
+		/// Start giving this frame's text.
+		void Begin();
+
+		/// Add text, formatted as printf does.
+		void AddText(const Font& font, const Vector4& pos, const float scale, const UInt32 colour, const TextJustification justification, const char* text, ...);
+
+		/// Finish giving this frame's text. Text from last frame that wasn't
+		/// given again is removed.
+		void End();
+
+		/// Draw the glyphs of all the text.
+		void Draw(SpriteRenderer* renderer) const;
+
+		/// Remove all text.
+		void Clear();
+
+		inline UInt32 num_glyphs() const { return (UInt32)glyphs_.size(); }
+
+		/// @return how many times text has been laid out, for checking how
+		/// much of it is reused
+		inline UInt32 layout_count() const { return layout_count_; }
+	private:
+		struct TextRun
+		{
+			TextRun() :
+				font(NULL),
+				position(0.0f, 0.0f, 0.0f),
+				scale(1.0f),
+				colour(0),
+				justification(TJ_LEFT),
+				first_glyph(0),
+				num_glyphs(0)
+			{
+			}
+
+			const Font* font;
+			Vector4 position;
+			float scale;
+			UInt32 colour;
+			TextJustification justification;
+			std::string text;
+
+			/// the glyphs of this run are glyphs_[first_glyph, first_glyph + num_glyphs)
+			UInt32 first_glyph;
+			UInt32 num_glyphs;
+		};
+
+		std::vector<TextRun> runs_;
+		std::vector<Sprite> glyphs_;
+		std::vector<Sprite> new_glyphs_;
+		UInt32 next_run_;
+		UInt32 layout_count_;
+	};
+}
+
+#endif // _GEF_TEXT_LAYOUT_H
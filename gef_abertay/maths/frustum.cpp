@@ -2,6 +2,7 @@
 #include <maths/matrix44.h>
 #include <maths/sphere.h>
 #include <maths/aabb.h>
+#include <maths/simd.h>
 #include <math.h>
 
 namespace gef
@@ -13,6 +14,7 @@ namespace gef
 	{
 		const Vector4& sphere_centre = sphere.position();
 		float sphere_radius = sphere.radius();
+		bool intersects = false;
 
 			// calculate our distances to each of the planes
 		for (int i = 0; i < 6; ++i)
@@ -25,13 +27,76 @@ namespace gef
 			if (distance < -sphere_radius)
 				return FI_OUT;
 
-			// else if the distance is between +- radius, then we intersect
+			// else if the distance is between +- radius, then we intersect,
+			// but the remaining planes can still put the sphere outside
 			if (fabsf(distance) < sphere_radius)
-				return FI_INTERSECTS;
+				intersects = true;
 		}
 
 		// otherwise we are fully in view
-		return FI_IN;
+		return intersects ? FI_INTERSECTS : FI_IN;
+	}
+
+	Int32 Frustum::CullSpheres(const float* centre_x, const float* centre_y, const float* centre_z, const float* radius, const Int32 count, UInt8* visible) const
+	{
+		Int32 num_visible = 0;
+		Int32 sphere_num = 0;
+
+#if defined(GEF_SIMD)
+		// planes broadcast across the four lanes, so each lane handles one sphere
+		simd::Float4 plane_a[NUM_FRUSTUM_PLANES], plane_b[NUM_FRUSTUM_PLANES], plane_c[NUM_FRUSTUM_PLANES], plane_d[NUM_FRUSTUM_PLANES];
+		for (int i = 0; i < NUM_FRUSTUM_PLANES; ++i)
+		{
+			plane_a[i] = simd::Splat(planes_[i].a());
+			plane_b[i] = simd::Splat(planes_[i].b());
+			plane_c[i] = simd::Splat(planes_[i].c());
+			plane_d[i] = simd::Splat(planes_[i].d());
+		}
+
+		for (; sphere_num + 4 <= count; sphere_num += 4)
+		{
+			const simd::Float4 x = simd::Load(centre_x + sphere_num);
+			const simd::Float4 y = simd::Load(centre_y + sphere_num);
+			const simd::Float4 z = simd::Load(centre_z + sphere_num);
+			const simd::Float4 negative_radius = simd::Sub(simd::Splat(0.0f), simd::Load(radius + sphere_num));
+
+			// a sphere is outside if it is further than its radius behind any plane
+			simd::Float4 outside = simd::Splat(0.0f);
+			for (int i = 0; i < NUM_FRUSTUM_PLANES; ++i)
+			{
+				simd::Float4 distance = simd::MulAdd(x, plane_a[i], plane_d[i]);
+				distance = simd::MulAdd(y, plane_b[i], distance);
+				distance = simd::MulAdd(z, plane_c[i], distance);
+				outside = simd::Or(outside, simd::Less(distance, negative_radius));
+			}
+
+			const Int32 outside_mask = simd::SignMask(outside);
+			for (int lane = 0; lane < 4; ++lane)
+			{
+				const UInt8 lane_visible = (outside_mask & (1 << lane)) ? 0 : 1;
+				visible[sphere_num + lane] = lane_visible;
+				num_visible += lane_visible;
+			}
+		}
+#endif
+
+		for (; sphere_num < count; ++sphere_num)
+		{
+			const Vector4 centre(centre_x[sphere_num], centre_y[sphere_num], centre_z[sphere_num]);
+			UInt8 sphere_visible = 1;
+			for (int i = 0; i < NUM_FRUSTUM_PLANES; ++i)
+			{
+				if (planes_[i].DistanceFromPoint(centre) < -radius[sphere_num])
+				{
+					sphere_visible = 0;
+					break;
+				}
+			}
+			visible[sphere_num] = sphere_visible;
+			num_visible += sphere_visible;
+		}
+
+		return num_visible;
 	}
 
 	FrustumIntersect Frustum::Intersects(const Aabb& aabb) const
@@ -90,90 +155,62 @@ namespace gef
 
 	void Frustum::ExtractPlanesD3D(const Matrix44& viewproj, bool normalise)
 	{
+		// gef matrices transform row vectors, so the clip space coordinates
+		// are the dot products of a point with the columns of viewproj
 		// Left clipping plane
-		planes_[0].set_a(viewproj.m(0,3) + viewproj.m(0,0));
-		planes_[0].set_b(viewproj.m(1,3) + viewproj.m(1,0));
-		planes_[0].set_c(viewproj.m(2,3) + viewproj.m(2,0));
-		planes_[0].set_d(viewproj.m(3,3) + viewproj.m(3,0));
+		planes_[FP_LEFT].set_a(viewproj.m(0,3) + viewproj.m(0,0));
+		planes_[FP_LEFT].set_b(viewproj.m(1,3) + viewproj.m(1,0));
+		planes_[FP_LEFT].set_c(viewproj.m(2,3) + viewproj.m(2,0));
+		planes_[FP_LEFT].set_d(viewproj.m(3,3) + viewproj.m(3,0));
 		// Right clipping plane
-		planes_[0].set_a(viewproj.m(0,3) - viewproj.m(0,0));
-		planes_[0].set_b(viewproj.m(1,3) - viewproj.m(1,0));
-		planes_[0].set_c(viewproj.m(2,3) - viewproj.m(2,0));
-		planes_[0].set_d(viewproj.m(3,3) - viewproj.m(3,0));
+		planes_[FP_RIGHT].set_a(viewproj.m(0,3) - viewproj.m(0,0));
+		planes_[FP_RIGHT].set_b(viewproj.m(1,3) - viewproj.m(1,0));
+		planes_[FP_RIGHT].set_c(viewproj.m(2,3) - viewproj.m(2,0));
+		planes_[FP_RIGHT].set_d(viewproj.m(3,3) - viewproj.m(3,0));
 		// Top clipping plane
-		planes_[1].set_a(viewproj.m(0,3) - viewproj.m(0,1));
-		planes_[1].set_b(viewproj.m(1,3) - viewproj.m(1,1));
-		planes_[1].set_c(viewproj.m(2,3) - viewproj.m(2,1));
-		planes_[1].set_d(viewproj.m(3,3) - viewproj.m(3,1));
+		planes_[FP_TOP].set_a(viewproj.m(0,3) - viewproj.m(0,1));
+		planes_[FP_TOP].set_b(viewproj.m(1,3) - viewproj.m(1,1));
+		planes_[FP_TOP].set_c(viewproj.m(2,3) - viewproj.m(2,1));
+		planes_[FP_TOP].set_d(viewproj.m(3,3) - viewproj.m(3,1));
 		// Bottom clipping plane
-		planes_[2].set_a(viewproj.m(0,3) + viewproj.m(0,1));
-		planes_[2].set_b(viewproj.m(1,3) + viewproj.m(1,1));
-		planes_[2].set_c(viewproj.m(2,3) + viewproj.m(2,1));
-		planes_[2].set_d(viewproj.m(3,3) + viewproj.m(3,1));
+		planes_[FP_BOTTOM].set_a(viewproj.m(0,3) + viewproj.m(0,1));
+		planes_[FP_BOTTOM].set_b(viewproj.m(1,3) + viewproj.m(1,1));
+		planes_[FP_BOTTOM].set_c(viewproj.m(2,3) + viewproj.m(2,1));
+		planes_[FP_BOTTOM].set_d(viewproj.m(3,3) + viewproj.m(3,1));
 		// Near clipping plane
-		planes_[3].set_a(viewproj.m(0,2));
-		planes_[3].set_b(viewproj.m(1,2));
-		planes_[3].set_c(viewproj.m(2,2));
-		planes_[3].set_d(viewproj.m(3,2));
+		planes_[FP_NEAR].set_a(viewproj.m(0,2));
+		planes_[FP_NEAR].set_b(viewproj.m(1,2));
+		planes_[FP_NEAR].set_c(viewproj.m(2,2));
+		planes_[FP_NEAR].set_d(viewproj.m(3,2));
 		// Far clipping plane
-		planes_[5].set_a(viewproj.m(0,3) - viewproj.m(0,2));
-		planes_[5].set_b(viewproj.m(1,3) - viewproj.m(1,2));
-		planes_[5].set_c(viewproj.m(2,3) - viewproj.m(2,2));
-		planes_[5].set_d(viewproj.m(3,3) - viewproj.m(3,2));
+		planes_[FP_FAR].set_a(viewproj.m(0,3) - viewproj.m(0,2));
+		planes_[FP_FAR].set_b(viewproj.m(1,3) - viewproj.m(1,2));
+		planes_[FP_FAR].set_c(viewproj.m(2,3) - viewproj.m(2,2));
+		planes_[FP_FAR].set_d(viewproj.m(3,3) - viewproj.m(3,2));
 		// Normalize the plane equations, if requested
 		if (normalise == true)
 		{
-			planes_[0].Normalise();
-			planes_[1].Normalise();
-			planes_[2].Normalise();
-			planes_[3].Normalise();
-			planes_[4].Normalise();
-			planes_[5].Normalise();
+			for (int i = 0; i < NUM_FRUSTUM_PLANES; ++i)
+				planes_[i].Normalise();
 		}
 	}
 
 
 	void Frustum::ExtractPlanesGL(const Matrix44& viewproj, bool normalise)
 	{
-		// Left clipping plane
-		planes_[0].set_a(viewproj.m(3,0) + viewproj.m(0,0));
-		planes_[0].set_b(viewproj.m(3,1) + viewproj.m(0,1));
-		planes_[0].set_c(viewproj.m(3,2) + viewproj.m(0,2));
-		planes_[0].set_d(viewproj.m(3,3) + viewproj.m(0,3));
-		// Right clipping plane
-		planes_[0].set_a(viewproj.m(3,0) - viewproj.m(0,0));
-		planes_[0].set_b(viewproj.m(3,1) - viewproj.m(0,1));
-		planes_[0].set_c(viewproj.m(3,2) - viewproj.m(0,2));
-		planes_[0].set_d(viewproj.m(3,3) - viewproj.m(0,3));
-		// Top clipping plane
-		planes_[1].set_a(viewproj.m(3,0) - viewproj.m(1,0));
-		planes_[1].set_b(viewproj.m(3,1) - viewproj.m(1,1));
-		planes_[1].set_c(viewproj.m(3,2) - viewproj.m(1,2));
-		planes_[1].set_d(viewproj.m(3,3) - viewproj.m(1,3));
-		// Bottom clipping plane
-		planes_[2].set_a(viewproj.m(3,0) + viewproj.m(1,0));
-		planes_[2].set_b(viewproj.m(3,1) + viewproj.m(1,1));
-		planes_[2].set_c(viewproj.m(3,2) + viewproj.m(1,2));
-		planes_[2].set_d(viewproj.m(3,3) + viewproj.m(1,3));
+		// the same as D3D apart from the near plane, which is at z = -w
+		ExtractPlanesD3D(viewproj, false);
+
 		// Near clipping plane
-		planes_[3].set_a(viewproj.m(3,0) + viewproj.m(2,0));
-		planes_[3].set_b(viewproj.m(3,1) + viewproj.m(2,1));
-		planes_[3].set_c(viewproj.m(3,2) + viewproj.m(2,2));
-		planes_[3].set_d(viewproj.m(3,3) + viewproj.m(2,3));
-		// Far clipping plane
-		planes_[5].set_a(viewproj.m(3,0) - viewproj.m(2,0));
-		planes_[5].set_b(viewproj.m(3,1) - viewproj.m(2,1));
-		planes_[5].set_c(viewproj.m(3,2) - viewproj.m(2,2));
-		planes_[5].set_d(viewproj.m(3,3) - viewproj.m(2,3));
+		planes_[FP_NEAR].set_a(viewproj.m(0,3) + viewproj.m(0,2));
+		planes_[FP_NEAR].set_b(viewproj.m(1,3) + viewproj.m(1,2));
+		planes_[FP_NEAR].set_c(viewproj.m(2,3) + viewproj.m(2,2));
+		planes_[FP_NEAR].set_d(viewproj.m(3,3) + viewproj.m(3,2));
 		// Normalize the plane equations, if requested
 		if (normalise == true)
 		{
-			planes_[0].Normalise();
-			planes_[1].Normalise();
-			planes_[2].Normalise();
-			planes_[3].Normalise();
-			planes_[4].Normalise();
-			planes_[5].Normalise();
+			for (int i = 0; i < NUM_FRUSTUM_PLANES; ++i)
+				planes_[i].Normalise();
 		}
 	}
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 #define _GEF_MATHS_FRUSTUM_H
 
 #include <maths/plane.h>
+#include <gef.h>
 
 namespace gef
 {
@@ -31,8 +32,26 @@ namespace gef
 	public:
 		FrustumIntersect Intersects(const Sphere& sphere) const;
 		FrustumIntersect Intersects(const Aabb& aabb) const;
+
+		/// Test a batch of spheres, given as separate arrays of centre coordinates
+		/// and radii, against the frustum. Four spheres are tested at a time when
+		/// SIMD is available. The planes must have been extracted normalised.
+		/// @param[out] visible		set to 1 for spheres that are at least partly
+		///							inside the frustum and 0 otherwise
+		/// @return the number of visible spheres
+		Int32 CullSpheres(const float* centre_x, const float* centre_y, const float* centre_z, const float* radius, const Int32 count, UInt8* visible) const;
+
+		/// Extract the planes from a view projection matrix that maps to D3D clip
+		/// space, where 0 <= z <= w.
 		void ExtractPlanesD3D(const Matrix44& viewproj, bool normalise);
+
+		/// Extract the planes from a view projection matrix that maps to OpenGL
+		/// clip space, where -w <= z <= w. This volume contains the D3D one, so
+		/// these planes are also a safe, slightly looser, choice for culling
+		/// when the projection type isn't known.
 		void ExtractPlanesGL(const Matrix44& viewproj, bool normalise);
+
+		inline const Plane& plane(const FrustumPlane plane) const { return planes_[plane]; }
 	protected:
 		Plane planes_[NUM_FRUSTUM_PLANES];
 	};
@@ -2,6 +2,7 @@
 #include <maths/vector4.h>
 #include <maths/vector4.h>
 #include <maths/quaternion.h>
+#include <maths/simd.h>
 #include <math.h>
 
 
@@ -23,10 +24,58 @@ namespace gef
 		values_[3] = Vector4::kZero;
 	}
 
+#if defined(GEF_SIMD)
+	// the rows of a matrix as float arrays for loading into SIMD registers
+	static inline const float* RowValues(const Vector4& row)
+	{
+		return (const float*)&row;
+	}
+
+	static inline float* RowValues(Vector4& row)
+	{
+		return (float*)&row;
+	}
+#endif
+
+#if defined(GEF_SIMD_SSE)
+#define GEF_SHUFFLE_MASK(x, y, z, w)	((x) | ((y) << 2) | ((z) << 4) | ((w) << 6))
+#define GEF_SWIZZLE(v, x, y, z, w)		_mm_shuffle_ps(v, v, GEF_SHUFFLE_MASK(x, y, z, w))
+#define GEF_SHUFFLE(a, b, x, y, z, w)	_mm_shuffle_ps(a, b, GEF_SHUFFLE_MASK(x, y, z, w))
+
+	// 2x2 matrices are stored in one register as (m00, m01, m10, m11)
+
+	// a*b
+	static inline __m128 Matrix22Mul(const __m128 a, const __m128 b)
+	{
+		return _mm_add_ps(_mm_mul_ps(a, GEF_SWIZZLE(b, 0, 3, 0, 3)), _mm_mul_ps(GEF_SWIZZLE(a, 1, 0, 3, 2), GEF_SWIZZLE(b, 2, 1, 2, 1)));
+	}
+
+	// adjugate(a)*b
+	static inline __m128 Matrix22AdjMul(const __m128 a, const __m128 b)
+	{
+		return _mm_sub_ps(_mm_mul_ps(GEF_SWIZZLE(a, 3, 3, 0, 0), b), _mm_mul_ps(GEF_SWIZZLE(a, 1, 1, 2, 2), GEF_SWIZZLE(b, 2, 3, 0, 1)));
+	}
+
+	// a*adjugate(b)
+	static inline __m128 Matrix22MulAdj(const __m128 a, const __m128 b)
+	{
+		return _mm_sub_ps(_mm_mul_ps(a, GEF_SWIZZLE(b, 3, 0, 3, 0)), _mm_mul_ps(GEF_SWIZZLE(a, 1, 0, 3, 2), GEF_SWIZZLE(b, 2, 1, 2, 1)));
+	}
+#endif
+
 	const Matrix44 Matrix44::operator*(const Matrix44& matrix) const
 	{
 		Matrix44 result;
 
+#if defined(GEF_SIMD)
+		const simd::Float4 row0 = simd::Load(RowValues(matrix.values_[0]));
+		const simd::Float4 row1 = simd::Load(RowValues(matrix.values_[1]));
+		const simd::Float4 row2 = simd::Load(RowValues(matrix.values_[2]));
+		const simd::Float4 row3 = simd::Load(RowValues(matrix.values_[3]));
+
+		for (int i = 0; i < 4; i++)
+			simd::Store(RowValues(result.values_[i]), simd::TransformRow(simd::Load(RowValues(values_[i])), row0, row1, row2, row3));
+#else
 		for (int i = 0; i < 4; i++)
 		{
 			result.values_[i].set_x(values_[i].x() * matrix.values_[0].x() + values_[i].y() * matrix.values_[1].x() + values_[i].z() * matrix.values_[2].x() + values_[i].w() * matrix.values_[3].x());
@@ -34,6 +83,7 @@ namespace gef
 			result.values_[i].set_z(values_[i].x() * matrix.values_[0].z() + values_[i].y() * matrix.values_[1].z() + values_[i].z() * matrix.values_[2].z() + values_[i].w() * matrix.values_[3].z());
 			result.values_[i].set_w(values_[i].x() * matrix.values_[0].w() + values_[i].y() * matrix.values_[1].w() + values_[i].z() * matrix.values_[2].w() + values_[i].w() * matrix.values_[3].w());
 		}
+#endif
 
 		return result; 
 	}
@@ -287,8 +337,27 @@ namespace gef
 
 	void Matrix44::Transpose(const Matrix44& matrix)
 	{
+#if defined(GEF_SIMD_SSE)
+		__m128 row0 = _mm_loadu_ps(RowValues(matrix.values_[0]));
+		__m128 row1 = _mm_loadu_ps(RowValues(matrix.values_[1]));
+		__m128 row2 = _mm_loadu_ps(RowValues(matrix.values_[2]));
+		__m128 row3 = _mm_loadu_ps(RowValues(matrix.values_[3]));
+		_MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+		_mm_storeu_ps(RowValues(values_[0]), row0);
+		_mm_storeu_ps(RowValues(values_[1]), row1);
+		_mm_storeu_ps(RowValues(values_[2]), row2);
+		_mm_storeu_ps(RowValues(values_[3]), row3);
+#elif defined(GEF_SIMD_NEON)
+		// a de-interleaving load of the rows gives the columns
+		const float32x4x4_t columns = vld4q_f32(RowValues(matrix.values_[0]));
+		vst1q_f32(RowValues(values_[0]), columns.val[0]);
+		vst1q_f32(RowValues(values_[1]), columns.val[1]);
+		vst1q_f32(RowValues(values_[2]), columns.val[2]);
+		vst1q_f32(RowValues(values_[3]), columns.val[3]);
+#else
 		for (Int32 rowNum = 0; rowNum < 4; ++rowNum)
 			values_[rowNum] = matrix.GetColumn(rowNum);
+#endif
 	}
 
 	void Matrix44::AffineInverse(const Matrix44& matrix)
@@ -343,6 +412,63 @@ namespace gef
 
 	void Matrix44::Inverse(const Matrix44 matrix, float* determinant)
 	{
+#if defined(GEF_SIMD_SSE)
+		// block inverse using the 2x2 sub matrices
+		//     | A B |
+		// M = | C D |
+		const __m128 row0 = _mm_loadu_ps(RowValues(matrix.values_[0]));
+		const __m128 row1 = _mm_loadu_ps(RowValues(matrix.values_[1]));
+		const __m128 row2 = _mm_loadu_ps(RowValues(matrix.values_[2]));
+		const __m128 row3 = _mm_loadu_ps(RowValues(matrix.values_[3]));
+
+		const __m128 A = _mm_movelh_ps(row0, row1);
+		const __m128 B = _mm_movehl_ps(row1, row0);
+		const __m128 C = _mm_movelh_ps(row2, row3);
+		const __m128 D = _mm_movehl_ps(row3, row2);
+
+		// (|A|, |B|, |C|, |D|)
+		const __m128 sub_determinants = _mm_sub_ps(
+			_mm_mul_ps(GEF_SHUFFLE(row0, row2, 0, 2, 0, 2), GEF_SHUFFLE(row1, row3, 1, 3, 1, 3)),
+			_mm_mul_ps(GEF_SHUFFLE(row0, row2, 1, 3, 1, 3), GEF_SHUFFLE(row1, row3, 0, 2, 0, 2)));
+		const __m128 det_A = GEF_SWIZZLE(sub_determinants, 0, 0, 0, 0);
+		const __m128 det_B = GEF_SWIZZLE(sub_determinants, 1, 1, 1, 1);
+		const __m128 det_C = GEF_SWIZZLE(sub_determinants, 2, 2, 2, 2);
+		const __m128 det_D = GEF_SWIZZLE(sub_determinants, 3, 3, 3, 3);
+
+		const __m128 D_C = Matrix22AdjMul(D, C);
+		const __m128 A_B = Matrix22AdjMul(A, B);
+
+		// adjugates of the blocks of the inverse
+		__m128 X = _mm_sub_ps(_mm_mul_ps(det_D, A), Matrix22Mul(B, D_C));
+		__m128 W = _mm_sub_ps(_mm_mul_ps(det_A, D), Matrix22Mul(C, A_B));
+		__m128 Y = _mm_sub_ps(_mm_mul_ps(det_B, C), Matrix22MulAdj(D, A_B));
+		__m128 Z = _mm_sub_ps(_mm_mul_ps(det_C, B), Matrix22MulAdj(A, D_C));
+
+		// |M| = |A||D| + |B||C| - trace((A#B)(D#C))
+		__m128 trace = _mm_mul_ps(A_B, GEF_SWIZZLE(D_C, 0, 2, 1, 3));
+		trace = _mm_add_ps(trace, GEF_SWIZZLE(trace, 1, 0, 3, 2));
+		trace = _mm_add_ps(trace, GEF_SWIZZLE(trace, 2, 3, 0, 1));
+		const __m128 det_M = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(det_A, det_D), _mm_mul_ps(det_B, det_C)), trace);
+
+		const float det = _mm_cvtss_f32(det_M);
+		if (det != 0.0f)
+		{
+			const __m128 reciprocal_det = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), det_M);
+			X = _mm_mul_ps(X, reciprocal_det);
+			Y = _mm_mul_ps(Y, reciprocal_det);
+			Z = _mm_mul_ps(Z, reciprocal_det);
+			W = _mm_mul_ps(W, reciprocal_det);
+
+			// take the adjugate of each block and put them back in rows
+			_mm_storeu_ps(RowValues(values_[0]), GEF_SHUFFLE(X, Y, 3, 1, 3, 1));
+			_mm_storeu_ps(RowValues(values_[1]), GEF_SHUFFLE(X, Y, 2, 0, 2, 0));
+			_mm_storeu_ps(RowValues(values_[2]), GEF_SHUFFLE(Z, W, 3, 1, 3, 1));
+			_mm_storeu_ps(RowValues(values_[3]), GEF_SHUFFLE(Z, W, 2, 0, 2, 0));
+		}
+
+		if (determinant)
+			*determinant = det;
+#else
 		int a, i, j;
 		Vector4 v, vec[3];
 		float det;
@@ -367,12 +493,14 @@ namespace gef
 				v = vec[0].CrossProduct3(vec[1], vec[2]);
 
 
-				float temp = powf(-1.0f, (float)i) / det;
+				// (-1)^i / det
+				float temp = ((i & 1) ? -1.0f : 1.0f) / det;
 				SetColumn(i, Vector4(temp*v.x(), temp*v.y(), temp*v.z(), temp*v.w()));
 			}
 	   }
 
 		if(determinant)
 			*determinant = det;
+#endif
 	}
 }
\ No newline at end of file
@@ -16,6 +16,7 @@ namespace gef
 	class Plane : public Vector4
 	{
 	public:
+		Plane();
 		Plane(float a, float b, float c, float d);
 
 		void Normalise();
@@ -1,5 +1,6 @@
 #include <maths/quaternion.h>
 #include <maths/matrix44.h>
+#include <maths/simd.h>
 
 namespace gef
 {
@@ -69,15 +70,26 @@ void Quaternion::SetFromMatrix(const Matrix44& matrix)
 
 void Quaternion::Lerp(const Quaternion& startQ, const Quaternion& endQ, float time)
 {
+#if defined(GEF_SIMD)
+	// x, y, z and w are laid out like a float[4]
+	simd::Store(&x, simd::MulAdd(simd::Splat(1.0f - time), simd::Load(&startQ.x), simd::Mul(simd::Splat(time), simd::Load(&endQ.x))));
+#else
 	x = (1.0f - time) * startQ.x + time * endQ.x;
 	y = (1.0f - time) * startQ.y + time * endQ.y;
 	z = (1.0f - time) * startQ.z + time * endQ.z;
 	w = (1.0f - time) * startQ.w + time * endQ.w;
+#endif
 }
 
 void Quaternion::Slerp(const Quaternion& startQ, const Quaternion& endQ, float time)
 {
+#if defined(GEF_SIMD)
+	const simd::Float4 start = simd::Load(&startQ.x);
+	const simd::Float4 end = simd::Load(&endQ.x);
+	float dot = simd::Dot4(start, end);
+#else
 	float dot = startQ.x*endQ.x + startQ.y*endQ.y + startQ.z*endQ.z + startQ.w*endQ.w;
+#endif
 	if(dot >= 1.0f)
 	{
 		*this = endQ;
@@ -87,17 +99,22 @@ void Quaternion::Slerp(const Quaternion& startQ, const Quaternion& endQ, float t
 		/*	dot = cos(theta)
 			if (dot < 0), q1 and q2 are more than 90 degrees apart,
 			so we can invert one to reduce spinning	*/
-		Quaternion targetQ;
+		float target_sign = 1.0f;
 		if (dot < 0.0f)
 		{
 			dot = -dot;
-			targetQ = -endQ;
+			target_sign = -1.0f;
 		}
-		else
-			targetQ = endQ;
-		
+
 		float angle = acosf(dot);
-		*this = (startQ*sinf(angle*(1.0f-time)) + targetQ*sinf(angle*time))/sinf(angle);
+		float reciprocal_sin_angle = 1.0f / sinf(angle);
+		float start_weight = sinf(angle*(1.0f-time)) * reciprocal_sin_angle;
+		float end_weight = target_sign * sinf(angle*time) * reciprocal_sin_angle;
+#if defined(GEF_SIMD)
+		simd::Store(&x, simd::MulAdd(simd::Splat(start_weight), start, simd::Mul(simd::Splat(end_weight), end)));
+#else
+		*this = startQ*start_weight + endQ*end_weight;
+#endif
 	}
 
 }
@@ -119,12 +136,17 @@ const Quaternion Quaternion::operator * (const Quaternion& quaternion) const
 
 void Quaternion::Normalise()
 {
+#if defined(GEF_SIMD)
+	const simd::Float4 q = simd::Load(&x);
+	simd::Store(&x, simd::Mul(q, simd::Splat(1.0f / sqrtf(simd::Dot4(q, q)))));
+#else
 	float length = Length();
 
 	x /= length;
 	y /= length;
 	z /= length;
 	w /= length;
+#endif
 }
 
 void Quaternion::Conjugate(const Quaternion& quaternion)
@@ -0,0 +1,120 @@
+#ifndef _GEF_SIMD_H
+#define _GEF_SIMD_H
+
+// Selects the instruction set used by the hot paths of Vector4, Matrix44 and
+// Quaternion. SSE2 is used on x86 and x64, NEON on ARM, and the original
+// scalar code everywhere else. Define GEF_NO_SIMD to force the scalar code.
+//
+// The maths types keep their float[4] storage and are not declared as 16 byte
+// aligned, because Joint and the animation keys that contain them are read
+// from .scn files with a single stream read and aligning them would change
+// their size. Loads and stores are unaligned, which costs nothing extra on
+// data that happens to be aligned.
+#if !defined(GEF_NO_SIMD)
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GEF_SIMD_SSE
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define GEF_SIMD_NEON
+#endif
+#endif
+
+#if defined(GEF_SIMD_SSE) || defined(GEF_SIMD_NEON)
+#define GEF_SIMD
+#endif
+
+#if defined(GEF_SIMD_SSE)
+#include <xmmintrin.h>
+#include <emmintrin.h>
+#elif defined(GEF_SIMD_NEON)
+#include <arm_neon.h>
+#endif
+
+#if defined(GEF_SIMD)
+
+namespace gef
+{
+namespace simd
+{
+#if defined(GEF_SIMD_SSE)
+	typedef __m128 Float4;
+
+	inline Float4 Load(const float* values) { return _mm_loadu_ps(values); }
+	inline void Store(float* values, const Float4 v) { _mm_storeu_ps(values, v); }
+	inline Float4 Splat(const float value) { return _mm_set1_ps(value); }
+	inline Float4 Add(const Float4 a, const Float4 b) { return _mm_add_ps(a, b); }
+	inline Float4 Sub(const Float4 a, const Float4 b) { return _mm_sub_ps(a, b); }
+	inline Float4 Mul(const Float4 a, const Float4 b) { return _mm_mul_ps(a, b); }
+	// a*b + c
+	inline Float4 MulAdd(const Float4 a, const Float4 b, const Float4 c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+
+	// comparisons give all bits set in each lane where the result is true
+	inline Float4 Less(const Float4 a, const Float4 b) { return _mm_cmplt_ps(a, b); }
+	inline Float4 Or(const Float4 a, const Float4 b) { return _mm_or_ps(a, b); }
+	// bit n is set when the top bit of lane n is set
+	inline int SignMask(const Float4 v) { return _mm_movemask_ps(v); }
+
+	inline Float4 SplatX(const Float4 v) { return _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0)); }
+	inline Float4 SplatY(const Float4 v) { return _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1)); }
+	inline Float4 SplatZ(const Float4 v) { return _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2)); }
+	inline Float4 SplatW(const Float4 v) { return _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3)); }
+
+	inline float Dot4(const Float4 a, const Float4 b)
+	{
+		Float4 product = _mm_mul_ps(a, b);
+		product = _mm_add_ps(product, _mm_shuffle_ps(product, product, _MM_SHUFFLE(2, 3, 0, 1)));
+		product = _mm_add_ps(product, _mm_shuffle_ps(product, product, _MM_SHUFFLE(1, 0, 3, 2)));
+		return _mm_cvtss_f32(product);
+	}
+#elif defined(GEF_SIMD_NEON)
+	typedef float32x4_t Float4;
+
+	inline Float4 Load(const float* values) { return vld1q_f32(values); }
+	inline void Store(float* values, const Float4 v) { vst1q_f32(values, v); }
+	inline Float4 Splat(const float value) { return vdupq_n_f32(value); }
+	inline Float4 Add(const Float4 a, const Float4 b) { return vaddq_f32(a, b); }
+	inline Float4 Sub(const Float4 a, const Float4 b) { return vsubq_f32(a, b); }
+	inline Float4 Mul(const Float4 a, const Float4 b) { return vmulq_f32(a, b); }
+	// a*b + c
+	inline Float4 MulAdd(const Float4 a, const Float4 b, const Float4 c) { return vmlaq_f32(c, a, b); }
+
+	// comparisons give all bits set in each lane where the result is true
+	inline Float4 Less(const Float4 a, const Float4 b) { return vreinterpretq_f32_u32(vcltq_f32(a, b)); }
+	inline Float4 Or(const Float4 a, const Float4 b) { return vreinterpretq_f32_u32(vorrq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b))); }
+	// bit n is set when the top bit of lane n is set
+	inline int SignMask(const Float4 v)
+	{
+		static const int32_t shifts[4] = { 0, 1, 2, 3 };
+		const uint32x4_t top_bits = vshrq_n_u32(vreinterpretq_u32_f32(v), 31);
+		const uint32x4_t lane_bits = vshlq_u32(top_bits, vld1q_s32(shifts));
+		const uint32x2_t sum = vpadd_u32(vget_low_u32(lane_bits), vget_high_u32(lane_bits));
+		return (int)vget_lane_u32(vpadd_u32(sum, sum), 0);
+	}
+
+	inline Float4 SplatX(const Float4 v) { return vdupq_lane_f32(vget_low_f32(v), 0); }
+	inline Float4 SplatY(const Float4 v) { return vdupq_lane_f32(vget_low_f32(v), 1); }
+	inline Float4 SplatZ(const Float4 v) { return vdupq_lane_f32(vget_high_f32(v), 0); }
+	inline Float4 SplatW(const Float4 v) { return vdupq_lane_f32(vget_high_f32(v), 1); }
+
+	inline float Dot4(const Float4 a, const Float4 b)
+	{
+		const Float4 product = vmulq_f32(a, b);
+		float32x2_t sum = vadd_f32(vget_low_f32(product), vget_high_f32(product));
+		sum = vpadd_f32(sum, sum);
+		return vget_lane_f32(sum, 0);
+	}
+#endif
+
+	// v.x*row0 + v.y*row1 + v.z*row2 + v.w*row3, i.e. a row vector times a matrix
+	inline Float4 TransformRow(const Float4 v, const Float4 row0, const Float4 row1, const Float4 row2, const Float4 row3)
+	{
+		Float4 result = Mul(SplatX(v), row0);
+		result = MulAdd(SplatY(v), row1, result);
+		result = MulAdd(SplatZ(v), row2, result);
+		return MulAdd(SplatW(v), row3, result);
+	}
+}
+}
+
+#endif // GEF_SIMD
+
+#endif // _GEF_SIMD_H
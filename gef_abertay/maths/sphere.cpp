@@ -1,5 +1,7 @@
 #include <maths/sphere.h>
 #include <maths/aabb.h>
+#include <maths/matrix44.h>
+#include <math.h>
 
 namespace gef
 {
@@ -24,15 +26,21 @@ namespace gef
 	{
 		Sphere result;
 
-		Vector4 point_on_sphere(1.0f, 1.0f, 1.0f);
-		point_on_sphere.Normalise();
-
-		point_on_sphere *= radius_;
-
-		point_on_sphere = point_on_sphere.TransformNoTranslation(transform_matrix);
-		result.set_radius(point_on_sphere.Length());
+		// the radius grows by the largest scale along any axis, so the
+		// sphere still contains the transformed bounds under non-uniform scale
+		float max_scale_sqr = 0.0f;
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			const float scale_sqr = transform_matrix.m(axis, 0)*transform_matrix.m(axis, 0)
+				+ transform_matrix.m(axis, 1)*transform_matrix.m(axis, 1)
+				+ transform_matrix.m(axis, 2)*transform_matrix.m(axis, 2);
+			if (scale_sqr > max_scale_sqr)
+				max_scale_sqr = scale_sqr;
+		}
+
+		result.set_radius(radius_*sqrtf(max_scale_sqr));
 		result.set_position(position_.Transform(transform_matrix));
 
 		return result;
 	}
-}
\ No newline at end of file
+}
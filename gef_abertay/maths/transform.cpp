@@ -13,11 +13,14 @@ namespace gef
 
 	const Matrix44 Transform::GetMatrix() const
 	{
-		Matrix44 result, scale_matrix, rotation_matrix;
-	
-		scale_matrix.Scale(scale_);
-		rotation_matrix.Rotation(rotation_);
-		result = scale_matrix * rotation_matrix;
+		Matrix44 result;
+
+		// scale * rotation with a diagonal scale matrix just scales the
+		// rows of the rotation, so there is no need for a full product
+		result.Rotation(rotation_);
+		result.SetRow(0, result.GetRow(0) * scale_.x());
+		result.SetRow(1, result.GetRow(1) * scale_.y());
+		result.SetRow(2, result.GetRow(2) * scale_.z());
 		result.SetTranslation(translation_);
 
 		return result;
@@ -2,6 +2,7 @@
 #include <maths/matrix44.h>
 #include <maths/matrix33.h>
 #include <maths/math_utils.h>
+#include <maths/simd.h>
 #include <math.h>
 
 namespace gef
@@ -54,6 +55,18 @@ namespace gef
 
 	const Vector4 Vector4::Transform(const class Matrix44& _mat) const
 	{
+#if defined(GEF_SIMD)
+		// treat this as a point, w = 1, and return w = 0 like the scalar version
+		const simd::Float4 v = simd::Load(values_);
+		simd::Float4 result_v = simd::MulAdd(simd::SplatX(v), simd::Load(_mat.GetRow(0).values_), simd::Load(_mat.GetRow(3).values_));
+		result_v = simd::MulAdd(simd::SplatY(v), simd::Load(_mat.GetRow(1).values_), result_v);
+		result_v = simd::MulAdd(simd::SplatZ(v), simd::Load(_mat.GetRow(2).values_), result_v);
+
+		Vector4 result;
+		simd::Store(result.values_, result_v);
+		result.values_[3] = 0.0f;
+		return result;
+#else
 		Vector4 result = Vector4(0.0f, 0.0f, 0.0f);
 
 		result.set_x(values_[0]*_mat.m(0,0)+values_[1]*_mat.m(1,0)+values_[2]*_mat.m(2,0)+_mat.m(3,0));
@@ -61,6 +74,7 @@ namespace gef
 		result.set_z(values_[0]*_mat.m(0,2)+values_[1]*_mat.m(1,2)+values_[2]*_mat.m(2,2)+_mat.m(3,2));
 
 		return result;
+#endif
 	}
 
 	const Vector4 Vector4::Transform(const class Matrix33& _mat) const
@@ -87,6 +101,17 @@ namespace gef
 
 	const Vector4 Vector4::TransformNoTranslation(const class Matrix44& _mat) const
 	{
+#if defined(GEF_SIMD)
+		const simd::Float4 v = simd::Load(values_);
+		simd::Float4 result_v = simd::Mul(simd::SplatX(v), simd::Load(_mat.GetRow(0).values_));
+		result_v = simd::MulAdd(simd::SplatY(v), simd::Load(_mat.GetRow(1).values_), result_v);
+		result_v = simd::MulAdd(simd::SplatZ(v), simd::Load(_mat.GetRow(2).values_), result_v);
+
+		Vector4 result;
+		simd::Store(result.values_, result_v);
+		result.values_[3] = 0.0f;
+		return result;
+#else
 		Vector4 result = Vector4(0.0f, 0.0f, 0.0f);
 
 		result.set_x(values_[0]*_mat.m(0,0)+values_[1]*_mat.m(1,0)+values_[2]*_mat.m(2,0));
@@ -94,16 +119,20 @@ namespace gef
 		result.set_z(values_[0]*_mat.m(0,2)+values_[1]*_mat.m(1,2)+values_[2]*_mat.m(2,2));
 
 		return result;
+#endif
 	}
 
 	const Vector4 Vector4::TransformW(const class Matrix44& _mat) const
 	{
 		Vector4 result;
-
+#if defined(GEF_SIMD)
+		simd::Store(result.values_, simd::TransformRow(simd::Load(values_), simd::Load(_mat.GetRow(0).values_), simd::Load(_mat.GetRow(1).values_), simd::Load(_mat.GetRow(2).values_), simd::Load(_mat.GetRow(3).values_)));
+#else
 		result.set_x(values_[0] * _mat.m(0, 0) + values_[1] * _mat.m(1, 0) + values_[2] * _mat.m(2, 0) + values_[3] * _mat.m(3, 0));
 		result.set_y(values_[0] * _mat.m(0, 1) + values_[1] * _mat.m(1, 1) + values_[2] * _mat.m(2, 1) + values_[3] * _mat.m(3, 1));
 		result.set_z(values_[0] * _mat.m(0, 2) + values_[1] * _mat.m(1, 2) + values_[2] * _mat.m(2, 2) + values_[3] * _mat.m(3, 2));
 		result.set_w(values_[0] * _mat.m(0, 3) + values_[1] * _mat.m(1, 3) + values_[2] * _mat.m(2, 3) + values_[3] * _mat.m(3, 3));
+#endif
 
 		return result;
 	}
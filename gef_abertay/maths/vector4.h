@@ -49,8 +49,8 @@ public:
 	void set_value(float x, float y, float z);
 	void set_value(float x, float y, float z, float w);
 protected:
-	// store values as an array of floats so the implementation
-	// can be changed at a later date to support use SIMD instructions
+	// store values as an array of floats so they can be loaded
+	// straight into SIMD registers, see maths/simd.h
 	float values_[4];
 public:
 	static const Vector4 kZero;
@@ -20,6 +20,7 @@
 #include <graphics/texture.h>
 #include <graphics/index_buffer.h>
 #include <graphics/shader_interface.h>
+#include <cstring>
 
 namespace gef
 {
@@ -43,9 +44,13 @@ namespace gef
 		,default_blend_state_(NULL)
 		,default_depth_stencil_state_(NULL)
 		,always_depth_stencil_state_(NULL)
+		,default_instanced_shader_(platform)
+		,instance_buffer_(NULL)
+		,instance_buffer_capacity_(0)
 
 	{
 		platform_.AddShader(&default_shader_);
+		platform_.AddShader(&default_instanced_shader_);
 		shader_ = &default_shader_;
 
 		projection_matrix_.SetIdentity();
@@ -142,8 +147,11 @@ namespace gef
 		ReleaseNull(default_blend_state_);
 		ReleaseNull(default_depth_stencil_state_);
 		ReleaseNull(always_depth_stencil_state_);
+		ReleaseNull(instance_buffer_);
+		instance_buffer_capacity_ = 0;
 
 		platform_.RemoveShader(&default_shader_);
+		platform_.RemoveShader(&default_instanced_shader_);
 
 	}
 
@@ -162,12 +170,23 @@ namespace gef
 
 	void Renderer3DD3D11::End()
 	{
+		FlushRenderQueue();
+
 		const PlatformD3D11& platform_d3d = static_cast<const PlatformD3D11&>(platform());
 		platform_d3d.EndScene();
 	}
 
 	void Renderer3DD3D11::DrawMesh(const  MeshInstance& mesh_instance)
 	{
+		if (render_queue_enabled_)
+		{
+			QueueMesh(mesh_instance);
+			return;
+		}
+
+		if (!IsVisible(mesh_instance))
+			return;
+
 		// set up the shader data for default shader
 		if (shader_ == &default_shader_)
 			default_shader_.SetSceneData(default_shader_data_, view_matrix_, projection_matrix_);
@@ -175,7 +194,7 @@ namespace gef
 		const Mesh* mesh = mesh_instance.mesh();
 		if(mesh != NULL)
 		{
-			set_world_matrix(mesh_instance.transform());
+			set_world_matrix(mesh_instance.transform(), mesh_instance.transform_kind());
 
 			const VertexBuffer* vertex_buffer = mesh->vertex_buffer();
 			//ShaderGL* shader_GL = static_cast<ShaderGL*>(shader_);
@@ -186,6 +205,8 @@ namespace gef
 
 				shader_->device_interface()->UseProgram();
 				vertex_buffer->Bind(platform_);
+				stats_.shader_changes++;
+				stats_.vertex_buffer_binds++;
 
 				// vertex format must be set after the vertex buffer is bound
 				shader_->device_interface()->SetVertexFormat();
@@ -206,28 +227,18 @@ namespace gef
 
 						//only set default shader data if current shader is the default shader
 						shader_->SetMaterialData(material);
+						stats_.material_changes++;
 
 						// GRC FIXME - probably want to split variable data into scene, object, primitive[material?] based
 						// rather than set all variables per primitive
 						shader_->device_interface()->SetVariableData();
 						shader_->device_interface()->BindTextureResources(platform());
 
-						//GLenum primitive_type = primitive_types[primitive->type()];
-
-						// Set primitive topology
-						const PlatformD3D11& platform_d3d = static_cast<const PlatformD3D11&>(platform_);
-						platform_d3d.device_context()->IASetPrimitiveTopology(primitive_types[primitive->type()]);
-
 						index_buffer->Bind(platform_);
+						stats_.index_buffer_binds++;
 
-						// use the primitive end index to specify how may indices we wish to draw
-						// in case we don't want to draw them all
-
-						if (index_buffer->num_indices() > 0)
-							platform_d3d.device_context()->DrawIndexed(index_buffer->num_indices(), 0, 0);
-						else
-							platform_d3d.device_context()->Draw(vertex_buffer->num_vertices(), 0);
-
+						SubmitPrimitive(*primitive, *vertex_buffer);
+						stats_.draw_calls++;
 
 						index_buffer->Unbind(platform_);
 						shader_->device_interface()->UnbindTextureResources(platform());
@@ -240,6 +251,143 @@ namespace gef
 		}
 	}
 
+	void Renderer3DD3D11::SubmitPrimitive(const Primitive& primitive, const VertexBuffer& vertex_buffer)
+	{
+		const PlatformD3D11& platform_d3d = static_cast<const PlatformD3D11&>(platform_);
+		platform_d3d.device_context()->IASetPrimitiveTopology(primitive_types[primitive.type()]);
+
+		// use the primitive end index to specify how may indices we wish to draw
+		// in case we don't want to draw them all
+		const IndexBuffer* index_buffer = primitive.index_buffer();
+		if (index_buffer->num_indices() > 0)
+			platform_d3d.device_context()->DrawIndexed(index_buffer->num_indices(), 0, 0);
+		else
+			platform_d3d.device_context()->Draw(vertex_buffer.num_vertices(), 0);
+	}
+
+	void Renderer3DD3D11::DrawMeshInstanced(const Mesh& mesh, const Matrix44* transforms, const Int32 count, const Material* material, const MeshInstance::TransformKind transform_kind)
+	{
+		// custom shaders only take a single world matrix
+		if (shader_ != &default_shader_)
+		{
+			Renderer3D::DrawMeshInstanced(mesh, transforms, count, material, transform_kind);
+			return;
+		}
+
+		const VertexBuffer* vertex_buffer = mesh.vertex_buffer();
+		if (count <= 0 || vertex_buffer == NULL)
+			return;
+
+		Int32 visible_count = count;
+		const Matrix44* visible_transforms = CullInstances(mesh, transforms, visible_count);
+		if (visible_count == 0)
+			return;
+
+		if (!UpdateInstanceBuffer(visible_transforms, visible_count))
+		{
+			DrawMeshCopies(mesh, visible_transforms, visible_count, material, transform_kind);
+			return;
+		}
+
+		// instanced draws don't go through the render queue, they are
+		// submitted straight away and are depth tested against whatever
+		// the queue draws at End
+		const PlatformD3D11& platform_d3d = static_cast<const PlatformD3D11&>(platform_);
+		Default3DInstancedShader& shader = default_instanced_shader_;
+		shader.SetSceneData(default_shader_data_, view_matrix_, projection_matrix_);
+		shader.SetMeshData(MeshInstance());
+
+		shader.device_interface()->UseProgram();
+		vertex_buffer->Bind(platform_);
+		UINT stride = shader.device_interface()->instance_size();
+		UINT offset = 0;
+		platform_d3d.device_context()->IASetVertexBuffers(1, 1, &instance_buffer_, &stride, &offset);
+		stats_.shader_changes++;
+		stats_.vertex_buffer_binds++;
+
+		shader.device_interface()->SetVertexFormat();
+
+		for (UInt32 primitive_index = 0; primitive_index < mesh.num_primitives(); ++primitive_index)
+		{
+			const Primitive* primitive = mesh.GetPrimitive(primitive_index);
+			const IndexBuffer* index_buffer = primitive->index_buffer();
+			if (primitive->type() == UNDEFINED || index_buffer == NULL)
+				continue;
+
+			if (material)
+				shader.SetMaterialData(material);
+			else if (override_material_)
+				shader.SetMaterialData(override_material_);
+			else
+				shader.SetMaterialData(primitive->material());
+			stats_.material_changes++;
+
+			shader.device_interface()->SetVariableData();
+			shader.device_interface()->BindTextureResources(platform_);
+
+			index_buffer->Bind(platform_);
+			stats_.index_buffer_binds++;
+
+			platform_d3d.device_context()->IASetPrimitiveTopology(primitive_types[primitive->type()]);
+			if (index_buffer->num_indices() > 0)
+				platform_d3d.device_context()->DrawIndexedInstanced(index_buffer->num_indices(), visible_count, 0, 0, 0);
+			else
+				platform_d3d.device_context()->DrawInstanced(vertex_buffer->num_vertices(), visible_count, 0, 0);
+			stats_.draw_calls++;
+
+			index_buffer->Unbind(platform_);
+			shader.device_interface()->UnbindTextureResources(platform_);
+		}
+
+		ID3D11Buffer* null_buffer = NULL;
+		stride = 0;
+		platform_d3d.device_context()->IASetVertexBuffers(1, 1, &null_buffer, &stride, &offset);
+		vertex_buffer->Unbind(platform_);
+		shader.device_interface()->ClearVertexFormat();
+	}
+
+	bool Renderer3DD3D11::UpdateInstanceBuffer(const Matrix44* transforms, const Int32 count)
+	{
+		const PlatformD3D11& platform_d3d = static_cast<const PlatformD3D11&>(platform_);
+		const Int32 instance_size = default_instanced_shader_.device_interface()->instance_size();
+
+		if (count > instance_buffer_capacity_)
+		{
+			ReleaseNull(instance_buffer_);
+
+			// grow in powers of two so a level that adds a few blocks doesn't
+			// recreate the buffer every frame
+			Int32 capacity = instance_buffer_capacity_ > 0 ? instance_buffer_capacity_ : 64;
+			while (capacity < count)
+				capacity *= 2;
+
+			D3D11_BUFFER_DESC bd;
+			ZeroMemory(&bd, sizeof(bd));
+			bd.Usage = D3D11_USAGE_DYNAMIC;
+			bd.ByteWidth = capacity*instance_size;
+			bd.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+			bd.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+
+			HRESULT hresult = platform_d3d.device()->CreateBuffer(&bd, NULL, &instance_buffer_);
+			if (FAILED(hresult))
+			{
+				instance_buffer_capacity_ = 0;
+				return false;
+			}
+			instance_buffer_capacity_ = capacity;
+		}
+
+		D3D11_MAPPED_SUBRESOURCE resource;
+		HRESULT hresult = platform_d3d.device_context()->Map(instance_buffer_, 0, D3D11_MAP_WRITE_DISCARD, 0, &resource);
+		if (FAILED(hresult))
+			return false;
+
+		// Matrix44 rows are already in the layout the shader reads
+		memcpy(resource.pData, transforms, count*instance_size);
+		platform_d3d.device_context()->Unmap(instance_buffer_, 0);
+		return true;
+	}
+
 	void Renderer3DD3D11::DrawPrimitive(const  MeshInstance& mesh_instance, Int32 primitive_index, Int32 num_indices)
 	{
 
@@ -13,6 +13,7 @@
 #include <graphics/renderer_3d.h>
 //#include <graphics/primitive.h>
 #include <graphics/default_3d_shader.h>
+#include <graphics/default_3d_instanced_shader.h>
 
 namespace gef
 {
@@ -32,10 +33,16 @@ namespace gef
 
 		void DrawMesh(const  MeshInstance& mesh_instance);
 		void DrawPrimitive(const  MeshInstance& mesh_instance, Int32 primitive_index, Int32 num_indices = -1);
+		void DrawMeshInstanced(const Mesh& mesh, const Matrix44* transforms, const Int32 count, const Material* material = NULL, const MeshInstance::TransformKind transform_kind = MeshInstance::kGeneral);
 		void SetFillMode(FillMode fill_mode);
 		void SetDepthTest(DepthTest depth_test);
 
 	protected:
+		void SubmitPrimitive(const Primitive& primitive, const VertexBuffer& vertex_buffer);
+
+		/// Copy the transforms into the instance buffer, growing it if needed.
+		bool UpdateInstanceBuffer(const Matrix44* transforms, const Int32 count);
+
 		static const D3D11_PRIMITIVE_TOPOLOGY Renderer3DD3D11::primitive_types[NUM_PRIMITIVE_TYPES];
 
 	private:
@@ -45,6 +52,10 @@ namespace gef
 
 		ID3D11DepthStencilState* default_depth_stencil_state_;
 		ID3D11DepthStencilState* always_depth_stencil_state_;
+
+		Default3DInstancedShader default_instanced_shader_;
+		ID3D11Buffer* instance_buffer_;
+		Int32 instance_buffer_capacity_;
 	};
 }
 
@@ -249,11 +249,21 @@ namespace gef
 		element.SemanticName = shader_parameter.semantic_name.c_str();
 		element.SemanticIndex = shader_parameter.semantic_index;
 		element.Format = GetVertexAttributeFormat(shader_parameter.type);
-		element.InputSlot = 0;
 //		element.AlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT;
 		element.AlignedByteOffset = shader_parameter.byte_offset;
-		element.InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
-		element.InstanceDataStepRate = 0;
+		if (shader_parameter.per_instance)
+		{
+			// instance data is bound to the slot after the vertex buffer
+			element.InputSlot = 1;
+			element.InputSlotClass = D3D11_INPUT_PER_INSTANCE_DATA;
+			element.InstanceDataStepRate = 1;
+		}
+		else
+		{
+			element.InputSlot = 0;
+			element.InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
+			element.InstanceDataStepRate = 0;
+		}
 	}
 
 	DXGI_FORMAT ShaderInterfaceD3D11::GetVertexAttributeFormat(VariableType type)
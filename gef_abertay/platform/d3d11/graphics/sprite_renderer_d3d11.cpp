@@ -6,6 +6,7 @@
 #include <graphics/vertex_buffer.h>
 #include <graphics/sprite.h>
 #include <graphics/shader_interface.h>
+#include <cstring>
 
 namespace gef
 {
@@ -20,7 +21,9 @@ namespace gef
 		,default_render_state_(NULL)
 		,default_blend_state_(NULL)
 		,default_depth_stencil_state_(NULL)
-
+		,batch_shader_(platform)
+		,batch_vertex_buffer_(NULL)
+		,batch_vertex_buffer_capacity_(0)
 	{
 		vertex_buffer_ = gef::VertexBuffer::Create(platform);
 
@@ -33,6 +36,7 @@ namespace gef
 		platform_.AddTexture(default_texture_);
 
 		platform_.AddShader(&default_shader_);
+		platform_.AddShader(&batch_shader_);
 		shader_ = &default_shader_;
 
 		projection_matrix_ = platform_.OrthographicFrustum(0.0f, (float)platform_.width(), 0.0f, (float)platform_.height(), -1.0f, 1.0f);
@@ -105,6 +109,9 @@ namespace gef
 		ReleaseNull(default_depth_stencil_state_);
 
 		platform_.RemoveShader(&default_shader_);
+		platform_.RemoveShader(&batch_shader_);
+		ReleaseNull(batch_vertex_buffer_);
+		batch_vertex_buffer_capacity_ = 0;
 
 		if (vertex_buffer_)
 		{
@@ -147,6 +154,12 @@ namespace gef
 
 	void SpriteRendererD3D11::DrawSprite(const Sprite& sprite)
 	{
+		if (batching_enabled_ && shader_ == &default_shader_)
+		{
+			QueueSprite(sprite);
+			return;
+		}
+
 		if (shader_ == &default_shader_)
 		{
 			const Texture* texture = sprite.texture();
@@ -164,18 +177,101 @@ namespace gef
 
 		platform_d3d.device_context()->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 		platform_d3d.device_context()->Draw(6, 0);
+		stats_.sprites++;
+		stats_.draw_calls++;
 
 		if (shader_ == &default_shader_)
 		{
 			default_shader_.device_interface()->UnbindTextureResources(platform_);
+			stats_.texture_changes++;
 		}
 	}
 
 	void SpriteRendererD3D11::End()
 	{
+		FlushSpriteBatch();
+
 		vertex_buffer_->Unbind(platform_);
 
 		platform_.EndScene();
 	}
-}
 
+	void SpriteRendererD3D11::SubmitSpriteBatches(const SpriteVertex* vertices, const UInt32 num_vertices, const SpriteBatch* batches, const UInt32 num_batches)
+	{
+		if (!UpdateBatchVertexBuffer(vertices, num_vertices))
+			return;
+
+		const PlatformD3D11& platform_d3d = static_cast<const PlatformD3D11&>(platform_);
+
+		batch_shader_.device_interface()->UseProgram();
+		batch_shader_.SetSceneData(projection_matrix_);
+
+		UINT stride = sizeof(SpriteVertex);
+		UINT offset = 0;
+		platform_d3d.device_context()->IASetVertexBuffers(0, 1, &batch_vertex_buffer_, &stride, &offset);
+		batch_shader_.device_interface()->SetVertexFormat();
+		platform_d3d.device_context()->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+
+		for (UInt32 batch_num = 0; batch_num < num_batches; ++batch_num)
+		{
+			const SpriteBatch& batch = batches[batch_num];
+			batch_shader_.SetBatchData(batch.texture ? batch.texture : default_texture_);
+			batch_shader_.device_interface()->SetVariableData();
+			batch_shader_.device_interface()->BindTextureResources(platform_);
+
+			platform_d3d.device_context()->Draw(batch.num_vertices, batch.first_vertex);
+
+			batch_shader_.device_interface()->UnbindTextureResources(platform_);
+		}
+
+		batch_shader_.device_interface()->ClearVertexFormat();
+
+		// put back the state Begin set up for sprites drawn straight away
+		vertex_buffer_->Bind(platform_);
+		if (shader_ == &default_shader_)
+		{
+			default_shader_.device_interface()->UseProgram();
+			default_shader_.device_interface()->SetVertexFormat();
+		}
+	}
+
+	bool SpriteRendererD3D11::UpdateBatchVertexBuffer(const SpriteVertex* vertices, const UInt32 num_vertices)
+	{
+		const PlatformD3D11& platform_d3d = static_cast<const PlatformD3D11&>(platform_);
+
+		if (num_vertices > batch_vertex_buffer_capacity_)
+		{
+			ReleaseNull(batch_vertex_buffer_);
+
+			// grow in powers of two so a screen with a bit more text doesn't
+			// recreate the buffer every frame
+			UInt32 capacity = batch_vertex_buffer_capacity_ > 0 ? batch_vertex_buffer_capacity_ : 256*kVerticesPerSprite;
+			while (capacity < num_vertices)
+				capacity *= 2;
+
+			D3D11_BUFFER_DESC bd;
+			ZeroMemory(&bd, sizeof(bd));
+			bd.Usage = D3D11_USAGE_DYNAMIC;
+			bd.ByteWidth = capacity*sizeof(SpriteVertex);
+			bd.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+			bd.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+
+			HRESULT hresult = platform_d3d.device()->CreateBuffer(&bd, NULL, &batch_vertex_buffer_);
+			if (FAILED(hresult))
+			{
+				batch_vertex_buffer_capacity_ = 0;
+				return false;
+			}
+			batch_vertex_buffer_capacity_ = capacity;
+		}
+
+		D3D11_MAPPED_SUBRESOURCE resource;
+		HRESULT hresult = platform_d3d.device_context()->Map(batch_vertex_buffer_, 0, D3D11_MAP_WRITE_DISCARD, 0, &resource);
+		if (FAILED(hresult))
+			return false;
+
+		memcpy(resource.pData, vertices, num_vertices*sizeof(SpriteVertex));
+		platform_d3d.device_context()->Unmap(batch_vertex_buffer_, 0);
+		return true;
+	}
+}
@@ -2,6 +2,7 @@
 #define _GEF_SPRITE_RENDERER_D3D11_H
 
 #include <graphics/sprite_renderer.h>
+#include <graphics/default_sprite_batch_shader.h>
 #include <d3d11.h>
 
 namespace gef
@@ -20,12 +21,22 @@ namespace gef
 		void DrawSprite(const Sprite& sprite);
 		void End();
 
+	protected:
+		void SubmitSpriteBatches(const SpriteVertex* vertices, const UInt32 num_vertices, const SpriteBatch* batches, const UInt32 num_batches);
+
+		/// Copy the vertices into the batch vertex buffer, growing it if needed.
+		bool UpdateBatchVertexBuffer(const SpriteVertex* vertices, const UInt32 num_vertices);
+
 	private:
 		void CleanUp();
 
 		Texture* default_texture_;
 		VertexBuffer* vertex_buffer_;
 
+		DefaultSpriteBatchShader batch_shader_;
+		ID3D11Buffer* batch_vertex_buffer_;
+		UInt32 batch_vertex_buffer_capacity_;
+
 		ID3D11RasterizerState* default_render_state_;
 		ID3D11BlendState* default_blend_state_;
 		ID3D11DepthStencilState* default_depth_stencil_state_;
@@ -0,0 +1,35 @@
+#include <system/debug_log.h>
+#include <cstdarg>
+#include <cstdio>
+
+#include <maths/matrix44.h>
+#include <maths/vector4.h>
+
+namespace gef
+{
+	void DebugOut(const char * text, ...)
+	{
+		va_list args;
+
+		va_start(args, text);
+		std::vfprintf(stderr, text, args);
+		va_end(args);
+	}
+
+
+	void DebugOut(const char* label, const Matrix44& matrix)
+	{
+		DebugOut("%s\n", label);
+		for (int i = 0; i<4; ++i)
+		{
+			for(int j=0;j<4;++j)
+				DebugOut("%f ", matrix.m(i,j));
+			DebugOut("\n");
+		}
+	}
+
+	void DebugOut(const char* label, const Vector4& vector)
+	{
+		DebugOut("%s: %f %f %f \n", label, vector.x(), vector.y(), vector.z());
+	}
+}
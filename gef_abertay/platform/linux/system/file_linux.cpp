@@ -0,0 +1,163 @@
+#include <platform/linux/system/file_linux.h>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <cerrno>
+
+namespace gef
+{
+	File* File::Create()
+	{
+		return new FileLinux();
+	}
+
+	const int FileLinux::kInvalidDescriptor = -1;
+
+	FileLinux::FileLinux() :
+		file_descriptor_(kInvalidDescriptor),
+		is_mapped_(false)
+	{
+	}
+
+	FileLinux::~FileLinux()
+	{
+		Unmap();
+		Close();
+	}
+
+	bool FileLinux::Open(const char* const filename)
+	{
+		Close();
+		file_descriptor_ = open(filename, O_RDONLY);
+
+		return file_descriptor_ != kInvalidDescriptor;
+	}
+
+	bool FileLinux::Close()
+	{
+		bool success = true;
+		if (file_descriptor_ != kInvalidDescriptor)
+		{
+			success = close(file_descriptor_) == 0;
+			file_descriptor_ = kInvalidDescriptor;
+		}
+
+		return success;
+	}
+
+	bool FileLinux::GetSize(Int32 &size)
+	{
+		struct stat file_stat;
+		if (fstat(file_descriptor_, &file_stat) != 0)
+			return false;
+
+		size = static_cast<Int32>(file_stat.st_size);
+
+		return true;
+	}
+
+	void* FileLinux::Map(Int32& size)
+	{
+		Unmap();
+
+		Int32 file_size = 0;
+		if (!GetSize(file_size))
+			return NULL;
+
+		// mmap can't map nothing, so an empty file gets the buffer from File::Map
+		if (file_size == 0)
+			return File::Map(size);
+
+		// a private mapping, so writes go to a copy of the page rather than the file
+		void* data = mmap(NULL, file_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, file_descriptor_, 0);
+		if (data == MAP_FAILED)
+			return File::Map(size);
+
+		mapped_data_ = data;
+		mapped_size_ = file_size;
+		is_mapped_ = true;
+		size = file_size;
+		return mapped_data_;
+	}
+
+	void FileLinux::Unmap()
+	{
+		if (is_mapped_)
+		{
+			munmap(mapped_data_, mapped_size_);
+			mapped_data_ = NULL;
+			mapped_size_ = 0;
+			is_mapped_ = false;
+		}
+		else
+			File::Unmap();
+	}
+
+	bool FileLinux::Seek(const SeekFrom seek_from, const Int32 offset/*, Int32* position*/)
+	{
+		int whence = SEEK_SET;
+		switch (seek_from)
+		{
+		case SF_Start:
+			whence = SEEK_SET;
+			break;
+		case SF_Current:
+			whence = SEEK_CUR;
+			break;
+		case SF_End:
+			whence = SEEK_END;
+			break;
+		}
+
+		return lseek(file_descriptor_, offset, whence) != (off_t)-1;
+	}
+
+	bool FileLinux::Read(void *buffer, const Int32 size, Int32& bytes_read)
+	{
+		// read can return less than requested, so keep going until the
+		// buffer is full or the end of the file is reached
+		bytes_read = 0;
+		while (bytes_read < size)
+		{
+			ssize_t result = read(file_descriptor_, static_cast<char*>(buffer) + bytes_read, size - bytes_read);
+			if (result < 0)
+			{
+				if (errno == EINTR)
+					continue;
+				return false;
+			}
+
+			if (result == 0)
+				break;
+
+			bytes_read += static_cast<Int32>(result);
+		}
+
+		return true;
+	}
+
+	bool FileLinux::Read(void *buffer, const Int32 size, const Int32 offset, Int32& bytes_read)
+	{
+		bytes_read = 0;
+		while (bytes_read < size)
+		{
+			ssize_t result = pread(file_descriptor_, static_cast<char*>(buffer) + bytes_read, size - bytes_read, offset + bytes_read);
+			if (result < 0)
+			{
+				if (errno == EINTR)
+					continue;
+				return false;
+			}
+
+			if (result == 0)
+				break;
+
+			bytes_read += static_cast<Int32>(result);
+		}
+
+		return true;
+	}
+
+}
@@ -0,0 +1,35 @@
+#ifndef _GEF_FILE_LINUX_H
+#define _GEF_FILE_LINUX_H
+
+#include <system/file.h>
+
+namespace gef
+{
+
+class FileLinux : public File
+{
+public:
+
+	FileLinux();
+	~FileLinux();
+
+	bool Open(const char* const filename);
+	bool Seek(const SeekFrom seek_from, Int32 offset/*, Int32* position = NULL*/);
+	bool Read(void *buffer, const Int32 size, Int32& bytes_read);
+	bool Read(void *buffer, const Int32 size, const Int32 offset, Int32& bytes_read);
+	bool Close();
+	bool GetSize(Int32 &size);
+	void* Map(Int32& size);
+	void Unmap();
+
+private:
+	int file_descriptor_;
+	// mapped_data_ is from mmap rather than the buffer File::Map reads into
+	bool is_mapped_;
+
+	static const int kInvalidDescriptor;
+};
+
+}
+
+#endif // _GEF_FILE_LINUX_H
@@ -0,0 +1,148 @@
+#include <platform/linux/system/platform_linux_null.h>
+#include <graphics/sprite_renderer.h>
+#include <graphics/renderer_3d.h>
+#include <input/input_manager.h>
+
+namespace gef
+{
+	PlatformLinuxNull::PlatformLinuxNull(const Int32 width, const Int32 height, const UInt32 frame_limit) :
+		frame_count_(0),
+		frame_limit_(frame_limit),
+		fixed_frame_time_(0.0f)
+	{
+		set_width(width);
+		set_height(height);
+
+		// CLOCK_MONOTONIC is not affected by changes to the system time
+		clock_gettime(CLOCK_MONOTONIC, &start_time_);
+		last_frame_time_ = start_time_;
+	}
+
+	PlatformLinuxNull::~PlatformLinuxNull()
+	{
+	}
+
+	bool PlatformLinuxNull::Update()
+	{
+		if (frame_limit_ > 0 && frame_count_ >= frame_limit_)
+			return false;
+
+		++frame_count_;
+		return true;
+	}
+
+	float PlatformLinuxNull::GetFrameTime()
+	{
+		struct timespec time;
+		clock_gettime(CLOCK_MONOTONIC, &time);
+		float frame_time = (float)(TimeInSeconds(time) - TimeInSeconds(last_frame_time_));
+		last_frame_time_ = time;
+
+		if (fixed_frame_time_ > 0.0f)
+			frame_time = fixed_frame_time_;
+
+		return frame_time;
+	}
+
+	double PlatformLinuxNull::GetElapsedTime() const
+	{
+		struct timespec time;
+		clock_gettime(CLOCK_MONOTONIC, &time);
+		return TimeInSeconds(time) - TimeInSeconds(start_time_);
+	}
+
+	double PlatformLinuxNull::TimeInSeconds(const struct timespec& time)
+	{
+		return (double)time.tv_sec + (double)time.tv_nsec * 1e-9;
+	}
+
+	void PlatformLinuxNull::PreRender()
+	{
+	}
+
+	void PlatformLinuxNull::PostRender()
+	{
+	}
+
+	void PlatformLinuxNull::Clear() const
+	{
+	}
+
+	void PlatformLinuxNull::Clear(const bool clear_render_target, const bool clear_depth_buffer, const bool clear_stencil_buffer) const
+	{
+	}
+
+	std::string PlatformLinuxNull::FormatFilename(const std::string& filename) const
+	{
+		return FormatFilename(filename.c_str());
+	}
+
+	std::string PlatformLinuxNull::FormatFilename(const char* filename) const
+	{
+		std::string formatted_filename(filename);
+		for (std::string::iterator c = formatted_filename.begin(); c != formatted_filename.end(); ++c)
+		{
+			if (*c == '\\')
+				*c = '/';
+		}
+		return formatted_filename;
+	}
+
+	SpriteRenderer* PlatformLinuxNull::CreateSpriteRenderer()
+	{
+		return SpriteRenderer::Create(*this);
+	}
+
+	Renderer3D* PlatformLinuxNull::CreateRenderer3D()
+	{
+		return Renderer3D::Create(*this);
+	}
+
+	InputManager* PlatformLinuxNull::CreateInputManager()
+	{
+		return InputManager::Create(*this);
+	}
+
+	// the projections match the D3D11 platform so game side culling and
+	// picking code behaves the same as it does on Windows
+	Matrix44 PlatformLinuxNull::PerspectiveProjectionFov(const float fov, const float aspect_ratio, const float near_distance, const float far_distance) const
+	{
+		Matrix44 projection_matrix;
+		projection_matrix.PerspectiveFovD3D(fov, aspect_ratio, near_distance, far_distance);
+		return projection_matrix;
+	}
+
+	Matrix44 PlatformLinuxNull::PerspectiveProjectionFrustum(const float left, const float right, const float top, const float bottom, const float near_distance, const float far_distance) const
+	{
+		Matrix44 projection_matrix;
+		projection_matrix.PerspectiveFrustumD3D(left, right, top, bottom, near_distance, far_distance);
+		return projection_matrix;
+	}
+
+	Matrix44 PlatformLinuxNull::OrthographicFrustum(const float left, const float right, const float top, const float bottom, const float near_distance, const float far_distance) const
+	{
+		Matrix44 projection_matrix;
+		projection_matrix.OrthographicFrustumD3D(left, right, top, bottom, near_distance, far_distance);
+		return projection_matrix;
+	}
+
+	void PlatformLinuxNull::BeginScene() const
+	{
+	}
+
+	void PlatformLinuxNull::EndScene() const
+	{
+	}
+
+	// shaders are never compiled, but the shader classes still load their
+	// source, so use the D3D11 shaders that ship with every project
+	const char* PlatformLinuxNull::GetShaderDirectory() const
+	{
+		return "d3d11";
+	}
+
+	const char* PlatformLinuxNull::GetShaderFileExtension() const
+	{
+		return "hlsl";
+	}
+}
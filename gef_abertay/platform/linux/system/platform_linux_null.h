@@ -0,0 +1,68 @@
+#ifndef _GEF_PLATFORM_LINUX_NULL_H
+#define _GEF_PLATFORM_LINUX_NULL_H
+
+#include <system/platform.h>
+#include <time.h>
+
+namespace gef
+{
+	/// A headless platform for Linux. Nothing is drawn and there is no audio
+	/// device, but all the CPU side work of an application still runs, which
+	/// makes it suitable for profiling and automated runs.
+	///
+	/// Frames are not capped to a display refresh. Set a frame limit to make
+	/// Update return false, and so end Application::Run, after that many frames.
+	class PlatformLinuxNull : public Platform
+	{
+	public:
+		PlatformLinuxNull(const Int32 width = 960, const Int32 height = 544, const UInt32 frame_limit = 0);
+		~PlatformLinuxNull();
+
+		bool Update();
+		float GetFrameTime();
+		void PreRender();
+		void PostRender();
+		void Clear() const;
+		void Clear(const bool clear_render_target, const bool clear_depth_buffer, const bool clear_stencil_buffer) const;
+
+		std::string FormatFilename(const std::string& filename) const;
+		std::string FormatFilename(const char* filename) const;
+
+		class SpriteRenderer* CreateSpriteRenderer();
+		class Renderer3D* CreateRenderer3D();
+		class InputManager* CreateInputManager();
+
+		Matrix44 PerspectiveProjectionFov(const float fov, const float aspect_ratio, const float near_distance, const float far_distance) const;
+		Matrix44 PerspectiveProjectionFrustum(const float left, const float right, const float top, const float bottom, const float near_distance, const float far_distance) const;
+		Matrix44 OrthographicFrustum(const float left, const float right, const float top, const float bottom, const float near_distance, const float far_distance) const;
+
+		void BeginScene() const;
+		void EndScene() const;
+		const char* GetShaderDirectory() const;
+		const char* GetShaderFileExtension() const;
+
+		/// @return number of completed calls to Update
+		inline UInt32 frame_count() const { return frame_count_; }
+		inline UInt32 frame_limit() const { return frame_limit_; }
+		inline void set_frame_limit(const UInt32 frame_limit) { frame_limit_ = frame_limit; }
+
+		/// When greater than zero GetFrameTime returns this value instead of
+		/// the measured time, so runs are deterministic.
+		inline float fixed_frame_time() const { return fixed_frame_time_; }
+		inline void set_fixed_frame_time(const float frame_time) { fixed_frame_time_ = frame_time; }
+
+		/// @return wall clock seconds since the platform was created
+		double GetElapsedTime() const;
+
+	private:
+		static double TimeInSeconds(const struct timespec& time);
+
+		UInt32 frame_count_;
+		UInt32 frame_limit_;
+		float fixed_frame_time_;
+		struct timespec start_time_;
+		struct timespec last_frame_time_;
+	};
+}
+
+#endif // _GEF_PLATFORM_LINUX_NULL_H
@@ -0,0 +1,170 @@
+#include <platform/null/audio/audio_manager_null.h>
+
+namespace gef
+{
+	AudioManager* AudioManager::Create()
+	{
+		return new AudioManagerNull();
+	}
+
+	AudioManagerNull::AudioManagerNull(const UInt32 max_simultaneous_voices) :
+		max_simultaneous_voices_(max_simultaneous_voices),
+		sample_voice_looping_(max_simultaneous_voices, false),
+		sample_voice_volume_info_(max_simultaneous_voices),
+		music_loaded_(false),
+		music_playing_(false),
+		master_volume_(1.0f)
+	{
+	}
+
+	AudioManagerNull::~AudioManagerNull()
+	{
+	}
+
+	Int32 AudioManagerNull::LoadSample(const char *strFileName, const Platform& platform)
+	{
+		// reuse a slot freed by UnloadSample so ids stay small
+		for (UInt32 sample_index = 0; sample_index < samples_.size(); ++sample_index)
+		{
+			if (!samples_[sample_index])
+			{
+				samples_[sample_index] = true;
+				return sample_index;
+			}
+		}
+
+		samples_.push_back(true);
+		return (Int32)samples_.size() - 1;
+	}
+
+	Int32 AudioManagerNull::LoadMusic(const char *strFileName, const Platform& platform)
+	{
+		music_loaded_ = true;
+		return 0;
+	}
+
+	void AudioManagerNull::UnloadMusic()
+	{
+		StopMusic();
+		music_loaded_ = false;
+	}
+
+	void AudioManagerNull::UnloadSample(Int32 sample_num)
+	{
+		if (sample_num >= 0 && sample_num < (Int32)samples_.size())
+			samples_[sample_num] = false;
+	}
+
+	void AudioManagerNull::UnloadAllSamples()
+	{
+		samples_.clear();
+		for (UInt32 voice_index = 0; voice_index < max_simultaneous_voices_; ++voice_index)
+			sample_voice_looping_[voice_index] = false;
+	}
+
+	Int32 AudioManagerNull::PlayMusic()
+	{
+		if (!music_loaded_)
+			return -1;
+
+		music_playing_ = true;
+		return 0;
+	}
+
+	Int32 AudioManagerNull::StopMusic()
+	{
+		music_playing_ = false;
+		return 0;
+	}
+
+	Int32 AudioManagerNull::PlaySample(const Int32 sample_index, const bool looping)
+	{
+		if (sample_index < 0 || sample_index >= (Int32)samples_.size() || !samples_[sample_index])
+			return -1;
+
+		// only looping voices stay busy
+		UInt32 voice_index = 0;
+		for (; voice_index < max_simultaneous_voices_; ++voice_index)
+		{
+			if (!sample_voice_looping_[voice_index])
+				break;
+		}
+
+		if (voice_index == max_simultaneous_voices_)
+			return -1;
+
+		sample_voice_looping_[voice_index] = looping;
+		sample_voice_volume_info_[voice_index] = VolumeInfo();
+		return voice_index;
+	}
+
+	Int32 AudioManagerNull::StopPlayingSampleVoice(const Int32 voice_index)
+	{
+		if (!ValidVoice(voice_index))
+			return -1;
+
+		sample_voice_looping_[voice_index] = false;
+		return 0;
+	}
+
+	Int32 AudioManagerNull::SetSamplePitch(const Int32 voice_index, float pitch)
+	{
+		return ValidVoice(voice_index) ? 0 : -1;
+	}
+
+	Int32 AudioManagerNull::SetMusicPitch(float pitch)
+	{
+		return 0;
+	}
+
+	Int32 AudioManagerNull::GetSampleVoiceVolumeInfo(const Int32 voice_index, struct VolumeInfo& volume_info)
+	{
+		if (!ValidVoice(voice_index))
+			return -1;
+
+		volume_info = sample_voice_volume_info_[voice_index];
+		return 0;
+	}
+
+	Int32 AudioManagerNull::SetSampleVoiceVolumeInfo(const Int32 voice_index, const struct VolumeInfo& volume_info)
+	{
+		if (!ValidVoice(voice_index))
+			return -1;
+
+		sample_voice_volume_info_[voice_index] = volume_info;
+		return 0;
+	}
+
+	Int32 AudioManagerNull::GetMusicVolumeInfo(struct VolumeInfo& volume_info)
+	{
+		volume_info = music_volume_info_;
+		return 0;
+	}
+
+	Int32 AudioManagerNull::SetMusicVolumeInfo(const struct VolumeInfo& volume_info)
+	{
+		music_volume_info_ = volume_info;
+		return 0;
+	}
+
+	Int32 AudioManagerNull::SetMasterVolume(float volume)
+	{
+		master_volume_ = volume;
+		return 0;
+	}
+
+	bool AudioManagerNull::sample_voice_playing(const UInt32 voice_index)
+	{
+		return ValidVoice(voice_index) && sample_voice_looping_[voice_index];
+	}
+
+	bool AudioManagerNull::sample_voice_looping(const UInt32 voice_index)
+	{
+		return ValidVoice(voice_index) && sample_voice_looping_[voice_index];
+	}
+
+	bool AudioManagerNull::ValidVoice(const Int32 voice_index) const
+	{
+		return voice_index >= 0 && voice_index < (Int32)max_simultaneous_voices_;
+	}
+}
@@ -0,0 +1,57 @@
+#ifndef _GEF_AUDIO_MANAGER_NULL_H
+#define _GEF_AUDIO_MANAGER_NULL_H
+
+#include <audio/audio_manager.h>
+#include <vector>
+
+#define DEFAULT_NUM_SIMULTANEOUS_VOICES		(4)
+
+namespace gef
+{
+	/// An AudioManager without an audio device. Samples and music are only
+	/// book-kept so games see the same ids and voice states they would get
+	/// from a real device. Sound is never mixed, so a voice that is not
+	/// looping finishes as soon as it starts.
+	class AudioManagerNull : public AudioManager
+	{
+	public:
+		AudioManagerNull(const UInt32 max_simultaneous_voices = DEFAULT_NUM_SIMULTANEOUS_VOICES);
+		~AudioManagerNull();
+
+		Int32 LoadSample(const char *strFileName, const Platform& platform);
+		Int32 LoadMusic(const char *strFileName, const Platform& platform);
+		void UnloadMusic();
+		void UnloadSample(Int32 sample_num);
+		void UnloadAllSamples();
+
+		Int32 PlayMusic();
+		Int32 StopMusic();
+		Int32 PlaySample(const Int32 sample_index, const bool looping = false);
+		Int32 StopPlayingSampleVoice(const Int32 voice_index);
+
+		Int32 SetSamplePitch(const Int32 voice_index, float pitch);
+		Int32 SetMusicPitch(float pitch);
+		Int32 GetSampleVoiceVolumeInfo(const Int32 voice_index, struct VolumeInfo& volume_info);
+		Int32 SetSampleVoiceVolumeInfo(const Int32 voice_index, const struct VolumeInfo& volume_info);
+		Int32 GetMusicVolumeInfo(struct VolumeInfo& volume_info);
+		Int32 SetMusicVolumeInfo(const struct VolumeInfo& volume_info);
+		Int32 SetMasterVolume(float volume);
+
+		bool sample_voice_playing(const UInt32 voice_index);
+		bool sample_voice_looping(const UInt32 voice_index);
+
+	private:
+		bool ValidVoice(const Int32 voice_index) const;
+
+		UInt32 max_simultaneous_voices_;
+		std::vector<bool> samples_;
+		std::vector<bool> sample_voice_looping_;
+		std::vector<VolumeInfo> sample_voice_volume_info_;
+		VolumeInfo music_volume_info_;
+		bool music_loaded_;
+		bool music_playing_;
+		float master_volume_;
+	};
+}
+
+#endif // _GEF_AUDIO_MANAGER_NULL_H
@@ -1,10 +1,50 @@
-#include <graphics/index_buffer.h>
-#include <cstddef> // for NULL definition
+#include <platform/null/graphics/index_buffer_null.h>
+#include <cstdlib>
+#include <cstring>
 
 namespace gef
 {
 	IndexBuffer* IndexBuffer::Create(Platform& platform)
 	{
-		return NULL;
+		return new IndexBufferNull();
 	}
-}
\ No newline at end of file
+
+	IndexBufferNull::IndexBufferNull()
+	{
+	}
+
+	IndexBufferNull::~IndexBufferNull()
+	{
+	}
+
+	bool IndexBufferNull::Init(const Platform& platform, const void* indices, const UInt32 num_indices, const UInt32 index_byte_size, const bool read_only)
+	{
+		num_indices_ = num_indices;
+		index_byte_size_ = index_byte_size;
+		bool success = true;
+
+		if (!read_only)
+		{
+			index_data_ = malloc(index_byte_size * num_indices);
+			if (!index_data_)
+				success = false;
+			else
+				memcpy(index_data_, indices, index_byte_size * num_indices);
+		}
+
+		return success;
+	}
+
+	void IndexBufferNull::Bind(const Platform& platform) const
+	{
+	}
+
+	void IndexBufferNull::Unbind(const Platform& platform) const
+	{
+	}
+
+	bool IndexBufferNull::Update(const Platform& platform)
+	{
+		return true;
+	}
+}
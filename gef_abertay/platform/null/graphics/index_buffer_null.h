@@ -0,0 +1,21 @@
+#ifndef _GEF_INDEX_BUFFER_NULL_H
+#define _GEF_INDEX_BUFFER_NULL_H
+
+#include <graphics/index_buffer.h>
+
+namespace gef
+{
+	class IndexBufferNull : public IndexBuffer
+	{
+	public:
+		IndexBufferNull();
+		~IndexBufferNull();
+
+		bool Init(const Platform& platform, const void* indices, const UInt32 num_indices, const UInt32 index_byte_size, const bool read_only = true);
+		void Bind(const Platform& platform) const;
+		void Unbind(const Platform& platform) const;
+		bool Update(const Platform& platform);
+	};
+}
+
+#endif // _GEF_INDEX_BUFFER_NULL_H
@@ -0,0 +1,136 @@
+#include <platform/null/graphics/renderer_3d_null.h>
+#include <graphics/mesh.h>
+#include <graphics/mesh_instance.h>
+#include <graphics/primitive.h>
+#include <graphics/material.h>
+#include <graphics/shader.h>
+#include <graphics/shader_interface.h>
+#include <graphics/vertex_buffer.h>
+#include <graphics/index_buffer.h>
+#include <graphics/texture.h>
+#include <system/platform.h>
+
+namespace gef
+{
+	Renderer3D* Renderer3D::Create(Platform& platform)
+	{
+		return new Renderer3DNull(platform);
+	}
+
+	Renderer3DNull::Renderer3DNull(Platform& platform) :
+		Renderer3D(platform)
+	{
+		default_texture_ = Texture::CreateCheckerTexture(16, 1, platform);
+		platform_.AddTexture(default_texture_);
+
+		platform_.AddShader(&default_shader_);
+		shader_ = &default_shader_;
+	}
+
+	Renderer3DNull::~Renderer3DNull()
+	{
+		platform_.RemoveShader(&default_shader_);
+		platform_.RemoveTexture(default_texture_);
+		DeleteNull(default_texture_);
+	}
+
+	void Renderer3DNull::Begin(bool clear)
+	{
+		platform_.BeginScene();
+
+		if (clear)
+			platform_.Clear();
+	}
+
+	void Renderer3DNull::End()
+	{
+		FlushRenderQueue();
+
+		platform_.EndScene();
+	}
+
+	void Renderer3DNull::DrawMesh(const MeshInstance& mesh_instance)
+	{
+		if (render_queue_enabled_)
+		{
+			QueueMesh(mesh_instance);
+			return;
+		}
+
+		if (!IsVisible(mesh_instance))
+			return;
+
+		// set up the shader data for default shader
+		if (shader_ == &default_shader_)
+			default_shader_.SetSceneData(default_shader_data_, view_matrix_, projection_matrix_);
+
+		const Mesh* mesh = mesh_instance.mesh();
+		if (mesh != NULL)
+		{
+			set_world_matrix(mesh_instance.transform(), mesh_instance.transform_kind());
+
+			const VertexBuffer* vertex_buffer = mesh->vertex_buffer();
+
+			if (vertex_buffer && shader_)
+			{
+				shader_->SetMeshData(mesh_instance);
+
+				shader_->device_interface()->UseProgram();
+				vertex_buffer->Bind(platform_);
+				stats_.shader_changes++;
+				stats_.vertex_buffer_binds++;
+				shader_->device_interface()->SetVertexFormat();
+
+				for (UInt32 primitive_index = 0; primitive_index < mesh->num_primitives(); ++primitive_index)
+				{
+					const Primitive* primitive = mesh->GetPrimitive(primitive_index);
+					const IndexBuffer* index_buffer = primitive->index_buffer();
+					if (primitive->type() != UNDEFINED && index_buffer)
+					{
+						const Material* material;
+						if (override_material_)
+							material = override_material_;
+						else
+							material = primitive->material();
+
+						shader_->SetMaterialData(material);
+						stats_.material_changes++;
+
+						shader_->device_interface()->SetVariableData();
+						shader_->device_interface()->BindTextureResources(platform_);
+
+						index_buffer->Bind(platform_);
+						stats_.index_buffer_binds++;
+
+						SubmitPrimitive(*primitive, *vertex_buffer);
+						stats_.draw_calls++;
+
+						index_buffer->Unbind(platform_);
+
+						shader_->device_interface()->UnbindTextureResources(platform_);
+					}
+				}
+
+				vertex_buffer->Unbind(platform_);
+				shader_->device_interface()->ClearVertexFormat();
+			}
+		}
+	}
+
+	void Renderer3DNull::SubmitPrimitive(const Primitive& primitive, const VertexBuffer& vertex_buffer)
+	{
+		// nothing to draw to, the draw is only counted
+	}
+
+	void Renderer3DNull::DrawPrimitive(const MeshInstance& mesh_instance, Int32 primitive_index, Int32 num_indices)
+	{
+	}
+
+	void Renderer3DNull::SetFillMode(FillMode fill_mode)
+	{
+	}
+
+	void Renderer3DNull::SetDepthTest(DepthTest depth_test)
+	{
+	}
+}
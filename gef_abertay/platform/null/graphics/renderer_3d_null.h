@@ -0,0 +1,34 @@
+#ifndef _GEF_RENDERER_3D_NULL_H
+#define _GEF_RENDERER_3D_NULL_H
+
+#include <graphics/renderer_3d.h>
+
+namespace gef
+{
+	class Platform;
+	class MeshInstance;
+	class Texture;
+
+	/// Renderer3D that does all the CPU side work of a draw (shader constants,
+	/// material selection, buffer binds) but never touches a device.
+	class Renderer3DNull : public Renderer3D
+	{
+	public:
+		Renderer3DNull(Platform& platform);
+		~Renderer3DNull();
+
+		void Begin(bool clear);
+		void End();
+		void DrawMesh(const class MeshInstance& mesh_instance);
+		void DrawPrimitive(const  MeshInstance& mesh_instance, Int32 primitive_index, Int32 num_indices);
+		void SetFillMode(FillMode fill_mode);
+		void SetDepthTest(DepthTest depth_test);
+
+	protected:
+		void SubmitPrimitive(const Primitive& primitive, const VertexBuffer& vertex_buffer);
+
+		Texture* default_texture_;
+	};
+}
+
+#endif // _GEF_RENDERER_3D_NULL_H
@@ -0,0 +1,53 @@
+#include <platform/null/graphics/shader_interface_null.h>
+
+namespace gef
+{
+	ShaderInterface* ShaderInterface::Create(const Platform& platform)
+	{
+		return new ShaderInterfaceNull();
+	}
+
+	ShaderInterfaceNull::ShaderInterfaceNull()
+	{
+	}
+
+	ShaderInterfaceNull::~ShaderInterfaceNull()
+	{
+	}
+
+	bool ShaderInterfaceNull::CreateProgram()
+	{
+		// the variable data is still allocated so shaders can write
+		// their constants exactly as they would on a real device
+		AllocateVariableData();
+		return true;
+	}
+
+	void ShaderInterfaceNull::CreateVertexFormat()
+	{
+	}
+
+	void ShaderInterfaceNull::UseProgram()
+	{
+	}
+
+	void ShaderInterfaceNull::SetVariableData()
+	{
+	}
+
+	void ShaderInterfaceNull::SetVertexFormat()
+	{
+	}
+
+	void ShaderInterfaceNull::ClearVertexFormat()
+	{
+	}
+
+	void ShaderInterfaceNull::BindTextureResources(const Platform& platform) const
+	{
+	}
+
+	void ShaderInterfaceNull::UnbindTextureResources(const Platform& platform) const
+	{
+	}
+}
@@ -0,0 +1,96 @@
+#include <platform/null/graphics/sprite_renderer_null.h>
+#include <graphics/sprite.h>
+#include <graphics/texture.h>
+#include <graphics/vertex_buffer.h>
+#include <graphics/shader_interface.h>
+#include <system/platform.h>
+
+namespace gef
+{
+	SpriteRenderer* SpriteRenderer::Create(Platform& platform)
+	{
+		return new SpriteRendererNull(platform);
+	}
+
+	SpriteRendererNull::SpriteRendererNull(Platform& platform) :
+		SpriteRenderer(platform),
+		default_texture_(NULL),
+		vertex_buffer_(NULL)
+	{
+		vertex_buffer_ = VertexBuffer::Create(platform_);
+
+		float vertices[] = {
+			-0.5f, -0.5f, 0.0f,
+			0.5f, -0.5f, 0.0f,
+			-0.5f, 0.5f, 0.0f,
+			0.5f, 0.5f, 0.0f };
+
+		vertex_buffer_->Init(platform_, vertices, 4, sizeof(float) * 3);
+		platform_.AddVertexBuffer(vertex_buffer_);
+
+		default_texture_ = Texture::CreateCheckerTexture(16, 1, platform);
+		platform_.AddTexture(default_texture_);
+
+		platform_.AddShader(&default_shader_);
+
+		projection_matrix_ = platform_.OrthographicFrustum(0, (float)platform_.width(), 0, (float)platform_.height(), -1, 1);
+		SetShader(NULL);
+	}
+
+	SpriteRendererNull::~SpriteRendererNull()
+	{
+		platform_.RemoveShader(&default_shader_);
+		platform_.RemoveTexture(default_texture_);
+		platform_.RemoveVertexBuffer(vertex_buffer_);
+		DeleteNull(default_texture_);
+		DeleteNull(vertex_buffer_);
+	}
+
+	void SpriteRendererNull::Begin(bool clear)
+	{
+		platform_.BeginScene();
+		if (clear)
+			platform_.Clear();
+
+		vertex_buffer_->Bind(platform_);
+
+		if (shader_ == &default_shader_)
+		{
+			default_shader_.SetSceneData(projection_matrix_);
+			default_shader_.device_interface()->UseProgram();
+			default_shader_.device_interface()->SetVertexFormat();
+		}
+	}
+
+	void SpriteRendererNull::End()
+	{
+		FlushSpriteBatch();
+
+		vertex_buffer_->Unbind(platform_);
+		platform_.EndScene();
+	}
+
+	void SpriteRendererNull::DrawSprite(const Sprite& sprite)
+	{
+		if (batching_enabled_ && shader_ == &default_shader_)
+		{
+			QueueSprite(sprite);
+			return;
+		}
+
+		stats_.sprites++;
+		stats_.draw_calls++;
+
+		if (shader_ == &default_shader_)
+		{
+			stats_.texture_changes++;
+			const Texture* texture = sprite.texture();
+			if (!texture)
+				texture = default_texture_;
+			default_shader_.SetSpriteData(sprite, texture);
+			default_shader_.device_interface()->SetVariableData();
+			default_shader_.device_interface()->BindTextureResources(platform_);
+			default_shader_.device_interface()->UnbindTextureResources(platform_);
+		}
+	}
+}
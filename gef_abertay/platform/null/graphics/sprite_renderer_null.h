@@ -0,0 +1,29 @@
+#ifndef _GEF_SPRITE_RENDERER_NULL_H
+#define _GEF_SPRITE_RENDERER_NULL_H
+
+#include <graphics/sprite_renderer.h>
+
+namespace gef
+{
+	// forward declarations
+	class Platform;
+	class Texture;
+	class VertexBuffer;
+
+	class SpriteRendererNull : public SpriteRenderer
+	{
+	public:
+		SpriteRendererNull(Platform& platform);
+		~SpriteRendererNull();
+
+		void Begin(bool clear);
+		void End();
+		void DrawSprite(const Sprite& sprite);
+
+	private:
+		Texture* default_texture_;
+		VertexBuffer* vertex_buffer_;
+	};
+}
+
+#endif // _GEF_SPRITE_RENDERER_NULL_H
@@ -1,10 +1,28 @@
-#include <graphics/texture.h>
-#include <cstddef> // for NULL definition
+#include <platform/null/graphics/texture_null.h>
+#include <graphics/image_data.h>
 
 namespace gef
 {
 	Texture* Texture::Create(const Platform& platform, const ImageData& image_data)
 	{
-		return NULL;
+		return new TextureNull(platform, image_data);
 	}
-}
\ No newline at end of file
+
+	TextureNull::TextureNull(const Platform& platform, const ImageData& image_data) :
+		width_(image_data.width()),
+		height_(image_data.height())
+	{
+	}
+
+	TextureNull::~TextureNull()
+	{
+	}
+
+	void TextureNull::Bind(const Platform& platform, const int texture_stage_num) const
+	{
+	}
+
+	void TextureNull::Unbind(const Platform& platform, const int texture_stage_num) const
+	{
+	}
+}
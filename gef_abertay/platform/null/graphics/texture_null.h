@@ -0,0 +1,26 @@
+#ifndef _GEF_TEXTURE_NULL_H
+#define _GEF_TEXTURE_NULL_H
+
+#include <graphics/texture.h>
+
+namespace gef
+{
+	class TextureNull : public Texture
+	{
+	public:
+		TextureNull(const Platform& platform, const ImageData& image_data);
+		~TextureNull();
+
+		void Bind(const Platform& platform, const int texture_stage_num) const;
+		void Unbind(const Platform& platform, const int texture_stage_num) const;
+
+		inline Int32 width() const { return width_; }
+		inline Int32 height() const { return height_; }
+
+	private:
+		Int32 width_;
+		Int32 height_;
+	};
+}
+
+#endif // _GEF_TEXTURE_NULL_H
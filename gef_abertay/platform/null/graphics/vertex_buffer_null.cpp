@@ -1,10 +1,52 @@
-#include <graphics/vertex_buffer.h>
-#include <cstddef> // for NULL definition
+#include <platform/null/graphics/vertex_buffer_null.h>
+#include <cstdlib>
+#include <cstring>
 
 namespace gef
 {
 	VertexBuffer* VertexBuffer::Create(Platform& platform)
 	{
-		return NULL;
+		return new VertexBufferNull();
 	}
-}
\ No newline at end of file
+
+	VertexBufferNull::VertexBufferNull()
+	{
+	}
+
+	VertexBufferNull::~VertexBufferNull()
+	{
+	}
+
+	bool VertexBufferNull::Init(const Platform& platform, const void* vertices, const UInt32 num_vertices, const UInt32 vertex_byte_size, const bool read_only)
+	{
+		num_vertices_ = num_vertices;
+		vertex_byte_size_ = vertex_byte_size;
+		bool success = true;
+
+		// there is no device buffer, so the data is only kept when
+		// the caller wants to update it later
+		if (!read_only)
+		{
+			vertex_data_ = malloc(vertex_byte_size * num_vertices);
+			if (!vertex_data_)
+				success = false;
+			else
+				memcpy(vertex_data_, vertices, vertex_byte_size * num_vertices);
+		}
+
+		return success;
+	}
+
+	bool VertexBufferNull::Update(const Platform& platform)
+	{
+		return true;
+	}
+
+	void VertexBufferNull::Bind(const Platform& platform) const
+	{
+	}
+
+	void VertexBufferNull::Unbind(const Platform& platform) const
+	{
+	}
+}
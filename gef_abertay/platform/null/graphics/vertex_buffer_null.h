@@ -0,0 +1,21 @@
+#ifndef _GEF_VERTEX_BUFFER_NULL_H
+#define _GEF_VERTEX_BUFFER_NULL_H
+
+#include <graphics/vertex_buffer.h>
+
+namespace gef
+{
+	class VertexBufferNull : public VertexBuffer
+	{
+	public:
+		VertexBufferNull();
+		~VertexBufferNull();
+		bool Init(const Platform& platform, const void* vertices, const UInt32 num_vertices, const UInt32 vertex_byte_size, const bool read_only = true);
+		bool Update(const Platform& platform);
+
+		void Bind(const Platform& platform) const;
+		void Unbind(const Platform& platform) const;
+	};
+}
+
+#endif // _GEF_VERTEX_BUFFER_NULL_H
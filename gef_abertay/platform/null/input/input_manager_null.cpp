@@ -0,0 +1,22 @@
+#include <platform/null/input/input_manager_null.h>
+
+namespace gef
+{
+	InputManager* InputManager::Create(Platform& platform)
+	{
+		return new InputManagerNull(platform);
+	}
+
+	InputManagerNull::InputManagerNull(Platform& platform)
+		: InputManager(platform)
+	{
+		keyboard_ = new KeyboardNull();
+		controller_manager_ = new SonyControllerInputManagerNull(platform);
+	}
+
+	InputManagerNull::~InputManagerNull()
+	{
+		delete controller_manager_;
+		delete keyboard_;
+	}
+}
@@ -0,0 +1,23 @@
+#ifndef _GEF_INPUT_MANAGER_NULL_H
+#define _GEF_INPUT_MANAGER_NULL_H
+
+#include <input/input_manager.h>
+#include <platform/null/input/keyboard_null.h>
+#include <platform/null/input/sony_controller_input_manager_null.h>
+
+namespace gef
+{
+	class Platform;
+
+	class InputManagerNull : public InputManager
+	{
+	public:
+		InputManagerNull(Platform& platform);
+		~InputManagerNull();
+
+		inline KeyboardNull* keyboard_null() const { return static_cast<KeyboardNull*>(keyboard_); }
+		inline SonyControllerInputManagerNull* controller_input_null() const { return static_cast<SonyControllerInputManagerNull*>(controller_manager_); }
+	};
+}
+
+#endif // _GEF_INPUT_MANAGER_NULL_H
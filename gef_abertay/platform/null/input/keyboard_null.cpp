@@ -0,0 +1,42 @@
+#include <platform/null/input/keyboard_null.h>
+#include <cstring>
+
+namespace gef
+{
+	KeyboardNull::KeyboardNull()
+	{
+		memset(live_keyboard_state_, 0, sizeof(live_keyboard_state_));
+		memset(keyboard_state_, 0, sizeof(keyboard_state_));
+		memset(previous_keyboard_state_, 0, sizeof(previous_keyboard_state_));
+	}
+
+	KeyboardNull::~KeyboardNull()
+	{
+	}
+
+	void KeyboardNull::Update()
+	{
+		memcpy(previous_keyboard_state_, keyboard_state_, sizeof(keyboard_state_));
+		memcpy(keyboard_state_, live_keyboard_state_, sizeof(live_keyboard_state_));
+	}
+
+	bool KeyboardNull::IsKeyDown(KeyCode key) const
+	{
+		return keyboard_state_[key];
+	}
+
+	bool KeyboardNull::IsKeyPressed(KeyCode key) const
+	{
+		return keyboard_state_[key] && !previous_keyboard_state_[key];
+	}
+
+	bool KeyboardNull::IsKeyReleased(KeyCode key) const
+	{
+		return !keyboard_state_[key] && previous_keyboard_state_[key];
+	}
+
+	void KeyboardNull::SetKeyDown(KeyCode key, bool down)
+	{
+		live_keyboard_state_[key] = down;
+	}
+}
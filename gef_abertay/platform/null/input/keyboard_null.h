@@ -0,0 +1,30 @@
+#ifndef _GEF_KEYBOARD_NULL_H
+#define _GEF_KEYBOARD_NULL_H
+
+#include <input/keyboard.h>
+
+namespace gef
+{
+	/// A keyboard with no device behind it. Keys are pressed and released
+	/// from code with SetKeyDown, and the pressed / released states are
+	/// worked out on the following Update, as they are for a real keyboard.
+	class KeyboardNull : public Keyboard
+	{
+	public:
+		KeyboardNull();
+		~KeyboardNull();
+		void Update();
+		bool IsKeyDown(KeyCode key) const;
+		bool IsKeyPressed(KeyCode key) const;
+		bool IsKeyReleased(KeyCode key) const;
+
+		void SetKeyDown(KeyCode key, bool down);
+
+	protected:
+		bool live_keyboard_state_[NUM_KEY_CODES];
+		bool keyboard_state_[NUM_KEY_CODES];
+		bool previous_keyboard_state_[NUM_KEY_CODES];
+	};
+}
+
+#endif // _GEF_KEYBOARD_NULL_H
@@ -0,0 +1,113 @@
+#include <platform/null/input/sony_controller_input_manager_null.h>
+#include <system/file.h>
+#include <system/debug_log.h>
+#include <cstdlib>
+
+namespace gef
+{
+	std::string SonyControllerInputManagerNull::default_script_filename_;
+
+	SonyControllerInputManagerNull::SonyControllerInputManagerNull(const Platform& platform) :
+		SonyControllerInputManager(platform),
+		next_script_event_(0),
+		update_count_(0)
+	{
+		if (!default_script_filename_.empty())
+			LoadScript(default_script_filename_.c_str());
+	}
+
+	SonyControllerInputManagerNull::~SonyControllerInputManagerNull()
+	{
+	}
+
+	void SonyControllerInputManagerNull::set_default_script_filename(const char* filename)
+	{
+		default_script_filename_ = filename ? filename : "";
+	}
+
+	Int32 SonyControllerInputManagerNull::Update()
+	{
+		UInt32 previous_buttons_down = controller_.buttons_down();
+
+		while (next_script_event_ < script_.size() && script_[next_script_event_].update <= update_count_)
+		{
+			const ScriptEvent& script_event = script_[next_script_event_++];
+			controller_.set_buttons_down(script_event.buttons_down);
+			controller_.set_left_stick_x_axis(script_event.left_stick_x_axis);
+			controller_.set_left_stick_y_axis(script_event.left_stick_y_axis);
+			controller_.set_right_stick_x_axis(script_event.right_stick_x_axis);
+			controller_.set_right_stick_y_axis(script_event.right_stick_y_axis);
+		}
+
+		controller_.UpdateButtonStates(previous_buttons_down);
+		++update_count_;
+
+		return 0;
+	}
+
+	bool SonyControllerInputManagerNull::LoadScript(const char* filename)
+	{
+		File* file = File::Create();
+		void* buffer = NULL;
+		Int32 buffer_size = 0;
+
+		bool success = file->Open(filename) && file->GetSize(buffer_size);
+		if (success)
+		{
+			buffer = malloc(buffer_size);
+			Int32 bytes_read = 0;
+			success = buffer && file->Read(buffer, buffer_size, bytes_read) && bytes_read == buffer_size;
+		}
+		file->Close();
+		delete file;
+
+		if (success)
+			ParseScript(static_cast<const char*>(buffer), buffer_size);
+		else
+			DebugOut("SonyControllerInputManagerNull: %s failed to load\n", filename);
+
+		free(buffer);
+		return success;
+	}
+
+	void SonyControllerInputManagerNull::ParseScript(const char* script, Int32 script_length)
+	{
+		script_.clear();
+		next_script_event_ = 0;
+
+		const char* line = script;
+		const char* script_end = script + script_length;
+		while (line < script_end)
+		{
+			const char* line_end = line;
+			while (line_end < script_end && *line_end != '\n')
+				++line_end;
+
+			const char* c = line;
+			while (c < line_end && (*c == ' ' || *c == '\t'))
+				++c;
+
+			if (c != line_end && *c != '#' && *c != '\r')
+			{
+				// copy the line so it is null terminated for strtoul / strtod
+				std::string line_text(c, line_end);
+				ScriptEvent script_event;
+				char* next = NULL;
+				script_event.update = strtoul(line_text.c_str(), &next, 10);
+				script_event.buttons_down = strtoul(next, &next, 0);
+				script_event.left_stick_x_axis = (float)strtod(next, &next);
+				script_event.left_stick_y_axis = (float)strtod(next, &next);
+				script_event.right_stick_x_axis = (float)strtod(next, &next);
+				script_event.right_stick_y_axis = (float)strtod(next, &next);
+				AddScriptEvent(script_event);
+			}
+
+			line = line_end + 1;
+		}
+	}
+
+	void SonyControllerInputManagerNull::AddScriptEvent(const ScriptEvent& script_event)
+	{
+		script_.push_back(script_event);
+	}
+}
@@ -0,0 +1,59 @@
+#ifndef _GEF_SONY_CONTROLLER_INPUT_MANAGER_NULL_H
+#define _GEF_SONY_CONTROLLER_INPUT_MANAGER_NULL_H
+
+#include <input/sony_controller_input_manager.h>
+#include <vector>
+#include <string>
+
+namespace gef
+{
+	/// A controller driven by a script instead of a device, so a game can be
+	/// played back headless. Each script line sets the controller state from
+	/// the given update onwards:
+	///
+	///     <update> <buttons> <left x> <left y> <right x> <right y>
+	///
+	/// update is always decimal, so it can be padded with zeros (0100).
+	/// buttons is a gef_SONY_CTRL_ mask and may be written in hex (0x4000).
+	/// Lines must be in update order. Empty lines and lines starting with #
+	/// are ignored.
+	class SonyControllerInputManagerNull : public SonyControllerInputManager
+	{
+	public:
+		struct ScriptEvent
+		{
+			UInt32 update;
+			UInt32 buttons_down;
+			float left_stick_x_axis;
+			float left_stick_y_axis;
+			float right_stick_x_axis;
+			float right_stick_y_axis;
+		};
+
+		SonyControllerInputManagerNull(const Platform& platform);
+		~SonyControllerInputManagerNull();
+
+		Int32 Update();
+
+		/// Load a script file, replacing the current script.
+		/// @return false if the file could not be loaded
+		bool LoadScript(const char* filename);
+		void ParseScript(const char* script, Int32 script_length);
+		void AddScriptEvent(const ScriptEvent& script_event);
+
+		inline UInt32 update_count() const { return update_count_; }
+
+		/// Script loaded by every controller created afterwards, so a script
+		/// can be given to an InputManager created inside the application.
+		static void set_default_script_filename(const char* filename);
+
+	private:
+		std::vector<ScriptEvent> script_;
+		size_t next_script_event_;
+		UInt32 update_count_;
+
+		static std::string default_script_filename_;
+	};
+}
+
+#endif // _GEF_SONY_CONTROLLER_INPUT_MANAGER_NULL_H
@@ -65,12 +65,23 @@ namespace gef
 
     void Renderer3DVita::End()
     {
+        FlushRenderQueue();
+
         const PlatformVita& platform_vita = static_cast<const PlatformVita&>(platform());
         platform_vita.EndScene();
     }
 
 	void Renderer3DVita::DrawMesh(const  MeshInstance& mesh_instance)
 	{
+		if (render_queue_enabled_)
+		{
+			QueueMesh(mesh_instance);
+			return;
+		}
+
+		if (!IsVisible(mesh_instance))
+			return;
+
 		// set up the shader data for default shader
 		if (shader_ == &default_shader_)
 			default_shader_.SetSceneData(default_shader_data_, view_matrix_, projection_matrix_);
@@ -78,7 +89,7 @@ namespace gef
 		const Mesh* mesh = mesh_instance.mesh();
 		if (mesh != NULL)
 		{
-			set_world_matrix(mesh_instance.transform());
+			set_world_matrix(mesh_instance.transform(), mesh_instance.transform_kind());
 
 			const VertexBuffer* vertex_buffer = mesh->vertex_buffer();
 			//ShaderGL* shader_GL = static_cast<ShaderGL*>(shader_);
@@ -89,6 +100,8 @@ namespace gef
 
 				shader_->device_interface()->UseProgram();
 				vertex_buffer->Bind(platform_);
+				stats_.shader_changes++;
+				stats_.vertex_buffer_binds++;
 
 				// vertex format must be set after the vertex buffer is bound
 				shader_->device_interface()->SetVertexFormat();
@@ -109,6 +122,7 @@ namespace gef
 
 						//only set default shader data if current shader is the default shader
 						shader_->SetMaterialData(material);
+						stats_.material_changes++;
 
 						// GRC FIXME - probably want to split variable data into scene, object, primitive[material?] based
 						// rather than set all variables per primitive
@@ -117,11 +131,10 @@ namespace gef
 
 
 						index_buffer->Bind(platform_);
+						stats_.index_buffer_binds++;
 
-						const PlatformVita& platform_vita = static_cast<const PlatformVita&>(platform_);
-						const IndexBufferVita* index_buffer_vita = static_cast<const IndexBufferVita*>(primitive->index_buffer());
-						sceGxmDraw(platform_vita.context(), primitive_types[primitive->type()], index_buffer_vita->index_format(), index_buffer_vita->graphics_data(), index_buffer_vita->num_indices());
-
+						SubmitPrimitive(*primitive, *vertex_buffer);
+						stats_.draw_calls++;
 
 
 						index_buffer->Unbind(platform_);
@@ -145,7 +158,7 @@ namespace gef
         const Mesh* mesh = mesh_instance.mesh();
         if(mesh != NULL)
         {
-            set_world_matrix(mesh_instance.transform());
+            set_world_matrix(mesh_instance.transform(), mesh_instance.transform_kind());
 
             const VertexBuffer* vertex_buffer = mesh->vertex_buffer();
             //ShaderGL* shader_GL = static_cast<ShaderGL*>(shader_);
@@ -199,6 +212,13 @@ namespace gef
     }
 #endif
 
+	void Renderer3DVita::SubmitPrimitive(const Primitive& primitive, const VertexBuffer& vertex_buffer)
+	{
+		const PlatformVita& platform_vita = static_cast<const PlatformVita&>(platform_);
+		const IndexBufferVita* index_buffer_vita = static_cast<const IndexBufferVita*>(primitive.index_buffer());
+		sceGxmDraw(platform_vita.context(), primitive_types[primitive.type()], index_buffer_vita->index_format(), index_buffer_vita->graphics_data(), index_buffer_vita->num_indices());
+	}
+
     //	void Renderer3DVita::ClearZBuffer()
     //	{
     //	}
@@ -30,6 +30,8 @@ namespace gef
 		void SetDepthTest(DepthTest depth_test);
 
 	protected:
+		void SubmitPrimitive(const Primitive& primitive, const VertexBuffer& vertex_buffer);
+
 		static const SceGxmPrimitiveType primitive_types[NUM_PRIMITIVE_TYPES];
 
 		Texture* default_texture_;
@@ -109,6 +109,8 @@ namespace gef
 
 		const PlatformVita& platform_vita = static_cast<const PlatformVita&>(platform_);
 		sceGxmDraw(platform_vita.context(), SCE_GXM_PRIMITIVE_TRIANGLE_STRIP, SCE_GXM_INDEX_FORMAT_U16, colouredSpriteIndices, 4);
+		stats_.sprites++;
+		stats_.draw_calls++;
 
 
 		if (shader_ == &default_shader_)
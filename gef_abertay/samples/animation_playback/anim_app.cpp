@@ -16,6 +16,7 @@
 #include <graphics/scene.h>
 #include <animation/skeleton.h>
 #include <animation/animation.h>
+#include <math.h>
 
 AnimApp::AnimApp(gef::Platform& platform) :
 	Application(platform),
@@ -25,7 +26,16 @@ AnimApp::AnimApp(gef::Platform& platform) :
 	model_scene_(NULL),
 	skeleton_(NULL),
 	running_anim_(NULL),
-	idle_anim_(NULL)
+	idle_anim_(NULL),
+	walking_anim_(NULL),
+	blend_tree_(NULL),
+	locomotion_blend_(-1),
+	idle_input_(-1),
+	walking_input_(-1),
+	running_input_(-1),
+	upper_body_layer_(-1),
+	speed_(0.0f),
+	upper_body_weight_(0.0f)
 {
 }
 
@@ -66,12 +76,11 @@ void AnimApp::Init()
 	}
 
 	// anims
-
-	// initialise the animation player with the bind pose
-	anim_player_.Update(0.0f, bind_pose_);
-
 	running_anim_ = LoadAnimation("running_InPlace.scn");
 	idle_anim_ = LoadAnimation("idle.scn");
+	walking_anim_ = LoadAnimation("walking_inPlace.scn");
+
+	InitBlendTree();
 
 	// start with the character facing the right
 	face_right_ = true;
@@ -84,6 +93,15 @@ void AnimApp::CleanUp()
 {
 	bone_matrices_.clear();
 
+	// the blend tree and bindings point at the animations, so they go first
+	delete blend_tree_;
+	blend_tree_ = NULL;
+	binding_cache_.Clear();
+	pose_pool_.CleanUp();
+
+	delete walking_anim_;
+	walking_anim_ = NULL;
+
 	delete running_anim_;
 	running_anim_ = NULL;
 
@@ -114,6 +132,7 @@ bool AnimApp::Update(float frame_time)
 
 
 	float forward = 0.0f;
+	bool upper_body_held = false;
 
 
 	// read input devices to control the character
@@ -128,7 +147,10 @@ bool AnimApp::Update(float frame_time)
 		{
 			const gef::SonyController* controller = controller_manager->GetController(0);
 			if (controller)
+			{
 				forward = controller->left_stick_x_axis();
+				upper_body_held = (controller->buttons_down() & gef_SONY_CTRL_CROSS) != 0;
+			}
 		}
 
 		// if there is a keyboard, check the arrow keys to control the direction of the character
@@ -139,50 +161,27 @@ bool AnimApp::Update(float frame_time)
 				forward = 1.0f;
 			else if (keyboard->IsKeyDown(gef::Keyboard::KC_LEFT))
 				forward = -1.0f;
-		}
-	}
 
-	// store the animation used on the last frame so we can detect if
-	// we need to trigger a animation change in this frame
-	const gef::Animation* previous_anim = anim_player_.clip();
-
-	// forward == 0.0f, character is in idle state
-	// otherwise the character is moving left or right
-	if (forward == 0.0f)
-	{
-		// check to see if we are transiting to idle from a different animation
-		// if so start playing idle from the beginning
-		if (previous_anim != idle_anim_)
-		{
-			anim_player_.set_clip(idle_anim_);
-			anim_player_.set_looping(true);
-			anim_player_.set_anim_time(0.0f);
+			if (keyboard->IsKeyDown(gef::Keyboard::KC_SPACE))
+				upper_body_held = true;
 		}
 	}
-	else
-	{
-		if (forward > 0.0f)
-			face_right_ = true;
-		else
-			face_right_ = false;
 
-		// if previous animation is different from running animation the
-		// start playing the run animation from the start
-		if (previous_anim != running_anim_)
-		{
-			anim_player_.set_clip(running_anim_);
-			anim_player_.set_looping(true);
-			anim_player_.set_anim_time(0.0f);
-		}
-	}
+	if (forward != 0.0f)
+		face_right_ = forward > 0.0f;
 
-	if (skeleton_)
+	if (blend_tree_)
 	{
-		anim_player_.Update(frame_time, bind_pose_);
+		UpdateBlendWeights(frame_time, forward, upper_body_held);
+
+		// the scratch poses from the last frame are finished with
+		pose_pool_.Reset();
+		blend_tree_->Update(frame_time);
+		blend_tree_->Evaluate(pose_pool_, pose_);
 
 		// calculate bone matrices that need to be passed to the shader
-		// this should be the final pose if multiple animations are blended together
-		std::vector<gef::Matrix44>::const_iterator pose_matrix_iter = anim_player_.pose().global_pose().begin();
+		// this is the final pose with all of the animations blended together
+		std::vector<gef::Matrix44>::const_iterator pose_matrix_iter = pose_.global_pose().begin();
 		std::vector<gef::Joint>::const_iterator joint_iter = skeleton_->joints().begin();
 
 		for (std::vector<gef::Matrix44>::iterator bone_matrix_iter = bone_matrices_.begin(); bone_matrix_iter != bone_matrices_.end(); ++bone_matrix_iter, ++joint_iter, ++pose_matrix_iter)
@@ -241,6 +240,14 @@ void AnimApp::DrawHUD()
 	{
 		// display frame rate
 		font_->RenderText(sprite_renderer_, gef::Vector4(850.0f, 510.0f, -0.9f), 1.0f, 0xffffffff, gef::TJ_LEFT, "FPS: %.1f", fps_);
+
+		// the blend tree gets its scratch poses from the pool, so the animation update only
+		// allocates when the pool runs out, which the overflow count shows
+		if (blend_tree_)
+		{
+			font_->RenderText(sprite_renderer_, gef::Vector4(20.0f, 470.0f, -0.9f), 1.0f, 0xffffffff, gef::TJ_LEFT, "Speed: %.2f  Upper body (space): %.2f", speed_, upper_body_weight_);
+			font_->RenderText(sprite_renderer_, gef::Vector4(20.0f, 490.0f, -0.9f), 1.0f, 0xffffffff, gef::TJ_LEFT, "Pool poses: %d / %d  Overflow: %u", pose_pool_.peak_used(), pose_pool_.capacity(), pose_pool_.overflow_count());
+		}
 	}
 }
 
@@ -288,3 +295,59 @@ gef::Animation* AnimApp::LoadAnimation(const char* anim_scene_filename, const ch
 	return anim;
 }
 
+
+void AnimApp::InitBlendTree()
+{
+	if (!skeleton_ || !idle_anim_ || !running_anim_)
+		return;
+
+	pose_ = bind_pose_;
+	blend_tree_ = new gef::BlendTree(bind_pose_);
+
+	// locomotion, a blend between idle, walking and running driven by the speed of the character
+	const Int32 idle_clip = blend_tree_->AddClip(binding_cache_.GetBinding(*skeleton_, *idle_anim_));
+	const Int32 running_clip = blend_tree_->AddClip(binding_cache_.GetBinding(*skeleton_, *running_anim_));
+	locomotion_blend_ = blend_tree_->AddBlend();
+	idle_input_ = blend_tree_->AddBlendInput(locomotion_blend_, idle_clip, 1.0f);
+	if (walking_anim_)
+	{
+		const Int32 walking_clip = blend_tree_->AddClip(binding_cache_.GetBinding(*skeleton_, *walking_anim_));
+		walking_input_ = blend_tree_->AddBlendInput(locomotion_blend_, walking_clip, 0.0f);
+	}
+	running_input_ = blend_tree_->AddBlendInput(locomotion_blend_, running_clip, 0.0f);
+
+	// idle on the spine and every joint above it, layered over the locomotion
+	// so the character can keep still from the waist up while the legs run
+	const Int32 upper_body_clip = blend_tree_->AddClip(binding_cache_.GetBinding(*skeleton_, *idle_anim_));
+	const Int32 upper_body_mask = blend_tree_->AddJointMask(gef::GetStringId("mixamorig:Spine"));
+	upper_body_layer_ = blend_tree_->AddLayer(locomotion_blend_, upper_body_clip, upper_body_mask);
+	blend_tree_->SetWeight(upper_body_layer_, 0.0f);
+	blend_tree_->set_root(upper_body_layer_);
+
+	// the pool is sized for the tree up front, so evaluating the tree doesn't allocate
+	pose_pool_.Init(skeleton_->joint_count(), blend_tree_->PoolPosesNeeded());
+}
+
+void AnimApp::UpdateBlendWeights(float frame_time, float forward, bool upper_body_held)
+{
+	// ease towards the input over about a quarter of a second so changes blend rather than pop
+	const float ease = frame_time * 4.0f < 1.0f ? frame_time * 4.0f : 1.0f;
+	speed_ += (fabsf(forward) - speed_) * ease;
+	upper_body_weight_ += ((upper_body_held ? 1.0f : 0.0f) - upper_body_weight_) * ease;
+
+	if (walking_input_ != -1)
+	{
+		// idle to walking over the first half of the speed range, walking to running over the second
+		const float walking_weight = speed_ < 0.5f ? speed_ * 2.0f : 2.0f - speed_ * 2.0f;
+		blend_tree_->SetBlendInputWeight(locomotion_blend_, idle_input_, speed_ < 0.5f ? 1.0f - walking_weight : 0.0f);
+		blend_tree_->SetBlendInputWeight(locomotion_blend_, walking_input_, walking_weight);
+		blend_tree_->SetBlendInputWeight(locomotion_blend_, running_input_, speed_ < 0.5f ? 0.0f : 1.0f - walking_weight);
+	}
+	else
+	{
+		blend_tree_->SetBlendInputWeight(locomotion_blend_, idle_input_, 1.0f - speed_);
+		blend_tree_->SetBlendInputWeight(locomotion_blend_, running_input_, speed_);
+	}
+
+	blend_tree_->SetWeight(upper_body_layer_, upper_body_weight_);
+}
@@ -9,7 +9,9 @@
 #include <vector>
 #include <graphics/mesh_instance.h>
 #include <animation/skeleton.h>
-#include "motion_clip_player.h"
+#include <animation/animation_binding.h>
+#include <animation/blend_tree.h>
+#include <animation/pose_pool.h>
 
 // FRAMEWORK FORWARD DECLARATIONS
 namespace gef
@@ -39,6 +41,8 @@ private:
 	void SetupLights();
 	void SetupCamera();
 	gef::Animation* LoadAnimation(const char* anim_scene_file, const char* anim_name = NULL);
+	void InitBlendTree();
+	void UpdateBlendWeights(float frame_time, float forward, bool upper_body_held);
 
 	gef::SpriteRenderer* sprite_renderer_;
 	gef::Renderer3D* renderer_3d_;
@@ -63,12 +67,30 @@ private:
 	std::vector<gef::Matrix44> bone_matrices_;
 	gef::SkeletonPose bind_pose_;
 
-	MotionClipPlayer anim_player_;
-
 	gef::Animation* running_anim_;
 
 	gef::Animation* idle_anim_;
 
+	// NULL when walking_inPlace.scn hasn't been built, idle blends straight into running then
+	gef::Animation* walking_anim_;
+
+	// the pose of the character, set by evaluating the blend tree every frame
+	gef::SkeletonPose pose_;
+	gef::AnimationBindingCache binding_cache_;
+	gef::BlendTree* blend_tree_;
+	// scratch poses for the blend tree, reset every frame
+	gef::PosePool pose_pool_;
+	Int32 locomotion_blend_;
+	Int32 idle_input_;
+	Int32 walking_input_;
+	Int32 running_input_;
+	Int32 upper_body_layer_;
+
+	// 0 when standing still up to 1 when running, eased towards the input
+	float speed_;
+	// how much of the idle upper body is layered over the legs
+	float upper_body_weight_;
+
 	bool face_right_;
 };
 
@@ -18,4 +18,8 @@ set ASSET_NAME=running_InPlace
 set FBX2SCN_FLAGS=-scaling-factor 0.01 -animation-only
 %FBX2SCN_EXE% -o %OUTPUT_DIR%\%ASSET_NAME%.scn %FBX2SCN_FLAGS% %ASSET_NAME%.fbx
 
+set ASSET_NAME=walking_inPlace
+set FBX2SCN_FLAGS=-scaling-factor 0.01 -animation-only
+%FBX2SCN_EXE% -o %OUTPUT_DIR%\%ASSET_NAME%.scn %FBX2SCN_FLAGS% %ASSET_NAME%.fbx
+
 pause
\ No newline at end of file
@@ -4,13 +4,50 @@
 
 namespace gef
 {
-	File::File()
+	File::File() :
+		mapped_data_(NULL),
+		mapped_size_(0)
 	{
 
 	}
 
 	File::~File()
 	{
+		// platforms that map files unmap them in their own destructor, this frees the copy made by File::Map
+		File::Unmap();
+	}
+
+	void* File::Map(Int32& size)
+	{
+		// no way to map files on this platform, so read it all into a buffer
+		Unmap();
+
+		Int32 file_size = 0;
+		if(!Seek(SF_Start, 0) || !GetSize(file_size))
+			return NULL;
+
+		void* data = std::malloc(file_size > 0 ? file_size : 1);
+		if(!data)
+			return NULL;
+
+		Int32 bytes_read = 0;
+		if(!Read(data, file_size, bytes_read) || bytes_read != file_size)
+		{
+			std::free(data);
+			return NULL;
+		}
+
+		mapped_data_ = data;
+		mapped_size_ = file_size;
+		size = file_size;
+		return mapped_data_;
+	}
+
+	void File::Unmap()
+	{
+		std::free(mapped_data_);
+		mapped_data_ = NULL;
+		mapped_size_ = 0;
 	}
 
 
@@ -27,9 +27,19 @@ namespace gef
 		virtual bool GetSize(Int32 &size) = 0;
 		bool Load(const char* const filename, void** buffer, Int32& buffer_size);
 
+		// the whole of the open file in memory, or NULL if it can't be read. The memory
+		// is valid until Unmap or the file is deleted, even after the file is closed.
+		// Platforms that can map files do, so pages are only read when they are touched.
+		// Writes to the memory are never written back to the file
+		virtual void* Map(Int32& size);
+		virtual void Unmap();
+
 		static File* Create();
 	protected:
 		File();
+
+		void* mapped_data_;
+		Int32 mapped_size_;
 	};
 }
 
@@ -0,0 +1,49 @@
+#include <system/hash.h>
+#include <cstring>
+
+namespace gef
+{
+	static const UInt64 kPrime1 = 0x9e3779b185ebca87ULL;
+	static const UInt64 kPrime2 = 0xc2b2ae3d27d4eb4fULL;
+	static const UInt64 kPrime3 = 0x165667b19e3779f9ULL;
+	static const UInt64 kPrime4 = 0x85ebca77c2b2ae63ULL;
+	static const UInt64 kPrime5 = 0x27d4eb2f165667c5ULL;
+
+	static inline UInt64 RotateLeft(const UInt64 value, const Int32 bits)
+	{
+		return (value << bits) | (value >> (64 - bits));
+	}
+
+	// spreads every bit of the hash over all of the others
+	static inline UInt64 FinalMix(UInt64 hash)
+	{
+		hash ^= hash >> 33;
+		hash *= kPrime2;
+		hash ^= hash >> 29;
+		hash *= kPrime3;
+		hash ^= hash >> 32;
+		return hash;
+	}
+
+	UInt64 GetDataHash(const void* data, const Int32 size)
+	{
+		const UInt8* bytes = (const UInt8*)data;
+		UInt64 hash = kPrime5 + (UInt64)size;
+
+		Int32 byte_num = 0;
+		for(; byte_num + 8 <= size; byte_num += 8)
+		{
+			UInt64 word;
+			memcpy(&word, bytes + byte_num, sizeof(word));
+			hash ^= RotateLeft(word * kPrime2, 31) * kPrime1;
+			hash = RotateLeft(hash, 27) * kPrime1 + kPrime4;
+		}
+		for(; byte_num < size; ++byte_num)
+		{
+			hash ^= bytes[byte_num] * kPrime5;
+			hash = RotateLeft(hash, 11) * kPrime1;
+		}
+
+		return FinalMix(hash);
+	}
+}
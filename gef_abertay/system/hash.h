@@ -0,0 +1,15 @@
+#ifndef _GEF_HASH_H
+#define _GEF_HASH_H
+
+#include <gef.h>
+
+namespace gef
+{
+	// a 64 bit hash of a block of data, for telling whether a file's contents have
+	// changed. It takes eight bytes at a time, the same way as a single lane of
+	// xxHash64, so hashing a file is quick next to parsing it, and every bit of
+	// the data can change every bit of the hash
+	extern UInt64 GetDataHash(const void* data, const Int32 size);
+}
+
+#endif // _GEF_HASH_H
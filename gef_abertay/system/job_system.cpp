@@ -0,0 +1,101 @@
+#include <system/job_system.h>
+#include <algorithm>
+
+namespace gef
+{
+	JobSystem::JobSystem(const Int32 worker_count) :
+		stopping_(false)
+	{
+		for(Int32 worker_num = 0; worker_num < worker_count; ++worker_num)
+			workers_.push_back(std::thread(&JobSystem::WorkerLoop, this));
+	}
+
+	JobSystem::~JobSystem()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			stopping_ = true;
+		}
+		work_available_.notify_all();
+
+		for(std::vector<std::thread>::iterator worker = workers_.begin(); worker != workers_.end(); ++worker)
+			worker->join();
+	}
+
+	Int32 JobSystem::DefaultWorkerCount()
+	{
+		// hardware_concurrency can return 0 when the count isn't known
+		Int32 thread_count = (Int32)std::thread::hardware_concurrency();
+		return thread_count > 1 ? thread_count - 1 : 0;
+	}
+
+	void JobSystem::ParallelFor(const Int32 count, const Int32 batch_size, RangeFunction function, void* user_data)
+	{
+		if(count <= 0)
+			return;
+
+		const Int32 range_size = batch_size > 0 ? batch_size : 1;
+		const Int32 range_count = (count + range_size - 1) / range_size;
+
+		// nothing to share, so skip the locking
+		if(workers_.empty() || range_count == 1)
+		{
+			for(Int32 begin = 0; begin < count; begin += range_size)
+				function(user_data, begin, std::min(begin + range_size, count));
+			return;
+		}
+
+		Batch batch;
+		batch.function = function;
+		batch.user_data = user_data;
+		batch.count = count;
+		batch.batch_size = range_size;
+		batch.next_begin = 0;
+		batch.ranges_left = range_count;
+
+		std::unique_lock<std::mutex> lock(mutex_);
+		batches_.push_back(&batch);
+		work_available_.notify_all();
+
+		// help with the batch rather than sitting idle
+		while(batch.next_begin < batch.count)
+			RunRange(batch, lock);
+
+		while(batch.ranges_left > 0)
+			batch_done_.wait(lock);
+	}
+
+	void JobSystem::WorkerLoop()
+	{
+		std::unique_lock<std::mutex> lock(mutex_);
+		for(;;)
+		{
+			while(!stopping_ && batches_.empty())
+				work_available_.wait(lock);
+
+			if(batches_.empty())
+				return;
+
+			RunRange(*batches_.front(), lock);
+		}
+	}
+
+	void JobSystem::RunRange(Batch& batch, std::unique_lock<std::mutex>& lock)
+	{
+		const Int32 begin = batch.next_begin;
+		const Int32 end = std::min(begin + batch.batch_size, batch.count);
+		batch.next_begin = end;
+
+		// once every range has been handed out the batch leaves the queue,
+		// it stays alive until the caller has seen ranges_left reach 0
+		if(batch.next_begin >= batch.count)
+			batches_.erase(std::find(batches_.begin(), batches_.end(), &batch));
+
+		lock.unlock();
+		batch.function(batch.user_data, begin, end);
+		lock.lock();
+
+		if(--batch.ranges_left == 0)
+			batch_done_.notify_all();
+	}
+}
@@ -0,0 +1,63 @@
+#ifndef _GEF_JOB_SYSTEM_H
+#define _GEF_JOB_SYSTEM_H
+
+#include <gef.h>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace gef
+{
+	// A fixed set of worker threads that run ranges of work.
+	//
+	// ParallelFor splits [0, count) into ranges and blocks until they are all
+	// done. The calling thread runs ranges as well while it waits, so a job
+	// system with no workers runs everything on the calling thread.
+	class JobSystem
+	{
+	public:
+		// called for each range, begin is inclusive and end exclusive
+		typedef void (*RangeFunction)(void* user_data, const Int32 begin, const Int32 end);
+
+		JobSystem(const Int32 worker_count = DefaultWorkerCount());
+		~JobSystem();
+
+		// runs function over [0, count) in ranges of at most batch_size items
+		// the function is called from several threads at once, so ranges must not write to shared data
+		void ParallelFor(const Int32 count, const Int32 batch_size, RangeFunction function, void* user_data);
+
+		inline Int32 worker_count() const { return (Int32)workers_.size(); }
+
+		// one worker for each hardware thread apart from the calling one
+		static Int32 DefaultWorkerCount();
+
+	private:
+		// the ranges left to run for one ParallelFor call
+		struct Batch
+		{
+			RangeFunction function;
+			void* user_data;
+			Int32 count;
+			Int32 batch_size;
+			Int32 next_begin;
+			Int32 ranges_left;
+		};
+
+		void WorkerLoop();
+		// runs the next range of the batch, lock is held on entry and exit
+		void RunRange(Batch& batch, std::unique_lock<std::mutex>& lock);
+
+		std::vector<std::thread> workers_;
+		std::deque<Batch*> batches_;
+		std::mutex mutex_;
+		// signalled when a batch is queued or the workers should stop
+		std::condition_variable work_available_;
+		// signalled when the last range of a batch finishes
+		std::condition_variable batch_done_;
+		bool stopping_;
+	};
+}
+
+#endif // _GEF_JOB_SYSTEM_H
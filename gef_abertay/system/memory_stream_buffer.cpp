@@ -7,4 +7,21 @@ namespace gef
 		setg(buffer, buffer, buffer + size);
 		setp(buffer, buffer + size);
 	}
+
+	std::streamoff RemainingStreamSize(std::istream& stream)
+	{
+		const std::streampos position = stream.tellg();
+		if(position != std::streampos(-1))
+		{
+			stream.seekg(0, std::ios::end);
+			const std::streampos end = stream.tellg();
+			stream.seekg(position);
+			if(end != std::streampos(-1))
+				return end - position;
+			stream.clear();
+		}
+
+		const std::streamsize available = stream.rdbuf()->in_avail();
+		return available > 0 ? (std::streamoff)available : 0;
+	}
 }
@@ -1,6 +1,7 @@
 #ifndef _GEF_MEMORY_STREAM_BUFFER_H
 #define _GEF_MEMORY_STREAM_BUFFER_H
 
+#include <istream>
 #include <streambuf>
 
 namespace gef
@@ -10,6 +11,10 @@ namespace gef
 	public:
 		MemoryStreamBuffer(char* buffer, size_t size);
 	};
+
+	// the bytes left to read, from the end of the stream where it can seek and the
+	// buffered data where it can't, such as a MemoryStreamBuffer
+	std::streamoff RemainingStreamSize(std::istream& stream);
 }
 
 #endif // _GEF_MEMORY_STREAM_BUFFER_H
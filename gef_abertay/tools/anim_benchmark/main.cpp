@@ -0,0 +1,605 @@
+// Benchmark for sampling animation keys:
+//  - TransformAnimNode: finding the keys either side of the playback time with
+//    the old linear search, a binary search and a key cursor
+//  - SkeletonPose::SetPoseFromAnim: a whole skeleton sampled every frame, with
+//    and without key cursors, and with the joints bound to nodes up front
+//  - CompressedAnimation: memory, error and sampling cost of a compressed clip
+//  - AnimationUpdateSystem: a crowd of characters, each blending two clips,
+//    posed one at a time with SkeletonPose and in a batch on worker threads
+//  - BlendTree: a blend of two clips with a masked additive layer on top,
+//    counting heap allocations made while it is evaluated
+//
+// The clip is long so the cost of searching the keys shows up.
+
+#include <animation/animation.h>
+#include <animation/skeleton.h>
+#include <animation/compressed_animation.h>
+#include <animation/animation_update_system.h>
+#include <animation/animation_binding.h>
+#include <animation/blend_tree.h>
+#include <animation/pose_pool.h>
+#include <system/job_system.h>
+#include <maths/quaternion.h>
+#include <maths/vector4.h>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <vector>
+#include <new>
+
+// counts every heap allocation, so the benchmark can check code that shouldn't allocate.
+// The worker threads allocate too, so the count is atomic, and every form of new and
+// delete is replaced so each allocation is freed by the matching function
+static std::atomic<unsigned int> g_allocation_count(0);
+
+static void* CountedAllocate(size_t size)
+{
+	++g_allocation_count;
+	void* memory = malloc(size ? size : 1);
+	if (!memory)
+		throw std::bad_alloc();
+	return memory;
+}
+
+void* operator new(size_t size)
+{
+	return CountedAllocate(size);
+}
+
+void* operator new[](size_t size)
+{
+	return CountedAllocate(size);
+}
+
+void operator delete(void* memory) noexcept
+{
+	free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+	free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept
+{
+	free(memory);
+}
+
+void operator delete[](void* memory, size_t) noexcept
+{
+	free(memory);
+}
+
+namespace
+{
+	const int kNumJoints = 64;
+	// one minute at 30 keys a second
+	const int kNumKeys = 1800;
+	const float kKeyInterval = 1.0f / 30.0f;
+	// sampled at 60 frames a second
+	const float kFrameTime = 1.0f / 60.0f;
+	// characters in the crowd and the frames they are updated for
+	const int kNumCharacters = 128;
+	const int kNumCrowdFrames = 300;
+	const float kCrowdBlendWeight = 0.3f;
+
+	// stops the compiler from removing the work being timed
+	volatile float g_sink = 0.0f;
+
+	float Random(const float min_value, const float max_value)
+	{
+		return min_value + (max_value - min_value) * ((float)rand() / (float)RAND_MAX);
+	}
+
+	// the search TransformAnimNode used before key cursors, kept here for comparison
+	gef::Quaternion LinearGetRotation(const std::vector<gef::QuaternionKey>& keys, const float time)
+	{
+		gef::Quaternion result;
+		result.Identity();
+
+		const gef::QuaternionKey* prev_key = NULL;
+		const gef::QuaternionKey* next_key = NULL;
+		UInt32 key_index;
+		for (key_index = 0; key_index < keys.size(); key_index++)
+		{
+			if (keys[key_index].time > time)
+			{
+				next_key = &keys[key_index];
+				if (key_index > 0)
+					prev_key = &keys[key_index - 1];
+				break;
+			}
+		}
+
+		if (key_index == keys.size())
+			next_key = &keys[key_index - 1];
+
+		if (prev_key)
+			result.Slerp(prev_key->value, next_key->value, (time - prev_key->time) / (next_key->time - prev_key->time));
+		else if (next_key)
+			result = next_key->value;
+
+		return result;
+	}
+
+	gef::Vector4 LinearGetVector(const std::vector<gef::Vector3Key>& keys, const float time)
+	{
+		gef::Vector4 result(0.0f, 0.0f, 0.0f);
+
+		const gef::Vector3Key* prev_key = NULL;
+		const gef::Vector3Key* next_key = NULL;
+		UInt32 key_index;
+		for (key_index = 0; key_index < keys.size(); key_index++)
+		{
+			if (keys[key_index].time > time)
+			{
+				next_key = &keys[key_index];
+				if (key_index > 0)
+					prev_key = &keys[key_index - 1];
+				break;
+			}
+		}
+
+		if (key_index == keys.size())
+			next_key = &keys[key_index - 1];
+
+		if (prev_key)
+			result.Lerp(prev_key->value, next_key->value, (time - prev_key->time) / (next_key->time - prev_key->time));
+		else if (next_key)
+			result = next_key->value;
+
+		return result;
+	}
+
+	template <typename Function>
+	void Run(const char* name, const int iterations, const int num_samples, Function function)
+	{
+		// warm up caches before timing
+		function();
+
+		std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+		for (int iteration = 0; iteration < iterations; ++iteration)
+			function();
+		std::chrono::high_resolution_clock::time_point end = std::chrono::high_resolution_clock::now();
+
+		const double total_ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+		printf("%-32s %10.2f ns/joint\n", name, total_ns / ((double)iterations * num_samples));
+	}
+
+	float MaxError(const gef::Quaternion& a, const gef::Quaternion& b)
+	{
+		return fmaxf(fmaxf(fabsf(a.x - b.x), fabsf(a.y - b.y)), fmaxf(fabsf(a.z - b.z), fabsf(a.w - b.w)));
+	}
+
+	float MaxError(const gef::Vector4& a, const gef::Vector4& b)
+	{
+		return fmaxf(fmaxf(fabsf(a.x() - b.x()), fabsf(a.y() - b.y())), fabsf(a.z() - b.z()));
+	}
+
+	// q and -q are the same rotation
+	float RotationError(const gef::Quaternion& a, const gef::Quaternion& b)
+	{
+		return fminf(MaxError(a, b), MaxError(a, -b));
+	}
+
+	// the keys and nodes of an animation, not counting allocator overhead
+	UInt32 AnimationMemorySize(const gef::Animation& animation)
+	{
+		UInt32 size = sizeof(gef::Animation);
+		for (std::map<gef::StringId, gef::AnimNode*>::const_iterator anim_node_iter = animation.anim_nodes().begin(); anim_node_iter != animation.anim_nodes().end(); ++anim_node_iter)
+		{
+			const gef::TransformAnimNode* node = static_cast<const gef::TransformAnimNode*>(anim_node_iter->second);
+			// the map node holds the key, the value and three pointers
+			size += sizeof(gef::TransformAnimNode) + sizeof(gef::StringId) + sizeof(void*) * 4;
+			size += (UInt32)(node->scale_keys().size() * sizeof(gef::Vector3Key) + node->rotation_keys().size() * sizeof(gef::QuaternionKey) + node->translation_keys().size() * sizeof(gef::Vector3Key));
+		}
+		return size;
+	}
+
+	// a clip with smooth motion, like one from a modelling package, where some joints never move
+	void CreateSmoothAnimation(gef::Animation& animation)
+	{
+		for (int joint_index = 0; joint_index < kNumJoints; ++joint_index)
+		{
+			gef::TransformAnimNode* node = new gef::TransformAnimNode();
+			node->set_name_id((gef::StringId)(joint_index + 1));
+			node->rotation_keys().resize(kNumKeys);
+			node->translation_keys().resize(kNumKeys);
+			node->scale_keys().resize(kNumKeys);
+
+			const bool moving = joint_index % 4 != 3;
+			const float frequency = Random(0.2f, 2.0f);
+			const float phase = Random(0.0f, 6.28f);
+			gef::Vector4 axis(Random(-1.0f, 1.0f), Random(-1.0f, 1.0f), Random(-1.0f, 1.0f));
+			axis.Normalise();
+			const gef::Vector4 offset(Random(-1.0f, 1.0f), Random(-1.0f, 1.0f), Random(-1.0f, 1.0f));
+
+			for (int key_index = 0; key_index < kNumKeys; ++key_index)
+			{
+				const float time = key_index * kKeyInterval;
+				const float wave = moving ? sinf(time * frequency + phase) : 0.0f;
+
+				const float half_angle = wave * 0.5f;
+				gef::QuaternionKey& rotation_key = node->rotation_keys()[key_index];
+				rotation_key.value = gef::Quaternion(axis.x() * sinf(half_angle), axis.y() * sinf(half_angle), axis.z() * sinf(half_angle), cosf(half_angle));
+				rotation_key.time = time;
+
+				gef::Vector3Key& translation_key = node->translation_keys()[key_index];
+				translation_key.value = offset + gef::Vector4(0.1f, 0.2f, 0.05f) * wave;
+				translation_key.time = time;
+
+				gef::Vector3Key& scale_key = node->scale_keys()[key_index];
+				scale_key.value = gef::Vector4(1.0f, 1.0f, 1.0f);
+				scale_key.time = time;
+			}
+			animation.AddNode(node);
+		}
+		animation.CalculateDuration();
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	int iterations = 1;
+	if (argc > 1)
+		iterations = atoi(argv[1]);
+	int worker_count = gef::JobSystem::DefaultWorkerCount();
+	if (argc > 2)
+		worker_count = atoi(argv[2]);
+
+	srand(1);
+
+	// a chain of joints, each with rotation and translation keys
+	gef::Skeleton skeleton;
+	gef::Animation animation;
+	std::vector<const gef::TransformAnimNode*> nodes;
+	for (int joint_index = 0; joint_index < kNumJoints; ++joint_index)
+	{
+		gef::Joint joint;
+		joint.name_id = (gef::StringId)(joint_index + 1);
+		joint.inv_bind_pose.SetIdentity();
+		joint.parent = joint_index - 1;
+		skeleton.AddJoint(joint);
+
+		gef::TransformAnimNode* node = new gef::TransformAnimNode();
+		node->set_name_id(joint.name_id);
+		node->rotation_keys().resize(kNumKeys);
+		node->translation_keys().resize(kNumKeys);
+		for (int key_index = 0; key_index < kNumKeys; ++key_index)
+		{
+			// exported clips don't always have evenly spaced keys
+			const float time = (key_index + Random(-0.25f, 0.25f)) * kKeyInterval;
+
+			gef::QuaternionKey& rotation_key = node->rotation_keys()[key_index];
+			rotation_key.value = gef::Quaternion(Random(-1.0f, 1.0f), Random(-1.0f, 1.0f), Random(-1.0f, 1.0f), Random(-1.0f, 1.0f));
+			rotation_key.value.Normalise();
+			rotation_key.time = time;
+
+			gef::Vector3Key& translation_key = node->translation_keys()[key_index];
+			translation_key.value = gef::Vector4(Random(-1.0f, 1.0f), Random(-1.0f, 1.0f), Random(-1.0f, 1.0f));
+			translation_key.time = time;
+		}
+		animation.AddNode(node);
+		nodes.push_back(node);
+	}
+	animation.CalculateDuration();
+
+	std::vector<float> frame_times;
+	for (float time = 0.0f; time < animation.duration(); time += kFrameTime)
+		frame_times.push_back(time);
+	const int num_frames = (int)frame_times.size();
+	const int num_samples = num_frames * kNumJoints;
+
+	printf("gef animation benchmark: %d joints, %d keys, %d frames\n", kNumJoints, kNumKeys, num_frames);
+
+	// TransformAnimNode
+	Run("linear search (old)", iterations, num_samples, [&]()
+	{
+		for (int frame = 0; frame < num_frames; ++frame)
+		{
+			for (int joint_index = 0; joint_index < kNumJoints; ++joint_index)
+			{
+				g_sink += LinearGetRotation(nodes[joint_index]->rotation_keys(), frame_times[frame]).w;
+				g_sink += LinearGetVector(nodes[joint_index]->translation_keys(), frame_times[frame]).x();
+			}
+		}
+	});
+
+	Run("binary search", iterations, num_samples, [&]()
+	{
+		for (int frame = 0; frame < num_frames; ++frame)
+		{
+			for (int joint_index = 0; joint_index < kNumJoints; ++joint_index)
+			{
+				g_sink += nodes[joint_index]->GetRotation(frame_times[frame]).w;
+				g_sink += nodes[joint_index]->GetTranslation(frame_times[frame]).x();
+			}
+		}
+	});
+
+	std::vector<gef::TransformAnimCursor> cursors(kNumJoints);
+	Run("key cursor", iterations, num_samples, [&]()
+	{
+		for (int frame = 0; frame < num_frames; ++frame)
+		{
+			for (int joint_index = 0; joint_index < kNumJoints; ++joint_index)
+			{
+				g_sink += nodes[joint_index]->GetRotation(frame_times[frame], cursors[joint_index]).w;
+				g_sink += nodes[joint_index]->GetTranslation(frame_times[frame], cursors[joint_index]).x();
+			}
+		}
+	});
+
+	// SkeletonPose
+	gef::SkeletonPose bind_pose;
+	bind_pose.CreateBindPose(&skeleton);
+	gef::SkeletonPose pose = bind_pose;
+
+	Run("SetPoseFromAnim", iterations, num_samples, [&]()
+	{
+		for (int frame = 0; frame < num_frames; ++frame)
+			pose.SetPoseFromAnim(animation, bind_pose, frame_times[frame], false);
+		g_sink += pose.local_pose()[kNumJoints - 1].translation().x();
+	});
+
+	std::vector<gef::TransformAnimCursor> pose_cursors;
+	Run("SetPoseFromAnim with cursors", iterations, num_samples, [&]()
+	{
+		for (int frame = 0; frame < num_frames; ++frame)
+			pose.SetPoseFromAnim(animation, bind_pose, frame_times[frame], pose_cursors, false);
+		g_sink += pose.local_pose()[kNumJoints - 1].translation().x();
+	});
+
+	gef::AnimationBindingCache binding_cache;
+	const gef::AnimationBinding& binding = binding_cache.GetBinding(skeleton, animation);
+	std::vector<gef::TransformAnimCursor> binding_cursors;
+	gef::SkeletonPose bound_pose = bind_pose;
+	Run("SetPoseFromAnim with binding", iterations, num_samples, [&]()
+	{
+		for (int frame = 0; frame < num_frames; ++frame)
+			bound_pose.SetPoseFromAnim(binding, bind_pose, frame_times[frame], binding_cursors, false);
+		g_sink += bound_pose.local_pose()[kNumJoints - 1].translation().x();
+	});
+
+	// the tip of the chain, so every joint's transform is looked up
+	const int num_tip_samples = 200;
+	Run("GetGlobalJointTransformFromAnim", iterations, num_tip_samples * kNumJoints, [&]()
+	{
+		for (int sample = 0; sample < num_tip_samples; ++sample)
+			g_sink += gef::SkeletonPose::GetGlobalJointTransformFromAnim(&animation, bind_pose, frame_times[sample], kNumJoints - 1).GetTranslation().x();
+	});
+
+	Run("  ... with binding", iterations, num_tip_samples * kNumJoints, [&]()
+	{
+		for (int sample = 0; sample < num_tip_samples; ++sample)
+			g_sink += gef::SkeletonPose::GetGlobalJointTransformFromAnim(binding, bind_pose, frame_times[sample], kNumJoints - 1).GetTranslation().x();
+	});
+
+	// a binding must pose the skeleton the same as looking up the nodes
+	float max_binding_error = 0.0f;
+	for (int joint_index = 0; joint_index < kNumJoints; ++joint_index)
+	{
+		max_binding_error = fmaxf(max_binding_error, MaxError(bound_pose.local_pose()[joint_index].rotation(), pose.local_pose()[joint_index].rotation()));
+		max_binding_error = fmaxf(max_binding_error, MaxError(bound_pose.local_pose()[joint_index].translation(), pose.local_pose()[joint_index].translation()));
+	}
+	for (int row = 0; row < 4; ++row)
+	{
+		const float tip_time = frame_times[num_tip_samples / 2];
+		max_binding_error = fmaxf(max_binding_error, MaxError(gef::SkeletonPose::GetGlobalJointTransformFromAnim(binding, bind_pose, tip_time, kNumJoints - 1).GetRow(row),
+			gef::SkeletonPose::GetGlobalJointTransformFromAnim(&animation, bind_pose, tip_time, kNumJoints - 1).GetRow(row)));
+	}
+	printf("max |binding - FindNode| = %g\n", max_binding_error);
+
+	// every way of finding the keys must give the same result as the linear search,
+	// including times outside the clip and a cursor that jumps about
+	float max_error = 0.0f;
+	gef::TransformAnimCursor cursor;
+	for (int sample = 0; sample < 100000; ++sample)
+	{
+		const gef::TransformAnimNode* node = nodes[sample % kNumJoints];
+		const float time = sample < 50000 ? sample * 0.001f - 1.0f : Random(-1.0f, animation.duration() + 1.0f);
+
+		const gef::Quaternion expected_rotation = LinearGetRotation(node->rotation_keys(), time);
+		const gef::Vector4 expected_translation = LinearGetVector(node->translation_keys(), time);
+		max_error = fmaxf(max_error, MaxError(node->GetRotation(time), expected_rotation));
+		max_error = fmaxf(max_error, MaxError(node->GetRotation(time, cursor), expected_rotation));
+		max_error = fmaxf(max_error, MaxError(node->GetTranslation(time), expected_translation));
+		max_error = fmaxf(max_error, MaxError(node->GetTranslation(time, cursor), expected_translation));
+	}
+	printf("max |sampled - linear search| = %g\n", max_error);
+
+	// CompressedAnimation
+	gef::Animation smooth_animation;
+	CreateSmoothAnimation(smooth_animation);
+
+	gef::CompressedAnimation::Settings settings;
+	gef::CompressedAnimation compressed;
+	std::chrono::high_resolution_clock::time_point compress_start = std::chrono::high_resolution_clock::now();
+	compressed.Compress(smooth_animation, settings);
+	std::chrono::high_resolution_clock::time_point compress_end = std::chrono::high_resolution_clock::now();
+
+	// the clip must come back the same after writing and reading it
+	std::stringstream clip_stream;
+	compressed.Write(clip_stream);
+	gef::CompressedAnimation read_back;
+	const bool read_ok = read_back.Read(clip_stream) && read_back.key_count() == compressed.key_count();
+
+	printf("compressed clip: %u keys to %u keys, %u bytes to %u bytes (%.1fx), compressed in %.1f ms\n",
+		(UInt32)(kNumJoints * kNumKeys * 3), compressed.key_count(), AnimationMemorySize(smooth_animation), compressed.memory_size(),
+		(double)AnimationMemorySize(smooth_animation) / compressed.memory_size(),
+		std::chrono::duration_cast<std::chrono::microseconds>(compress_end - compress_start).count() / 1000.0);
+
+	gef::CompressedAnimation random_compressed;
+	random_compressed.Compress(animation, settings);
+	printf("compressed random clip: %u bytes to %u bytes (%.1fx)\n", AnimationMemorySize(animation), random_compressed.memory_size(),
+		(double)AnimationMemorySize(animation) / random_compressed.memory_size());
+
+	std::vector<Int32> joint_tracks;
+	read_back.BindSkeleton(skeleton, joint_tracks);
+
+	std::vector<gef::TransformAnimCursor> smooth_cursors;
+	Run("SetPoseFromAnim (smooth clip)", iterations, num_samples, [&]()
+	{
+		for (int frame = 0; frame < num_frames; ++frame)
+			pose.SetPoseFromAnim(smooth_animation, bind_pose, frame_times[frame], smooth_cursors, false);
+		g_sink += pose.local_pose()[kNumJoints - 1].translation().x();
+	});
+
+	std::vector<gef::TransformAnimCursor> compressed_cursors;
+	Run("compressed SamplePose", iterations, num_samples, [&]()
+	{
+		for (int frame = 0; frame < num_frames; ++frame)
+			read_back.SamplePose(joint_tracks, bind_pose, frame_times[frame], compressed_cursors, pose, false);
+		g_sink += pose.local_pose()[kNumJoints - 1].translation().x();
+	});
+
+	// compare with the full clip at times between the keys
+	float max_rotation_error = 0.0f;
+	float max_translation_error = 0.0f;
+	for (int sample = 0; sample < 100000; ++sample)
+	{
+		const int joint_index = sample % kNumJoints;
+		const float time = Random(0.0f, smooth_animation.duration());
+		const gef::TransformAnimNode* node = static_cast<const gef::TransformAnimNode*>(smooth_animation.FindNode((gef::StringId)(joint_index + 1)));
+		gef::TransformAnimCursor cursor;
+		max_rotation_error = fmaxf(max_rotation_error, RotationError(read_back.GetRotation(joint_tracks[joint_index], time, cursor), node->GetRotation(time)));
+		max_translation_error = fmaxf(max_translation_error, MaxError(read_back.GetTranslation(joint_tracks[joint_index], time, cursor), node->GetTranslation(time)));
+	}
+	printf("max compressed error: rotation %g, translation %g\n", max_rotation_error, max_translation_error);
+
+	// the tolerances plus a little for quantising the values and key times
+	const bool compressed_ok = read_ok && max_rotation_error < settings.rotation_tolerance * 2.0f && max_translation_error < settings.translation_tolerance * 2.0f;
+
+	// AnimationUpdateSystem
+	// each character plays both clips from a different start time and blends between them
+	const int num_crowd_samples = kNumCrowdFrames * kNumCharacters * kNumJoints;
+	std::vector<gef::SkeletonPose> start_poses(kNumCharacters, bind_pose);
+	std::vector<gef::SkeletonPose> end_poses(kNumCharacters, bind_pose);
+	std::vector<gef::SkeletonPose> blended_poses(kNumCharacters, bind_pose);
+	std::vector<std::vector<gef::TransformAnimCursor> > start_cursors(kNumCharacters);
+	std::vector<std::vector<gef::TransformAnimCursor> > end_cursors(kNumCharacters);
+	std::vector<gef::Matrix44> crowd_bone_matrices(kNumCharacters * kNumJoints);
+
+	Run("crowd with SkeletonPose", iterations, num_crowd_samples, [&]()
+	{
+		for (int frame = 0; frame < kNumCrowdFrames; ++frame)
+		{
+			for (int character = 0; character < kNumCharacters; ++character)
+			{
+				const float time = frame_times[frame] + character * 0.1f;
+				start_poses[character].SetPoseFromAnim(animation, bind_pose, time, start_cursors[character], false);
+				end_poses[character].SetPoseFromAnim(smooth_animation, bind_pose, time, end_cursors[character], false);
+				blended_poses[character].Linear2PoseBlend(start_poses[character], end_poses[character], kCrowdBlendWeight);
+				for (int joint_index = 0; joint_index < kNumJoints; ++joint_index)
+					crowd_bone_matrices[character * kNumJoints + joint_index] = skeleton.joint(joint_index).inv_bind_pose * blended_poses[character].global_pose()[joint_index];
+			}
+		}
+	});
+
+	gef::JobSystem job_system(worker_count);
+	gef::AnimationUpdateSystem serial_update_system;
+	gef::AnimationUpdateSystem parallel_update_system(&job_system);
+	gef::AnimationUpdateSystem* update_systems[2] = { &serial_update_system, &parallel_update_system };
+	for (int system_num = 0; system_num < 2; ++system_num)
+	{
+		for (int character = 0; character < kNumCharacters; ++character)
+		{
+			const Int32 instance = update_systems[system_num]->AddInstance(bind_pose);
+			update_systems[system_num]->SetClip(instance, 0, &animation);
+			update_systems[system_num]->SetClip(instance, 1, &smooth_animation);
+			update_systems[system_num]->SetBlendWeight(instance, kCrowdBlendWeight);
+		}
+	}
+
+	char parallel_name[64];
+	sprintf(parallel_name, "crowd batched, %d workers", job_system.worker_count());
+	const char* update_system_names[2] = { "crowd batched, no workers", parallel_name };
+	for (int system_num = 0; system_num < 2; ++system_num)
+	{
+		gef::AnimationUpdateSystem& update_system = *update_systems[system_num];
+		Run(update_system_names[system_num], iterations, num_crowd_samples, [&]()
+		{
+			for (int frame = 0; frame < kNumCrowdFrames; ++frame)
+			{
+				for (int character = 0; character < kNumCharacters; ++character)
+				{
+					const float time = frame_times[frame] + character * 0.1f;
+					update_system.SetTime(character, 0, time);
+					update_system.SetTime(character, 1, time);
+				}
+				update_system.Update();
+			}
+			g_sink += update_system.skinning_matrices(kNumCharacters - 1)[kNumJoints - 1].GetTranslation().x();
+		});
+	}
+
+	// the batches must give the same bone matrices as posing each character with SkeletonPose
+	float max_crowd_error = 0.0f;
+	for (int system_num = 0; system_num < 2; ++system_num)
+	{
+		for (int character = 0; character < kNumCharacters; ++character)
+		{
+			const gef::Matrix44* skinning_matrices = update_systems[system_num]->skinning_matrices(character);
+			for (int joint_index = 0; joint_index < kNumJoints; ++joint_index)
+			{
+				for (int row = 0; row < 4; ++row)
+					max_crowd_error = fmaxf(max_crowd_error, MaxError(skinning_matrices[joint_index].GetRow(row), crowd_bone_matrices[character * kNumJoints + joint_index].GetRow(row)));
+			}
+		}
+	}
+	printf("max |batched - SkeletonPose| = %g\n", max_crowd_error);
+
+	// BlendTree
+	// the two clips blended, with the smooth clip added to the second half of the chain
+	gef::BlendTree blend_tree(bind_pose);
+	const gef::AnimationBinding& smooth_binding = binding_cache.GetBinding(skeleton, smooth_animation);
+	const Int32 random_clip = blend_tree.AddClip(binding);
+	const Int32 smooth_clip = blend_tree.AddClip(smooth_binding);
+	const Int32 locomotion = blend_tree.AddBlend();
+	blend_tree.AddBlendInput(locomotion, random_clip, 0.7f);
+	blend_tree.AddBlendInput(locomotion, smooth_clip, 0.3f);
+	const Int32 additive_clip = blend_tree.AddClip(smooth_binding);
+	blend_tree.SetClipTime(additive_clip, 1.0f);
+	blend_tree.AddAdditive(locomotion, additive_clip, gef::BlendTree::kBindPose, blend_tree.AddJointMask((gef::StringId)(kNumJoints / 2 + 1)));
+
+	gef::PosePool pose_pool;
+	pose_pool.Init(kNumJoints, blend_tree.PoolPosesNeeded());
+	gef::SkeletonPose tree_pose = bind_pose;
+
+	const unsigned int tree_allocation_start = g_allocation_count;
+	Run("BlendTree::Evaluate", iterations, num_samples, [&]()
+	{
+		for (int frame = 0; frame < num_frames; ++frame)
+		{
+			pose_pool.Reset();
+			blend_tree.Update(kFrameTime);
+			blend_tree.Evaluate(pose_pool, tree_pose);
+		}
+		g_sink += tree_pose.global_pose()[kNumJoints - 1].GetTranslation().x();
+	});
+	const unsigned int tree_allocations = g_allocation_count - tree_allocation_start;
+	printf("blend tree: %d pool poses, %u heap allocations in %d evaluations\n", pose_pool.peak_used(), tree_allocations, (iterations + 1) * num_frames);
+
+	// a tree with one clip must give the same pose as SetPoseFromAnim
+	gef::BlendTree clip_tree(bind_pose);
+	const Int32 tree_clip = clip_tree.AddClip(binding);
+	clip_tree.SetClipTime(tree_clip, frame_times[num_frames / 2]);
+	pose_pool.Reset();
+	clip_tree.Evaluate(pose_pool, tree_pose);
+	pose.SetPoseFromAnim(animation, bind_pose, frame_times[num_frames / 2]);
+	float max_tree_error = 0.0f;
+	for (int joint_index = 0; joint_index < kNumJoints; ++joint_index)
+	{
+		for (int row = 0; row < 4; ++row)
+			max_tree_error = fmaxf(max_tree_error, MaxError(tree_pose.global_pose()[joint_index].GetRow(row), pose.global_pose()[joint_index].GetRow(row)));
+	}
+	printf("max |blend tree clip - SetPoseFromAnim| = %g\n", max_tree_error);
+
+	const bool tree_ok = tree_allocations == 0 && pose_pool.overflow_count() == 0 && max_tree_error == 0.0f;
+
+	return max_error == 0.0f && max_binding_error == 0.0f && compressed_ok && max_crowd_error == 0.0f && tree_ok ? 0 : 1;
+}
@@ -1,6 +1,8 @@
 #include <platform/win32/system/platform_win32_null_renderer.h>
 #include "fbx_loader.h"
 #include <graphics/scene.h>
+#include <animation/animation.h>
+#include <animation/compressed_animation.h>
 #include <iostream>
 
 
@@ -13,6 +15,10 @@ int main(int argc, char* argv[])
 	char* output_filename = "output.scn";
 	char* input_filename = "";
 	bool animation_only = false;
+	bool compress_animations = false;
+	// 2 writes the layout that is mapped into memory and used in place
+	int scene_version = 1;
+	gef::CompressedAnimation::Settings compression_settings;
 
 
 	gef::FBXLoader fbx_loader;
@@ -127,6 +133,27 @@ int main(int argc, char* argv[])
 				}
 				break;
 
+			case 'c':
+				if(stricmp(&argv[arg_num][1], "compress-animations") == 0)
+				{
+					compress_animations = true;
+				}
+				break;
+
+			case 'k':
+				if(stricmp(&argv[arg_num][1], "key-tolerance") == 0)
+				{
+					// the largest error allowed when keys are removed from compressed animations
+					float key_tolerance = atof(argv[arg_num + 1]);
+					if (key_tolerance > 0.0f)
+					{
+						compression_settings.rotation_tolerance = key_tolerance;
+						compression_settings.translation_tolerance = key_tolerance;
+						compression_settings.scale_tolerance = key_tolerance;
+					}
+				}
+				break;
+
 			case 'e':
 				if(stricmp(&argv[arg_num][1], "enable-skinning") == 0)
 				{
@@ -145,6 +172,11 @@ int main(int argc, char* argv[])
 					if (scaling_factor != 0.0f)
 						fbx_loader.set_scaling_factor(scaling_factor);
 				}
+				else if (stricmp(&argv[arg_num][1], "scene-version") == 0)
+				{
+					if (arg_num < argc - 2)
+						scene_version = atoi(argv[arg_num + 1]) == 2 ? 2 : 1;
+				}
 				break;
 
 			case 't':
@@ -166,7 +198,7 @@ int main(int argc, char* argv[])
 	std::cout << std::endl << "FBX to Abertay Framework Scene Builder v0.01" << std::endl << std::endl;;
 
 	std::cout << "input file: " << input_filename << std::endl;
-	std::cout << "output file: " << output_filename << std::endl << std::endl;;
+	std::cout << "output file: " << output_filename << " (version " << scene_version << ")" << std::endl << std::endl;;
 
 
 	std::cout << "Loading file: " << input_filename << std::endl;
@@ -175,8 +207,35 @@ int main(int argc, char* argv[])
 	if(success)
 	{
 		std::cout << "file: " << input_filename << " loaded." << std::endl << std::endl;
+
+		if(compress_animations)
+		{
+			// replace every animation with its compressed version
+			for(std::map<gef::StringId, gef::Animation*>::iterator animation_iter = scene->animations.begin(); animation_iter != scene->animations.end(); ++animation_iter)
+			{
+				gef::CompressedAnimation* compressed_animation = new gef::CompressedAnimation();
+				compressed_animation->Compress(*animation_iter->second, compression_settings);
+				scene->compressed_animations[animation_iter->first] = compressed_animation;
+
+				UInt32 num_keys = 0;
+				for(std::map<gef::StringId, gef::AnimNode*>::const_iterator anim_node_iter = animation_iter->second->anim_nodes().begin(); anim_node_iter != animation_iter->second->anim_nodes().end(); ++anim_node_iter)
+				{
+					if(anim_node_iter->second->type() == gef::AnimNode::kTransform)
+					{
+						const gef::TransformAnimNode* transform_node = static_cast<const gef::TransformAnimNode*>(anim_node_iter->second);
+						num_keys += (UInt32)(transform_node->rotation_keys().size() + transform_node->translation_keys().size() + transform_node->scale_keys().size());
+					}
+				}
+				std::cout << "Compressed animation: " << num_keys << " keys to " << compressed_animation->key_count() << " keys, " << compressed_animation->memory_size() << " bytes" << std::endl;
+
+				delete animation_iter->second;
+			}
+			scene->animations.clear();
+			std::cout << std::endl;
+		}
+
 		std::cout << "Writing output file: " << output_filename << std::endl;
-		success = scene->WriteSceneToFile(platform, output_filename);
+		success = scene->WriteSceneToFile(platform, output_filename, scene_version);
 		if(success)
 			std::cout << "Success." << std::endl;
 		else
@@ -0,0 +1,220 @@
+// Micro-benchmark for the maths that runs every frame:
+//  - Renderer3D: world view projection products, normal matrix inverses and
+//    transposes, view space positions for the render queue, inverses of
+//    rigid instance transforms
+//  - SkeletonPose: joint transform blends and local to global products
+//  - GameObject::UpdateFromSimulation: rotation and translation from a body
+//
+// Build it with and without GEF_NO_SIMD to compare the SIMD and scalar code.
+
+#include <maths/matrix44.h>
+#include <maths/vector4.h>
+#include <maths/quaternion.h>
+#include <maths/transform.h>
+#include <maths/simd.h>
+#include <graphics/mesh_instance.h>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <vector>
+
+namespace
+{
+	const int kNumItems = 1024;
+
+	// stops the compiler from removing the work being timed
+	volatile float g_sink = 0.0f;
+
+	float Random(const float min_value, const float max_value)
+	{
+		return min_value + (max_value - min_value) * ((float)rand() / (float)RAND_MAX);
+	}
+
+	gef::Quaternion RandomRotation()
+	{
+		gef::Quaternion rotation(Random(-1.0f, 1.0f), Random(-1.0f, 1.0f), Random(-1.0f, 1.0f), Random(-1.0f, 1.0f));
+		rotation.Normalise();
+		return rotation;
+	}
+
+	gef::Matrix44 RandomTransform()
+	{
+		gef::Transform transform;
+		transform.set_rotation(RandomRotation());
+		transform.set_scale(gef::Vector4(Random(0.5f, 2.0f), Random(0.5f, 2.0f), Random(0.5f, 2.0f)));
+		transform.set_translation(gef::Vector4(Random(-10.0f, 10.0f), Random(-10.0f, 10.0f), Random(-10.0f, 10.0f)));
+		return transform.GetMatrix();
+	}
+
+	template <typename Function>
+	void Run(const char* name, const int iterations, Function function)
+	{
+		// warm up caches before timing
+		function();
+
+		std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+		for (int iteration = 0; iteration < iterations; ++iteration)
+			function();
+		std::chrono::high_resolution_clock::time_point end = std::chrono::high_resolution_clock::now();
+
+		const double total_ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+		printf("%-32s %8.2f ns/op\n", name, total_ns / ((double)iterations * kNumItems));
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	int iterations = 2000;
+	if (argc > 1)
+		iterations = atoi(argv[1]);
+
+	srand(1);
+
+	std::vector<gef::Matrix44> matrices(kNumItems), other_matrices(kNumItems), results(kNumItems);
+	std::vector<gef::Vector4> positions(kNumItems), transformed(kNumItems);
+	std::vector<gef::Transform> start_poses(kNumItems), end_poses(kNumItems), blended(kNumItems);
+	std::vector<gef::Matrix44> rigid_matrices(kNumItems);
+	std::vector<float> angles(kNumItems);
+	for (int i = 0; i < kNumItems; ++i)
+	{
+		matrices[i] = RandomTransform();
+		other_matrices[i] = RandomTransform();
+		positions[i] = gef::Vector4(Random(-10.0f, 10.0f), Random(-10.0f, 10.0f), Random(-10.0f, 10.0f));
+		start_poses[i] = gef::Transform(matrices[i]);
+		end_poses[i] = gef::Transform(other_matrices[i]);
+		angles[i] = Random(-3.14f, 3.14f);
+		rigid_matrices[i].Rotation(RandomRotation());
+		rigid_matrices[i].SetTranslation(positions[i]);
+	}
+
+	gef::Matrix44 view_projection = RandomTransform();
+
+#if defined(GEF_SIMD_SSE)
+	printf("gef maths benchmark: SSE\n");
+#elif defined(GEF_SIMD_NEON)
+	printf("gef maths benchmark: NEON\n");
+#else
+	printf("gef maths benchmark: scalar\n");
+#endif
+
+	// Renderer3D
+	Run("Matrix44::operator*", iterations, [&]()
+	{
+		for (int i = 0; i < kNumItems; ++i)
+			results[i] = matrices[i] * view_projection;
+		g_sink += results[kNumItems - 1].m(3, 3);
+	});
+
+	Run("Matrix44::Inverse", iterations, [&]()
+	{
+		for (int i = 0; i < kNumItems; ++i)
+			results[i].Inverse(matrices[i]);
+		g_sink += results[kNumItems - 1].m(3, 3);
+	});
+
+	Run("MeshInstance inverse (rigid)", iterations, [&]()
+	{
+		for (int i = 0; i < kNumItems; ++i)
+			gef::MeshInstance::CalculateInverseTransform(rigid_matrices[i], gef::MeshInstance::kRigid, results[i]);
+		g_sink += results[kNumItems - 1].m(3, 3);
+	});
+
+	Run("Matrix44::Transpose", iterations, [&]()
+	{
+		for (int i = 0; i < kNumItems; ++i)
+			results[i].Transpose(matrices[i]);
+		g_sink += results[kNumItems - 1].m(3, 3);
+	});
+
+	Run("Vector4::Transform", iterations, [&]()
+	{
+		for (int i = 0; i < kNumItems; ++i)
+			transformed[i] = positions[i].Transform(matrices[i]);
+		g_sink += transformed[kNumItems - 1].z();
+	});
+
+	// SkeletonPose
+	Run("Transform::Linear2TransformBlend", iterations, [&]()
+	{
+		for (int i = 0; i < kNumItems; ++i)
+			blended[i].Linear2TransformBlend(start_poses[i], end_poses[i], 0.3f);
+		g_sink += blended[kNumItems - 1].rotation().w;
+	});
+
+	Run("Transform::GetMatrix", iterations, [&]()
+	{
+		for (int i = 0; i < kNumItems; ++i)
+			results[i] = start_poses[i].GetMatrix();
+		g_sink += results[kNumItems - 1].m(3, 3);
+	});
+
+	Run("global pose product", iterations, [&]()
+	{
+		// each joint relative to the one before, as in CalculateGlobalPose
+		results[0] = matrices[0];
+		for (int i = 1; i < kNumItems; ++i)
+			results[i] = matrices[i] * results[i - 1];
+		g_sink += results[kNumItems - 1].m(3, 3);
+	});
+
+	// GameObject::UpdateFromSimulation
+	Run("UpdateFromSimulation", iterations, [&]()
+	{
+		for (int i = 0; i < kNumItems; ++i)
+		{
+			gef::Matrix44 object_rotation;
+			object_rotation.RotationZ(angles[i]);
+			object_rotation.SetTranslation(positions[i]);
+			results[i] = object_rotation;
+		}
+		g_sink += results[kNumItems - 1].m(3, 0);
+	});
+
+	// check the inverse against the identity so a broken SIMD path shows up here
+	float max_error = 0.0f;
+	for (int i = 0; i < kNumItems; ++i)
+	{
+		gef::Matrix44 inverse;
+		inverse.Inverse(matrices[i]);
+		const gef::Matrix44 identity = matrices[i] * inverse;
+		for (int row = 0; row < 4; ++row)
+		{
+			for (int column = 0; column < 4; ++column)
+			{
+				const float error = fabsf(identity.m(row, column) - (row == column ? 1.0f : 0.0f));
+				if (error > max_error)
+					max_error = error;
+			}
+		}
+	}
+	printf("max |M * inverse(M) - I| = %g\n", max_error);
+
+	// the cheap inverses must match the full one
+	float max_kind_error = 0.0f;
+	for (int i = 0; i < kNumItems; ++i)
+	{
+		gef::Matrix44 uniform_scale;
+		uniform_scale.Scale(gef::Vector4(2.5f, 2.5f, 2.5f));
+		uniform_scale = uniform_scale * rigid_matrices[i];
+
+		gef::Matrix44 expected_rigid, expected_uniform, rigid, uniform;
+		expected_rigid.Inverse(rigid_matrices[i]);
+		expected_uniform.Inverse(uniform_scale);
+		gef::MeshInstance::CalculateInverseTransform(rigid_matrices[i], gef::MeshInstance::kRigid, rigid);
+		gef::MeshInstance::CalculateInverseTransform(uniform_scale, gef::MeshInstance::kUniformScale, uniform);
+		for (int row = 0; row < 4; ++row)
+		{
+			for (int column = 0; column < 4; ++column)
+			{
+				const float error = fmaxf(fabsf(rigid.m(row, column) - expected_rigid.m(row, column)), fabsf(uniform.m(row, column) - expected_uniform.m(row, column)));
+				if (error > max_kind_error)
+					max_kind_error = error;
+			}
+		}
+	}
+	printf("max |rigid and uniform scale inverse - Inverse| = %g\n", max_kind_error);
+
+	return max_error < 1.0e-3f && max_kind_error < 1.0e-3f ? 0 : 1;
+}
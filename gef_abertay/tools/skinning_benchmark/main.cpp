@@ -0,0 +1,197 @@
+// Benchmark for skinning vertices on the CPU with CpuSkinner:
+//  - the way the skinning shaders do it, transforming by every bone and
+//    adding up the results, kept here for reference
+//  - CpuSkinner on the calling thread
+//  - CpuSkinner with the vertices spread over worker threads
+//
+// Every result is checked against the reference.
+
+#include <graphics/cpu_skinning.h>
+#include <graphics/mesh.h>
+#include <system/job_system.h>
+#include <maths/matrix44.h>
+#include <maths/quaternion.h>
+#include <maths/vector4.h>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+	const int kNumBones = 64;
+	// about the size of a detailed character
+	const int kNumVertices = 20000;
+	const int kNumFrames = 60;
+
+	// stops the compiler from removing the work being timed
+	volatile float g_sink = 0.0f;
+
+	float Random(const float min_value, const float max_value)
+	{
+		return min_value + (max_value - min_value) * ((float)rand() / (float)RAND_MAX);
+	}
+
+	// the sum of the vertex transformed by each bone, as the skinning shaders do it
+	void ReferenceSkin(const std::vector<gef::Mesh::SkinnedVertex>& vertices, const std::vector<gef::Matrix44>& bone_matrices, std::vector<gef::Vector4>& positions, std::vector<gef::Vector4>& normals)
+	{
+		for (size_t vertex_num = 0; vertex_num < vertices.size(); ++vertex_num)
+		{
+			const gef::Mesh::SkinnedVertex& vertex = vertices[vertex_num];
+			gef::Vector4 position(0.0f, 0.0f, 0.0f, 0.0f);
+			gef::Vector4 normal(0.0f, 0.0f, 0.0f, 0.0f);
+			for (int influence = 0; influence < 4; ++influence)
+			{
+				const gef::Matrix44& bone_matrix = bone_matrices[vertex.bone_indices[influence]];
+				const float weight = vertex.bone_weights[influence];
+				position += gef::Vector4(vertex.px, vertex.py, vertex.pz, 1.0f).TransformW(bone_matrix) * weight;
+				normal += gef::Vector4(vertex.nx, vertex.ny, vertex.nz, 0.0f).TransformW(bone_matrix) * weight;
+			}
+			normal.Normalise();
+			positions[vertex_num] = position;
+			normals[vertex_num] = normal;
+		}
+	}
+
+	template <typename Function>
+	void Run(const char* name, const int iterations, Function function)
+	{
+		// warm up caches before timing
+		function();
+
+		std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+		for (int iteration = 0; iteration < iterations; ++iteration)
+			function();
+		std::chrono::high_resolution_clock::time_point end = std::chrono::high_resolution_clock::now();
+
+		const double total_ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+		const double num_vertices = (double)iterations * kNumFrames * kNumVertices;
+		printf("%-32s %10.2f ns/vertex %10.2f Mvertices/s\n", name, total_ns / num_vertices, num_vertices * 1000.0 / total_ns);
+	}
+
+	// the reference only works out x, y and z
+	float MaxError(const std::vector<gef::Vector4>& a, const std::vector<gef::Vector4>& b)
+	{
+		float max_error = 0.0f;
+		for (size_t i = 0; i < a.size(); ++i)
+		{
+			max_error = std::max(max_error, std::fabs(a[i].x() - b[i].x()));
+			max_error = std::max(max_error, std::fabs(a[i].y() - b[i].y()));
+			max_error = std::max(max_error, std::fabs(a[i].z() - b[i].z()));
+		}
+		return max_error;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	int iterations = 1;
+	if (argc > 1)
+		iterations = atoi(argv[1]);
+	int worker_count = gef::JobSystem::DefaultWorkerCount();
+	if (argc > 2)
+		worker_count = atoi(argv[2]);
+
+	srand(1);
+
+	// vertices with up to four influences, weights normalised the same as Scene::FixUpSkinWeights
+	std::vector<gef::Mesh::SkinnedVertex> vertices(kNumVertices);
+	for (int vertex_num = 0; vertex_num < kNumVertices; ++vertex_num)
+	{
+		gef::Mesh::SkinnedVertex& vertex = vertices[vertex_num];
+		vertex.px = Random(-1.0f, 1.0f);
+		vertex.py = Random(0.0f, 2.0f);
+		vertex.pz = Random(-1.0f, 1.0f);
+		gef::Vector4 normal(Random(-1.0f, 1.0f), Random(-1.0f, 1.0f), Random(-1.0f, 1.0f));
+		normal.Normalise();
+		vertex.nx = normal.x();
+		vertex.ny = normal.y();
+		vertex.nz = normal.z();
+		vertex.u = vertex.v = 0.0f;
+
+		const int num_influences = 1 + rand() % 4;
+		float total_weight = 0.0f;
+		for (int influence = 0; influence < 4; ++influence)
+		{
+			vertex.bone_indices[influence] = (UInt8)(rand() % kNumBones);
+			vertex.bone_weights[influence] = influence < num_influences ? Random(0.1f, 1.0f) : 0.0f;
+			total_weight += vertex.bone_weights[influence];
+		}
+		for (int influence = 0; influence < 4; ++influence)
+			vertex.bone_weights[influence] /= total_weight;
+	}
+
+	// a palette for each frame, rigid transforms like inv_bind_pose * global_pose
+	std::vector<std::vector<gef::Matrix44> > palettes(kNumFrames, std::vector<gef::Matrix44>(kNumBones));
+	for (int frame = 0; frame < kNumFrames; ++frame)
+	{
+		for (int bone = 0; bone < kNumBones; ++bone)
+		{
+			gef::Quaternion rotation(Random(-1.0f, 1.0f), Random(-1.0f, 1.0f), Random(-1.0f, 1.0f), Random(-1.0f, 1.0f));
+			rotation.Normalise();
+			palettes[frame][bone].Rotation(rotation);
+			palettes[frame][bone].SetTranslation(gef::Vector4(Random(-1.0f, 1.0f), Random(-1.0f, 1.0f), Random(-1.0f, 1.0f)));
+		}
+	}
+
+	gef::JobSystem job_system(worker_count);
+	printf("gef skinning benchmark: %d vertices, %d bones, %d frames, %d workers\n", kNumVertices, kNumBones, kNumFrames, job_system.worker_count());
+
+	std::vector<gef::Vector4> reference_positions(kNumVertices), reference_normals(kNumVertices);
+	std::vector<gef::Vector4> positions(kNumVertices), normals(kNumVertices);
+
+	Run("reference (per bone)", iterations, [&]()
+	{
+		for (int frame = 0; frame < kNumFrames; ++frame)
+			ReferenceSkin(vertices, palettes[frame], reference_positions, reference_normals);
+		g_sink += reference_positions[kNumVertices - 1].x();
+	});
+
+	gef::CpuSkinner skinner;
+	Run("CpuSkinner, no workers", iterations, [&]()
+	{
+		for (int frame = 0; frame < kNumFrames; ++frame)
+			skinner.Skin(&vertices.front(), kNumVertices, &palettes[frame].front(), kNumBones, &positions.front(), &normals.front());
+		g_sink += positions[kNumVertices - 1].x();
+	});
+
+	Run("CpuSkinner, positions only", iterations, [&]()
+	{
+		for (int frame = 0; frame < kNumFrames; ++frame)
+			skinner.Skin(&vertices.front(), kNumVertices, &palettes[frame].front(), kNumBones, &positions.front(), NULL);
+		g_sink += positions[kNumVertices - 1].x();
+	});
+
+	gef::CpuSkinner parallel_skinner(&job_system);
+	char parallel_name[64];
+	sprintf(parallel_name, "CpuSkinner, %d workers", job_system.worker_count());
+	Run(parallel_name, iterations, [&]()
+	{
+		for (int frame = 0; frame < kNumFrames; ++frame)
+			parallel_skinner.Skin(&vertices.front(), kNumVertices, &palettes[frame].front(), kNumBones, &positions.front(), &normals.front());
+		g_sink += positions[kNumVertices - 1].x();
+	});
+
+	// every frame must match the reference, blending the matrices first only changes the rounding
+	float max_position_error = 0.0f;
+	float max_normal_error = 0.0f;
+	std::vector<gef::Vector4> parallel_positions(kNumVertices), parallel_normals(kNumVertices);
+	bool parallel_matches = true;
+	for (int frame = 0; frame < kNumFrames; ++frame)
+	{
+		ReferenceSkin(vertices, palettes[frame], reference_positions, reference_normals);
+		skinner.Skin(&vertices.front(), kNumVertices, &palettes[frame].front(), kNumBones, &positions.front(), &normals.front());
+		parallel_skinner.Skin(&vertices.front(), kNumVertices, &palettes[frame].front(), kNumBones, &parallel_positions.front(), &parallel_normals.front());
+
+		max_position_error = std::max(max_position_error, MaxError(positions, reference_positions));
+		max_normal_error = std::max(max_normal_error, MaxError(normals, reference_normals));
+		if (MaxError(positions, parallel_positions) != 0.0f || MaxError(normals, parallel_normals) != 0.0f)
+			parallel_matches = false;
+	}
+	printf("max |CpuSkinner - reference|: position %g, normal %g\n", max_position_error, max_normal_error);
+	printf("workers give the same result: %s\n", parallel_matches ? "yes" : "no");
+
+	return max_position_error < 1e-4f && max_normal_error < 1e-4f && parallel_matches ? 0 : 1;
+}